@@ -40,6 +40,9 @@ Action::Action()
 :_originalTarget(nullptr)
 ,_target(nullptr)
 ,_tag(Action::INVALID_TAG)
+,_compactManager(nullptr)
+,_compactChannel(-1)
+,_compactIndex(-1)
 {
 }
 
@@ -34,6 +34,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Node;
+class ActionManager;
 /**
  * @addtogroup actions
  * @{
@@ -122,6 +123,12 @@ protected:
     /** The action tag. An identifier of the action */
     int     _tag;
 
+    // where the ActionManager keeps the action when it is in its compact storage
+    ActionManager *_compactManager;   // nullptr when the action isn't in a compact storage
+    int     _compactChannel;
+    int     _compactIndex;
+    friend class ActionManager;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCActionInstant.h"
+#include "2d/CCActionManager.h"
 #include "base/CCDirector.h"
 #include "base/CCEventCustom.h"
 #include "base/CCEventDispatcher.h"
@@ -105,8 +106,22 @@ bool ActionInterval::initWithDuration(float d)
     return true;
 }
 
+float ActionInterval::getElapsed()
+{
+    // the compact storage of the ActionManager only updates _elapsed when the action leaves it
+    if (_compactManager)
+    {
+        return _compactManager->getCompactActionElapsed(this);
+    }
+    return _elapsed;
+}
+
 bool ActionInterval::isDone() const
 {
+    if (_compactManager)
+    {
+        return _compactManager->getCompactActionElapsed(this) >= _duration;
+    }
     return _elapsed >= _duration;
 }
 
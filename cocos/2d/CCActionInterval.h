@@ -67,7 +67,7 @@ class CC_DLL ActionInterval : public FiniteTimeAction
 {
 public:
     /** how many seconds had elapsed since the actions started to run. */
-    inline float getElapsed(void) { return _elapsed; }
+    float getElapsed(void);
 
     //extension in GridAction
     void setAmplitudeRate(float amp);
@@ -98,6 +98,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     float _elapsed;
     bool   _firstTick;
+    friend class ActionManager;
 };
 
 /** @brief Runs actions sequentially, one after another
@@ -373,6 +374,7 @@ protected:
     Vec3 _dstAngle;
     Vec3 _startAngle;
     Vec3 _diffAngle;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
@@ -411,6 +413,7 @@ protected:
     bool _is3D;
     Vec3 _deltaAngle;
     Vec3 _startAngle;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateBy);
@@ -450,6 +453,7 @@ protected:
     Vec3 _positionDelta;
     Vec3 _startPosition;
     Vec3 _previousPosition;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
@@ -746,6 +750,7 @@ protected:
     float _deltaX;
     float _deltaY;
     float _deltaZ;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
@@ -843,6 +848,7 @@ protected:
     GLubyte _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
@@ -927,6 +933,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     Color3B _to;
     Color3B _from;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TintTo);
@@ -964,6 +971,7 @@ protected:
     GLshort _fromR;
     GLshort _fromG;
     GLshort _fromB;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TintBy);
@@ -29,10 +29,17 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionInterval.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
 #include "base/uthash.h"
+#include "base/utlist.h"
+
+#include <typeinfo>
+#include <vector>
+#include <algorithm>
+#include <float.h>
 
 NS_CC_BEGIN
 //
@@ -46,13 +53,125 @@ typedef struct _hashElement
     Action              *currentAction;
     bool                currentActionSalvaged;
     bool                paused;
+    int                 compactActions; // number of actions in the compact storage
+    bool                stepped;        // whether it is in the stepped targets list
+    struct _hashElement *prev, *next;   // stepped targets list
     UT_hash_handle      hh;
 } tHashElement;
 
+//
+// compact storage
+//
+// The common interval actions are kept in parallel arrays, one set of arrays per animated property.
+// Computing the values is a plain loop on floats, and applying them doesn't dispatch on the action type.
+//
+enum
+{
+    kCompactPosition,
+    kCompactScale,
+    kCompactRotation,
+    kCompactRotation3D,
+    kCompactOpacity,
+    kCompactColor,
+    kCompactChannelCount
+};
+
+static const int kCompactMaxComponents = 3;
+
+struct CompactChannel
+{
+    CompactChannel() : components(0) {}
+
+    int                     components;
+    std::vector<Action*>    actions;    // nullptr when removed while the channel is applied
+    std::vector<Node*>      targets;
+    std::vector<float>      elapsed;
+    std::vector<float>      duration;
+    std::vector<float>      running;    // 0 while the target is paused
+    std::vector<float>      ticked;     // 0 until the first step, which doesn't count dt
+    std::vector<float>      time;
+    std::vector<float>      from[kCompactMaxComponents];
+    std::vector<float>      delta[kCompactMaxComponents];
+    std::vector<float>      value[kCompactMaxComponents];
+    std::vector<float>      previous[kCompactMaxComponents];    // position set by the previous step, for stackable MoveBy
+
+    size_t size() const { return actions.size(); }
+
+    void push(Action *action, Node *target, float actionDuration, bool paused, const float *start, const float *change, const float *last)
+    {
+        actions.push_back(action);
+        targets.push_back(target);
+        elapsed.push_back(0);
+        duration.push_back(std::max(actionDuration, FLT_EPSILON));
+        running.push_back(paused ? 0.0f : 1.0f);
+        ticked.push_back(0);
+        time.push_back(0);
+        for (int c = 0; c < components; ++c)
+        {
+            from[c].push_back(start[c]);
+            delta[c].push_back(change[c]);
+            value[c].push_back(start[c]);
+            previous[c].push_back(last[c]);
+        }
+    }
+
+    // the last action takes the place of the removed one. Returns it, its index must be updated
+    Action* removeAt(size_t index)
+    {
+        Action *moved = nullptr;
+        size_t last = actions.size() - 1;
+        if (index != last)
+        {
+            actions[index] = actions[last];
+            targets[index] = targets[last];
+            elapsed[index] = elapsed[last];
+            duration[index] = duration[last];
+            running[index] = running[last];
+            ticked[index] = ticked[last];
+            time[index] = time[last];
+            for (int c = 0; c < components; ++c)
+            {
+                from[c][index] = from[c][last];
+                delta[c][index] = delta[c][last];
+                value[c][index] = value[c][last];
+                previous[c][index] = previous[c][last];
+            }
+            moved = actions[index];
+        }
+
+        actions.pop_back();
+        targets.pop_back();
+        elapsed.pop_back();
+        duration.pop_back();
+        running.pop_back();
+        ticked.pop_back();
+        time.pop_back();
+        for (int c = 0; c < components; ++c)
+        {
+            from[c].pop_back();
+            delta[c].pop_back();
+            value[c].pop_back();
+            previous[c].pop_back();
+        }
+        return moved;
+    }
+};
+
+typedef struct _compactActions
+{
+    CompactChannel          channels[kCompactChannelCount];
+    // while true, removed actions are only cleared, the arrays are packed after the update
+    bool                    updating;
+    bool                    hasHoles;
+    std::vector<Action*>    finished;
+} tCompactActions;
+
 ActionManager::ActionManager()
 : _targets(nullptr),
+  _steppedTargets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _compactActions(nullptr)
 {
 
 }
@@ -62,6 +181,7 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    CC_SAFE_DELETE(_compactActions);
 }
 
 // private
@@ -69,6 +189,10 @@ ActionManager::~ActionManager()
 void ActionManager::deleteHashElement(tHashElement *element)
 {
     ccArrayFree(element->actions);
+    if (element->stepped)
+    {
+        DL_DELETE(_steppedTargets, element);
+    }
     HASH_DEL(_targets, element);
     element->target->release();
     free(element);
@@ -98,6 +222,11 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->currentActionSalvaged = true;
     }
 
+    if (action->_compactChannel != -1)
+    {
+        removeCompactAction(action);
+        element->compactActions--;
+    }
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
     // update actionIndex in case we are in tick. looping over the actions
@@ -125,9 +254,10 @@ void ActionManager::pauseTarget(Node *target)
 {
     tHashElement *element = nullptr;
     HASH_FIND_PTR(_targets, &target, element);
-    if (element)
+    if (element && ! element->paused)
     {
         element->paused = true;
+        setCompactActionsPaused(element, true);
     }
 }
 
@@ -135,9 +265,10 @@ void ActionManager::resumeTarget(Node *target)
 {
     tHashElement *element = nullptr;
     HASH_FIND_PTR(_targets, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        setCompactActionsPaused(element, false);
     }
 }
 
@@ -150,6 +281,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
         if (! element->paused) 
         {
             element->paused = true;
+            setCompactActionsPaused(element, true);
             idsWithActions.pushBack(element->target);
         }
     }    
@@ -190,6 +322,24 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+     if (_compactActions && addCompactAction(action, element))
+     {
+         element->compactActions++;
+     }
+     else
+     {
+         addSteppedTarget(element);
+     }
+}
+
+void ActionManager::addSteppedTarget(tHashElement *element)
+{
+    if (! element->stepped)
+    {
+        element->stepped = true;
+        DL_APPEND(_steppedTargets, element);
+    }
 }
 
 // remove
@@ -222,6 +372,18 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        if (element->compactActions > 0)
+        {
+            for (int i = 0; i < element->actions->num; ++i)
+            {
+                Action *action = (Action*)element->actions->arr[i];
+                if (action->_compactChannel != -1)
+                {
+                    removeCompactAction(action);
+                }
+            }
+            element->compactActions = 0;
+        }
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -365,10 +527,365 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
     return 0;
 }
 
+// compact storage
+
+void ActionManager::setCompactStorageEnabled(bool enabled)
+{
+    if (enabled == (_compactActions != nullptr))
+    {
+        return;
+    }
+
+    if (enabled)
+    {
+        _compactActions = new (std::nothrow) tCompactActions();
+        _compactActions->updating = false;
+        _compactActions->hasHoles = false;
+
+        static const int components[kCompactChannelCount] = { 3, 3, 2, 3, 1, 3 };
+        for (int i = 0; i < kCompactChannelCount; ++i)
+        {
+            _compactActions->channels[i].components = components[i];
+        }
+
+        // the running actions are moved to the compact storage too
+        for (tHashElement *element = _targets; element != nullptr; element = (tHashElement*)element->hh.next)
+        {
+            for (int i = 0; i < element->actions->num; ++i)
+            {
+                Action *action = (Action*)element->actions->arr[i];
+                if (action != element->currentAction && addCompactAction(action, element))
+                {
+                    element->compactActions++;
+                }
+            }
+        }
+    }
+    else
+    {
+        CCASSERT(! _compactActions->updating, "Can't disable the compact storage while it is updated");
+
+        // the actions state is written back, they are stepped as usual from now on
+        for (tHashElement *element = _targets; element != nullptr; element = (tHashElement*)element->hh.next)
+        {
+            addSteppedTarget(element);
+            for (int i = 0; i < element->actions->num; ++i)
+            {
+                Action *action = (Action*)element->actions->arr[i];
+                if (action->_compactChannel != -1)
+                {
+                    removeCompactAction(action);
+                }
+            }
+            element->compactActions = 0;
+        }
+
+        CC_SAFE_DELETE(_compactActions);
+    }
+}
+
+bool ActionManager::addCompactAction(Action *action, tHashElement *element)
+{
+    // only the exact types: subclasses may override update()
+    const std::type_info& type = typeid(*action);
+    float start[kCompactMaxComponents] = { 0, 0, 0 };
+    float change[kCompactMaxComponents] = { 0, 0, 0 };
+    float last[kCompactMaxComponents] = { 0, 0, 0 };
+    int channel = -1;
+
+    if (type == typeid(MoveBy) || type == typeid(MoveTo))
+    {
+        auto move = static_cast<MoveBy*>(action);
+        channel = kCompactPosition;
+        start[0] = move->_startPosition.x; start[1] = move->_startPosition.y; start[2] = move->_startPosition.z;
+        change[0] = move->_positionDelta.x; change[1] = move->_positionDelta.y; change[2] = move->_positionDelta.z;
+        last[0] = move->_previousPosition.x; last[1] = move->_previousPosition.y; last[2] = move->_previousPosition.z;
+    }
+    else if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
+    {
+        auto scale = static_cast<ScaleTo*>(action);
+        channel = kCompactScale;
+        start[0] = scale->_startScaleX; start[1] = scale->_startScaleY; start[2] = scale->_startScaleZ;
+        change[0] = scale->_deltaX; change[1] = scale->_deltaY; change[2] = scale->_deltaZ;
+    }
+    else if (type == typeid(RotateTo))
+    {
+        auto rotate = static_cast<RotateTo*>(action);
+        channel = rotate->_is3D ? kCompactRotation3D : kCompactRotation;
+        start[0] = rotate->_startAngle.x; start[1] = rotate->_startAngle.y; start[2] = rotate->_startAngle.z;
+        change[0] = rotate->_diffAngle.x; change[1] = rotate->_diffAngle.y; change[2] = rotate->_diffAngle.z;
+    }
+    else if (type == typeid(RotateBy))
+    {
+        auto rotate = static_cast<RotateBy*>(action);
+        channel = rotate->_is3D ? kCompactRotation3D : kCompactRotation;
+        start[0] = rotate->_startAngle.x; start[1] = rotate->_startAngle.y; start[2] = rotate->_startAngle.z;
+        change[0] = rotate->_deltaAngle.x; change[1] = rotate->_deltaAngle.y; change[2] = rotate->_deltaAngle.z;
+    }
+    else if (type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut))
+    {
+        auto fade = static_cast<FadeTo*>(action);
+        channel = kCompactOpacity;
+        start[0] = fade->_fromOpacity;
+        change[0] = (float)(fade->_toOpacity - fade->_fromOpacity);
+    }
+    else if (type == typeid(TintTo))
+    {
+        auto tint = static_cast<TintTo*>(action);
+        channel = kCompactColor;
+        start[0] = tint->_from.r; start[1] = tint->_from.g; start[2] = tint->_from.b;
+        change[0] = (float)(tint->_to.r - tint->_from.r);
+        change[1] = (float)(tint->_to.g - tint->_from.g);
+        change[2] = (float)(tint->_to.b - tint->_from.b);
+    }
+    else if (type == typeid(TintBy))
+    {
+        auto tint = static_cast<TintBy*>(action);
+        channel = kCompactColor;
+        start[0] = tint->_fromR; start[1] = tint->_fromG; start[2] = tint->_fromB;
+        change[0] = tint->_deltaR; change[1] = tint->_deltaG; change[2] = tint->_deltaB;
+    }
+
+    if (channel == -1)
+    {
+        return false;
+    }
+
+    auto interval = static_cast<ActionInterval*>(action);
+    CompactChannel& compact = _compactActions->channels[channel];
+    action->_compactManager = this;
+    action->_compactChannel = channel;
+    action->_compactIndex = (int)compact.size();
+    compact.push(action, element->target, interval->getDuration(), element->paused, start, change, last);
+
+    // the action may have been stepped already, when the storage is enabled while it runs
+    size_t index = compact.size() - 1;
+    compact.elapsed[index] = interval->_elapsed;
+    compact.ticked[index] = interval->_firstTick ? 0.0f : 1.0f;
+
+    return true;
+}
+
+void ActionManager::removeCompactAction(Action *action)
+{
+    CompactChannel& compact = _compactActions->channels[action->_compactChannel];
+    size_t index = action->_compactIndex;
+    auto interval = static_cast<ActionInterval*>(action);
+
+    interval->_elapsed = compact.elapsed[index];
+    interval->_firstTick = (compact.ticked[index] == 0);
+
+    // a stackable MoveBy moves its start along with the node
+    if (action->_compactChannel == kCompactPosition)
+    {
+        auto move = static_cast<MoveBy*>(action);
+        move->_startPosition.set(compact.from[0][index], compact.from[1][index], compact.from[2][index]);
+        move->_previousPosition.set(compact.previous[0][index], compact.previous[1][index], compact.previous[2][index]);
+    }
+
+    action->_compactManager = nullptr;
+    action->_compactChannel = -1;
+    action->_compactIndex = -1;
+
+    if (_compactActions->updating)
+    {
+        compact.actions[index] = nullptr;
+        _compactActions->hasHoles = true;
+    }
+    else
+    {
+        Action *moved = compact.removeAt(index);
+        if (moved)
+        {
+            moved->_compactIndex = (int)index;
+        }
+    }
+}
+
+float ActionManager::getCompactActionElapsed(const Action *action) const
+{
+    return _compactActions->channels[action->_compactChannel].elapsed[action->_compactIndex];
+}
+
+void ActionManager::setCompactActionsPaused(tHashElement *element, bool paused)
+{
+    if (element->compactActions == 0)
+    {
+        return;
+    }
+
+    for (int i = 0; i < element->actions->num; ++i)
+    {
+        Action *action = (Action*)element->actions->arr[i];
+        if (action->_compactChannel != -1)
+        {
+            _compactActions->channels[action->_compactChannel].running[action->_compactIndex] = paused ? 0.0f : 1.0f;
+        }
+    }
+}
+
+// sets the value computed for a compact action on its target
+static void applyCompactAction(CompactChannel& compact, int channel, size_t i)
+{
+    Node *target = compact.targets[i];
+    switch (channel)
+    {
+        case kCompactPosition:
+        {
+#if CC_ENABLE_STACKABLE_ACTIONS
+            Vec3 currentPos = target->getPosition3D();
+            for (int c = 0; c < 3; ++c)
+            {
+                float component = c == 0 ? currentPos.x : (c == 1 ? currentPos.y : currentPos.z);
+                compact.from[c][i] += component - compact.previous[c][i];
+                compact.previous[c][i] = compact.from[c][i] + compact.delta[c][i] * compact.time[i];
+            }
+            target->setPosition3D(Vec3(compact.previous[0][i], compact.previous[1][i], compact.previous[2][i]));
+#else
+            target->setPosition3D(Vec3(compact.value[0][i], compact.value[1][i], compact.value[2][i]));
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+            break;
+        }
+        case kCompactScale:
+            target->setScaleX(compact.value[0][i]);
+            target->setScaleY(compact.value[1][i]);
+            target->setScaleZ(compact.value[2][i]);
+            break;
+        case kCompactRotation:
+#if CC_USE_PHYSICS
+            if (compact.from[0][i] == compact.from[1][i] && compact.delta[0][i] == compact.delta[1][i])
+            {
+                target->setRotation(compact.value[0][i]);
+                break;
+            }
+#endif // CC_USE_PHYSICS
+            target->setRotationSkewX(compact.value[0][i]);
+            target->setRotationSkewY(compact.value[1][i]);
+            break;
+        case kCompactRotation3D:
+            target->setRotation3D(Vec3(compact.value[0][i], compact.value[1][i], compact.value[2][i]));
+            break;
+        case kCompactOpacity:
+            target->setOpacity((GLubyte)compact.value[0][i]);
+            break;
+        case kCompactColor:
+            target->setColor(Color3B((GLubyte)compact.value[0][i], (GLubyte)compact.value[1][i], (GLubyte)compact.value[2][i]));
+            break;
+        default:
+            break;
+    }
+}
+
+void ActionManager::updateCompactActions(float dt)
+{
+    _compactActions->updating = true;
+
+    size_t counts[kCompactChannelCount];
+    size_t maxCount = 0;
+    for (int channel = 0; channel < kCompactChannelCount; ++channel)
+    {
+        CompactChannel& compact = _compactActions->channels[channel];
+        const size_t count = compact.size();
+        counts[channel] = count;
+        maxCount = std::max(maxCount, count);
+
+        // same steps as ActionInterval::step()
+        float *elapsed = compact.elapsed.data();
+        float *running = compact.running.data();
+        float *ticked = compact.ticked.data();
+        float *time = compact.time.data();
+        const float *duration = compact.duration.data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            elapsed[i] += dt * running[i] * ticked[i];
+            ticked[i] = std::max(ticked[i], running[i]);
+            time[i] = std::max(0.0f, std::min(1.0f, elapsed[i] / duration[i]));
+        }
+
+        for (int c = 0; c < compact.components; ++c)
+        {
+            const float *from = compact.from[c].data();
+            const float *delta = compact.delta[c].data();
+            float *value = compact.value[c].data();
+            for (size_t i = 0; i < count; ++i)
+            {
+                value[i] = from[i] + delta[i] * time[i];
+            }
+        }
+    }
+
+    // The channels are applied side by side: the actions run on a node are usually added together,
+    // so they are at the same index, and the node is still in the cache for the next channel.
+    // Applying calls the node setters, which may add or remove actions: the arrays are indexed, not iterated
+    for (size_t i = 0; i < maxCount; ++i)
+    {
+        for (int channel = 0; channel < kCompactChannelCount; ++channel)
+        {
+            CompactChannel& compact = _compactActions->channels[channel];
+            if (i >= counts[channel] || compact.actions[i] == nullptr || compact.running[i] == 0)
+            {
+                continue;
+            }
+
+            // the action itself isn't touched: its state is written back when it leaves the storage
+            if (compact.elapsed[i] >= compact.duration[i])
+            {
+                compact.actions[i]->retain();
+                _compactActions->finished.push_back(compact.actions[i]);
+            }
+
+            applyCompactAction(compact, channel, i);
+        }
+    }
+
+    _compactActions->updating = false;
+
+    if (_compactActions->hasHoles)
+    {
+        _compactActions->hasHoles = false;
+        for (int channel = 0; channel < kCompactChannelCount; ++channel)
+        {
+            CompactChannel& compact = _compactActions->channels[channel];
+            for (size_t i = compact.size(); i-- > 0; )
+            {
+                if (compact.actions[i] == nullptr)
+                {
+                    Action *moved = compact.removeAt(i);
+                    if (moved)
+                    {
+                        moved->_compactIndex = (int)i;
+                    }
+                }
+            }
+        }
+    }
+
+    // the finished actions are stopped and removed like in the main loop, unless a setter already removed them
+    if (! _compactActions->finished.empty())
+    {
+        std::vector<Action*> finished;
+        finished.swap(_compactActions->finished);
+        for (auto action : finished)
+        {
+            if (action->_compactChannel != -1)
+            {
+                action->stop();
+                removeAction(action);
+            }
+            action->release();
+        }
+    }
+}
+
 // main loop
 void ActionManager::update(float dt)
 {
-    for (tHashElement *elt = _targets; elt != nullptr; )
+    if (_compactActions)
+    {
+        updateCompactActions(dt);
+    }
+
+    for (tHashElement *elt = _steppedTargets; elt != nullptr; )
     {
         _currentTarget = elt;
         _currentTargetSalvaged = false;
@@ -380,8 +897,9 @@ void ActionManager::update(float dt)
                 _currentTarget->actionIndex++)
             {
                 _currentTarget->currentAction = (Action*)_currentTarget->actions->arr[_currentTarget->actionIndex];
-                if (_currentTarget->currentAction == nullptr)
+                if (_currentTarget->currentAction == nullptr || _currentTarget->currentAction->_compactChannel != -1)
                 {
+                    _currentTarget->currentAction = nullptr;
                     continue;
                 }
 
@@ -412,13 +930,19 @@ void ActionManager::update(float dt)
 
         // elt, at this moment, is still valid
         // so it is safe to ask this here (issue #490)
-        elt = (tHashElement*)(elt->hh.next);
+        elt = elt->next;
 
         // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
         if (_currentTargetSalvaged && _currentTarget->actions->num == 0)
         {
             deleteHashElement(_currentTarget);
         }
+        else if (_currentTarget->actions->num > 0 && _currentTarget->actions->num == _currentTarget->compactActions)
+        {
+            // only compact actions left, the target isn't visited until a regular action is added
+            _currentTarget->stepped = false;
+            DL_DELETE(_steppedTargets, _currentTarget);
+        }
     }
 
     // issue #635
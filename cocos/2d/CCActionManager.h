@@ -38,6 +38,7 @@ NS_CC_BEGIN
 class Action;
 
 struct _hashElement;
+struct _compactActions;
 
 /**
  * @addtogroup actions
@@ -127,6 +128,21 @@ public:
      */
     void resumeTargets(const Vector<Node*>& targetsToResume);
 
+    /** Enables the compact storage of the common interval actions. Disabled by default.
+     MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo, FadeIn, FadeOut, TintTo and TintBy actions
+     that are run directly on a node (not inside a Sequence, a Spawn, an ease action...) are kept in arrays
+     grouped by the property they animate, and updated together instead of through Action::step().
+     The other actions, including subclasses of these ones, are updated as usual.
+     It is faster when many nodes are tweened, but:
+     - the compact actions are updated before the other ones, instead of in the order they were added
+     - changing the duration of a running compact action has no effect
+     @since v3.4
+     */
+    void setCompactStorageEnabled(bool enabled);
+
+    /** Returns whether the compact storage of the common interval actions is enabled. */
+    bool isCompactStorageEnabled() const { return _compactActions != nullptr; }
+
     void update(float dt);
     
 protected:
@@ -136,10 +152,24 @@ protected:
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
 
+    // compact storage specific
+
+    bool addCompactAction(Action *action, struct _hashElement *element);
+    void removeCompactAction(Action *action);
+    float getCompactActionElapsed(const Action *action) const;
+    void addSteppedTarget(struct _hashElement *element);
+    void setCompactActionsPaused(struct _hashElement *element, bool paused);
+    void updateCompactActions(float dt);
+
+    friend class ActionInterval;
+
 protected:
     struct _hashElement    *_targets;
+    // the targets running actions that aren't in the compact storage
+    struct _hashElement    *_steppedTargets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+    struct _compactActions *_compactActions;
 };
 
 // end of actions group
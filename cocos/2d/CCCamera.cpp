@@ -25,6 +25,7 @@
 #include "base/CCDirector.h"
 #include "platform/CCGLView.h"
 #include "2d/CCScene.h"
+#include "renderer/CCRenderer.h"
 
 NS_CC_BEGIN
 
@@ -316,4 +317,63 @@ void Camera::setScene(Scene* scene)
     }
 }
 
+// CameraDrawLists
+
+void CameraDrawLists::reset(const std::vector<Camera*>& cameras)
+{
+    _cameras = cameras;
+    _cameraFlags.resize(cameras.size());
+    for (size_t i = 0; i < cameras.size(); ++i)
+    {
+        _cameraFlags[i] = (unsigned short)cameras[i]->getCameraFlag();
+    }
+
+    // the lists keep their capacity from frame to frame
+    _lists.resize(cameras.size());
+    for (auto& list : _lists)
+    {
+        list.clear();
+    }
+}
+
+void CameraDrawLists::addDraw(Node* node, const Mat4* transform, uint32_t flags)
+{
+    unsigned short mask = node->getCameraMask();
+    for (size_t i = 0; i < _cameraFlags.size(); ++i)
+    {
+        if (_cameraFlags[i] & mask)
+        {
+            Draw draw = { node, transform, flags, false };
+            _lists[i].push_back(draw);
+        }
+    }
+}
+
+void CameraDrawLists::addVisit(Node* node, const Mat4* parentTransform, uint32_t parentFlags)
+{
+    Draw draw = { node, parentTransform, parentFlags, true };
+    for (auto& list : _lists)
+    {
+        list.push_back(draw);
+    }
+}
+
+void CameraDrawLists::replay(size_t cameraIndex, Renderer* renderer) const
+{
+    // the draws may still read the deprecated model view stack
+    bool useMatrixStack = renderer->isLegacyMatrixStackEnabled();
+    auto director = Director::getInstance();
+    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    for (const auto& draw : _lists[cameraIndex])
+    {
+        if (useMatrixStack || draw.node->usesLegacyMatrixStack())
+            director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, *draw.transform);
+        if (draw.visit)
+            draw.node->visit(renderer, *draw.transform, draw.flags);
+        else
+            draw.node->draw(renderer, *draw.transform, draw.flags);
+    }
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
+
 NS_CC_END
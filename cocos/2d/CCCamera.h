@@ -190,6 +190,46 @@ protected:
     friend class Director;
 };
 
+/**
+ * The draws of a frame sorted by camera, recorded by one traversal of the scene.
+ * While a Renderer has lists, Node::visit() computes the transforms and records the draws instead of drawing,
+ * and the scene replays the draws of each camera. @see Scene::setCameraVisitMode()
+ */
+class CC_DLL CameraDrawLists
+{
+public:
+    /** clears the lists, and sets the cameras that get draws */
+    void reset(const std::vector<Camera*>& cameras);
+
+    const std::vector<Camera*>& getCameras() const { return _cameras; }
+
+    /** records node->draw(renderer, *transform, flags) for the cameras of the node's camera mask */
+    void addDraw(Node* node, const Mat4* transform, uint32_t flags);
+
+    /** records node->visit(renderer, *parentTransform, parentFlags) for every camera, for the nodes that
+     have a custom visit() */
+    void addVisit(Node* node, const Mat4* parentTransform, uint32_t parentFlags);
+
+    /** draws and visits what was recorded for a camera, the caller sets the visiting camera and its projection */
+    void replay(size_t cameraIndex, Renderer* renderer) const;
+
+    /** returns the number of draws and visits recorded for a camera */
+    size_t getDrawCount(size_t cameraIndex) const { return _lists[cameraIndex].size(); }
+
+protected:
+    struct Draw
+    {
+        Node* node;
+        const Mat4* transform;
+        uint32_t flags;
+        bool visit;
+    };
+
+    std::vector<Camera*> _cameras;
+    std::vector<unsigned short> _cameraFlags;
+    std::vector<std::vector<Draw>> _lists;
+};
+
 NS_CC_END
 
 #endif// __CCCAMERA_H_
@@ -103,6 +103,7 @@ public:
      */
     virtual void onExit() override;
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
     
 CC_CONSTRUCTOR_ACCESS:
     ClippingNode();
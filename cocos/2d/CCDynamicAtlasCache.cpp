@@ -0,0 +1,464 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "2d/CCDynamicAtlasCache.h"
+
+#include <algorithm>
+#include <climits>
+
+#include "2d/CCSpriteFrame.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+#include "platform/CCGL.h"
+#include "platform/CCImage.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureCache.h"
+#include "deprecated/CCString.h"
+
+NS_CC_BEGIN
+
+static DynamicAtlasCache* s_sharedDynamicAtlasCache = nullptr;
+
+DynamicAtlasCache* DynamicAtlasCache::getInstance()
+{
+    if (! s_sharedDynamicAtlasCache)
+    {
+        s_sharedDynamicAtlasCache = new (std::nothrow) DynamicAtlasCache();
+    }
+    return s_sharedDynamicAtlasCache;
+}
+
+void DynamicAtlasCache::destroyInstance()
+{
+    CC_SAFE_RELEASE_NULL(s_sharedDynamicAtlasCache);
+}
+
+DynamicAtlasCache::DynamicAtlasCache()
+: _enabled(false)
+, _pageSize(1024)
+, _maxImageSize(256)
+, _maxPageCount(4)
+, _pageSerial(0)
+{
+}
+
+DynamicAtlasCache::~DynamicAtlasCache()
+{
+    removeAllPages();
+}
+
+void DynamicAtlasCache::setPageSize(int pixels)
+{
+    _pageSize = std::min(pixels, Configuration::getInstance()->getMaxTextureSize());
+}
+
+Texture2D* DynamicAtlasCache::addImage(const std::string& filepath, Rect* rect)
+{
+    if (!_enabled || filepath.empty())
+    {
+        return nullptr;
+    }
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filepath);
+    if (fullpath.empty())
+    {
+        return nullptr;
+    }
+
+    auto it = _entries.find(fullpath);
+    if (it != _entries.end())
+    {
+        *rect = CC_RECT_PIXELS_TO_POINTS(it->second.rect);
+        return it->second.page->texture;
+    }
+
+    if (_rejectedFiles.find(fullpath) != _rejectedFiles.end())
+    {
+        return nullptr;
+    }
+
+    Image* image = new (std::nothrow) Image();
+    Entry entry = { nullptr, Rect::ZERO };
+    bool decoded = false;
+
+    do
+    {
+        CC_BREAK_IF(!image || !image->initWithImageFile(fullpath));
+        decoded = true;
+        CC_BREAK_IF(image->isCompressed() || image->getNumberOfMipmaps() > 1);
+        CC_BREAK_IF(image->getWidth() > _maxImageSize || image->getHeight() > _maxImageSize);
+
+        auto format = image->getRenderFormat();
+        CC_BREAK_IF(format != Texture2D::PixelFormat::RGBA8888 && format != Texture2D::PixelFormat::RGB888);
+
+        unsigned char* rgba = image->getData();
+        ssize_t rgbaLen = image->getDataLen();
+        // an opaque image looks the same in a page with or without premultiplied alpha
+        bool opaque = format == Texture2D::PixelFormat::RGB888;
+        if (opaque)
+        {
+            Texture2D::convertDataToFormat(image->getData(), image->getDataLen(), format, Texture2D::PixelFormat::RGBA8888, &rgba, &rgbaLen);
+        }
+
+        for (auto page : _pages)
+        {
+            if ((opaque || page->premultipliedAlpha == image->hasPremultipliedAlpha())
+                && insertImage(page, rgba, image->getWidth(), image->getHeight(), &entry.rect))
+            {
+                entry.page = page;
+                break;
+            }
+        }
+
+        if (!entry.page && (int)_pages.size() < _maxPageCount)
+        {
+            Page* page = createPage(opaque || image->hasPremultipliedAlpha());
+            if (page && insertImage(page, rgba, image->getWidth(), image->getHeight(), &entry.rect))
+            {
+                entry.page = page;
+            }
+        }
+
+        if (rgba != image->getData())
+        {
+            free(rgba);
+        }
+    } while (0);
+
+    if (!entry.page && decoded)
+    {
+        // the caller falls back to the TextureCache, which finds the file there instead of decoding it again
+        Director::getInstance()->getTextureCache()->addDecodedImage(fullpath, image);
+    }
+
+    CC_SAFE_RELEASE(image);
+
+    if (!entry.page)
+    {
+        _rejectedFiles.insert(fullpath);
+        return nullptr;
+    }
+
+    _entries[fullpath] = entry;
+    *rect = CC_RECT_PIXELS_TO_POINTS(entry.rect);
+    return entry.page->texture;
+}
+
+SpriteFrame* DynamicAtlasCache::getSpriteFrame(const std::string& filepath)
+{
+    Rect rect;
+    Texture2D* texture = addImage(filepath, &rect);
+    if (texture)
+    {
+        return SpriteFrame::createWithTexture(texture, rect);
+    }
+    return nullptr;
+}
+
+DynamicAtlasCache::Page* DynamicAtlasCache::createPage(bool premultipliedAlpha)
+{
+    int size = std::min(_pageSize, Configuration::getInstance()->getMaxTextureSize());
+    ssize_t dataLen = (ssize_t)size * size * 4;
+    unsigned char* data = static_cast<unsigned char*>(calloc(dataLen, 1));
+    if (!data)
+    {
+        return nullptr;
+    }
+
+    Image* image = new (std::nothrow) Image();
+    bool ok = image->initWithRawData(data, dataLen, size, size, 8, premultipliedAlpha);
+    free(data);
+    if (!ok)
+    {
+        CC_SAFE_RELEASE(image);
+        return nullptr;
+    }
+
+    // the TextureCache converts the page to the default alpha pixel format, and counts its memory
+    std::string key = StringUtils::format("/cc_dynamic_atlas_page_%u", _pageSerial++);
+    Texture2D* texture = Director::getInstance()->getTextureCache()->addImage(image, key);
+    if (!texture)
+    {
+        CC_SAFE_RELEASE(image);
+        return nullptr;
+    }
+    texture->retain();
+
+    Page* page = new (std::nothrow) Page();
+    page->texture = texture;
+    page->key = key;
+    page->premultipliedAlpha = premultipliedAlpha;
+    page->usedPixels = 0;
+    page->imageCount = 0;
+    SkylineSegment ground = { 0, 0, texture->getPixelsWide() };
+    page->skyline.push_back(ground);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // also retained by the VolatileTextureMgr, which reloads the page from it
+    page->image = image;
+#else
+    image->release();
+#endif
+
+    _pages.push_back(page);
+    return page;
+}
+
+void DynamicAtlasCache::releasePage(Page* page)
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    if (textureCache && textureCache->getTextureForKey(page->key) == page->texture)
+    {
+        textureCache->removeTextureForKey(page->key);
+    }
+    page->texture->release();
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    page->image->release();
+#endif
+    delete page;
+}
+
+int DynamicAtlasCache::findPosition(const Page* page, int width, int height, int* x, int* y) const
+{
+    int pageWidth = page->texture->getPixelsWide();
+    int pageHeight = page->texture->getPixelsHigh();
+    auto& skyline = page->skyline;
+
+    int bestIndex = -1;
+    int bestTop = INT_MAX;
+    int bestWidth = INT_MAX;
+
+    for (int i = 0; i < (int)skyline.size(); ++i)
+    {
+        int left = skyline[i].x;
+        if (left + width > pageWidth)
+            break;
+
+        // the rect rests on the highest segment below it
+        int top = skyline[i].y;
+        int widthLeft = width;
+        for (int j = i; widthLeft > 0; ++j)
+        {
+            top = std::max(top, skyline[j].y);
+            widthLeft -= skyline[j].width;
+        }
+
+        if (top + height > pageHeight)
+            continue;
+
+        if (top + height < bestTop || (top + height == bestTop && skyline[i].width < bestWidth))
+        {
+            bestIndex = i;
+            bestTop = top + height;
+            bestWidth = skyline[i].width;
+            *x = left;
+            *y = top;
+        }
+    }
+
+    return bestIndex;
+}
+
+void DynamicAtlasCache::addSkylineLevel(Page* page, int index, int x, int y, int width, int height)
+{
+    auto& skyline = page->skyline;
+
+    SkylineSegment segment = { x, y + height, width };
+    skyline.insert(skyline.begin() + index, segment);
+
+    // shrink or remove the segments now covered by the new one
+    for (size_t i = index + 1; i < skyline.size(); )
+    {
+        int right = skyline[i - 1].x + skyline[i - 1].width;
+        if (skyline[i].x >= right)
+            break;
+
+        int overlap = right - skyline[i].x;
+        if (skyline[i].width <= overlap)
+        {
+            skyline.erase(skyline.begin() + i);
+        }
+        else
+        {
+            skyline[i].x += overlap;
+            skyline[i].width -= overlap;
+            break;
+        }
+    }
+
+    // merge the neighbours at the same height
+    for (size_t i = 0; i + 1 < skyline.size(); )
+    {
+        if (skyline[i].y == skyline[i + 1].y)
+        {
+            skyline[i].width += skyline[i + 1].width;
+            skyline.erase(skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+bool DynamicAtlasCache::insertImage(Page* page, const unsigned char* rgba, int width, int height, Rect* rect)
+{
+    // a one pixel border repeats the edges, so that linear filtering doesn't blend the neighbours in
+    int paddedWidth = width + 2;
+    int paddedHeight = height + 2;
+
+    int x = 0;
+    int y = 0;
+    int index = findPosition(page, paddedWidth, paddedHeight, &x, &y);
+    if (index < 0)
+    {
+        return false;
+    }
+    addSkylineLevel(page, index, x, y, paddedWidth, paddedHeight);
+
+    ssize_t paddedLen = (ssize_t)paddedWidth * paddedHeight * 4;
+    std::vector<unsigned char> padded(paddedLen);
+    for (int row = 0; row < paddedHeight; ++row)
+    {
+        const unsigned char* src = rgba + (size_t)std::min(std::max(row - 1, 0), height - 1) * width * 4;
+        unsigned char* dst = &padded[(size_t)row * paddedWidth * 4];
+        memcpy(dst, src, 4);
+        memcpy(dst + 4, src, width * 4);
+        memcpy(dst + (paddedWidth - 1) * 4, src + (width - 1) * 4, 4);
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    int stride = page->image->getWidth() * 4;
+    for (int row = 0; row < paddedHeight; ++row)
+    {
+        memcpy(page->image->getData() + (size_t)(y + row) * stride + x * 4, &padded[(size_t)row * paddedWidth * 4], paddedWidth * 4);
+    }
+#endif
+
+    unsigned char* pixels = padded.data();
+    ssize_t pixelsLen = paddedLen;
+    auto pixelFormat = page->texture->getPixelFormat();
+    if (pixelFormat != Texture2D::PixelFormat::RGBA8888)
+    {
+        Texture2D::convertDataToFormat(padded.data(), paddedLen, Texture2D::PixelFormat::RGBA8888, pixelFormat, &pixels, &pixelsLen);
+    }
+
+    // rows of 16 bit formats aren't 4 bytes aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    page->texture->updateWithData(pixels, x, y, paddedWidth, paddedHeight);
+
+    if (pixels != padded.data())
+    {
+        free(pixels);
+    }
+
+    page->usedPixels += paddedWidth * paddedHeight;
+    ++page->imageCount;
+
+    *rect = Rect(x + 1, y + 1, width, height);
+    return true;
+}
+
+void DynamicAtlasCache::removeUnusedPages()
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+
+    for (auto it = _pages.begin(); it != _pages.end(); )
+    {
+        Page* page = *it;
+        // retained by this cache, and by the TextureCache unless it was flushed
+        unsigned int owners = textureCache->getTextureForKey(page->key) == page->texture ? 2 : 1;
+        if (page->texture->getReferenceCount() > owners)
+        {
+            ++it;
+            continue;
+        }
+
+        CCLOG("cocos2d: DynamicAtlasCache: removing unused page: %s", page->key.c_str());
+
+        for (auto entry = _entries.begin(); entry != _entries.end(); )
+        {
+            if (entry->second.page == page)
+                entry = _entries.erase(entry);
+            else
+                ++entry;
+        }
+        releasePage(page);
+        it = _pages.erase(it);
+    }
+
+    // the files that didn't fit may fit now
+    _rejectedFiles.clear();
+}
+
+void DynamicAtlasCache::removeAllPages()
+{
+    for (auto page : _pages)
+    {
+        releasePage(page);
+    }
+    _pages.clear();
+    _entries.clear();
+    _rejectedFiles.clear();
+}
+
+std::string DynamicAtlasCache::getCachedAtlasInfo() const
+{
+    std::string buffer;
+    char buftmp[4096];
+
+    int imageCount = 0;
+    for (auto page : _pages)
+    {
+        int pageWidth = page->texture->getPixelsWide();
+        int pageHeight = page->texture->getPixelsHigh();
+        snprintf(buftmp, sizeof(buftmp)-1, "\"%s\" rc=%lu id=%lu %d x %d%s: %d images, %.1f%% used\n",
+                 page->key.c_str(),
+                 (long)page->texture->getReferenceCount(),
+                 (long)page->texture->getName(),
+                 pageWidth,
+                 pageHeight,
+                 page->premultipliedAlpha ? " premultiplied" : "",
+                 page->imageCount,
+                 page->usedPixels * 100.0f / ((float)pageWidth * pageHeight));
+        buffer += buftmp;
+        imageCount += page->imageCount;
+    }
+
+    // each packed image had its own texture, so the sprites of its file broke the batches of the others
+    snprintf(buftmp, sizeof(buftmp)-1, "DynamicAtlasCache dumpDebugInfo: %d images in %d pages (%s): their sprites need %d textures instead of %d, %d files not packed\n",
+             imageCount,
+             (int)_pages.size(),
+             _enabled ? "enabled" : "disabled",
+             (int)_pages.size(),
+             imageCount,
+             (int)_rejectedFiles.size());
+    buffer += buftmp;
+
+    return buffer;
+}
+
+NS_CC_END
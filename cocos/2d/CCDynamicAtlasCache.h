@@ -0,0 +1,176 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_DYNAMIC_ATLAS_CACHE_H__
+#define __CC_DYNAMIC_ATLAS_CACHE_H__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "base/CCRef.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class Texture2D;
+class SpriteFrame;
+class Image;
+
+/**
+ * @addtogroup sprite_nodes
+ * @{
+ */
+
+/** Singleton that packs small image files into shared textures, the pages.
+
+A sprite drawn from a loose image file uses its own texture, so it can't be batched with the sprites of other files.
+When the cache is enabled, Sprite::create(filename), Sprite::setTexture(filename) and SpriteFrame::create(filename, rect)
+use a rect of a page instead of the texture of the file, and consecutive sprites of the same page are drawn in one batch.
+
+Files are packed on their first use, with a skyline packer. Only the uncompressed RGBA8888 and RGB888 images that
+are not larger than getMaxImageSize() are packed; the other files keep their own texture.
+A page has the default alpha pixel format of Texture2D when it is created, and the linear filtering of the default
+texture parameters. Changing the texture parameters of a sprite's texture changes them for every sprite of the page.
+Sprites of a page can't be added to a SpriteBatchNode created with the file of the image.
+
+It is disabled by default.
+@since v3.3
+*/
+class CC_DLL DynamicAtlasCache : public Ref
+{
+public:
+    /** Returns the shared instance of the cache */
+    static DynamicAtlasCache* getInstance();
+
+    /** Releases the pages and the shared instance */
+    static void destroyInstance();
+
+    /**
+     * @js NA
+     * @lua NA
+     */
+    DynamicAtlasCache();
+    /**
+     * @js NA
+     * @lua NA
+     */
+    virtual ~DynamicAtlasCache();
+
+    /** Enables the packing of the files used by sprites. Images packed before it is disabled stay in their page. */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    /** Sets the width and height of the pages created from now on, in pixels. The default is 1024.
+    It is clamped to the maximum texture size of the GPU.
+    */
+    void setPageSize(int pixels);
+    int getPageSize() const { return _pageSize; }
+
+    /** Sets the largest width or height of the images that are packed, in pixels. The default is 256. */
+    void setMaxImageSize(int pixels) { _maxImageSize = pixels; }
+    int getMaxImageSize() const { return _maxImageSize; }
+
+    /** Sets how many pages can be created. When they are full, the files keep their own texture. The default is 4. */
+    void setMaxPageCount(int count) { _maxPageCount = count; }
+    int getMaxPageCount() const { return _maxPageCount; }
+
+    /** Returns the page where the image of a file is packed, and its rect in the page in points.
+    The image is packed now if it wasn't already. Returns nullptr when the cache is disabled, or when the image can't be packed.
+    An image that was decoded but can't be packed is added to the TextureCache, where the caller finds it.
+    */
+    Texture2D* addImage(const std::string& filepath, Rect* rect);
+
+    /** Returns a new SpriteFrame that shows the whole image of a file from its page, or nullptr like addImage() */
+    SpriteFrame* getSpriteFrame(const std::string& filepath);
+
+    /** Releases the pages that no sprite nor sprite frame uses anymore. The images they hold will be packed again. */
+    void removeUnusedPages();
+
+    /** Releases every page. The sprites that use them keep their textures. */
+    void removeAllPages();
+
+    /** Returns the occupancy of each page, and how many textures were merged into them */
+    std::string getCachedAtlasInfo() const;
+
+protected:
+    // segment of the skyline: the top of the rects packed below [x, x + width)
+    struct SkylineSegment
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    struct Page
+    {
+        Texture2D* texture;
+        // the key of the texture in the TextureCache
+        std::string key;
+        bool premultipliedAlpha;
+        std::vector<SkylineSegment> skyline;
+        // pixels covered by the packed images and their borders
+        int usedPixels;
+        int imageCount;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // RGBA8888 copy of the page, to restore it when the GL context is lost
+        Image* image;
+#endif
+    };
+
+    struct Entry
+    {
+        Page* page;
+        // in pixels, without the border
+        Rect rect;
+    };
+
+    Page* createPage(bool premultipliedAlpha);
+    void releasePage(Page* page);
+    bool insertImage(Page* page, const unsigned char* rgba, int width, int height, Rect* rect);
+    // finds where a width x height rect fits the lowest in the skyline, returns the index of its first segment or -1
+    int findPosition(const Page* page, int width, int height, int* x, int* y) const;
+    void addSkylineLevel(Page* page, int index, int x, int y, int width, int height);
+
+    bool _enabled;
+    int _pageSize;
+    int _maxImageSize;
+    int _maxPageCount;
+    unsigned int _pageSerial;
+
+    std::vector<Page*> _pages;
+    // by full path of the image file
+    std::unordered_map<std::string, Entry> _entries;
+    // files that can't be packed, to not load them again
+    std::unordered_set<std::string> _rejectedFiles;
+};
+
+// end of sprite_nodes group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_DYNAMIC_ATLAS_CACHE_H__
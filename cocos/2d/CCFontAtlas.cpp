@@ -30,6 +30,10 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCWorkerPool.h"
+
+#include <algorithm>
 
 
 NS_CC_BEGIN
@@ -37,10 +41,58 @@ NS_CC_BEGIN
 const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::EVENT_PURGE_TEXTURES = "__cc_FontAtlasPurgeTextures";
+const char* FontAtlas::EVENT_LETTERS_READY = "__cc_FontAtlasLettersReady";
+
+// shared by all the atlases, so that a layout cached for a deleted atlas never matches a new one
+static unsigned int s_nextGeneration = 0;
+
+// letters rasterized on the TASK_OTHER thread of the AsyncTaskPool
+struct FontAtlas::RasterBatch
+{
+    struct Letter
+    {
+        char16_t letter;
+        unsigned char* pixels;
+        long bitmapWidth;
+        long bitmapHeight;
+        Rect rect;
+        int xAdvance;
+    };
+
+    // nullptr once the atlas is deleted
+    FontAtlas* atlas;
+    // retained until the batch is back on the cocos thread
+    FontFreeType* font;
+    WorkerPool* workerPool;
+    std::vector<Letter> letters;
+
+    void rasterize()
+    {
+        auto renderLetter = [this](ssize_t index) {
+            auto& letter = letters[index];
+            letter.pixels = font->renderGlyph(letter.letter, letter.bitmapWidth, letter.bitmapHeight, letter.rect, letter.xAdvance);
+        };
+
+        // FreeType loads one glyph at a time, only the distance maps are worth spreading
+        if (font->isDistanceFieldEnabled())
+        {
+            workerPool->parallelFor(letters.size(), renderLetter);
+        }
+        else
+        {
+            for (size_t index = 0; index < letters.size(); ++index)
+                renderLetter(index);
+        }
+    }
+};
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 , _currentPageData(nullptr)
+, _dirtyPageOrigY(0)
+, _currentPageDirty(false)
+, _asyncRasterization(false)
+, _generation(++s_nextGeneration)
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
@@ -102,6 +154,12 @@ FontAtlas::~FontAtlas()
     }
 #endif
 
+    // the letters still rasterized are dropped when they come back
+    for (auto batch : _rasterBatches)
+    {
+        batch->atlas = nullptr;
+    }
+
     _font->release();
     relaseTextures();
 
@@ -138,6 +196,9 @@ void FontAtlas::purgeTexturesAtlas()
         _currentPage = 0;
         _currentPageOrigX = 0;
         _currentPageOrigY = 0;
+        _dirtyPageOrigY = 0;
+        _currentPageDirty = false;
+        _generation = ++s_nextGeneration;
 
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
         eventDispatcher->dispatchCustomEvent(EVENT_PURGE_TEXTURES,this);
@@ -165,6 +226,17 @@ void FontAtlas::listenRendererRecreated(EventCustom *event)
         _currentPage = 0;
         _currentPageOrigX = 0;
         _currentPageOrigY = 0;
+        _dirtyPageOrigY = 0;
+        _currentPageDirty = false;
+        _generation = ++s_nextGeneration;
+
+        if (_asyncRasterization)
+        {
+            // the letters will be uploaded later, with updateWithData()
+            auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
+            _atlasTextures[0]->initWithData(_currentPageData, _currentPageDataSize, 
+                pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+        }
 
         _rendererRecreate = true;
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
@@ -202,134 +274,212 @@ bool FontAtlas::prepareLetterDefinitions(const std::u16string& utf16String)
     
     size_t length = utf16String.length();
 
-    float offsetAdjust = _letterPadding / 2;  
+    if (_asyncRasterization)
+    {
+        RasterBatch* batch = nullptr;
+        for (size_t i = 0; i < length; ++i)
+        {
+            auto letter = utf16String[i];
+            if (_fontLetterDefinitions.find(letter) != _fontLetterDefinitions.end() || !_pendingLetters.insert(letter).second)
+                continue;
+
+            if (batch == nullptr)
+            {
+                batch = new (std::nothrow) RasterBatch();
+                batch->atlas = this;
+                batch->font = fontTTf;
+                batch->workerPool = WorkerPool::getInstance();
+            }
+            RasterBatch::Letter pending = { letter, nullptr, 0, 0, Rect::ZERO, 0 };
+            batch->letters.push_back(pending);
+        }
+
+        if (batch)
+        {
+            fontTTf->retain();
+            _rasterBatches.push_back(batch);
+
+            AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [](void* param) {
+                auto batch = static_cast<RasterBatch*>(param);
+                if (batch->atlas)
+                {
+                    batch->atlas->onLettersRasterized(batch);
+                }
+                for (auto& letter : batch->letters)
+                {
+                    delete [] letter.pixels;
+                }
+                batch->font->release();
+                delete batch;
+            }, batch, [batch]() {
+                batch->rasterize();
+            });
+        }
+        return true;
+    }
+
     long bitmapWidth;
     long bitmapHeight;
     Rect tempRect;
-    FontLetterDefinition tempDef;
+    int xAdvance;
+
+    for (size_t i = 0; i < length; ++i)
+    {
+        auto letter = utf16String[i];
+        if (_fontLetterDefinitions.find(letter) == _fontLetterDefinitions.end())
+        {
+            auto pixels = fontTTf->renderGlyph(letter, bitmapWidth, bitmapHeight, tempRect, xAdvance);
+            insertLetter(letter, pixels, bitmapWidth, bitmapHeight, tempRect, xAdvance);
+            delete [] pixels;
+        }
+    }
+
+    uploadCurrentPage();
+    return true;
+}
+
+void FontAtlas::onLettersRasterized(RasterBatch* batch)
+{
+    for (auto& letter : batch->letters)
+    {
+        _pendingLetters.erase(letter.letter);
+        // prepared by a purge in the meantime
+        if (_fontLetterDefinitions.find(letter.letter) == _fontLetterDefinitions.end())
+        {
+            insertLetter(letter.letter, letter.pixels, letter.bitmapWidth, letter.bitmapHeight, letter.rect, letter.xAdvance);
+        }
+    }
+    _rasterBatches.erase(std::find(_rasterBatches.begin(), _rasterBatches.end(), batch));
+
+    uploadCurrentPage();
+
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    eventDispatcher->dispatchCustomEvent(EVENT_LETTERS_READY, this);
+}
 
+void FontAtlas::insertLetter(char16_t letter, unsigned char* pixels, long bitmapWidth, long bitmapHeight, const Rect& rect, int xAdvance)
+{
+    FontFreeType* fontTTf = static_cast<FontFreeType*>(_font);
+    float offsetAdjust = _letterPadding / 2;
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
     auto  pixelFormat = fontTTf->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
-
-    bool existNewLetter = false;
     int bottomHeight = _commonLineHeight - _fontAscender;
 
-    float startY = _currentPageOrigY;
+    FontLetterDefinition tempDef;
+    tempDef.xAdvance = xAdvance;
+    tempDef.letteCharUTF16 = letter;
 
-    for (size_t i = 0; i < length; ++i)
+    if (pixels)
     {
-        auto outIterator = _fontLetterDefinitions.find(utf16String[i]);
-
-        if (outIterator == _fontLetterDefinitions.end())
-        {  
-            existNewLetter = true;
-
-            auto bitmap = fontTTf->getGlyphBitmap(utf16String[i],bitmapWidth,bitmapHeight,tempRect,tempDef.xAdvance);
-            if (bitmap)
+        tempDef.validDefinition = true;
+        tempDef.width            = rect.size.width + _letterPadding;
+        tempDef.height           = rect.size.height + _letterPadding;
+        tempDef.offsetX          = rect.origin.x + offsetAdjust;
+        tempDef.offsetY          = _fontAscender + rect.origin.y - offsetAdjust;
+        tempDef.clipBottom     = bottomHeight - (tempDef.height + rect.origin.y + offsetAdjust);
+
+        if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+        {
+            _currentPageOrigY += _commonLineHeight;
+            _currentPageOrigX = 0;
+            if(_currentPageOrigY + _commonLineHeight >= CacheTextureHeight)
             {
-                tempDef.validDefinition = true;
-                tempDef.letteCharUTF16   = utf16String[i];
-                tempDef.width            = tempRect.size.width + _letterPadding;
-                tempDef.height           = tempRect.size.height + _letterPadding;
-                tempDef.offsetX          = tempRect.origin.x + offsetAdjust;
-                tempDef.offsetY          = _fontAscender + tempRect.origin.y - offsetAdjust;
-                tempDef.clipBottom     = bottomHeight - (tempDef.height + tempRect.origin.y + offsetAdjust);
-
-                if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
+                _currentPageOrigY = CacheTextureHeight - _commonLineHeight;
+                uploadCurrentPage();
+
+                _currentPageOrigY = 0;
+                _dirtyPageOrigY = 0;
+                memset(_currentPageData, 0, _currentPageDataSize);
+                _currentPage++;
+                auto tex = new (std::nothrow) Texture2D;
+                if (_antialiasEnabled)
                 {
-                    _currentPageOrigY += _commonLineHeight;
-                    _currentPageOrigX = 0;
-                    if(_currentPageOrigY + _commonLineHeight >= CacheTextureHeight)
-                    {
-                        unsigned char *data = nullptr;
-                        if(pixelFormat == Texture2D::PixelFormat::AI88)
-                        {
-                            data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                        }
-                        else
-                        {
-                            data = _currentPageData + CacheTextureWidth * (int)startY;
-                        }
-                        _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-                            CacheTextureWidth, CacheTextureHeight - startY);
-
-                        startY = 0.0f;
-
-                        _currentPageOrigY = 0;
-                        memset(_currentPageData, 0, _currentPageDataSize);
-                        _currentPage++;
-                        auto tex = new (std::nothrow) Texture2D;
-                        if (_antialiasEnabled)
-                        {
-                            tex->setAntiAliasTexParameters();
-                        } 
-                        else
-                        {
-                            tex->setAliasTexParameters();
-                        }
-                        tex->initWithData(_currentPageData, _currentPageDataSize, 
-                            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-                        addTexture(tex,_currentPage);
-                        tex->release();
-                    }  
-                }
-                fontTTf->renderCharAt(_currentPageData,_currentPageOrigX,_currentPageOrigY,bitmap,bitmapWidth,bitmapHeight);
-
-                tempDef.U                = _currentPageOrigX;
-                tempDef.V                = _currentPageOrigY;
-                tempDef.textureID        = _currentPage;
-                _currentPageOrigX        += tempDef.width + 1;
-                // take from pixels to points
-                tempDef.width  =    tempDef.width  / scaleFactor;
-                tempDef.height =    tempDef.height / scaleFactor;      
-                tempDef.U      =    tempDef.U      / scaleFactor;
-                tempDef.V      =    tempDef.V      / scaleFactor;
-            }
-            else{
-                if(tempDef.xAdvance)
-                    tempDef.validDefinition = true;
+                    tex->setAntiAliasTexParameters();
+                } 
                 else
-                    tempDef.validDefinition = false;
-
-                tempDef.letteCharUTF16   = utf16String[i];
-                tempDef.width            = 0;
-                tempDef.height           = 0;
-                tempDef.U                = 0;
-                tempDef.V                = 0;
-                tempDef.offsetX          = 0;
-                tempDef.offsetY          = 0;
-                tempDef.textureID        = 0;
-                tempDef.clipBottom = 0;
-                _currentPageOrigX += 1;
-            }
+                {
+                    tex->setAliasTexParameters();
+                }
+                tex->initWithData(_currentPageData, _currentPageDataSize, 
+                    pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+                addTexture(tex,_currentPage);
+                tex->release();
+            }  
+        }
+        copyLetterAt(_currentPageOrigX, _currentPageOrigY, pixels, bitmapWidth, bitmapHeight);
+        _currentPageDirty = true;
+
+        tempDef.U                = _currentPageOrigX;
+        tempDef.V                = _currentPageOrigY;
+        tempDef.textureID        = _currentPage;
+        _currentPageOrigX        += tempDef.width + 1;
+        // take from pixels to points
+        tempDef.width  =    tempDef.width  / scaleFactor;
+        tempDef.height =    tempDef.height / scaleFactor;      
+        tempDef.U      =    tempDef.U      / scaleFactor;
+        tempDef.V      =    tempDef.V      / scaleFactor;
+    }
+    else
+    {
+        if(tempDef.xAdvance)
+            tempDef.validDefinition = true;
+        else
+            tempDef.validDefinition = false;
+
+        tempDef.width            = 0;
+        tempDef.height           = 0;
+        tempDef.U                = 0;
+        tempDef.V                = 0;
+        tempDef.offsetX          = 0;
+        tempDef.offsetY          = 0;
+        tempDef.textureID        = 0;
+        tempDef.clipBottom = 0;
+        _currentPageOrigX += 1;
+    }
+
+    _fontLetterDefinitions[tempDef.letteCharUTF16] = tempDef;
+}
 
-            _fontLetterDefinitions[tempDef.letteCharUTF16] = tempDef;
-        }       
+void FontAtlas::copyLetterAt(int posX, int posY, const unsigned char* pixels, long bitmapWidth, long bitmapHeight)
+{
+    // the pixels already have the layout of the page: 2 bytes per pixel with an outline, 1 otherwise
+    int bytesPerPixel = static_cast<FontFreeType*>(_font)->getOutlineSize() > 0 ? 2 : 1;
+    for (long y = 0; y < bitmapHeight; ++y)
+    {
+        memcpy(_currentPageData + ((posY + y) * CacheTextureWidth + posX) * bytesPerPixel,
+               pixels + y * bitmapWidth * bytesPerPixel,
+               bitmapWidth * bytesPerPixel);
     }
+}
+
+void FontAtlas::uploadCurrentPage()
+{
+    if (!_currentPageDirty)
+        return;
 
-    if(existNewLetter)
+    auto  pixelFormat = static_cast<FontFreeType*>(_font)->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8; 
+    if (_rendererRecreate)
     {
-        if (_rendererRecreate)
+        _atlasTextures[_currentPage]->initWithData(_currentPageData, _currentPageDataSize, 
+            pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
+    } 
+    else
+    {
+        unsigned char *data = nullptr;
+        if(pixelFormat == Texture2D::PixelFormat::AI88)
         {
-            _atlasTextures[_currentPage]->initWithData(_currentPageData, _currentPageDataSize, 
-                pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth,CacheTextureHeight) );
-        } 
+            data = _currentPageData + CacheTextureWidth * (int)_dirtyPageOrigY * 2;
+        }
         else
         {
-            unsigned char *data = nullptr;
-            if(pixelFormat == Texture2D::PixelFormat::AI88)
-            {
-                data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-            }
-            else
-            {
-                data = _currentPageData + CacheTextureWidth * (int)startY;
-            }
-            _atlasTextures[_currentPage]->updateWithData(data, 0, startY, 
-                CacheTextureWidth, _currentPageOrigY - startY + _commonLineHeight);
+            data = _currentPageData + CacheTextureWidth * (int)_dirtyPageOrigY;
         }
+        _atlasTextures[_currentPage]->updateWithData(data, 0, _dirtyPageOrigY, 
+            CacheTextureWidth, _currentPageOrigY - _dirtyPageOrigY + _commonLineHeight);
     }
-    return true;
+
+    _dirtyPageOrigY = _currentPageOrigY;
+    _currentPageDirty = false;
 }
 
 void FontAtlas::addTexture(Texture2D *texture, int slot)
@@ -26,10 +26,13 @@
 #define _CCFontAtlas_h_
 
 #include <string>
+#include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
+#include "math/CCGeometry.h"
 #include "platform/CCStdC.h" // ssize_t on windows
 
 NS_CC_BEGIN
@@ -62,6 +65,8 @@ public:
     static const int CacheTextureWidth;
     static const int CacheTextureHeight;
     static const char* EVENT_PURGE_TEXTURES;
+    /** dispatched with the atlas as user data when letters rasterized in background were added to it */
+    static const char* EVENT_LETTERS_READY;
     /**
      * @js ctor
      */
@@ -77,6 +82,24 @@ public:
     
     bool prepareLetterDefinitions(const std::u16string& utf16String);
 
+    /** Rasterizes the missing letters on a background thread instead of in prepareLetterDefinitions().
+     The letters are added to the atlas in batches, on the cocos thread, and EVENT_LETTERS_READY is dispatched:
+     the labels of the atlas then lay out their text again. Until then they don't show the missing letters.
+     It only has effect on TTF fonts. It is disabled by default.
+     @since v3.3
+     */
+    void setAsyncRasterizationEnabled(bool enabled) { _asyncRasterization = enabled; }
+    bool isAsyncRasterizationEnabled() const { return _asyncRasterization; }
+
+    /** returns true while letters are rasterized in background */
+    bool hasPendingLetters() const { return !_pendingLetters.empty(); }
+
+    /** Returns a number that identifies the atlas and its letter definitions. It changes when the letters are purged.
+     Two atlases never have the same generation.
+     @since v3.3
+     */
+    unsigned int getGeneration() const { return _generation; }
+
     inline const std::unordered_map<ssize_t, Texture2D*>& getTextures() const{ return _atlasTextures;}
     void  addTexture(Texture2D *texture, int slot);
     float getCommonLineHeight() const;
@@ -108,7 +131,16 @@ public:
      void setAliasTexParameters();
 
 protected:
+    struct RasterBatch;
+
     void relaseTextures();
+    // packs a rendered letter into the current page, or records an empty letter when pixels is nullptr
+    void insertLetter(char16_t letter, unsigned char* pixels, long bitmapWidth, long bitmapHeight, const Rect& rect, int xAdvance);
+    void copyLetterAt(int posX, int posY, const unsigned char* pixels, long bitmapWidth, long bitmapHeight);
+    // uploads the rows of the current page changed since the last upload
+    void uploadCurrentPage();
+    void onLettersRasterized(RasterBatch* batch);
+
     std::unordered_map<ssize_t, Texture2D*> _atlasTextures;
     std::unordered_map<unsigned short, FontLetterDefinition> _fontLetterDefinitions;
     float _commonLineHeight;
@@ -121,6 +153,15 @@ protected:
     float _currentPageOrigX;
     float _currentPageOrigY;
     float _letterPadding;
+    // first row of the current page not uploaded yet
+    float _dirtyPageOrigY;
+    bool _currentPageDirty;
+
+    bool _asyncRasterization;
+    std::unordered_set<char16_t> _pendingLetters;
+    std::vector<RasterBatch*> _rasterBatches;
+
+    unsigned int _generation;
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
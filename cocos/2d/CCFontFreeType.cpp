@@ -25,10 +25,15 @@ THE SOFTWARE.
 
 #include "2d/CCFontFreeType.h"
 
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "platform/CCFileUtils.h"
-#include "edtaa3func.h"
 #include FT_BBOX_H
 
 NS_CC_BEGIN
@@ -46,6 +51,9 @@ typedef struct _DataRef
 
 static std::unordered_map<std::string, DataRef> s_cacheFontData;
 
+// FreeType isn't thread safe: the faces share the library, so glyphs are loaded one at a time
+static std::mutex s_freeTypeMutex;
+
 FontFreeType * FontFreeType::create(const std::string &fontName, int fontSize, GlyphCollection glyphs, const char *customGlyphs,bool distanceFieldEnabled /* = false */,int outline /* = 0 */)
 {
     FontFreeType *tempFont =  new FontFreeType(distanceFieldEnabled,outline);
@@ -132,6 +140,8 @@ bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
         }
     }
 
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
+
     if (FT_New_Memory_Face(getFTLibrary(), s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
         return false;
     
@@ -154,6 +164,8 @@ bool FontFreeType::createFontObject(const std::string &fontName, int fontSize)
 
 FontFreeType::~FontFreeType()
 {
+    std::lock_guard<std::mutex> lock(s_freeTypeMutex);
+
     if (_stroker)
     {
         FT_Stroker_Done(_stroker);
@@ -203,6 +215,7 @@ int * FontFreeType::getHorizontalKerningForTextUTF16(const std::u16string& text,
     bool hasKerning = FT_HAS_KERNING( _fontRef ) != 0;
     if (hasKerning)
     {
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
         for (int c = 1; c < outNumLetters; ++c)
         {
             sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
@@ -403,87 +416,145 @@ unsigned char * FontFreeType::getGlyphBitmapWithOutline(unsigned short theChar,
     return ret;
 }
 
+// Squared euclidean distance transform of one row or column, in linear time:
+// the lower envelope of the parabolas rooted at each sample (Felzenszwalb and Huttenlocher).
+static void distanceTransform1D(float *grid, long offset, long stride, long length, float *f, float *z, long *v)
+{
+    for (long q = 0; q < length; ++q)
+    {
+        f[q] = grid[offset + q * stride];
+    }
+
+    long k = 0;
+    v[0] = 0;
+    z[0] = -FLT_MAX;
+    z[1] = FLT_MAX;
+
+    for (long q = 1; q < length; ++q)
+    {
+        float s;
+        for (;;)
+        {
+            long r = v[k];
+            s = ((f[q] + q * q) - (f[r] + r * r)) / (2.0f * (q - r));
+            if (s > z[k] || k == 0)
+                break;
+            --k;
+        }
+        ++k;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = FLT_MAX;
+    }
+
+    k = 0;
+    for (long q = 0; q < length; ++q)
+    {
+        while (z[k + 1] < q)
+            ++k;
+        long r = v[k];
+        grid[offset + q * stride] = f[r] + (q - r) * (q - r);
+    }
+}
+
+static void distanceTransform(float *grid, long width, long height, float *f, float *z, long *v)
+{
+    for (long x = 0; x < width; ++x)
+        distanceTransform1D(grid, x, width, height, f, z, v);
+    for (long y = 0; y < height; ++y)
+        distanceTransform1D(grid, y * width, 1, width, f, z, v);
+}
+
 unsigned char * makeDistanceMap( unsigned char *img, long width, long height)
 {
-    long pixelAmount = (width + 2 * FontFreeType::DistanceMapSpread) * (height + 2 * FontFreeType::DistanceMapSpread);
-
-    short * xdist = (short *)  malloc( pixelAmount * sizeof(short) );
-    short * ydist = (short *)  malloc( pixelAmount * sizeof(short) );
-    double * gx   = (double *) calloc( pixelAmount, sizeof(double) );
-    double * gy      = (double *) calloc( pixelAmount, sizeof(double) );
-    double * data    = (double *) calloc( pixelAmount, sizeof(double) );
-    double * outside = (double *) calloc( pixelAmount, sizeof(double) );
-    double * inside  = (double *) calloc( pixelAmount, sizeof(double) );
-    long i,j;
-
-    // Convert img into double (data) rescale image levels between 0 and 1
+    const float inf = 1e20f;
     long outWidth = width + 2 * FontFreeType::DistanceMapSpread;
-    for (i = 0; i < width; ++i)
+    long outHeight = height + 2 * FontFreeType::DistanceMapSpread;
+    long pixelAmount = outWidth * outHeight;
+    long maxSide = std::max(outWidth, outHeight);
+
+    // squared distances to the contour, from outside and from inside it.
+    // Partially covered pixels start at their distance to the half coverage level.
+    std::vector<float> outside(pixelAmount, inf);
+    std::vector<float> inside(pixelAmount, 0.0f);
+    for (long j = 0; j < height; ++j)
     {
-        for (j = 0; j < height; ++j)
+        for (long i = 0; i < width; ++i)
         {
-            data[j * outWidth + FontFreeType::DistanceMapSpread + i] = img[j * width + i] / 255.0;
+            float a = img[j * width + i] / 255.0f;
+            long index = (j + FontFreeType::DistanceMapSpread) * outWidth + FontFreeType::DistanceMapSpread + i;
+            if (a >= 1.0f)
+            {
+                outside[index] = 0.0f;
+                inside[index] = inf;
+            }
+            else if (a > 0.0f)
+            {
+                float d = std::max(0.0f, 0.5f - a);
+                outside[index] = d * d;
+                d = std::max(0.0f, a - 0.5f);
+                inside[index] = d * d;
+            }
         }
     }
 
-    width += 2 * FontFreeType::DistanceMapSpread;
-    height += 2 * FontFreeType::DistanceMapSpread;
-
-    // Transform background (outside contour, in areas of 0's)   
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, outside);
-    for( i=0; i< pixelAmount; i++)
-        if( outside[i] < 0.0 )
-            outside[i] = 0.0;
-
-    // Transform foreground (inside contour, in areas of 1's)   
-    for( i=0; i< pixelAmount; i++)
-        data[i] = 1 - data[i];
-    computegradient( data, (int)width, (int)height, gx, gy);
-    edtaa3(data, gx, gy, (int)width, (int)height, xdist, ydist, inside);
-    for( i=0; i< pixelAmount; i++)
-        if( inside[i] < 0.0 )
-            inside[i] = 0.0;
+    std::vector<float> f(maxSide);
+    std::vector<float> z(maxSide + 1);
+    std::vector<long> v(maxSide);
+    distanceTransform(outside.data(), outWidth, outHeight, f.data(), z.data(), v.data());
+    distanceTransform(inside.data(), outWidth, outHeight, f.data(), z.data(), v.data());
 
     // The bipolar distance field is now outside-inside
-    double dist;
-    /* Single channel 8-bit output (bad precision and range, but simple) */    
-    unsigned char *out = (unsigned char *) malloc( pixelAmount * sizeof(unsigned char) );
-    for( i=0; i < pixelAmount; i++)
+    /* Single channel 8-bit output (bad precision and range, but simple) */
+    unsigned char *out = new unsigned char[pixelAmount];
+    for (long i = 0; i < pixelAmount; ++i)
     {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
+        float dist = sqrtf(outside[i]) - sqrtf(inside[i]);
+        dist = 128.0f - dist * 16;
         if( dist < 0 ) dist = 0;
         if( dist > 255 ) dist = 255;
         out[i] = (unsigned char) dist;
     }
-    /* Dual channel 16-bit output (more complicated, but good precision and range) */
-    /*unsigned char *out = (unsigned char *) malloc( pixelAmount * 3 * sizeof(unsigned char) ); 
-    for( i=0; i< pixelAmount; i++)
-    {
-        dist = outside[i] - inside[i];
-        dist = 128.0 - dist*16;
-        if( dist < 0.0 ) dist = 0.0;
-        if( dist >= 256.0 ) dist = 255.999;
-        // R channel is a copy of the original grayscale image
-        out[3*i] = img[i];
-        // G channel is fraction
-        out[3*i + 1] = (unsigned char) ( 256 - (dist - floor(dist)* 256.0 ));
-        // B channel is truncated integer part
-        out[3*i + 2] = (unsigned char)dist; 
-    }*/
-    
-    free( xdist );
-    free( ydist );
-    free( gx );
-    free( gy );
-    free( data );
-    free( outside );
-    free( inside );
 
     return out;
 }
 
+unsigned char * FontFreeType::renderGlyph(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance)
+{
+    unsigned char *pixels = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_freeTypeMutex);
+
+        auto bitmap = getGlyphBitmap(theChar, outWidth, outHeight, outRect, xAdvance);
+        if (bitmap == nullptr)
+            return nullptr;
+
+        if (_outlineSize > 0)
+        {
+            // already a copy
+            pixels = bitmap;
+        }
+        else
+        {
+            // the glyph slot is overwritten by the next glyph
+            pixels = new unsigned char[outWidth * outHeight];
+            memcpy(pixels, bitmap, outWidth * outHeight);
+        }
+    }
+
+    if (_distanceFieldEnabled)
+    {
+        auto distanceMap = makeDistanceMap(pixels, outWidth, outHeight);
+        delete [] pixels;
+        pixels = distanceMap;
+
+        outWidth += 2 * DistanceMapSpread;
+        outHeight += 2 * DistanceMapSpread;
+    }
+
+    return pixels;
+}
+
 void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned char* bitmap,long bitmapWidth,long bitmapHeight)
 {
     int iX = posX;
@@ -518,7 +589,7 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
             iX  = posX;
             iY += 1;
         }
-        free(distanceMap);
+        delete [] distanceMap;
     }
     else if(_outlineSize > 0)
     {
@@ -64,6 +64,13 @@ public:
     virtual int         * getHorizontalKerningForTextUTF16(const std::u16string& text, int &outNumLetters) const override;
     
     unsigned char       * getGlyphBitmap(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
+
+    /** Renders a glyph in the layout of the atlas pages: a distance map, luminance and alpha for outlines, or alpha.
+     Returns a buffer to delete[], or nullptr like getGlyphBitmap(). The size includes the spread of the distance map.
+     It can be called from any thread: the glyph is loaded under a lock shared by every font, and the distance map
+     is computed outside of it.
+     */
+    unsigned char       * renderGlyph(unsigned short theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
     
     virtual int           getFontMaxHeight() const override;  
     virtual int           getFontAscender() const;
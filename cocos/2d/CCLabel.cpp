@@ -252,6 +252,9 @@ Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = Te
 , _hAlignment(hAlignment)
 , _vAlignment(vAlignment)
 , _currNumLines(-1)
+, _layoutReusable(false)
+, _layoutOriginY(0.0f)
+, _lettersReadyListener(nullptr)
 , _fontScale(1.0f)
 , _useDistanceField(useDistanceField)
 , _useA8Shader(useA8Shader)
@@ -281,10 +284,22 @@ Label::Label(FontAtlas *atlas /* = nullptr */, TextHAlignment hAlignment /* = Te
         }
     });
     _eventDispatcher->addEventListenerWithSceneGraphPriority(purgeTextureListener, this);
+
+    // a scene graph priority would pause it while the label is off the scene, and the letters ready meanwhile would stay missing
+    _lettersReadyListener = EventListenerCustom::create(FontAtlas::EVENT_LETTERS_READY, [this](EventCustom* event){
+        // a dirty content is laid out before the next draw anyway
+        if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas && !_contentDirty)
+        {
+            alignText();
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_lettersReadyListener, 1);
 }
 
 Label::~Label()
 {
+    _eventDispatcher->removeEventListener(_lettersReadyListener);
+
     delete [] _horizontalKernings;
 
     if (_fontAtlas)
@@ -480,7 +495,8 @@ void Label::setString(const std::string& text)
         std::u16string utf16String;
         if (StringUtils::UTF8ToUTF16(_originalUTF8String, utf16String))
         {
-            _currentUTF16String  = utf16String;
+            _utf16Text.swap(utf16String);
+            _currentUTF16String  = _utf16Text;
         }
     }
 }
@@ -583,6 +599,7 @@ void Label::alignText()
 {
     if (_fontAtlas == nullptr || _currentUTF16String.empty())
     {
+        _layoutReusable = false;
         setContentSize(Size::ZERO);
         return;
     }
@@ -604,12 +621,47 @@ void Label::alignText()
             _batchNodes.push_back(batchNode);
         }
     }
-    LabelTextFormatter::createStringSprites(this);    
-    if(_maxLineWidth > 0 && _contentSize.width > _maxLineWidth && LabelTextFormatter::multilineText(this) )      
-        LabelTextFormatter::createStringSprites(this);
 
-    if(_labelWidth > 0 || (_currNumLines > 1 && _hAlignment != TextHAlignment::LEFT))
-        LabelTextFormatter::alignText(this);
+    LabelLayoutCache::Key layoutKey;
+    getLayoutKey(layoutKey);
+    auto layoutCache = LabelLayoutCache::getInstance();
+    auto layout = layoutCache->getLayout(layoutKey);
+    if (layout)
+    {
+        applyLayout(*layout);
+        _layoutReusable = false;
+    }
+    else
+    {
+        if (!relayoutChangedLines(layoutKey))
+        {
+            computeHorizontalKernings(_currentUTF16String);
+            LabelTextFormatter::createStringSprites(this);
+        }
+
+        bool wrapped = false;
+        if(_maxLineWidth > 0 && _contentSize.width > _maxLineWidth && LabelTextFormatter::multilineText(this) )
+        {
+            LabelTextFormatter::createStringSprites(this);
+            wrapped = true;
+        }
+
+        if(_labelWidth > 0 || (_currNumLines > 1 && _hAlignment != TextHAlignment::LEFT))
+            LabelTextFormatter::alignText(this);
+
+        // the letters rasterized in background are missing from the layout until they are ready
+        bool complete = !_fontAtlas->hasPendingLetters();
+        if (complete)
+        {
+            LabelLayoutCache::Layout newLayout;
+            saveLayout(newLayout);
+            layoutCache->addLayout(layoutKey, std::move(newLayout));
+        }
+        // relayoutChangedLines() moves the lines vertically only, and can't keep the line breaks of multilineText()
+        _layoutReusable = complete && !wrapped && !layoutKey.clipBlank && _hAlignment == TextHAlignment::LEFT
+            && (_labelHeight == 0 || _vAlignment == TextVAlignment::TOP);
+    }
+    _layoutKey = std::move(layoutKey);
 
     int strLen = static_cast<int>(_currentUTF16String.length());
     Rect uvRect;
@@ -641,6 +693,92 @@ void Label::alignText()
     updateColor();
 }
 
+void Label::getLayoutKey(LabelLayoutCache::Key& key) const
+{
+    key.atlasGeneration = _fontAtlas->getGeneration();
+    key.text = _currentUTF16String;
+    key.maxLineWidth = _maxLineWidth;
+    key.labelWidth = _labelWidth;
+    key.labelHeight = _labelHeight;
+    key.hAlignment = _hAlignment;
+    key.vAlignment = _vAlignment;
+    key.lineBreakWithoutSpaces = _lineBreakWithoutSpaces;
+    key.clipBlank = _currentLabelType == LabelType::TTF && _clipEnabled;
+    key.additionalKerning = _additionalKerning;
+    key.commonLineHeight = _commonLineHeight;
+    // the scale only matters to the line breaking
+    key.scaleX = _maxLineWidth > 0 ? getScaleX() : 1.0f;
+    key.contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
+}
+
+void Label::applyLayout(const LabelLayoutCache::Layout& layout)
+{
+    _currentUTF16String = layout.text;
+    _currNumLines = layout.numLines;
+
+    _limitShowCount = static_cast<int>(layout.letters.size());
+    if (_lettersInfo.size() < layout.letters.size())
+    {
+        _lettersInfo.resize(layout.letters.size());
+    }
+    std::copy(layout.letters.begin(), layout.letters.end(), _lettersInfo.begin());
+
+    // computed again by the next layout that needs them
+    delete [] _horizontalKernings;
+    _horizontalKernings = nullptr;
+
+    setContentSize(layout.contentSize);
+}
+
+void Label::saveLayout(LabelLayoutCache::Layout& layout) const
+{
+    layout.text = _currentUTF16String;
+    layout.numLines = _currNumLines;
+    layout.letters.assign(_lettersInfo.begin(), _lettersInfo.begin() + _limitShowCount);
+    layout.contentSize = _contentSize;
+}
+
+bool Label::relayoutChangedLines(const LabelLayoutCache::Key& key)
+{
+    if (!_layoutReusable || !_horizontalKernings || !key.hasSameParameters(_layoutKey))
+        return false;
+
+    const auto& lastText = _layoutKey.text;
+    const auto& text = _currentUTF16String;
+    size_t length = text.length();
+    size_t commonLength = std::min(lastText.length(), length);
+    size_t prefix = 0;
+    while (prefix < commonLength && lastText[prefix] == text[prefix])
+    {
+        ++prefix;
+    }
+    if (prefix == 0)
+        return false;
+
+    // the letters of the lines before the changed one keep their place
+    size_t lineStart = text.find_last_of(u'\n', prefix - 1);
+    lineStart = (lineStart == std::u16string::npos) ? 0 : lineStart + 1;
+    if (lineStart >= length || lineStart >= static_cast<size_t>(_limitShowCount))
+        return false;
+
+    // a kerning depends on the letter before or after it, depending on the font
+    size_t kerningStart = prefix - 1;
+    size_t textStart = prefix >= 2 ? prefix - 2 : 0;
+    int count = 0;
+    int* changedKernings = _fontAtlas->getFont()->getHorizontalKerningForTextUTF16(text.substr(textStart), count);
+    if (!changedKernings)
+        return false;
+
+    int* kernings = new int[length];
+    memcpy(kernings, _horizontalKernings, kerningStart * sizeof(int));
+    memcpy(kernings + kerningStart, changedKernings + (kerningStart - textStart), (length - kerningStart) * sizeof(int));
+    delete [] changedKernings;
+    delete [] _horizontalKernings;
+    _horizontalKernings = kernings;
+
+    return LabelTextFormatter::createStringSprites(this, static_cast<int>(lineStart));
+}
+
 bool Label::computeHorizontalKernings(const std::u16string& stringToRender)
 {
     if (_horizontalKernings)
@@ -944,17 +1082,9 @@ void Label::setFontDefinition(const FontDefinition& textDefinition)
 
 void Label::updateContent()
 {
-    std::u16string utf16String;
-    if (StringUtils::UTF8ToUTF16(_originalUTF8String, utf16String))
-    {
-        _currentUTF16String  = utf16String;
-    }
-
+    // drops the line breaks added by the last layout, the kernings are computed by alignText() when it needs them
+    _currentUTF16String = _utf16Text;
     computeStringNumLines();
-    if (_fontAtlas)
-    {
-        computeHorizontalKernings(_currentUTF16String);
-    }
 
     if (_textSprite)
     {
@@ -1100,9 +1230,12 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
     // but it is deprecated and your code should not rely on it
     Director* director = Director::getInstance();
     CCASSERT(nullptr != director, "Director is null when seting matrix stack");
-    
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    bool useMatrixStack = isLegacyMatrixStackUsed(renderer);
+    if (useMatrixStack)
+    {
+        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
 
     if (_textSprite)
@@ -1114,7 +1247,10 @@ void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t pare
         draw(renderer, _modelViewTransform, flags);
     }
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+    {
+        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
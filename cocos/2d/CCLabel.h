@@ -30,9 +30,12 @@
 #include "2d/CCSpriteBatchNode.h"
 #include "renderer/CCCustomCommand.h"
 #include "2d/CCFontAtlas.h"
+#include "2d/CCLabelLayoutCache.h"
 
 NS_CC_BEGIN
 
+class EventListenerCustom;
+
 enum class GlyphCollection {
     
     DYNAMIC,
@@ -264,6 +267,7 @@ public:
     virtual Rect getBoundingBox() const override;
 
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
     CC_DEPRECATED_ATTRIBUTE static Label* create(const std::string& text, const std::string& font, float fontSize,
@@ -290,14 +294,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     void onDraw(const Mat4& transform, bool transformUpdated);
 
-    struct LetterInfo
-    {
-        FontLetterDefinition def;
-
-        Vec2 position;
-        Size  contentSize;
-        int   atlasIndex;
-    };
+    typedef LabelLayoutCache::LetterInfo LetterInfo;
     enum class LabelType {
 
         TTF,
@@ -314,6 +311,12 @@ protected:
     void setFontScale(float fontScale);
     
     virtual void alignText();
+
+    void getLayoutKey(LabelLayoutCache::Key& key) const;
+    void applyLayout(const LabelLayoutCache::Layout& layout);
+    void saveLayout(LabelLayoutCache::Layout& layout) const;
+    // lays out again the lines from the first one that changed since the last layout, returns false when it can't
+    bool relayoutChangedLines(const LabelLayoutCache::Key& key);
     
     bool computeHorizontalKernings(const std::u16string& stringToRender);
 
@@ -375,6 +378,18 @@ protected:
     int           _currNumLines;
     std::u16string _currentUTF16String;
     std::string          _originalUTF8String;
+    // _originalUTF8String in UTF-16, without the line breaks added by multilineText()
+    std::u16string _utf16Text;
+
+    // the last layout, reused by relayoutChangedLines() when it isn't from the cache
+    LabelLayoutCache::Key _layoutKey;
+    bool _layoutReusable;
+    // widest line so far at the end of each line, in pixels
+    std::vector<float> _linesWidth;
+    // top of the first line, in pixels
+    float _layoutOriginY;
+    // lays out the letters rasterized in background, even when the label isn't running
+    EventListenerCustom* _lettersReadyListener;
 
     float _fontScale;
 
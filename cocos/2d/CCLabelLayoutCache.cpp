@@ -0,0 +1,167 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCLabelLayoutCache.h"
+
+#include "deprecated/CCString.h"
+
+NS_CC_BEGIN
+
+static LabelLayoutCache* s_sharedLabelLayoutCache = nullptr;
+
+LabelLayoutCache* LabelLayoutCache::getInstance()
+{
+    if (! s_sharedLabelLayoutCache)
+    {
+        s_sharedLabelLayoutCache = new (std::nothrow) LabelLayoutCache();
+    }
+    return s_sharedLabelLayoutCache;
+}
+
+void LabelLayoutCache::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedLabelLayoutCache);
+}
+
+LabelLayoutCache::Key::Key()
+: atlasGeneration(0)
+, maxLineWidth(0)
+, labelWidth(0)
+, labelHeight(0)
+, hAlignment(TextHAlignment::LEFT)
+, vAlignment(TextVAlignment::TOP)
+, lineBreakWithoutSpaces(false)
+, clipBlank(false)
+, additionalKerning(0.0f)
+, commonLineHeight(0.0f)
+, scaleX(1.0f)
+, contentScaleFactor(1.0f)
+{
+}
+
+bool LabelLayoutCache::Key::hasSameParameters(const Key& other) const
+{
+    return atlasGeneration == other.atlasGeneration
+        && maxLineWidth == other.maxLineWidth
+        && labelWidth == other.labelWidth
+        && labelHeight == other.labelHeight
+        && hAlignment == other.hAlignment
+        && vAlignment == other.vAlignment
+        && lineBreakWithoutSpaces == other.lineBreakWithoutSpaces
+        && clipBlank == other.clipBlank
+        && additionalKerning == other.additionalKerning
+        && commonLineHeight == other.commonLineHeight
+        && scaleX == other.scaleX
+        && contentScaleFactor == other.contentScaleFactor;
+}
+
+size_t LabelLayoutCache::KeyHash::operator()(const Key& key) const
+{
+    size_t hash = std::hash<std::u16string>()(key.text);
+    auto combine = [&hash](size_t value) {
+        hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+    };
+    combine(key.atlasGeneration);
+    combine(key.maxLineWidth);
+    combine(key.labelWidth);
+    combine(key.labelHeight);
+    combine(static_cast<size_t>(key.hAlignment) | static_cast<size_t>(key.vAlignment) << 4);
+    combine(std::hash<float>()(key.commonLineHeight));
+    combine(std::hash<float>()(key.scaleX));
+    return hash;
+}
+
+LabelLayoutCache::LabelLayoutCache()
+: _letterCount(0)
+, _maxLetterCount(32768)
+, _hits(0)
+, _misses(0)
+{
+}
+
+const LabelLayoutCache::Layout* LabelLayoutCache::getLayout(const Key& key)
+{
+    auto it = _layouts.find(key);
+    if (it == _layouts.end())
+    {
+        ++_misses;
+        return nullptr;
+    }
+
+    ++_hits;
+    _usage.splice(_usage.begin(), _usage, it->second.usage);
+    return &it->second.layout;
+}
+
+void LabelLayoutCache::addLayout(const Key& key, Layout layout)
+{
+    size_t letterCount = layout.letters.size();
+    if (letterCount > _maxLetterCount / 4)
+        return;
+
+    auto result = _layouts.emplace(key, Entry());
+    if (!result.second)
+        return;
+
+    auto& entry = result.first->second;
+    entry.layout = std::move(layout);
+    _usage.push_front(&result.first->first);
+    entry.usage = _usage.begin();
+    _letterCount += letterCount;
+
+    // the new layout is the most recently used, it isn't removed
+    removeLeastRecentlyUsed(_maxLetterCount);
+}
+
+void LabelLayoutCache::removeLeastRecentlyUsed(size_t letterCount)
+{
+    while (_letterCount > letterCount && !_usage.empty())
+    {
+        auto it = _layouts.find(*_usage.back());
+        _letterCount -= it->second.layout.letters.size();
+        _usage.pop_back();
+        _layouts.erase(it);
+    }
+}
+
+void LabelLayoutCache::removeAllLayouts()
+{
+    _layouts.clear();
+    _usage.clear();
+    _letterCount = 0;
+}
+
+void LabelLayoutCache::setMaxLetterCount(size_t count)
+{
+    _maxLetterCount = count;
+    removeLeastRecentlyUsed(_maxLetterCount);
+}
+
+std::string LabelLayoutCache::getCachedLayoutInfo() const
+{
+    return StringUtils::format("layouts: %d, letters: %d/%d, hits: %u, misses: %u",
+        static_cast<int>(_layouts.size()), static_cast<int>(_letterCount), static_cast<int>(_maxLetterCount), _hits, _misses);
+}
+
+NS_CC_END
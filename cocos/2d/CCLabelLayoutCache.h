@@ -0,0 +1,152 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_LABEL_LAYOUT_CACHE_H__
+#define __CC_LABEL_LAYOUT_CACHE_H__
+
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+
+#include "2d/CCFontAtlas.h"
+#include "base/ccTypes.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup label
+ * @{
+ */
+
+/** Singleton that keeps the layouts computed by the labels: the position of each letter of a text,
+after line breaking and alignment.
+
+A label looks its layout up before computing it, so labels showing the same text with the same font atlas,
+dimensions and alignment compute it once. The layouts of a font atlas are not used anymore once its letters are purged.
+The least recently used layouts are removed when the letters of the cached layouts exceed getMaxLetterCount().
+
+It is only used on the cocos thread.
+@since v3.3
+*/
+class CC_DLL LabelLayoutCache
+{
+public:
+    struct LetterInfo
+    {
+        FontLetterDefinition def;
+
+        Vec2 position;
+        Size  contentSize;
+        int   atlasIndex;
+    };
+
+    /** What the layout of a text depends on */
+    struct Key
+    {
+        Key();
+
+        /** returns true when the keys only differ by their text */
+        bool hasSameParameters(const Key& other) const;
+        bool operator==(const Key& other) const { return text == other.text && hasSameParameters(other); }
+
+        // FontAtlas::getGeneration()
+        unsigned int atlasGeneration;
+        std::u16string text;
+        unsigned int maxLineWidth;
+        unsigned int labelWidth;
+        unsigned int labelHeight;
+        TextHAlignment hAlignment;
+        TextVAlignment vAlignment;
+        bool lineBreakWithoutSpaces;
+        bool clipBlank;
+        float additionalKerning;
+        float commonLineHeight;
+        float scaleX;
+        float contentScaleFactor;
+    };
+
+    struct Layout
+    {
+        // the text with the line breaks added to fit the max line width
+        std::u16string text;
+        std::vector<LetterInfo> letters;
+        int numLines;
+        Size contentSize;
+    };
+
+    /** Returns the shared instance of the cache */
+    static LabelLayoutCache* getInstance();
+
+    /** Removes the layouts and the shared instance */
+    static void destroyInstance();
+
+    LabelLayoutCache();
+
+    /** Returns the layout of a key, or nullptr. The pointer is valid until the next call to addLayout() */
+    const Layout* getLayout(const Key& key);
+
+    /** Keeps the layout of a key. Layouts with more letters than a quarter of getMaxLetterCount() are not kept. */
+    void addLayout(const Key& key, Layout layout);
+
+    void removeAllLayouts();
+
+    /** Sets how many letters the cached layouts can have in total. The default is 32768, about 3 MB. 0 disables the cache. */
+    void setMaxLetterCount(size_t count);
+    size_t getMaxLetterCount() const { return _maxLetterCount; }
+
+    /** Returns the number of layouts, letters, hits and misses */
+    std::string getCachedLayoutInfo() const;
+
+protected:
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        Layout layout;
+        // position in _usage
+        std::list<const Key*>::iterator usage;
+    };
+
+    void removeLeastRecentlyUsed(size_t letterCount);
+
+    std::unordered_map<Key, Entry, KeyHash> _layouts;
+    // keys of _layouts, the most recently used first
+    std::list<const Key*> _usage;
+    size_t _letterCount;
+    size_t _maxLetterCount;
+    unsigned int _hits;
+    unsigned int _misses;
+};
+
+// end of label group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_LABEL_LAYOUT_CACHE_H__
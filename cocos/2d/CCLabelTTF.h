@@ -158,6 +158,7 @@ public:
      */
     virtual std::string getDescription() const override;
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
     virtual const Size& getContentSize() const override;
 protected:
     Label*    _renderLabel;
@@ -267,7 +267,7 @@ bool LabelTextFormatter::alignText(Label *theLabel)
     return true;
 }
 
-bool LabelTextFormatter::createStringSprites(Label *theLabel)
+bool LabelTextFormatter::createStringSprites(Label *theLabel, int startIndex /* = 0 */)
 {
     theLabel->_limitShowCount = 0;
     // check for string
@@ -325,8 +325,47 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
     {
         clipBlank = true;
     }
+
+    auto originY = nextFontPositionY;
+    if (startIndex > 0)
+    {
+        float offsetY = (originY - theLabel->_layoutOriginY) / contentScaleFactor;
+        for (int i = 0; i < startIndex; i++)
+        {
+            if (strWhole[i] == '\n')
+            {
+                lineIndex++;
+            }
+            else if (offsetY != 0.0f)
+            {
+                theLabel->_lettersInfo[i].position.y += offsetY;
+            }
+        }
+        theLabel->_limitShowCount = startIndex;
+
+        // the state of the loop below at the end of the line before startIndex
+        nextFontPositionY -= theLabel->_commonLineHeight * lineIndex;
+        longestLine = theLabel->_linesWidth[lineIndex - 1];
+        theLabel->_linesWidth.resize(lineIndex);
+        if (!fontAtlas->getLetterDefinitionForChar(strWhole[startIndex - 1], tempDefinition))
+        {
+            for (int i = startIndex - 2; i >= 0; i--)
+            {
+                if (strWhole[i] != '\n')
+                {
+                    tempDefinition = theLabel->_lettersInfo[i].def;
+                    break;
+                }
+            }
+        }
+    }
+    else
+    {
+        theLabel->_linesWidth.clear();
+    }
+    theLabel->_layoutOriginY = originY;
     
-    for (int i = 0; i < stringLen; i++)
+    for (int i = startIndex; i < stringLen; i++)
     {
         char16_t c    = strWhole[i];
         if (fontAtlas->getLetterDefinitionForChar(c, tempDefinition))
@@ -344,6 +383,7 @@ bool LabelTextFormatter::createStringSprites(Label *theLabel)
 
         if (c == '\n')
         {
+            theLabel->_linesWidth.push_back(longestLine);
             lineIndex++;
             nextFontPositionX  = 0;
             nextFontPositionY -= theLabel->_commonLineHeight;
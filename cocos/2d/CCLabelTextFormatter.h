@@ -38,7 +38,10 @@ public:
     
     static bool multilineText(Label *theLabel);
     static bool alignText(Label *theLabel);
-    static bool createStringSprites(Label *theLabel);
+    /** Lays out the letters from startIndex, the first letter of a line.
+     The letters before it keep their place in the last layout, they are only moved vertically.
+     */
+    static bool createStringSprites(Label *theLabel, int startIndex = 0);
 
 };
 
@@ -32,7 +32,7 @@ THE SOFTWARE.
 
 #include <algorithm>
 #include <string>
-#include <regex>
+#include <unordered_map>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -42,8 +42,11 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
 #include "2d/CCComponentContainer.h"
+#include "2d/CCNodePath.h"
+#include "2d/CCTransformTree.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 #include "deprecated/CCString.h"
@@ -74,6 +77,61 @@ bool nodeComparisonLess(Node* n1, Node* n2)
 // FIXME:: Yes, nodes might have a sort problem once every 15 days if the game runs at 60 FPS and each frame sprites are reordered.
 int Node::s_globalOrderOfArrival = 1;
 
+// The children by name and by tag. The nodes without name or tag are not in the maps, since they can't be looked up.
+struct Node::ChildIndex
+{
+    ChildIndex() : count(0), dirty(true) {}
+
+    void add(Node* child)
+    {
+        if (!child->_name.empty())
+            names.insert(std::make_pair(child->_hashOfName, child));
+        if (child->_tag != Node::INVALID_TAG)
+            tags.insert(std::make_pair(child->_tag, child));
+        ++count;
+    }
+
+    template <typename Map, typename Key>
+    static void erase(Map& map, const Key& key, Node* child)
+    {
+        auto range = map.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == child)
+            {
+                map.erase(it);
+                return;
+            }
+        }
+    }
+
+    void remove(Node* child)
+    {
+        if (!child->_name.empty())
+            erase(names, child->_hashOfName, child);
+        if (child->_tag != Node::INVALID_TAG)
+            erase(tags, child->_tag, child);
+        --count;
+    }
+
+    void rebuild(const Vector<Node*>& children)
+    {
+        names.clear();
+        tags.clear();
+        count = 0;
+        for (const auto& child : children)
+        {
+            add(child);
+        }
+        dirty = false;
+    }
+
+    std::unordered_multimap<size_t, Node*> names;
+    std::unordered_multimap<int, Node*> tags;
+    ssize_t count;      ///< number of children in the index, to catch the subclasses that change _children directly
+    bool dirty;         ///< a child was renamed or retagged
+};
+
 // MARK: Constructor, Destructor, Init
 
 Node::Node(void)
@@ -107,6 +165,7 @@ Node::Node(void)
 , _tag(Node::INVALID_TAG)
 , _name("")
 , _hashOfName(0)
+, _childIndex(nullptr)
 // userData is always inited as nil
 , _userData(nullptr)
 , _userObject(nullptr)
@@ -133,6 +192,10 @@ Node::Node(void)
 , _cascadeColorEnabled(false)
 , _cascadeOpacityEnabled(false)
 , _cameraMask(1)
+, _childrenVisitedInParallel(false)
+, _usesLegacyMatrixStack(false)
+, _transformTree(nullptr)
+, _transformIndex(0)
 {
     // set default scheduler and actionManager
     Director *director = Director::getInstance();
@@ -182,6 +245,13 @@ Node::~Node()
     // attributes
     CC_SAFE_RELEASE_NULL(_glProgramState);
 
+    CC_SAFE_DELETE(_childIndex);
+
+    if (_transformIndex == 0)
+        CC_SAFE_DELETE(_transformTree);
+    else
+        _transformTree->invalidate();
+
     for (auto& child : _children)
     {
         child->_parent = nullptr;
@@ -795,6 +865,10 @@ int Node::getTag() const
 void Node::setTag(int tag)
 {
     _tag = tag ;
+
+    // the index of the parent is rebuilt by its next look up
+    if (_parent && _parent->_childIndex)
+        _parent->_childIndex->dirty = true;
 }
 
 std::string Node::getName() const
@@ -807,6 +881,10 @@ void Node::setName(const std::string& name)
     _name = name;
     std::hash<std::string> h;
     _hashOfName = h(name);
+
+    // the index of the parent is rebuilt by its next look up
+    if (_parent && _parent->_childIndex)
+        _parent->_childIndex->dirty = true;
 }
 
 /// userData setter
@@ -891,10 +969,69 @@ void Node::childrenAlloc()
     _children.reserve(4);
 }
 
+void Node::setChildIndexEnabled(bool enabled)
+{
+    if (enabled == isChildIndexEnabled())
+        return;
+
+    if (enabled)
+        _childIndex = new (std::nothrow) ChildIndex();
+    else
+        CC_SAFE_DELETE(_childIndex);
+}
+
+bool Node::lookUpChildIndex(const std::string& name, size_t hash, Node** child) const
+{
+    if (!_childIndex || name.empty())
+        return false;
+
+    if (_childIndex->dirty || _childIndex->count != _children.size())
+        _childIndex->rebuild(_children);
+
+    *child = nullptr;
+    auto range = _childIndex->names.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second->_name.compare(name) == 0)
+        {
+            // the first one in the children order is returned, they must be scanned
+            if (*child)
+                return false;
+            *child = it->second;
+        }
+    }
+    return true;
+}
+
+bool Node::lookUpChildIndex(int tag, Node** child) const
+{
+    if (!_childIndex)
+        return false;
+
+    if (_childIndex->dirty || _childIndex->count != _children.size())
+        _childIndex->rebuild(_children);
+
+    auto range = _childIndex->tags.equal_range(tag);
+    if (range.first == range.second)
+    {
+        *child = nullptr;
+        return true;
+    }
+    if (std::next(range.first) != range.second)
+        return false;
+
+    *child = range.first->second;
+    return true;
+}
+
 Node* Node::getChildByTag(int tag) const
 {
     CCASSERT( tag != Node::INVALID_TAG, "Invalid tag");
 
+    Node* indexed = nullptr;
+    if (lookUpChildIndex(tag, &indexed))
+        return indexed;
+
     for (const auto& child : _children)
     {
         if(child && child->_tag == tag)
@@ -909,6 +1046,10 @@ Node* Node::getChildByName(const std::string& name) const
     
     std::hash<std::string> h;
     size_t hash = h(name);
+
+    Node* indexed = nullptr;
+    if (lookUpChildIndex(name, hash, &indexed))
+        return indexed;
     
     for (const auto& child : _children)
     {
@@ -924,114 +1065,14 @@ void Node::enumerateChildren(const std::string &name, std::function<bool (Node *
     CCASSERT(name.length() != 0, "Invalid name");
     CCASSERT(callback != nullptr, "Invalid callback function");
     
-    size_t length = name.length();
-    
-    size_t subStrStartPos = 0;  // sub string start index
-    size_t subStrlength = length; // sub string length
-    
-    // Starts with '//'?
-    bool searchRecursively = false;
-    if (length > 2 && name[0] == '/' && name[1] == '/')
-    {
-        searchRecursively = true;
-        subStrStartPos = 2;
-        subStrlength -= 2;
-    }
-    
-    // End with '/..'?
-    bool searchFromParent = false;
-    if (length > 3 &&
-        name[length-3] == '/' &&
-        name[length-2] == '.' &&
-        name[length-1] == '.')
-    {
-        searchFromParent = true;
-        subStrlength -= 3;
-    }
-    
-    // Remove '//', '/..' if exist
-    std::string newName = name.substr(subStrStartPos, subStrlength);
-
-    if (searchFromParent)
-    {
-        newName.insert(0, "[[:alnum:]]+/");
-    }
-    
-    
-    if (searchRecursively)
-    {
-        // name is '//xxx'
-        doEnumerateRecursive(this, newName, callback);
-    }
-    else
-    {
-        // name is xxx
-        doEnumerate(newName, callback);
-    }
+    NodePath(name).enumerate(this, callback);
 }
 
-bool Node::doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const
+void Node::enumerateChildren(const NodePath& path, const std::function<bool (Node *)>& callback) const
 {
-    bool ret =false;
-    
-    if (node->doEnumerate(name, callback))
-    {
-        // search itself
-        ret = true;
-    }
-    else
-    {
-        // search its children
-        for (const auto& child : node->getChildren())
-        {
-            if (doEnumerateRecursive(child, name, callback))
-            {
-                ret = true;
-                break;
-            }
-        }
-    }
-    
-    return ret;
-}
+    CCASSERT(callback != nullptr, "Invalid callback function");
 
-bool Node::doEnumerate(std::string name, std::function<bool (Node *)> callback) const
-{
-    // name may be xxx/yyy, should find its parent
-    size_t pos = name.find('/');
-    std::string searchName = name;
-    bool needRecursive = false;
-    if (pos != name.npos)
-    {
-        searchName = name.substr(0, pos);
-        name.erase(0, pos+1);
-        needRecursive = true;
-    }
-    
-    bool ret = false;
-    for (const auto& child : _children)
-    {
-        if (std::regex_match(child->_name, std::regex(searchName)))
-        {
-            if (!needRecursive)
-            {
-                // terminate enumeration if callback return true
-                if (callback(child))
-                {
-                    ret = true;
-                    break;
-                }
-            }
-            else
-            {
-                ret = child->doEnumerate(name, callback);
-                if (ret)
-                    break;
-            }
-        }
-    }
-    
-    return ret;
+    path.enumerate(this, callback);
 }
 
 /* "add" logic MUST only be on this method
@@ -1056,6 +1097,11 @@ void Node::addChild(Node* child, int localZOrder, const std::string &name)
 
 void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::string &name, bool setTag)
 {
+    if (_transformTree)
+    {
+        _transformTree->invalidate();
+    }
+
     if (_children.empty())
     {
         this->childrenAlloc();
@@ -1070,6 +1116,11 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
     
     child->setParent(this);
     child->setOrderOfArrival(s_globalOrderOfArrival++);
+
+    if (_childIndex && !_childIndex->dirty)
+    {
+        _childIndex->add(child);
+    }
     
 #if CC_USE_PHYSICS
     // Recursive add children with which have physics body.
@@ -1198,6 +1249,11 @@ void Node::removeFromPhysicsWorld()
 
 void Node::removeAllChildrenWithCleanup(bool cleanup)
 {
+    if (_transformTree)
+    {
+        _transformTree->invalidate();
+    }
+
     // not using detachChild improves speed here
     for (const auto& child : _children)
     {
@@ -1223,10 +1279,20 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
     }
     
     _children.clear();
+
+    if (_childIndex)
+    {
+        _childIndex->rebuild(_children);
+    }
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 {
+    if (_transformTree)
+    {
+        _transformTree->invalidate();
+    }
+
     // IMPORTANT:
     //  -1st do onExit
     //  -2nd cleanup
@@ -1250,6 +1316,11 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     // set parent nil at the end
     child->setParent(nullptr);
 
+    if (_childIndex && !_childIndex->dirty)
+    {
+        _childIndex->remove(child);
+    }
+
     _children.erase(childIndex);
 }
 
@@ -1269,6 +1340,9 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->setOrderOfArrival(s_globalOrderOfArrival++);
     child->_localZOrder = zOrder;
+    
+    // The child may be drawn at another place now, even with the same local Z order
+    _eventDispatcher->setDirtyForNode(child);
 }
 
 void Node::sortAllChildren()
@@ -1299,7 +1373,7 @@ void Node::visit()
     visit(renderer, parentTransform, true);
 }
 
-uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+void Node::updateNormalizedPosition(uint32_t parentFlags)
 {
     if(_usingNormalizedPosition)
     {
@@ -1313,6 +1387,16 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
             _normalizedPositionDirty = false;
         }
     }
+}
+
+uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    // the tree of an ancestor already computed the transform
+    bool inTransformTree = _transformIndex > 0;
+    if (inTransformTree && _transformTree->isUpdated())
+        return _transformTree->getFlags(_transformIndex);
+
+    updateNormalizedPosition(parentFlags);
     
     uint32_t flags = parentFlags;
     flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
@@ -1322,8 +1406,13 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     if(flags & FLAGS_DIRTY_MASK)
         _modelViewTransform = this->transform(parentTransform);
 
-    _transformUpdated = false;
-    _contentSizeDirty = false;
+    // visited on its own, maybe in parallel with other nodes of the tree: the visit doesn't touch the tree,
+    // which reads the dirty state and the new local transform at its next update
+    if (!inTransformTree)
+    {
+        _transformUpdated = false;
+        _contentSizeDirty = false;
+    }
 
     return flags;
 }
@@ -1345,18 +1434,46 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
+    // the transforms of the descendants are updated at once, they read them while they are visited
+    bool flatTransforms = isFlatTransformsEnabled();
+    if (flatTransforms)
+    {
+        _transformTree->update(flags);
+        _transformTree->setUpdated(true);
+    }
+
+    // the scene visits once for all its cameras: the draws are recorded, and drawn for each camera later
+    auto drawLists = renderer->getCameraDrawLists();
+    if (drawLists)
+    {
+        recordCameraDraws(renderer, drawLists, flags);
+        if (flatTransforms)
+            _transformTree->setUpdated(false);
+        return;
+    }
+
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
-    // but it is deprecated and your code should not rely on it
-    Director* director = Director::getInstance();
-    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    // but it is deprecated and your code should not rely on it.
+    // It is shared by all the threads, so it is not updated while visiting in parallel,
+    // and it is skipped when the renderer disables it.
+    bool useMatrixStack = isLegacyMatrixStackUsed(renderer);
+    if (useMatrixStack)
+    {
+        Director* director = Director::getInstance();
+        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
     int i = 0;
 
-    if(!_children.empty())
+    if (_childrenVisitedInParallel && !renderer->isRecordingInParallel() && _children.size() >= PARALLEL_VISIT_MIN_CHILDREN)
+    {
+        visitChildrenInParallel(renderer, flags, visibleByCamera);
+    }
+    else if(!_children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
@@ -1381,7 +1498,15 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+    {
+        Director::getInstance()->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
+
+    if (flatTransforms)
+    {
+        _transformTree->setUpdated(false);
+    }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1389,6 +1514,79 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+void Node::visitChildrenInParallel(Renderer* renderer, uint32_t flags, bool visibleByCamera)
+{
+    sortAllChildren();
+
+    ssize_t count = _children.size();
+    renderer->recordInParallel(count, [this, renderer, flags](ssize_t index) {
+        _children.at(index)->visit(renderer, _modelViewTransform, flags);
+    });
+
+    // merge in the same order as a serial visit: children zOrder < 0, self, the other children
+    ssize_t i = 0;
+    for ( ; i < count && _children.at(i)->_localZOrder < 0; ++i)
+        renderer->mergeRecordedCommands(i);
+
+    if (visibleByCamera)
+        this->draw(renderer, _modelViewTransform, flags);
+
+    for ( ; i < count; ++i)
+        renderer->mergeRecordedCommands(i);
+}
+
+void Node::recordCameraDraws(Renderer* renderer, CameraDrawLists* drawLists, uint32_t flags)
+{
+    // the nodes that have their own visit() are visited for each camera
+    auto recordChild = [this, renderer, drawLists, flags](Node* child) {
+        if (!child->hasCustomVisit())
+            child->visit(renderer, _modelViewTransform, flags);
+        else if (child->_visible)
+            drawLists->addVisit(child, &_modelViewTransform, flags);
+    };
+
+    sortAllChildren();
+
+    // children zOrder < 0, self, the other children
+    ssize_t count = _children.size();
+    ssize_t i = 0;
+    for ( ; i < count && _children.at(i)->_localZOrder < 0; ++i)
+        recordChild(_children.at(i));
+
+    drawLists->addDraw(this, &_modelViewTransform, flags);
+
+    for ( ; i < count; ++i)
+        recordChild(_children.at(i));
+}
+
+void Node::setFlatTransformsEnabled(bool enabled)
+{
+    if (enabled == isFlatTransformsEnabled())
+        return;
+
+    // this node leaves the tree of its ancestor, which is rebuilt without this subtree
+    if (_transformTree && _transformIndex > 0)
+        _transformTree->invalidate();
+
+    if (enabled)
+    {
+        CCASSERT(!hasCustomVisit(), "The nodes that override visit() can't keep flat transforms");
+        _transformTree = new (std::nothrow) TransformTree(this);
+        _transformIndex = 0;
+    }
+    else
+    {
+        CC_SAFE_DELETE(_transformTree);
+    }
+}
+
+bool Node::isLegacyMatrixStackUsed(Renderer* renderer) const
+{
+    if (renderer->isRecordingInParallel())
+        return false;
+    return renderer->isLegacyMatrixStackEnabled() || _usesLegacyMatrixStack;
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
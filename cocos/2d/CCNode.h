@@ -46,6 +46,9 @@ class Scheduler;
 class ActionManager;
 class Component;
 class ComponentContainer;
+class CameraDrawLists;
+class TransformTree;
+class NodePath;
 class EventDispatcher;
 class Scene;
 class Renderer;
@@ -104,6 +107,9 @@ public:
     /// Default tag used for all the nodes
     static const int INVALID_TAG = -1;
 
+    /// Minimum number of children to visit them on worker threads, see setChildrenVisitedInParallel()
+    static const int PARALLEL_VISIT_MIN_CHILDREN = 64;
+
     enum {
         FLAGS_TRANSFORM_DIRTY = (1 << 0),
         FLAGS_CONTENT_SIZE_DIRTY = (1 << 1),
@@ -759,6 +765,22 @@ public:
      * @since v3.2
      */
     virtual void enumerateChildren(const std::string &name, std::function<bool(Node* node)> callback) const;
+    /**
+     * Same as enumerateChildren() with a path that is parsed and compiled once, to run the same search many times.
+     *
+     * @since v3.3
+     */
+    void enumerateChildren(const NodePath& path, const std::function<bool(Node* node)>& callback) const;
+    /**
+     * Keeps an index of the children by name and by tag, so getChildByName(), getChildByTag() and the
+     * parts of the enumerateChildren() paths that are plain names don't scan the children.
+     * It costs two hash maps, enable it on the nodes that have many children and that are searched often.
+     *
+     * @since v3.3
+     */
+    void setChildIndexEnabled(bool enabled);
+    /** returns whether the children are indexed by name and by tag */
+    bool isChildIndexEnabled() const { return _childIndex != nullptr; }
     /**
      * Returns the array of the node's children
      *
@@ -1073,6 +1095,48 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Returns true when the class overrides visit() to add commands of its own or to change the GL state
+     * around its children. A Scene that visits its cameras in CameraVisitMode::SINGLE_PASS records the draws of
+     * the other nodes once for all the cameras, and visits these nodes and their children once per camera.
+     * The subclasses that override visit() must override it to return true. In debug, the Renderer asserts when a command
+     * is added while the draws are recorded, which only an overridden visit() does.
+     */
+    virtual bool hasCustomVisit() const { return false; }
+
+    /**
+     * Sets whether the children of this node can be visited on worker threads.
+     * Each child subtree records its commands into its own queue, and the queues are merged in the children order,
+     * so the drawing order is the same as a serial visit.
+     * Only enable it when the subtrees don't change shared state while they are visited:
+     * no render groups (RenderTexture, ClippingNode, NodeGrid...) and no use of the Director matrix stack.
+     * It is only used when the node has at least PARALLEL_VISIT_MIN_CHILDREN children.
+     */
+    void setChildrenVisitedInParallel(bool enabled) { _childrenVisitedInParallel = enabled; }
+    /** returns whether the children of this node can be visited on worker threads */
+    bool isChildrenVisitedInParallel() const { return _childrenVisitedInParallel; }
+
+    /**
+     * Declares that draw() or the children of this node read the Director model view stack
+     * with Director::getMatrix(). The node keeps loading its transform on the stack while it is visited
+     * even when the legacy matrix stack is disabled. @see Renderer::setLegacyMatrixStackEnabled()
+     */
+    void setUsesLegacyMatrixStack(bool uses) { _usesLegacyMatrixStack = uses; }
+    /** returns whether this node reads the Director model view stack */
+    bool usesLegacyMatrixStack() const { return _usesLegacyMatrixStack; }
+
+    /**
+     * Keeps the transforms of the descendants of this node in a TransformTree: contiguous arrays in depth-first
+     * order, where the dirty ranges are updated in one pass when this node is visited, instead of node by node.
+     * The arrays are rebuilt when children are added or removed below this node, so enable it on large hierarchies
+     * that rarely change, like tile maps made of nodes or UI panels.
+     * The node must not override visit().
+     * @since v3.3
+     */
+    void setFlatTransformsEnabled(bool enabled);
+    /** returns whether this node keeps the transforms of its descendants in a TransformTree */
+    bool isFlatTransformsEnabled() const { return _transformTree && _transformIndex == 0; }
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1601,11 +1665,25 @@ protected:
     virtual void disableCascadeColor();
     virtual void updateColor() {}
     
-    bool doEnumerate(std::string name, std::function<bool (Node *)> callback) const;
-    bool doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const;
+    // Looks a child up in the child index. Returns false when there is no index or several children match,
+    // and the children must be scanned. Otherwise child is set to the only match, or to nullptr.
+    bool lookUpChildIndex(const std::string& name, size_t hash, Node** child) const;
+    bool lookUpChildIndex(int tag, Node** child) const;
     
     //check whether this camera mask is visible by the current visiting camera
     bool isVisitableByVisitingCamera() const;
+
+    // visits the children on worker threads, see setChildrenVisitedInParallel()
+    void visitChildrenInParallel(Renderer* renderer, uint32_t flags, bool visibleByCamera);
+
+    // records the draws of this node and its children for the cameras, see Scene::setCameraVisitMode()
+    void recordCameraDraws(Renderer* renderer, CameraDrawLists* drawLists, uint32_t flags);
+
+    // whether the visit of this node loads its transform on the Director model view stack
+    bool isLegacyMatrixStackUsed(Renderer* renderer) const;
+
+    // updates the position from the normalized position, when the parent content size changed
+    void updateNormalizedPosition(uint32_t parentFlags);
     
     // update quaternion from Rotation3D
     void updateRotationQuat();
@@ -1674,6 +1752,9 @@ protected:
     std::string _name;               ///<a string label, an user defined string to identify this node
     size_t _hashOfName;            ///<hash value of _name, used for speed in getChildByName
 
+    struct ChildIndex;
+    ChildIndex* _childIndex;       ///<the children by name and by tag, see setChildIndexEnabled()
+
     void *_userData;                ///< A user assingned void pointer, Can be point to any cpp object
     Ref *_userObject;               ///< A user assigned Object
 
@@ -1723,6 +1804,13 @@ protected:
     
     // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
     unsigned short _cameraMask;
+
+    bool _childrenVisitedInParallel; ///< whether the children can be visited on worker threads
+
+    bool _usesLegacyMatrixStack; ///< whether the node reads the Director model view stack
+
+    TransformTree* _transformTree; ///< the tree that owns the transform of this node, or that this node owns
+    int _transformIndex;           ///< index in _transformTree, 0 for the root of the tree
     
     std::function<void()> _onEnterCallback;
     std::function<void()> _onExitCallback;
@@ -1731,6 +1819,9 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
+
+    friend class TransformTree;
+    friend class NodePath;
     
 #if CC_USE_PHYSICS
     friend class Layer;
@@ -0,0 +1,206 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCNodePath.h"
+
+#include <cctype>
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+// the characters that have a meaning in an ECMAScript regular expression
+static bool isPlainName(const std::string& text, size_t length)
+{
+    for (size_t i = 0; i < length; ++i)
+    {
+        switch (text[i])
+        {
+            case '^': case '$': case '\\': case '.': case '*': case '+': case '?':
+            case '(': case ')': case '[': case ']': case '{': case '}': case '|':
+                return false;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+NodePath::NodePath(const std::string& path)
+: _path(path)
+, _recursive(false)
+{
+    CCASSERT(path.length() != 0, "Invalid name");
+
+    size_t length = path.length();
+    size_t start = 0;
+    size_t count = length;
+
+    // Starts with '//'?
+    if (length > 2 && path[0] == '/' && path[1] == '/')
+    {
+        _recursive = true;
+        start = 2;
+        count -= 2;
+    }
+
+    // Ends with '/..'?
+    bool searchFromParent = false;
+    if (length > 3 && path.compare(length - 3, 3, "/..") == 0)
+    {
+        searchFromParent = true;
+        count -= 3;
+    }
+
+    std::string name = path.substr(start, count);
+    if (searchFromParent)
+    {
+        name.insert(0, "[[:alnum:]]+/");
+    }
+
+    std::hash<std::string> h;
+    size_t begin = 0;
+    while (true)
+    {
+        size_t end = name.find('/', begin);
+        Segment segment;
+        segment.text = name.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+        segment.hash = 0;
+
+        size_t textLength = segment.text.length();
+        if (segment.text == "[[:alnum:]]+")
+        {
+            segment.type = Segment::Type::ALNUM;
+        }
+        else if (isPlainName(segment.text, textLength))
+        {
+            segment.type = Segment::Type::NAME;
+            segment.hash = h(segment.text);
+        }
+        else if (textLength >= 2 && segment.text.compare(textLength - 2, 2, ".*") == 0 && isPlainName(segment.text, textLength - 2))
+        {
+            segment.type = Segment::Type::PREFIX;
+            segment.text.resize(textLength - 2);
+        }
+        else
+        {
+            segment.type = Segment::Type::REGEX;
+            segment.regex = std::regex(segment.text);
+        }
+        _segments.push_back(std::move(segment));
+
+        if (end == std::string::npos)
+            break;
+        begin = end + 1;
+    }
+}
+
+bool NodePath::Segment::match(const std::string& name) const
+{
+    switch (type)
+    {
+        case Type::NAME:
+            return name == text;
+        case Type::PREFIX:
+            return name.compare(0, text.length(), text) == 0;
+        case Type::ALNUM:
+            if (name.empty())
+                return false;
+            for (const auto& c : name)
+            {
+                if (!isalnum((unsigned char)c))
+                    return false;
+            }
+            return true;
+        case Type::REGEX:
+            return std::regex_match(name, regex);
+    }
+    return false;
+}
+
+bool NodePath::enumerate(const Node* node, const std::function<bool(Node*)>& callback) const
+{
+    CCASSERT(callback != nullptr, "Invalid callback function");
+
+    if (_recursive)
+        return enumerateRecursive(node, callback);
+    return enumerateSegments(node, 0, callback);
+}
+
+Node* NodePath::findFirst(const Node* node) const
+{
+    Node* found = nullptr;
+    enumerate(node, [&found](Node* match) {
+        found = match;
+        return true;
+    });
+    return found;
+}
+
+bool NodePath::enumerateSegments(const Node* node, size_t index, const std::function<bool(Node*)>& callback) const
+{
+    const auto& segment = _segments[index];
+    bool last = (index + 1 == _segments.size());
+
+    if (segment.type == Segment::Type::NAME)
+    {
+        Node* child = nullptr;
+        if (node->lookUpChildIndex(segment.text, segment.hash, &child))
+        {
+            if (!child)
+                return false;
+            return last ? callback(child) : enumerateSegments(child, index + 1, callback);
+        }
+    }
+
+    for (const auto& child : node->_children)
+    {
+        // different names may have the same hash, but it is compared first for speed
+        if (segment.type == Segment::Type::NAME && child->_hashOfName != segment.hash)
+            continue;
+
+        if (segment.match(child->_name))
+        {
+            // terminate the enumeration if callback returns true
+            if (last ? callback(child) : enumerateSegments(child, index + 1, callback))
+                return true;
+        }
+    }
+    return false;
+}
+
+bool NodePath::enumerateRecursive(const Node* node, const std::function<bool(Node*)>& callback) const
+{
+    // the node itself, then its children
+    if (enumerateSegments(node, 0, callback))
+        return true;
+
+    for (const auto& child : node->getChildren())
+    {
+        if (enumerateRecursive(child, callback))
+            return true;
+    }
+    return false;
+}
+
+NS_CC_END
@@ -0,0 +1,97 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCNODE_PATH_H__
+#define __CCNODE_PATH_H__
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <functional>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * A search path of Node::enumerateChildren(), parsed and compiled once.
+ *
+ * The path has the syntax of Node::enumerateChildren(): an optional `//` at the start to search recursively,
+ * names separated by `/`, and an optional `/..` at the end. Each name is matched without building a std::regex
+ * per child: plain names are compared as strings, or looked up in the child index of the node when it has one,
+ * names like `Button_.*` are compared by prefix, and `[[:alnum:]]+` by character class.
+ * The other regular expressions are compiled once, when the path is created.
+ *
+ * @code
+ * static const NodePath buttons("//Panel/Button_.*");
+ * panel->enumerateChildren(buttons, [](Node* button) { ...; return false; });
+ * @endcode
+ * @since v3.3
+ */
+class CC_DLL NodePath
+{
+public:
+    explicit NodePath(const std::string& path);
+
+    /** returns the path it was created from */
+    const std::string& getPath() const { return _path; }
+
+    /** Calls callback with the nodes below node that match the path, until callback returns true.
+     Returns true when callback stopped the search. */
+    bool enumerate(const Node* node, const std::function<bool(Node*)>& callback) const;
+
+    /** returns the first node below node that matches the path, or nullptr */
+    Node* findFirst(const Node* node) const;
+
+protected:
+    struct Segment
+    {
+        enum class Type
+        {
+            NAME,       // a plain name
+            PREFIX,     // a plain name followed by .*
+            ALNUM,      // [[:alnum:]]+
+            REGEX,
+        };
+
+        Type type;
+        std::string text;
+        size_t hash;
+        std::regex regex;
+
+        bool match(const std::string& name) const;
+    };
+
+    bool enumerateSegments(const Node* node, size_t index, const std::function<bool(Node*)>& callback) const;
+    bool enumerateRecursive(const Node* node, const std::function<bool(Node*)>& callback) const;
+
+    std::string _path;
+    std::vector<Segment> _segments;
+    bool _recursive;
+};
+
+NS_CC_END
+
+#endif // __CCNODE_PATH_H__
@@ -398,6 +398,9 @@ void ParticleBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t
 {
     CC_PROFILER_START("CCParticleBatchNode - draw");
 
+    // the children updated in parallel may still be writing their quads
+    ParticleSystem::finishParallelUpdates();
+
     if( _textureAtlas->getTotalQuads() == 0 )
     {
         return;
@@ -45,12 +45,25 @@ THE SOFTWARE.
 #include "2d/CCParticleSystem.h"
 
 #include <string>
+#include <mutex>
+#include <algorithm>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#define CC_PARTICLE_USE_SSE
+#elif defined(__ARM_NEON__) || defined(__aarch64__)
+#include <arm_neon.h>
+#define CC_PARTICLE_USE_NEON
+#endif
 
 #include "2d/CCParticleBatchNode.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
 #include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCWorkerPool.h"
 #include "renderer/CCTextureCache.h"
 #include "deprecated/CCString.h"
 #include "platform/CCFileUtils.h"
@@ -77,12 +90,170 @@ NS_CC_BEGIN
 //  cocos2d uses a another approach, but the results are almost identical. 
 //
 
+// number of float arrays in ParticleData (atlasIndex included)
+static const int PARTICLE_DATA_ARRAYS = 26;
+
+// number of particles moved by a task of finishParallelUpdates()
+static const int PARALLEL_UPDATE_CHUNK = 1024;
+
+// systems waiting for the parallel part of their update, in the order they were updated
+static std::vector<ParticleSystem*> s_parallelUpdates;
+static std::mutex s_parallelUpdatesMutex;
+
+// a single listener finishes the parallel updates after the scheduler update,
+// it is registered while at least one system is updated in parallel
+static EventListenerCustom* s_afterUpdateListener = nullptr;
+static int s_afterUpdateListenerCount = 0;
+
+static void retainAfterUpdateListener(EventDispatcher* eventDispatcher)
+{
+    if (s_afterUpdateListenerCount++ == 0)
+    {
+        s_afterUpdateListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom* /*event*/){
+            ParticleSystem::finishParallelUpdates();
+        });
+    }
+}
+
+static void releaseAfterUpdateListener(EventDispatcher* eventDispatcher)
+{
+    CCASSERT(s_afterUpdateListenerCount > 0, "The after update listener isn't used");
+    if (--s_afterUpdateListenerCount == 0)
+    {
+        eventDispatcher->removeEventListener(s_afterUpdateListener);
+        s_afterUpdateListener = nullptr;
+    }
+}
+
+ParticleData::ParticleData()
+: _buffer(nullptr)
+, _maxCount(0)
+{
+    setArrays(nullptr, 0);
+}
+
+ParticleData::~ParticleData()
+{
+    release();
+}
+
+bool ParticleData::init(int count)
+{
+    // each array is padded to 16 bytes, so all of them share the alignment of the buffer
+    size_t stride = ((size_t)std::max(count, 1) + 3) & ~(size_t)3;
+    float* buffer = (float*)calloc(stride * PARTICLE_DATA_ARRAYS, sizeof(float));
+    if (buffer == nullptr)
+    {
+        return false;
+    }
+
+    release();
+    _buffer = buffer;
+    _maxCount = count;
+    setArrays(buffer, stride);
+
+    return true;
+}
+
+void ParticleData::release()
+{
+    free(_buffer);
+    _buffer = nullptr;
+    _maxCount = 0;
+    setArrays(nullptr, 0);
+}
+
+void ParticleData::setArrays(float* buffer, size_t stride)
+{
+    float** arrays[PARTICLE_DATA_ARRAYS - 1] = {
+        &posx, &posy, &startPosX, &startPosY,
+        &colorR, &colorG, &colorB, &colorA,
+        &deltaColorR, &deltaColorG, &deltaColorB, &deltaColorA,
+        &size, &deltaSize, &rotation, &deltaRotation, &timeToLive,
+        &modeA.dirX, &modeA.dirY, &modeA.radialAccel, &modeA.tangentialAccel,
+        &modeB.angle, &modeB.degreesPerSecond, &modeB.radius, &modeB.deltaRadius,
+    };
+    for (int i = 0; i < PARTICLE_DATA_ARRAYS - 1; ++i)
+    {
+        *arrays[i] = buffer ? buffer + stride * i : nullptr;
+    }
+    atlasIndex = buffer ? (unsigned int*)(buffer + stride * (PARTICLE_DATA_ARRAYS - 1)) : nullptr;
+}
+
+void ParticleData::copyParticle(int dst, int src)
+{
+    posx[dst] = posx[src];
+    posy[dst] = posy[src];
+    startPosX[dst] = startPosX[src];
+    startPosY[dst] = startPosY[src];
+
+    colorR[dst] = colorR[src];
+    colorG[dst] = colorG[src];
+    colorB[dst] = colorB[src];
+    colorA[dst] = colorA[src];
+
+    deltaColorR[dst] = deltaColorR[src];
+    deltaColorG[dst] = deltaColorG[src];
+    deltaColorB[dst] = deltaColorB[src];
+    deltaColorA[dst] = deltaColorA[src];
+
+    size[dst] = size[src];
+    deltaSize[dst] = deltaSize[src];
+    rotation[dst] = rotation[src];
+    deltaRotation[dst] = deltaRotation[src];
+    timeToLive[dst] = timeToLive[src];
+    atlasIndex[dst] = atlasIndex[src];
+
+    modeA.dirX[dst] = modeA.dirX[src];
+    modeA.dirY[dst] = modeA.dirY[src];
+    modeA.radialAccel[dst] = modeA.radialAccel[src];
+    modeA.tangentialAccel[dst] = modeA.tangentialAccel[src];
+
+    modeB.angle[dst] = modeB.angle[src];
+    modeB.degreesPerSecond[dst] = modeB.degreesPerSecond[src];
+    modeB.radius[dst] = modeB.radius[src];
+    modeB.deltaRadius[dst] = modeB.deltaRadius[src];
+}
+
+void ParticleData::setParticle(int index, const tParticle& particle)
+{
+    posx[index] = particle.pos.x;
+    posy[index] = particle.pos.y;
+    startPosX[index] = particle.startPos.x;
+    startPosY[index] = particle.startPos.y;
+
+    colorR[index] = particle.color.r;
+    colorG[index] = particle.color.g;
+    colorB[index] = particle.color.b;
+    colorA[index] = particle.color.a;
+
+    deltaColorR[index] = particle.deltaColor.r;
+    deltaColorG[index] = particle.deltaColor.g;
+    deltaColorB[index] = particle.deltaColor.b;
+    deltaColorA[index] = particle.deltaColor.a;
+
+    size[index] = particle.size;
+    deltaSize[index] = particle.deltaSize;
+    rotation[index] = particle.rotation;
+    deltaRotation[index] = particle.deltaRotation;
+    timeToLive[index] = particle.timeToLive;
+
+    modeA.dirX[index] = particle.modeA.dir.x;
+    modeA.dirY[index] = particle.modeA.dir.y;
+    modeA.radialAccel[index] = particle.modeA.radialAccel;
+    modeA.tangentialAccel[index] = particle.modeA.tangentialAccel;
+
+    modeB.angle[index] = particle.modeB.angle;
+    modeB.degreesPerSecond[index] = particle.modeB.degreesPerSecond;
+    modeB.radius[index] = particle.modeB.radius;
+    modeB.deltaRadius[index] = particle.modeB.deltaRadius;
+}
+
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
 , _isAutoRemoveOnFinish(false)
 , _plistFile("")
 , _elapsed(0)
-, _particles(nullptr)
 , _configName("")
 , _emitCounter(0)
 , _particleIdx(0)
@@ -115,6 +286,10 @@ ParticleSystem::ParticleSystem()
 , _opacityModifyRGB(false)
 , _yCoordFlipped(1)
 , _positionType(PositionType::FREE)
+, _updatedInParallel(false)
+, _parallelUpdatePending(false)
+, _parallelUpdateCount(0)
+, _parallelUpdateDelta(0)
 {
     modeA.gravity = Vec2::ZERO;
     modeA.speed = 0;
@@ -429,11 +604,7 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
 {
     _totalParticles = numberOfParticles;
 
-    CC_SAFE_FREE(_particles);
-    
-    _particles = (tParticle*)calloc(_totalParticles, sizeof(tParticle));
-
-    if( ! _particles )
+    if( ! _particleData.init(_totalParticles) )
     {
         CCLOG("Particle system: not enough memory");
         this->release();
@@ -445,7 +616,7 @@ bool ParticleSystem::initWithTotalParticles(int numberOfParticles)
     {
         for (int i = 0; i < _totalParticles; i++)
         {
-            _particles[i].atlasIndex=i;
+            _particleData.atlasIndex[i]=i;
         }
     }
     // default, active
@@ -480,7 +651,17 @@ ParticleSystem::~ParticleSystem()
     // Since the scheduler retains the "target (in this case the ParticleSystem)
 	// it is not needed to call "unscheduleUpdate" here. In fact, it will be called in "cleanup"
     //unscheduleUpdate();
-    CC_SAFE_FREE(_particles);
+    if (_parallelUpdatePending)
+    {
+        // the quads of the subclass are already released: the pending update is dropped
+        std::lock_guard<std::mutex> lock(s_parallelUpdatesMutex);
+        s_parallelUpdates.erase(std::remove(s_parallelUpdates.begin(), s_parallelUpdates.end(), this), s_parallelUpdates.end());
+    }
+    if (_updatedInParallel)
+    {
+        releaseAfterUpdateListener(_eventDispatcher);
+    }
+    _particleData.release();
     CC_SAFE_RELEASE(_texture);
 }
 
@@ -491,14 +672,49 @@ bool ParticleSystem::addParticle()
         return false;
     }
 
-    tParticle * particle = &_particles[ _particleCount ];
-    this->initParticle(particle);
-    ++_particleCount;
+    addParticles(1);
 
     return true;
 }
 
+void ParticleSystem::addParticles(int count)
+{
+    int start = _particleCount;
+    int end = start + MIN(count, _totalParticles - start);
+    if (end <= start)
+    {
+        return;
+    }
+    _particleCount = end;
+
+    Vec2 startPos = getEmissionStartPosition();
+    tParticle particle;
+    for (int i = start; i < end; ++i)
+    {
+        makeParticle(&particle, startPos);
+        _particleData.setParticle(i, particle);
+    }
+}
+
 void ParticleSystem::initParticle(tParticle* particle)
+{
+    makeParticle(particle, getEmissionStartPosition());
+}
+
+Vec2 ParticleSystem::getEmissionStartPosition()
+{
+    if (_positionType == PositionType::FREE)
+    {
+        return this->convertToWorldSpace(Vec2::ZERO);
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        return _position;
+    }
+    return Vec2::ZERO;
+}
+
+void ParticleSystem::makeParticle(tParticle* particle, const Vec2& startPos)
 {
     // timeToLive
     // no negative life. prevent division by 0
@@ -554,17 +770,10 @@ void ParticleSystem::initParticle(tParticle* particle)
     particle->deltaRotation = (endA - startA) / particle->timeToLive;
 
     // position
-    if (_positionType == PositionType::FREE)
-    {
-        particle->startPos = this->convertToWorldSpace(Vec2::ZERO);
-    }
-    else if (_positionType == PositionType::RELATIVE)
-    {
-        particle->startPos = _position;
-    }
+    particle->startPos = startPos;
 
     // direction
-    float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * CCRANDOM_MINUS1_1() );    
+    float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * CCRANDOM_MINUS1_1() );
 
     // Mode Gravity: A
     if (_emitterMode == Mode::GRAVITY)
@@ -577,7 +786,7 @@ void ParticleSystem::initParticle(tParticle* particle)
 
         // radial accel
         particle->modeA.radialAccel = modeA.radialAccel + modeA.radialAccelVar * CCRANDOM_MINUS1_1();
- 
+
 
         // tangential accel
         particle->modeA.tangentialAccel = modeA.tangentialAccel + modeA.tangentialAccelVar * CCRANDOM_MINUS1_1();
@@ -588,7 +797,7 @@ void ParticleSystem::initParticle(tParticle* particle)
     }
 
     // Mode Radius: B
-    else 
+    else
     {
         // Set the default diameter of the particle from the source position
         float startRadius = modeB.startRadius + modeB.startRadiusVar * CCRANDOM_MINUS1_1();
@@ -607,7 +816,7 @@ void ParticleSystem::initParticle(tParticle* particle)
 
         particle->modeB.angle = a;
         particle->modeB.degreesPerSecond = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * CCRANDOM_MINUS1_1());
-    }    
+    }
 }
 
 void ParticleSystem::onEnter()
@@ -645,8 +854,7 @@ void ParticleSystem::resetSystem()
     _elapsed = 0;
     for (_particleIdx = 0; _particleIdx < _particleCount; ++_particleIdx)
     {
-        tParticle *p = &_particles[_particleIdx];
-        p->timeToLive = 0;
+        _particleData.timeToLive[_particleIdx] = 0;
     }
 }
 bool ParticleSystem::isFull()
@@ -659,6 +867,9 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    // the previous update may not be finished yet when update() is called by hand
+    waitForParallelUpdate();
+
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -668,11 +879,13 @@ void ParticleSystem::update(float dt)
             _emitCounter += dt;
         }
         
-        while (_particleCount < _totalParticles && _emitCounter > rate) 
+        int emitCount = 0;
+        while (_particleCount + emitCount < _totalParticles && _emitCounter > rate) 
         {
-            this->addParticle();
+            ++emitCount;
             _emitCounter -= rate;
         }
+        this->addParticles(emitCount);
 
         _elapsed += dt;
         if (_duration != -1 && _duration < _elapsed)
@@ -681,164 +894,245 @@ void ParticleSystem::update(float dt)
         }
     }
 
-    _particleIdx = 0;
-
-    Vec2 currentPosition = Vec2::ZERO;
-    if (_positionType == PositionType::FREE)
-    {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
-    }
-    else if (_positionType == PositionType::RELATIVE)
+    // life
+    float* timeToLive = _particleData.timeToLive;
+    for (int i = 0; i < _particleCount; ++i)
     {
-        currentPosition = _position;
+        timeToLive[i] -= dt;
     }
 
+    // remove the dead particles, moving the last particle in their place
+    for (_particleIdx = 0; _particleIdx < _particleCount; )
     {
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
-        
-        while (_particleIdx < _particleCount)
+        if (timeToLive[_particleIdx] > 0)
         {
-            tParticle *p = &_particles[_particleIdx];
-
-            // life
-            p->timeToLive -= dt;
-
-            if (p->timeToLive > 0) 
-            {
-                // Mode A: gravity, direction, tangential accel & radial accel
-                if (_emitterMode == Mode::GRAVITY)
-                {
-                    Vec2 tmp, radial, tangential;
-
-                    radial = Vec2::ZERO;
-                    // radial acceleration
-                    if (p->pos.x || p->pos.y)
-                    {
-                        radial = p->pos.getNormalized();
-                    }
-                    tangential = radial;
-                    radial = radial * p->modeA.radialAccel;
-
-                    // tangential acceleration
-                    float newy = tangential.x;
-                    tangential.x = -tangential.y;
-                    tangential.y = newy;
-                    tangential = tangential * p->modeA.tangentialAccel;
-
-                    // (gravity + radial + tangential) * dt
-                    tmp = radial + tangential + modeA.gravity;
-                    tmp = tmp * dt;
-                    p->modeA.dir = p->modeA.dir + tmp;
-                    
-                    // this is cocos2d-x v3.0
-//                    if (_configName.length()>0 && _yCoordFlipped != -1)
-
-                    // this is cocos2d-x v3.0
-                    tmp = p->modeA.dir * dt * _yCoordFlipped;
-                    p->pos = p->pos + tmp;
-                }
-
-                // Mode B: radius movement
-                else 
-                {                
-                    // Update the angle and radius of the particle.
-                    p->modeB.angle += p->modeB.degreesPerSecond * dt;
-                    p->modeB.radius += p->modeB.deltaRadius * dt;
+            ++_particleIdx;
+            continue;
+        }
 
-                    p->pos.x = - cosf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y = - sinf(p->modeB.angle) * p->modeB.radius;
-                    p->pos.y *= _yCoordFlipped;
-				}
+        // life < 0
+        int lastIndex = _particleCount - 1;
+        unsigned int currentIndex = _particleData.atlasIndex[_particleIdx];
+        if( _particleIdx != lastIndex )
+        {
+            _particleData.copyParticle(_particleIdx, lastIndex);
+        }
+        if (_batchNode)
+        {
+            //disable the switched particle
+            _batchNode->disableParticle(_atlasIndex+currentIndex);
 
-                // color
-                p->color.r += (p->deltaColor.r * dt);
-                p->color.g += (p->deltaColor.g * dt);
-                p->color.b += (p->deltaColor.b * dt);
-                p->color.a += (p->deltaColor.a * dt);
+            //switch indexes
+            _particleData.atlasIndex[lastIndex] = currentIndex;
+        }
 
-                // size
-                p->size += (p->deltaSize * dt);
-                p->size = MAX( 0, p->size );
+        --_particleCount;
 
-                // angle
-                p->rotation += (p->deltaRotation * dt);
+        if( _particleCount == 0 && _isAutoRemoveOnFinish )
+        {
+            this->unscheduleUpdate();
+            _parent->removeChild(this, true);
+            CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+            return;
+        }
+    }
 
-                //
-                // update values in quad
-                //
+    if (_updatedInParallel && _particleCount > 0)
+    {
+        // the particles are moved and the quads written by finishParallelUpdates()
+        prepareParticleQuads();
+        _transformSystemDirty = false;
 
-                Vec2    newPos;
+        _parallelUpdateCount = _particleCount;
+        _parallelUpdateDelta = dt;
+        {
+            std::lock_guard<std::mutex> lock(s_parallelUpdatesMutex);
+            s_parallelUpdates.push_back(this);
+            _parallelUpdatePending = true;
+        }
+    }
+    else
+    {
+        stepParticles(0, _particleCount, dt);
 
-                if (_positionType == PositionType::FREE)
-                {
-                    Vec3 p1(currentPosition.x,currentPosition.y,0),p2(p->startPos.x,p->startPos.y,0);
-                    worldToNodeTM.transformPoint(&p1);
-                    worldToNodeTM.transformPoint(&p2);
-                    p1 = p1 - p2;
-                    newPos = p->pos - Vec2(p1.x,p1.y);
-                }
-                else if(_positionType == PositionType::RELATIVE)
-                {
-                    Vec2 diff = currentPosition - p->startPos;
-                    newPos = p->pos - diff;
-                } 
-                else
-                {
-                    newPos = p->pos;
-                }
+        //
+        // update values in quads
+        //
+        updateParticleQuads();
+        _transformSystemDirty = false;
 
-                // translate newPos to correct position, since matrix transform isn't performed in batchnode
-                // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
-                if (_batchNode)
-                {
-                    newPos.x+=_position.x;
-                    newPos.y+=_position.y;
-                }
+        // only update gl buffer when visible
+        if (_visible && ! _batchNode)
+        {
+            postStep();
+        }
+    }
 
-                updateQuadWithParticle(p, newPos);
-                //updateParticleImp(self, updateParticleSel, p, newPos);
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
 
-                // update particle counter
-                ++_particleIdx;
-            } 
-            else 
-            {
-                // life < 0
-                int currentIndex = p->atlasIndex;
-                if( _particleIdx != _particleCount-1 )
-                {
-                    _particles[_particleIdx] = _particles[_particleCount-1];
-                }
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    _batchNode->disableParticle(_atlasIndex+currentIndex);
+void ParticleSystem::stepParticles(int begin, int end, float dt)
+{
+    ParticleData& data = _particleData;
+    float* posx = data.posx;
+    float* posy = data.posy;
 
-                    //switch indexes
-                    _particles[_particleCount-1].atlasIndex = currentIndex;
-                }
+    // Mode A: gravity, direction, tangential accel & radial accel
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        float* dirX = data.modeA.dirX;
+        float* dirY = data.modeA.dirY;
+        const float* radialAccel = data.modeA.radialAccel;
+        const float* tangentialAccel = data.modeA.tangentialAccel;
+        const float gravityX = modeA.gravity.x;
+        const float gravityY = modeA.gravity.y;
+        const float yCoordFlipped = (float)_yCoordFlipped;
+
+        int i = begin;
+#if defined(CC_PARTICLE_USE_SSE)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 gx = _mm_set1_ps(gravityX);
+        const __m128 gy = _mm_set1_ps(gravityY);
+        const __m128 vdt = _mm_set1_ps(dt);
+        const __m128 flip = _mm_set1_ps(yCoordFlipped);
+        for (; i + 4 <= end; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(posx + i);
+            __m128 y = _mm_loadu_ps(posy + i);
+
+            // radial direction, left to zero for the particles sitting on the emitter
+            __m128 lengthSq = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+            __m128 invLength = _mm_and_ps(_mm_div_ps(one, _mm_sqrt_ps(lengthSq)), _mm_cmpgt_ps(lengthSq, zero));
+            __m128 rx = _mm_mul_ps(x, invLength);
+            __m128 ry = _mm_mul_ps(y, invLength);
+
+            // (radial + tangential + gravity) * dt
+            __m128 radial = _mm_loadu_ps(radialAccel + i);
+            __m128 tangential = _mm_loadu_ps(tangentialAccel + i);
+            __m128 ax = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(rx, radial), _mm_mul_ps(ry, tangential)), gx);
+            __m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ry, radial), _mm_mul_ps(rx, tangential)), gy);
+            __m128 dx = _mm_add_ps(_mm_loadu_ps(dirX + i), _mm_mul_ps(ax, vdt));
+            __m128 dy = _mm_add_ps(_mm_loadu_ps(dirY + i), _mm_mul_ps(ay, vdt));
+            _mm_storeu_ps(dirX + i, dx);
+            _mm_storeu_ps(dirY + i, dy);
+
+            _mm_storeu_ps(posx + i, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(dx, vdt), flip)));
+            _mm_storeu_ps(posy + i, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(dy, vdt), flip)));
+        }
+#elif defined(CC_PARTICLE_USE_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float32x4_t gx = vdupq_n_f32(gravityX);
+        const float32x4_t gy = vdupq_n_f32(gravityY);
+        const float32x4_t vdt = vdupq_n_f32(dt);
+        const float32x4_t flip = vdupq_n_f32(yCoordFlipped);
+        for (; i + 4 <= end; i += 4)
+        {
+            float32x4_t x = vld1q_f32(posx + i);
+            float32x4_t y = vld1q_f32(posy + i);
+
+            // radial direction, left to zero for the particles sitting on the emitter.
+            // 1/sqrt is refined twice from the estimate, since armv7 has no vector division
+            float32x4_t lengthSq = vaddq_f32(vmulq_f32(x, x), vmulq_f32(y, y));
+            float32x4_t invLength = vrsqrteq_f32(lengthSq);
+            invLength = vmulq_f32(invLength, vrsqrtsq_f32(vmulq_f32(lengthSq, invLength), invLength));
+            invLength = vmulq_f32(invLength, vrsqrtsq_f32(vmulq_f32(lengthSq, invLength), invLength));
+            invLength = vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(invLength), vcgtq_f32(lengthSq, zero)));
+            float32x4_t rx = vmulq_f32(x, invLength);
+            float32x4_t ry = vmulq_f32(y, invLength);
+
+            // (radial + tangential + gravity) * dt
+            float32x4_t radial = vld1q_f32(radialAccel + i);
+            float32x4_t tangential = vld1q_f32(tangentialAccel + i);
+            float32x4_t ax = vaddq_f32(vsubq_f32(vmulq_f32(rx, radial), vmulq_f32(ry, tangential)), gx);
+            float32x4_t ay = vaddq_f32(vaddq_f32(vmulq_f32(ry, radial), vmulq_f32(rx, tangential)), gy);
+            float32x4_t dx = vaddq_f32(vld1q_f32(dirX + i), vmulq_f32(ax, vdt));
+            float32x4_t dy = vaddq_f32(vld1q_f32(dirY + i), vmulq_f32(ay, vdt));
+            vst1q_f32(dirX + i, dx);
+            vst1q_f32(dirY + i, dy);
+
+            vst1q_f32(posx + i, vaddq_f32(x, vmulq_f32(vmulq_f32(dx, vdt), flip)));
+            vst1q_f32(posy + i, vaddq_f32(y, vmulq_f32(vmulq_f32(dy, vdt), flip)));
+        }
+#endif
+        for (; i < end; ++i)
+        {
+            float x = posx[i];
+            float y = posy[i];
+
+            // radial acceleration
+            float lengthSq = x * x + y * y;
+            float invLength = lengthSq > 0 ? 1.0f / sqrtf(lengthSq) : 0.0f;
+            float rx = x * invLength;
+            float ry = y * invLength;
+
+            // (gravity + radial + tangential) * dt
+            float ax = rx * radialAccel[i] - ry * tangentialAccel[i] + gravityX;
+            float ay = ry * radialAccel[i] + rx * tangentialAccel[i] + gravityY;
+            dirX[i] += ax * dt;
+            dirY[i] += ay * dt;
+
+            // this is cocos2d-x v3.0
+            posx[i] = x + dirX[i] * dt * yCoordFlipped;
+            posy[i] = y + dirY[i] * dt * yCoordFlipped;
+        }
+    }
 
+    // Mode B: radius movement
+    else
+    {
+        // Update the angle and radius of the particle.
+        float* angle = data.modeB.angle;
+        float* radius = data.modeB.radius;
+        const float* degreesPerSecond = data.modeB.degreesPerSecond;
+        const float* deltaRadius = data.modeB.deltaRadius;
+        for (int i = begin; i < end; ++i)
+        {
+            angle[i] += degreesPerSecond[i] * dt;
+        }
+        for (int i = begin; i < end; ++i)
+        {
+            radius[i] += deltaRadius[i] * dt;
+        }
 
-                --_particleCount;
+        const float yCoordFlipped = (float)_yCoordFlipped;
+        for (int i = begin; i < end; ++i)
+        {
+            posx[i] = - cosf(angle[i]) * radius[i];
+            posy[i] = - sinf(angle[i]) * radius[i] * yCoordFlipped;
+        }
+    }
 
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        } //while
-        _transformSystemDirty = false;
+    // color, size and angle
+    float* colorR = data.colorR;
+    float* colorG = data.colorG;
+    float* colorB = data.colorB;
+    float* colorA = data.colorA;
+    const float* deltaColorR = data.deltaColorR;
+    const float* deltaColorG = data.deltaColorG;
+    const float* deltaColorB = data.deltaColorB;
+    const float* deltaColorA = data.deltaColorA;
+    for (int i = begin; i < end; ++i)
+    {
+        colorR[i] += deltaColorR[i] * dt;
+        colorG[i] += deltaColorG[i] * dt;
+        colorB[i] += deltaColorB[i] * dt;
+        colorA[i] += deltaColorA[i] * dt;
     }
-    
-    // only update gl buffer when visible
-    if (_visible && ! _batchNode)
+
+    float* size = data.size;
+    const float* deltaSize = data.deltaSize;
+    for (int i = begin; i < end; ++i)
     {
-        postStep();
+        size[i] = MAX(0, size[i] + deltaSize[i] * dt);
     }
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+    float* rotation = data.rotation;
+    const float* deltaRotation = data.deltaRotation;
+    for (int i = begin; i < end; ++i)
+    {
+        rotation[i] += deltaRotation[i] * dt;
+    }
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -846,13 +1140,105 @@ void ParticleSystem::updateWithNoTime(void)
     this->update(0.0f);
 }
 
+void ParticleSystem::updateParticleQuads()
+{
+    prepareParticleQuads();
+    writeParticleQuads(0, _particleCount);
+}
+
 void ParticleSystem::updateQuadWithParticle(tParticle* particle, const Vec2& newPosition)
 {
     CC_UNUSED_PARAM(particle);
     CC_UNUSED_PARAM(newPosition);
+    // not called anymore, see writeParticleQuads()
+}
+
+void ParticleSystem::updateParallelChunk(int begin, int end)
+{
+    stepParticles(begin, end, _parallelUpdateDelta);
+    writeParticleQuads(begin, end);
+}
+
+void ParticleSystem::prepareParticleQuads()
+{
     // should be overridden
 }
 
+void ParticleSystem::writeParticleQuads(int begin, int end)
+{
+    CC_UNUSED_PARAM(begin);
+    CC_UNUSED_PARAM(end);
+    // should be overridden
+}
+
+void ParticleSystem::setUpdatedInParallel(bool updatedInParallel)
+{
+    if (_updatedInParallel == updatedInParallel)
+        return;
+
+    waitForParallelUpdate();
+    _updatedInParallel = updatedInParallel;
+
+    if (updatedInParallel)
+    {
+        retainAfterUpdateListener(_eventDispatcher);
+    }
+    else
+    {
+        releaseAfterUpdateListener(_eventDispatcher);
+    }
+}
+
+void ParticleSystem::waitForParallelUpdate()
+{
+    if (_parallelUpdatePending)
+    {
+        finishParallelUpdates();
+    }
+}
+
+void ParticleSystem::finishParallelUpdates()
+{
+    std::lock_guard<std::mutex> lock(s_parallelUpdatesMutex);
+    if (s_parallelUpdates.empty())
+        return;
+
+    struct Chunk
+    {
+        ParticleSystem* system;
+        int begin;
+        int end;
+    };
+    static std::vector<Chunk> chunks;
+    chunks.clear();
+
+    // each chunk only touches its own particles and quads, so they can run in any order
+    for (auto system : s_parallelUpdates)
+    {
+        for (int begin = 0; begin < system->_parallelUpdateCount; begin += PARALLEL_UPDATE_CHUNK)
+        {
+            chunks.push_back({system, begin, std::min(begin + PARALLEL_UPDATE_CHUNK, system->_parallelUpdateCount)});
+        }
+    }
+
+    WorkerPool::getInstance()->parallelFor(chunks.size(), [](ssize_t index){
+        const Chunk& chunk = chunks[index];
+        chunk.system->updateParallelChunk(chunk.begin, chunk.end);
+    });
+
+    for (auto system : s_parallelUpdates)
+    {
+        system->_parallelUpdatePending = false;
+
+        // only update gl buffer when visible
+        if (system->_visible && ! system->_batchNode)
+        {
+            system->postStep();
+        }
+    }
+    s_parallelUpdates.clear();
+}
+
 void ParticleSystem::postStep()
 {
     // should be overridden
@@ -1141,13 +1527,14 @@ void ParticleSystem::setBatchNode(ParticleBatchNode* batchNode)
 {
     if( _batchNode != batchNode ) {
 
+        waitForParallelUpdate();
         _batchNode = batchNode; // weak reference
 
         if( batchNode ) {
             //each particle needs a unique index
             for (int i = 0; i < _totalParticles; i++)
             {
-                _particles[i].atlasIndex=i;
+                _particleData.atlasIndex[i]=i;
             }
         }
     }
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 #include "base/CCValue.h"
 
+#include <atomic>
+
 NS_CC_BEGIN
 
 /**
@@ -41,7 +43,9 @@ NS_CC_BEGIN
 class ParticleBatchNode;
 
 /**
-Structure that contains the values of each particle
+Structure that contains the values of one particle.
+The particles of a system are stored in its ParticleData, this structure is only used by the deprecated
+ParticleSystem::initParticle() and ParticleSystem::updateQuadWithParticle().
 */
 typedef struct sParticle {
     Vec2     pos;
@@ -77,7 +81,80 @@ typedef struct sParticle {
 
 }tParticle;
 
-//typedef void (*CC_UPDATE_PARTICLE_IMP)(id, SEL, tParticle*, Vec2);
+/** @brief Values of the particles of a ParticleSystem, stored as a structure of arrays.
+
+ Every property of the particles lives in its own array, so the update loops only stream through
+ the data they use and can process several particles per instruction.
+ The particle `i` is made of the i-th element of every array.
+ */
+class CC_DLL ParticleData
+{
+public:
+    float* posx;
+    float* posy;
+    float* startPosX;
+    float* startPosY;
+
+    float* colorR;
+    float* colorG;
+    float* colorB;
+    float* colorA;
+
+    float* deltaColorR;
+    float* deltaColorG;
+    float* deltaColorB;
+    float* deltaColorA;
+
+    float* size;
+    float* deltaSize;
+    float* rotation;
+    float* deltaRotation;
+    float* timeToLive;
+    unsigned int* atlasIndex;
+
+    //! Mode A: gravity, direction, radial accel, tangential accel
+    struct {
+        float* dirX;
+        float* dirY;
+        float* radialAccel;
+        float* tangentialAccel;
+    } modeA;
+
+    //! Mode B: radius mode
+    struct {
+        float* angle;
+        float* degreesPerSecond;
+        float* radius;
+        float* deltaRadius;
+    } modeB;
+
+    ParticleData();
+    ~ParticleData();
+
+    /** allocates zeroed arrays for `count` particles.
+     The previous arrays are released on success, and kept if there isn't enough memory.
+     */
+    bool init(int count);
+    /** releases the arrays */
+    void release();
+
+    /** returns the number of particles the arrays can hold */
+    int getMaxCount() const { return _maxCount; }
+
+    /** copies the values of the particle `src` to the particle `dst` */
+    void copyParticle(int dst, int src);
+    /** sets the values of the particle `index` from `particle`, except its atlas index */
+    void setParticle(int index, const tParticle& particle);
+
+protected:
+    void setArrays(float* buffer, size_t stride);
+
+    void* _buffer;
+    int _maxCount;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ParticleData);
+};
 
 class Texture2D;
 
@@ -181,8 +258,12 @@ public:
 
     //! Add a particle to the emitter
     bool addParticle();
-    //! Initializes a particle
-    void initParticle(tParticle* particle);
+    //! Add `count` particles to the emitter, as long as it isn't full
+    void addParticles(int count);
+    /** Initializes a particle
+     @deprecated The particles are stored in ParticleData and initialized by addParticles()
+     */
+    CC_DEPRECATED_ATTRIBUTE void initParticle(tParticle* particle);
     //! stop emitting particles. Running particles will continue to run until they die
     void stopSystem();
     //! Kill all living particles.
@@ -190,13 +271,32 @@ public:
     //! whether or not the system is full
     bool isFull();
 
-    //! should be overridden by subclasses
-    virtual void updateQuadWithParticle(tParticle* particle, const Vec2& newPosition);
+    /** Writes the quads of the living particles, after they were moved by a serial update.
+     Subclasses should rather override prepareParticleQuads() and writeParticleQuads(), which are used by both
+     the serial and the parallel updates: the parallel update doesn't call this method.
+     */
+    virtual void updateParticleQuads();
+    /** @deprecated Not called anymore: the quads are written by writeParticleQuads(), which subclasses should override instead */
+    CC_DEPRECATED_ATTRIBUTE virtual void updateQuadWithParticle(tParticle* particle, const Vec2& newPosition);
     //! should be overridden by subclasses
     virtual void postStep();
 
     virtual void updateWithNoTime(void);
 
+    /** Moves the particles on the worker threads of WorkerPool.
+     update() still emits and removes the particles on the cocos thread, so the random values are the same
+     as with a serial update. The motion and the quads of all the systems updated in parallel are then computed
+     together once the scheduler update is over, large systems being split in chunks of particles.
+     They are always finished before the system is drawn.
+     */
+    void setUpdatedInParallel(bool updatedInParallel);
+    bool isUpdatedInParallel() const { return _updatedInParallel; }
+
+    /** finishes the pending parallel updates of all the systems.
+     It is called after the scheduler update, and before drawing the systems.
+     */
+    static void finishParallelUpdates();
+
     virtual bool isAutoRemoveOnFinish() const;
     virtual void setAutoRemoveOnFinish(bool var);
 
@@ -408,6 +508,25 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void updateBlendFunc();
 
+    /** draws the random values of a new particle. They are drawn in the same order for every particle,
+     so that the same seed always emits the same particles */
+    void makeParticle(tParticle* particle, const Vec2& startPos);
+    /** returns the start position of the particles emitted now */
+    Vec2 getEmissionStartPosition();
+
+    /** moves the particles [begin, end) by `dt` seconds: position, color, size and rotation */
+    void stepParticles(int begin, int end, float dt);
+    /** moves the particles [begin, end) of a parallel update and writes their quads, on a worker thread */
+    void updateParallelChunk(int begin, int end);
+
+    /** reads from the node what the quads need, on the cocos thread. Should be overridden by subclasses */
+    virtual void prepareParticleQuads();
+    /** writes the quads of the particles [begin, end). It may run on a worker thread. Should be overridden by subclasses */
+    virtual void writeParticleQuads(int begin, int end);
+
+    /** finishes the pending parallel update of the system, if any */
+    void waitForParallelUpdate();
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -464,8 +583,8 @@ protected:
         float rotatePerSecondVar;
     } modeB;
 
-    //! Array of particles
-    tParticle *_particles;
+    //! Values of the particles
+    ParticleData _particleData;
 
     //Emitter name
     std::string _configName;
@@ -563,6 +682,13 @@ protected:
      */
     PositionType _positionType;
 
+    bool _updatedInParallel;
+    //! true between update() and the end of its parallel part
+    std::atomic<bool> _parallelUpdatePending;
+    //! particles and delta time of the pending parallel update
+    int _parallelUpdateCount;
+    float _parallelUpdateDelta;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
@@ -50,8 +50,11 @@ ParticleSystemQuad::ParticleSystemQuad()
 :_quads(nullptr)
 ,_indices(nullptr)
 ,_VAOname(0)
+,_quadsOrigin(Vec2::ZERO)
+,_quadsOffset(Vec2::ZERO)
 {
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    memset(_quadsTransform, 0, sizeof(_quadsTransform));
 }
 
 ParticleSystemQuad::~ParticleSystemQuad()
@@ -263,87 +266,131 @@ void ParticleSystemQuad::initIndices()
     }
 }
 
-void ParticleSystemQuad::updateQuadWithParticle(tParticle* particle, const Vec2& newPosition)
+void ParticleSystemQuad::prepareParticleQuads()
 {
-    V3F_C4B_T2F_Quad *quad;
-
-    if (_batchNode)
+    // The position of a particle in the node space is
+    //   newPos = pos - M * (currentPosition - startPos)
+    // where M is the linear part of the world to node transform in FREE mode,
+    // the identity in RELATIVE mode and zero in GROUPED mode.
+    Vec2 currentPosition = Vec2::ZERO;
+    float m0 = 0, m1 = 0, m4 = 0, m5 = 0;
+    if (_positionType == PositionType::FREE)
     {
-        V3F_C4B_T2F_Quad *batchQuads = _batchNode->getTextureAtlas()->getQuads();
-        quad = &(batchQuads[_atlasIndex+particle->atlasIndex]);
+        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        Mat4 worldToNodeTM = getWorldToNodeTransform();
+        m0 = worldToNodeTM.m[0];
+        m1 = worldToNodeTM.m[1];
+        m4 = worldToNodeTM.m[4];
+        m5 = worldToNodeTM.m[5];
     }
-    else
+    else if (_positionType == PositionType::RELATIVE)
     {
-        quad = &(_quads[_particleIdx]);
+        currentPosition = _position;
+        m0 = m5 = 1;
     }
-    Color4B color = (_opacityModifyRGB)
-        ? Color4B( particle->color.r*particle->color.a*255, particle->color.g*particle->color.a*255, particle->color.b*particle->color.a*255, particle->color.a*255)
-        : Color4B( particle->color.r*255, particle->color.g*255, particle->color.b*255, particle->color.a*255);
 
-    quad->bl.colors = color;
-    quad->br.colors = color;
-    quad->tl.colors = color;
-    quad->tr.colors = color;
+    _quadsOrigin = currentPosition;
+    _quadsTransform[0] = m0;
+    _quadsTransform[1] = m1;
+    _quadsTransform[2] = m4;
+    _quadsTransform[3] = m5;
 
-    // vertices
-    GLfloat size_2 = particle->size/2;
-    if (particle->rotation) 
-    {
-        GLfloat x1 = -size_2;
-        GLfloat y1 = -size_2;
-
-        GLfloat x2 = size_2;
-        GLfloat y2 = size_2;
-        GLfloat x = newPosition.x;
-        GLfloat y = newPosition.y;
-
-        GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(particle->rotation);
-        GLfloat cr = cosf(r);
-        GLfloat sr = sinf(r);
-        GLfloat ax = x1 * cr - y1 * sr + x;
-        GLfloat ay = x1 * sr + y1 * cr + y;
-        GLfloat bx = x2 * cr - y1 * sr + x;
-        GLfloat by = x2 * sr + y1 * cr + y;
-        GLfloat cx = x2 * cr - y2 * sr + x;
-        GLfloat cy = x2 * sr + y2 * cr + y;
-        GLfloat dx = x1 * cr - y2 * sr + x;
-        GLfloat dy = x1 * sr + y2 * cr + y;
-
-        // bottom-left
-        quad->bl.vertices.x = ax;
-        quad->bl.vertices.y = ay;
+    // translate newPos to correct position, since matrix transform isn't performed in batchnode
+    // don't update the particle with the new position information, it will interfere with the radius and tangential calculations
+    _quadsOffset = _batchNode ? _position : Vec2::ZERO;
+}
 
-        // bottom-right vertex:
-        quad->br.vertices.x = bx;
-        quad->br.vertices.y = by;
+void ParticleSystemQuad::writeParticleQuads(int begin, int end)
+{
+    V3F_C4B_T2F_Quad *quads = _quads;
+    const unsigned int *quadIndices = nullptr;
+    if (_batchNode)
+    {
+        quads = _batchNode->getTextureAtlas()->getQuads() + _atlasIndex;
+        quadIndices = _particleData.atlasIndex;
+    }
 
-        // top-left vertex:
-        quad->tl.vertices.x = dx;
-        quad->tl.vertices.y = dy;
+    const Vec2 currentPosition = _quadsOrigin;
+    const Vec2 offset = _quadsOffset;
+    const float m0 = _quadsTransform[0];
+    const float m1 = _quadsTransform[1];
+    const float m4 = _quadsTransform[2];
+    const float m5 = _quadsTransform[3];
 
-        // top-right vertex:
-        quad->tr.vertices.x = cx;
-        quad->tr.vertices.y = cy;
-    } 
-    else 
+    const ParticleData& data = _particleData;
+    for (int i = begin; i < end; ++i)
     {
-        // bottom-left vertex:
-        quad->bl.vertices.x = newPosition.x - size_2;
-        quad->bl.vertices.y = newPosition.y - size_2;
+        V3F_C4B_T2F_Quad *quad = &quads[quadIndices ? quadIndices[i] : i];
+
+        float diffX = currentPosition.x - data.startPosX[i];
+        float diffY = currentPosition.y - data.startPosY[i];
+        GLfloat x = data.posx[i] - (m0 * diffX + m4 * diffY) + offset.x;
+        GLfloat y = data.posy[i] - (m1 * diffX + m5 * diffY) + offset.y;
+
+        float r = data.colorR[i];
+        float g = data.colorG[i];
+        float b = data.colorB[i];
+        float a = data.colorA[i];
+        Color4B color = (_opacityModifyRGB)
+            ? Color4B( r*a*255, g*a*255, b*a*255, a*255)
+            : Color4B( r*255, g*255, b*255, a*255);
+
+        quad->bl.colors = color;
+        quad->br.colors = color;
+        quad->tl.colors = color;
+        quad->tr.colors = color;
+
+        // vertices
+        GLfloat size_2 = data.size[i]/2;
+        if (data.rotation[i])
+        {
+            GLfloat x1 = -size_2;
+            GLfloat y1 = -size_2;
 
-        // bottom-right vertex:
-        quad->br.vertices.x = newPosition.x + size_2;
-        quad->br.vertices.y = newPosition.y - size_2;
+            GLfloat x2 = size_2;
+            GLfloat y2 = size_2;
 
-        // top-left vertex:
-        quad->tl.vertices.x = newPosition.x - size_2;
-        quad->tl.vertices.y = newPosition.y + size_2;
+            GLfloat rad = (GLfloat)-CC_DEGREES_TO_RADIANS(data.rotation[i]);
+            GLfloat cr = cosf(rad);
+            GLfloat sr = sinf(rad);
 
-        // top-right vertex:
-        quad->tr.vertices.x = newPosition.x + size_2;
-        quad->tr.vertices.y = newPosition.y + size_2;                
+            // bottom-left
+            quad->bl.vertices.x = x1 * cr - y1 * sr + x;
+            quad->bl.vertices.y = x1 * sr + y1 * cr + y;
+
+            // bottom-right vertex:
+            quad->br.vertices.x = x2 * cr - y1 * sr + x;
+            quad->br.vertices.y = x2 * sr + y1 * cr + y;
+
+            // top-left vertex:
+            quad->tl.vertices.x = x1 * cr - y2 * sr + x;
+            quad->tl.vertices.y = x1 * sr + y2 * cr + y;
+
+            // top-right vertex:
+            quad->tr.vertices.x = x2 * cr - y2 * sr + x;
+            quad->tr.vertices.y = x2 * sr + y2 * cr + y;
+        }
+        else
+        {
+            // bottom-left vertex:
+            quad->bl.vertices.x = x - size_2;
+            quad->bl.vertices.y = y - size_2;
+
+            // bottom-right vertex:
+            quad->br.vertices.x = x + size_2;
+            quad->br.vertices.y = y - size_2;
+
+            // top-left vertex:
+            quad->tl.vertices.x = x - size_2;
+            quad->tl.vertices.y = y + size_2;
+
+            // top-right vertex:
+            quad->tr.vertices.x = x + size_2;
+            quad->tr.vertices.y = y + size_2;
+        }
     }
 }
+
 void ParticleSystemQuad::postStep()
 {
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
@@ -369,6 +416,7 @@ void ParticleSystemQuad::postStep()
 void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     CCASSERT( _particleIdx == 0 || _particleIdx == _particleCount, "Abnormal error in particle quad");
+    waitForParallelUpdate();
     //quad command
     if(_particleIdx > 0)
     {
@@ -379,28 +427,27 @@ void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_
 
 void ParticleSystemQuad::setTotalParticles(int tp)
 {
+    waitForParallelUpdate();
+
     // If we are setting the total number of particles to a number higher
     // than what is allocated, we need to allocate new arrays
     if( tp > _allocatedParticles )
     {
         // Allocate new memory
-        size_t particlesSize = tp * sizeof(tParticle);
         size_t quadsSize = sizeof(_quads[0]) * tp * 1;
         size_t indicesSize = sizeof(_indices[0]) * tp * 6 * 1;
 
-        tParticle* particlesNew = (tParticle*)realloc(_particles, particlesSize);
+        bool particlesAllocated = _particleData.init(tp);
         V3F_C4B_T2F_Quad* quadsNew = (V3F_C4B_T2F_Quad*)realloc(_quads, quadsSize);
         GLushort* indicesNew = (GLushort*)realloc(_indices, indicesSize);
 
-        if (particlesNew && quadsNew && indicesNew)
+        if (particlesAllocated && quadsNew && indicesNew)
         {
             // Assign pointers
-            _particles = particlesNew;
             _quads = quadsNew;
             _indices = indicesNew;
 
             // Clear the memory
-            memset(_particles, 0, particlesSize);
             memset(_quads, 0, quadsSize);
             memset(_indices, 0, indicesSize);
             
@@ -409,7 +456,6 @@ void ParticleSystemQuad::setTotalParticles(int tp)
         else
         {
             // Out of memory, failed to resize some array
-            if (particlesNew) _particles = particlesNew;
             if (quadsNew) _quads = quadsNew;
             if (indicesNew) _indices = indicesNew;
 
@@ -424,7 +470,7 @@ void ParticleSystemQuad::setTotalParticles(int tp)
         {
             for (int i = 0; i < _totalParticles; i++)
             {
-                _particles[i].atlasIndex=i;
+                _particleData.atlasIndex[i]=i;
             }
         }
 
@@ -556,6 +602,8 @@ void ParticleSystemQuad::setBatchNode(ParticleBatchNode * batchNode)
 {
     if( _batchNode != batchNode ) 
     {
+        waitForParallelUpdate();
+
         ParticleBatchNode* oldBatch = _batchNode;
 
         ParticleSystem::setBatchNode(batchNode);
@@ -92,11 +92,6 @@ public:
      * @lua NA
      */
     virtual void setTexture(Texture2D* texture) override;
-    /**
-     * @js NA
-     * @lua NA
-     */
-    virtual void updateQuadWithParticle(tParticle* particle, const Vec2& newPosition) override;
     /**
      * @js NA
      * @lua NA
@@ -153,6 +148,9 @@ protected:
     void setupVBO();
     bool allocMemory();
 
+    virtual void prepareParticleQuads() override;
+    virtual void writeParticleQuads(int begin, int end) override;
+
     V3F_C4B_T2F_Quad    *_quads;        // quads to be rendered
     GLushort            *_indices;      // indices
     GLuint              _VAOname;
@@ -160,6 +158,12 @@ protected:
 
     QuadCommand _quadCommand;           // quad command
 
+    // node state read by prepareParticleQuads(): the particle at pos is written at
+    // pos - transform * (origin - startPos) + offset
+    Vec2 _quadsOrigin;
+    float _quadsTransform[4];
+    Vec2 _quadsOffset;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystemQuad);
 };
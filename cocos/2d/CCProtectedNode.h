@@ -128,6 +128,7 @@ public:
     /// @} end of Children and Parent
     
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
     
     virtual void cleanup() override;
     
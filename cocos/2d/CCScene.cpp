@@ -48,6 +48,8 @@ Scene::Scene()
 {
     _ignoreAnchorPointForPosition = true;
     setAnchorPoint(Vec2(0.5f, 0.5f));
+    _cameraVisitMode = CameraVisitMode::PER_CAMERA;
+    _legacyMatrixStackEnabled = true;
     
     //create default camera
     _defaultCamera = Camera::create();
@@ -128,40 +130,57 @@ void Scene::onProjectionChanged(EventCustom* event)
 void Scene::render(Renderer* renderer)
 {
     auto director = Director::getInstance();
-    Camera* defaultCamera = nullptr;
     const auto& transform = getNodeToParentTransform();
+
+    // the default camera draws last, over the other cameras
+    Camera* defaultCamera = nullptr;
+    _renderingCameras.clear();
     for (const auto& camera : _cameras)
     {
-        Camera::_visitingCamera = camera;
-        if (Camera::_visitingCamera->getCameraFlag() == CameraFlag::DEFAULT)
-        {
-            defaultCamera = Camera::_visitingCamera;
-            continue;
-        }
-        
-        director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
-        director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, Camera::_visitingCamera->getViewProjectionMatrix());
-        
-        //visit the scene
-        visit(renderer, transform, 0);
-        renderer->render();
-        
-        director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+        if (camera->getCameraFlag() == CameraFlag::DEFAULT)
+            defaultCamera = camera;
+        else
+            _renderingCameras.push_back(camera);
     }
-    //draw with default camera
     if (defaultCamera)
+        _renderingCameras.push_back(defaultCamera);
+
+    bool legacyMatrixStack = renderer->isLegacyMatrixStackEnabled();
+    if (!_legacyMatrixStackEnabled)
+        renderer->setLegacyMatrixStackEnabled(false);
+
+    // the lists are already in use when the scene is visited by another one, e.g. by a RenderTexture
+    bool singlePass = _cameraVisitMode == CameraVisitMode::SINGLE_PASS && renderer->getCameraDrawLists() == nullptr;
+    if (singlePass)
     {
-        Camera::_visitingCamera = defaultCamera;
+        Camera::_visitingCamera = nullptr;
+        _cameraDrawLists.reset(_renderingCameras);
+        renderer->setCameraDrawLists(&_cameraDrawLists);
+        visit(renderer, transform, 0);
+        renderer->setCameraDrawLists(nullptr);
+    }
+
+    for (size_t i = 0; i < _renderingCameras.size(); ++i)
+    {
+        Camera::_visitingCamera = _renderingCameras[i];
         director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
         director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, Camera::_visitingCamera->getViewProjectionMatrix());
-        
-        //visit the scene
-        visit(renderer, transform, 0);
+
+        if (singlePass)
+        {
+            _cameraDrawLists.replay(i, renderer);
+        }
+        else
+        {
+            //visit the scene
+            visit(renderer, transform, 0);
+        }
         renderer->render();
         
         director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
     }
     Camera::_visitingCamera = nullptr;
+    renderer->setLegacyMatrixStackEnabled(legacyMatrixStack);
 }
 
 #if CC_USE_PHYSICS
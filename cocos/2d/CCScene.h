@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include <string>
 #include "2d/CCNode.h"
+#include "2d/CCCamera.h"
 
 NS_CC_BEGIN
 
@@ -61,6 +62,17 @@ Scene will create a default camera for you.
 class CC_DLL Scene : public Node
 {
 public:
+    /** How render() visits the scene for its cameras */
+    enum class CameraVisitMode
+    {
+        /** the scene is visited once per camera, and the nodes that the camera doesn't see are skipped */
+        PER_CAMERA,
+        /** the scene is visited once: the transforms are computed and the children sorted once, and the draws
+         are recorded into a list per camera, by camera mask. Each camera then draws its list.
+         The nodes whose hasCustomVisit() is true are visited once per camera with their children. */
+        SINGLE_PASS,
+    };
+
     /** creates a new Scene object */
     static Scene *create();
 
@@ -77,6 +89,22 @@ public:
     
     /** render the scene */
     void render(Renderer* renderer);
+
+    /** Sets how the scene is visited for its cameras. PER_CAMERA by default.
+     SINGLE_PASS saves the traversals when several cameras render the scene.
+     Nodes that override visit() must override hasCustomVisit() to be drawn correctly in SINGLE_PASS.
+     @since v3.3
+     */
+    void setCameraVisitMode(CameraVisitMode mode) { _cameraVisitMode = mode; }
+    CameraVisitMode getCameraVisitMode() const { return _cameraVisitMode; }
+
+    /** Disables the legacy Director model view stack while this scene is rendered, even when it is enabled
+     in the renderer. The nodes that read it must call Node::setUsesLegacyMatrixStack(true).
+     @see Renderer::setLegacyMatrixStackEnabled()
+     @since v3.3
+     */
+    void setLegacyMatrixStackEnabled(bool enabled) { _legacyMatrixStackEnabled = enabled; }
+    bool isLegacyMatrixStackEnabled() const { return _legacyMatrixStackEnabled; }
     
 CC_CONSTRUCTOR_ACCESS:
     Scene();
@@ -100,6 +128,12 @@ protected:
     EventListenerCustom*       _event;
 
     std::vector<BaseLight *> _lights;
+
+    CameraVisitMode _cameraVisitMode;
+    // the cameras in the rendering order, and their draws in SINGLE_PASS
+    std::vector<Camera*> _renderingCameras;
+    CameraDrawLists _cameraDrawLists;
+    bool _legacyMatrixStackEnabled;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "2d/CCAnimationCache.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlasCache.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCRenderer.h"
@@ -159,7 +160,14 @@ bool Sprite::initWithFile(const std::string& filename)
 {
     CCASSERT(filename.size()>0, "Invalid filename for sprite");
 
-    Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
+    Rect pageRect;
+    Texture2D *texture = DynamicAtlasCache::getInstance()->addImage(filename, &pageRect);
+    if (texture)
+    {
+        return initWithTexture(texture, pageRect);
+    }
+
+    texture = Director::getInstance()->getTextureCache()->addImage(filename);
     if (texture)
     {
         Rect rect = Rect::ZERO;
@@ -177,7 +185,14 @@ bool Sprite::initWithFile(const std::string &filename, const Rect& rect)
 {
     CCASSERT(filename.size()>0, "Invalid filename");
 
-    Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
+    Rect pageRect;
+    Texture2D *texture = DynamicAtlasCache::getInstance()->addImage(filename, &pageRect);
+    if (texture)
+    {
+        return initWithTexture(texture, Rect(pageRect.origin.x + rect.origin.x, pageRect.origin.y + rect.origin.y, rect.size.width, rect.size.height));
+    }
+
+    texture = Director::getInstance()->getTextureCache()->addImage(filename);
     if (texture)
     {
         return initWithTexture(texture, rect);
@@ -306,12 +321,15 @@ static unsigned char cc_2x2_white_image[] = {
 // MARK: texture
 void Sprite::setTexture(const std::string &filename)
 {
-    Texture2D *texture = Director::getInstance()->getTextureCache()->addImage(filename);
-    setTexture(texture);
-
     Rect rect = Rect::ZERO;
-    if (texture)
-        rect.size = texture->getContentSize();
+    Texture2D *texture = DynamicAtlasCache::getInstance()->addImage(filename, &rect);
+    if (! texture)
+    {
+        texture = Director::getInstance()->getTextureCache()->addImage(filename);
+        if (texture)
+            rect.size = texture->getContentSize();
+    }
+    setTexture(texture);
     setTextureRect(rect);
 }
 
@@ -134,6 +134,7 @@ public:
     virtual const BlendFunc& getBlendFunc() const override;
 
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
     
     using Node::addChild;
     virtual void addChild(Node * child, int zOrder, int tag) override;
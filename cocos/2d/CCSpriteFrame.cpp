@@ -27,6 +27,7 @@ THE SOFTWARE.
 
 #include "renderer/CCTextureCache.h"
 #include "2d/CCSpriteFrame.h"
+#include "2d/CCDynamicAtlasCache.h"
 #include "base/CCDirector.h"
 
 NS_CC_BEGIN
@@ -35,6 +36,13 @@ NS_CC_BEGIN
 
 SpriteFrame* SpriteFrame::create(const std::string& filename, const Rect& rect)
 {
+    Rect pageRect;
+    Texture2D *page = DynamicAtlasCache::getInstance()->addImage(filename, &pageRect);
+    if (page)
+    {
+        return createWithTexture(page, Rect(pageRect.origin.x + rect.origin.x, pageRect.origin.y + rect.origin.y, rect.size.width, rect.size.height));
+    }
+
     SpriteFrame *spriteFrame = new (std::nothrow) SpriteFrame();
     spriteFrame->initWithTextureFilename(filename, rect);
     spriteFrame->autorelease();
@@ -62,6 +70,15 @@ SpriteFrame* SpriteFrame::createWithTexture(Texture2D* texture, const Rect& rect
 
 SpriteFrame* SpriteFrame::create(const std::string& filename, const Rect& rect, bool rotated, const Vec2& offset, const Size& originalSize)
 {
+    // rect is in pixels here
+    Rect pageRect;
+    Texture2D *page = DynamicAtlasCache::getInstance()->addImage(filename, &pageRect);
+    if (page)
+    {
+        pageRect = CC_RECT_POINTS_TO_PIXELS(pageRect);
+        return createWithTexture(page, Rect(pageRect.origin.x + rect.origin.x, pageRect.origin.y + rect.origin.y, rect.size.width, rect.size.height), rotated, offset, originalSize);
+    }
+
     SpriteFrame *spriteFrame = new (std::nothrow) SpriteFrame();
     spriteFrame->initWithTextureFilename(filename, rect, rotated, offset, originalSize);
     spriteFrame->autorelease();
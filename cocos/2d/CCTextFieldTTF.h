@@ -166,6 +166,7 @@ public:
     virtual bool isSecureTextEntry();
 
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
 protected:
     //////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,160 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "2d/CCTransformTree.h"
+
+#include <algorithm>
+#include "2d/CCNode.h"
+
+NS_CC_BEGIN
+
+TransformTree::TransformTree(Node* root)
+: _root(root)
+, _built(false)
+, _updated(false)
+{
+}
+
+TransformTree::~TransformTree()
+{
+    invalidate();
+}
+
+void TransformTree::invalidate()
+{
+    // the root stays attached to its tree
+    for (size_t i = 1; i < _nodes.size(); ++i)
+    {
+        _nodes[i]->_transformTree = nullptr;
+        _nodes[i]->_transformIndex = 0;
+    }
+
+    _nodes.clear();
+    _parents.clear();
+    _subtreeEnds.clear();
+    _built = false;
+}
+
+void TransformTree::build()
+{
+    addNode(_root, -1);
+
+    size_t count = _nodes.size();
+    _flags.resize(count);
+    _worlds.resize(count);
+    _locals.resize(count);
+    for (size_t i = 1; i < count; ++i)
+    {
+        _locals[i] = _nodes[i]->getNodeToParentTransform();
+    }
+
+    _built = true;
+}
+
+void TransformTree::addNode(Node* node, int parent)
+{
+    int index = (int)_nodes.size();
+    _nodes.push_back(node);
+    _parents.push_back(parent);
+    _subtreeEnds.push_back(index + 1);
+    if (index > 0)
+    {
+        node->_transformTree = this;
+        node->_transformIndex = index;
+    }
+
+    // the nodes with a custom visit() compute the transforms of their children themselves,
+    // and the nested trees update their own nodes
+    if (index == 0 || !node->hasCustomVisit())
+    {
+        for (const auto& child : node->getChildren())
+        {
+            if (!child->isFlatTransformsEnabled())
+                addNode(child, index);
+        }
+    }
+
+    _subtreeEnds[index] = (int)_nodes.size();
+}
+
+void TransformTree::update(uint32_t rootFlags)
+{
+    if (!_built)
+    {
+        build();
+        // the local transforms were just read, the nodes may have moved while they were out of the tree
+        rootFlags |= Node::FLAGS_TRANSFORM_DIRTY;
+    }
+
+    _flags[0] = rootFlags;
+    if (rootFlags & Node::FLAGS_DIRTY_MASK)
+        _worlds[0] = _root->_modelViewTransform;
+
+    // flags and local transforms of the dirty nodes. The hidden subtrees are skipped like Node::visit() does,
+    // so they keep their dirty state until they are shown
+    int count = (int)_nodes.size();
+    for (int i = 1; i < count; )
+    {
+        Node* node = _nodes[i];
+        if (!node->_visible)
+        {
+            int end = _subtreeEnds[i];
+            std::fill(_flags.begin() + i, _flags.begin() + end, 0);
+            i = end;
+            continue;
+        }
+
+        uint32_t flags = _flags[_parents[i]];
+        node->updateNormalizedPosition(flags);
+        if (node->_transformUpdated)
+        {
+            flags |= Node::FLAGS_TRANSFORM_DIRTY;
+            _locals[i] = node->getNodeToParentTransform();
+        }
+        if (node->_contentSizeDirty)
+        {
+            flags |= Node::FLAGS_CONTENT_SIZE_DIRTY;
+        }
+        node->_transformUpdated = false;
+        node->_contentSizeDirty = false;
+
+        _flags[i] = flags;
+        ++i;
+    }
+
+    // world transforms, only reading the arrays: a parent is always before its children
+    for (int i = 1; i < count; ++i)
+    {
+        if (_flags[i] & Node::FLAGS_DIRTY_MASK)
+            Mat4::multiply(_worlds[_parents[i]], _locals[i], &_worlds[i]);
+    }
+
+    for (int i = 1; i < count; ++i)
+    {
+        if (_flags[i] & Node::FLAGS_DIRTY_MASK)
+            _nodes[i]->_modelViewTransform = _worlds[i];
+    }
+}
+
+NS_CC_END
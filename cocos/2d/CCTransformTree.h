@@ -0,0 +1,96 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CCTRANSFORM_TREE_H__
+#define __CCTRANSFORM_TREE_H__
+
+#include <vector>
+#include "math/CCMath.h"
+
+NS_CC_BEGIN
+
+class Node;
+
+/**
+ * The transforms of a node hierarchy, stored in contiguous arrays in depth-first order.
+ *
+ * Node::visit() computes the model view transform of a node when its parent or itself is dirty,
+ * reading the transforms from nodes spread across the heap. A TransformTree keeps the local and world matrices
+ * of the descendants of a root in arrays, where the children of a node follow it, and the descendants of a node
+ * are the range [index, subtree end). Each frame the root updates the dirty ranges in one pass over the arrays,
+ * and the descendants only read their transform and flags when they are visited.
+ *
+ * The arrays are rebuilt after children are added or removed anywhere in the hierarchy, so it suits large static
+ * hierarchies, like tiles or UI panels. The nodes that have a custom visit() are in the tree,
+ * but their children are not.
+ * @see Node::setFlatTransformsEnabled()
+ * @since v3.3
+ */
+class CC_DLL TransformTree
+{
+public:
+    explicit TransformTree(Node* root);
+    ~TransformTree();
+
+    /** returns the node that owns the tree */
+    Node* getRoot() const { return _root; }
+
+    /** Forgets the nodes of the tree. It is rebuilt by the next update(). */
+    void invalidate();
+
+    /** Updates the world transforms and the flags of the visible descendants of the root,
+     from the flags of the root computed by Node::processParentFlags(). */
+    void update(uint32_t rootFlags);
+
+    /** Whether the transforms are up to date for the visit in progress. The root sets it while it visits. */
+    bool isUpdated() const { return _updated; }
+    void setUpdated(bool updated) { _updated = updated; }
+
+    /** returns the visit flags of a node of the tree, the same as Node::processParentFlags() would return */
+    uint32_t getFlags(int index) const { return _flags[index]; }
+
+    /** returns the number of nodes in the tree, the root included */
+    size_t getNodeCount() const { return _nodes.size(); }
+
+protected:
+    void build();
+    void addNode(Node* node, int parent);
+
+    Node* _root;
+
+    // depth-first order, the root first
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<int> _subtreeEnds;
+    std::vector<uint32_t> _flags;
+    std::vector<Mat4> _locals;
+    std::vector<Mat4> _worlds;
+
+    bool _built;
+    bool _updated;
+};
+
+NS_CC_END
+
+#endif // __CCTRANSFORM_TREE_H__
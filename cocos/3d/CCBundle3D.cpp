@@ -162,7 +162,7 @@ void Bundle3D::clear()
 {
     if (_isBinary)
     {
-        CC_SAFE_DELETE(_binaryBuffer);
+        _binaryBuffer.clear();
         CC_SAFE_DELETE_ARRAY(_references);
     }
     else
@@ -971,7 +971,7 @@ bool Bundle3D::loadJson(const std::string& path)
 {
     clear();
 
-    Data data = FileUtils::getInstance()->getDataFromFile(path);
+    MappedData data = FileUtils::getInstance()->getMappedDataFromFile(path);
     ssize_t size = data.getSize();
 
     // json need null-terminated string.
@@ -999,11 +999,9 @@ bool Bundle3D::loadBinary(const std::string& path)
 {
     clear();
     
-    // get file data
-    CC_SAFE_DELETE(_binaryBuffer);
-    _binaryBuffer = new (std::nothrow) Data();
-    *_binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
-    if (_binaryBuffer->isNull())
+    // get file data, the reader reads it in place
+    _binaryBuffer = FileUtils::getInstance()->getMappedDataFromFile(path);
+    if (_binaryBuffer.isNull())
     {
         clear();
         CCLOG("warning: Failed to read file: %s", path.c_str());
@@ -1011,7 +1009,7 @@ bool Bundle3D::loadBinary(const std::string& path)
     }
     
     // Initialise bundle reader
-    _binaryReader.init( (char*)_binaryBuffer->getBytes(),  _binaryBuffer->getSize() );
+    _binaryReader.init( (char*)_binaryBuffer.getBytes(),  _binaryBuffer.getSize() );
     
     // Read identifier info
     char identifier[] = { 'C', '3', 'B', '\0'};
@@ -2021,7 +2019,6 @@ Bundle3D::Bundle3D()
     _path(""),
     _version(""),
     _jsonBuffer(nullptr),
-    _binaryBuffer(nullptr),
     _referenceCount(0),
     _references(nullptr),
     _isBinary(false)
@@ -30,6 +30,7 @@ cocos2d.cpp \
 2d/CCComponent.cpp \
 2d/CCComponentContainer.cpp \
 2d/CCDrawNode.cpp \
+2d/CCDynamicAtlasCache.cpp \
 2d/CCDrawingPrimitives.cpp \
 2d/CCFont.cpp \
 2d/CCFontAtlas.cpp \
@@ -43,6 +44,7 @@ cocos2d.cpp \
 2d/CCLabel.cpp \
 2d/CCLabelAtlas.cpp \
 2d/CCLabelBMFont.cpp \
+2d/CCLabelLayoutCache.cpp \
 2d/CCLabelTTF.cpp \
 2d/CCLabelTextFormatter.cpp \
 2d/CCLayer.cpp \
@@ -52,6 +54,7 @@ cocos2d.cpp \
 2d/CCMotionStreak.cpp \
 2d/CCNode.cpp \
 2d/CCNodeGrid.cpp \
+2d/CCNodePath.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
@@ -73,6 +76,7 @@ cocos2d.cpp \
 2d/CCTMXXMLParser.cpp \
 2d/CCTextFieldTTF.cpp \
 2d/CCTileMapAtlas.cpp \
+2d/CCTransformTree.cpp \
 2d/CCTransition.cpp \
 2d/CCTransitionPageTurn.cpp \
 2d/CCTransitionProgress.cpp \
@@ -81,6 +85,9 @@ cocos2d.cpp \
 3d/CCPlane.cpp \
 platform/CCGLView.cpp \
 platform/CCFileUtils.cpp \
+platform/CCMappedData.cpp \
+platform/CCResourcePack.cpp \
+platform/CCAsyncFileLoader.cpp \
 platform/CCSAXParser.cpp \
 platform/CCThread.cpp \
 platform/CCImage.cpp \
@@ -96,6 +103,7 @@ math/Vec3.cpp \
 math/Vec4.cpp \
 base/CCAsyncTaskPool.cpp \
 base/CCAutoreleasePool.cpp \
+base/CCBlockDecoder.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
 base/CCData.cpp \
@@ -124,11 +132,13 @@ base/CCProfiling.cpp \
 base/ccRandom.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
+base/CCTimerWheel.cpp \
 base/CCScriptSupport.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault.cpp \
 base/CCUserDefault-android.cpp \
 base/CCValue.cpp \
+base/CCWorkerPool.cpp \
 base/TGAlib.cpp \
 base/ZipUtils.cpp \
 base/atitc.cpp \
@@ -154,10 +164,12 @@ renderer/CCGLProgramCache.cpp \
 renderer/CCGLProgramState.cpp \
 renderer/CCGLProgramStateCache.cpp \
 renderer/CCGroupCommand.cpp \
+renderer/CCPixelConvert.cpp \
 renderer/CCQuadCommand.cpp \
 renderer/CCMeshCommand.cpp \
 renderer/CCRenderCommand.cpp \
 renderer/CCRenderer.cpp \
+renderer/CCStreamBuffer.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
@@ -0,0 +1,184 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCBlockDecoder.h"
+#include "base/CCWorkerPool.h"
+#include "math/MathUtil.h"
+
+#include <atomic>
+#include <algorithm>
+
+//#define INCLUDE_SSE2    : SSE2 block writer included
+//#define INCLUDE_NEON    : NEON block writer included
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE2
+    #include <emmintrin.h>
+#endif
+
+#if defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (__aarch64__)
+    #define INCLUDE_NEON
+    #include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+static std::atomic<bool> s_accelerated(true);
+static std::atomic<bool> s_softwareDecodingForced(false);
+
+// a band must hold enough blocks (or pixels) to pay for its hand-off to a worker
+static const int MIN_BAND_COST = 1024;
+
+typedef void (*Write4x4Function)(uint32_t* out, unsigned int stride, const uint32_t colors[4], uint32_t indices, const uint32_t alphas[16]);
+
+static void write4x4BlockScalar(uint32_t* out, unsigned int stride, const uint32_t colors[4], uint32_t indices, const uint32_t alphas[16])
+{
+    for (int y = 0; y < 4; ++y, out += stride)
+    {
+        for (int x = 0; x < 4; ++x)
+        {
+            out[x] = alphas[y * 4 + x] + colors[indices & 3];
+            indices >>= 2;
+        }
+    }
+}
+
+#ifdef INCLUDE_SSE2
+// the 2 bit indices of a row are spread over the 4 lanes, each lane keeping its own bits in place,
+// and compared with the 4 possible values shifted the same way
+static void write4x4BlockSSE2(uint32_t* out, unsigned int stride, const uint32_t colors[4], uint32_t indices, const uint32_t alphas[16])
+{
+    const __m128i fieldMask = _mm_setr_epi32(3, 3 << 2, 3 << 4, 3 << 6);
+    const __m128i index1 = _mm_setr_epi32(1, 1 << 2, 1 << 4, 1 << 6);
+    const __m128i index2 = _mm_setr_epi32(2, 2 << 2, 2 << 4, 2 << 6);
+    const __m128i color0 = _mm_set1_epi32((int)colors[0]);
+    const __m128i color1 = _mm_set1_epi32((int)colors[1]);
+    const __m128i color2 = _mm_set1_epi32((int)colors[2]);
+    const __m128i color3 = _mm_set1_epi32((int)colors[3]);
+
+    for (int y = 0; y < 4; ++y, indices >>= 8, out += stride)
+    {
+        __m128i index = _mm_and_si128(_mm_set1_epi32((int)(indices & 0xff)), fieldMask);
+        __m128i pixels = _mm_and_si128(_mm_cmpeq_epi32(index, _mm_setzero_si128()), color0);
+        pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_cmpeq_epi32(index, index1), color1));
+        pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_cmpeq_epi32(index, index2), color2));
+        pixels = _mm_or_si128(pixels, _mm_and_si128(_mm_cmpeq_epi32(index, fieldMask), color3));
+        pixels = _mm_add_epi32(pixels, _mm_loadu_si128((const __m128i*)(alphas + y * 4)));
+        _mm_storeu_si128((__m128i*)out, pixels);
+    }
+}
+#endif
+
+#ifdef INCLUDE_NEON
+static void write4x4BlockNeon(uint32_t* out, unsigned int stride, const uint32_t colors[4], uint32_t indices, const uint32_t alphas[16])
+{
+    static const uint32_t fieldMaskValues[4] = { 3, 3 << 2, 3 << 4, 3 << 6 };
+    static const uint32_t index1Values[4] = { 1, 1 << 2, 1 << 4, 1 << 6 };
+    static const uint32_t index2Values[4] = { 2, 2 << 2, 2 << 4, 2 << 6 };
+    const uint32x4_t fieldMask = vld1q_u32(fieldMaskValues);
+    const uint32x4_t index1 = vld1q_u32(index1Values);
+    const uint32x4_t index2 = vld1q_u32(index2Values);
+    const uint32x4_t color0 = vdupq_n_u32(colors[0]);
+    const uint32x4_t color1 = vdupq_n_u32(colors[1]);
+    const uint32x4_t color2 = vdupq_n_u32(colors[2]);
+    const uint32x4_t color3 = vdupq_n_u32(colors[3]);
+
+    for (int y = 0; y < 4; ++y, indices >>= 8, out += stride)
+    {
+        uint32x4_t index = vandq_u32(vdupq_n_u32(indices & 0xff), fieldMask);
+        uint32x4_t pixels = vandq_u32(vceqq_u32(index, vdupq_n_u32(0)), color0);
+        pixels = vorrq_u32(pixels, vandq_u32(vceqq_u32(index, index1), color1));
+        pixels = vorrq_u32(pixels, vandq_u32(vceqq_u32(index, index2), color2));
+        pixels = vorrq_u32(pixels, vandq_u32(vceqq_u32(index, fieldMask), color3));
+        pixels = vaddq_u32(pixels, vld1q_u32(alphas + y * 4));
+        vst1q_u32(out, pixels);
+    }
+}
+#endif
+
+static Write4x4Function selectWrite4x4Function()
+{
+#ifdef INCLUDE_SSE2
+    return write4x4BlockSSE2;
+#elif defined (INCLUDE_NEON)
+    #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) && !defined (__aarch64__)
+    // armeabi-v7a devices may lack NEON
+    if (!MathUtil::isNeon32Enabled())
+        return write4x4BlockScalar;
+    #endif
+    return write4x4BlockNeon;
+#else
+    return write4x4BlockScalar;
+#endif
+}
+
+void BlockDecoder::setAccelerated(bool accelerated)
+{
+    s_accelerated = accelerated;
+}
+
+bool BlockDecoder::isAccelerated()
+{
+    return s_accelerated;
+}
+
+void BlockDecoder::setSoftwareDecodingForced(bool forced)
+{
+    s_softwareDecodingForced = forced;
+}
+
+bool BlockDecoder::isSoftwareDecodingForced()
+{
+    return s_softwareDecodingForced;
+}
+
+void BlockDecoder::forEachRowBand(int rowCount, int costPerRow, const std::function<void(int, int)>& func)
+{
+    if (rowCount <= 0)
+        return;
+
+    int rowsPerBand = std::max(1, MIN_BAND_COST / std::max(costPerRow, 1));
+    int bandCount = (rowCount + rowsPerBand - 1) / rowsPerBand;
+    if (!s_accelerated || bandCount == 1)
+    {
+        func(0, rowCount);
+        return;
+    }
+
+    WorkerPool::getInstance()->parallelFor(bandCount, [&](ssize_t band) {
+        int firstRow = (int)band * rowsPerBand;
+        func(firstRow, std::min(firstRow + rowsPerBand, rowCount));
+    });
+}
+
+void BlockDecoder::write4x4Block(uint32_t* out, unsigned int stride, const uint32_t colors[4], uint32_t indices, const uint32_t alphas[16])
+{
+    static const Write4x4Function write4x4 = selectWrite4x4Function();
+    if (s_accelerated)
+        write4x4(out, stride, colors, indices, alphas);
+    else
+        write4x4BlockScalar(out, stride, colors, indices, alphas);
+}
+
+NS_CC_END
@@ -0,0 +1,77 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCBLOCK_DECODER_H__
+#define __CCBLOCK_DECODER_H__
+
+#include <functional>
+#include <stdint.h>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+/** @brief Settings and helpers shared by the software decoders of the compressed formats (ETC1, S3TC, ATITC and PVRTC).
+
+ Image uses these decoders when the GPU doesn't support the format of a file. By default they split the image
+ in bands of block rows decoded on the WorkerPool, and S3TC/ATITC write their blocks with SSE2 or NEON.
+ With the acceleration disabled they decode serially on the calling thread with the scalar code, which is the
+ reference: both give the same bytes.
+ */
+class CC_DLL BlockDecoder
+{
+public:
+    /** enables the parallel and SIMD decoding. Enabled by default */
+    static void setAccelerated(bool accelerated);
+    static bool isAccelerated();
+
+    /** makes Image decode the compressed formats on the cpu even when the GPU supports them.
+     Meant to check the decoders, it must be set before loading the images. Disabled by default.
+     */
+    static void setSoftwareDecodingForced(bool forced);
+    static bool isSoftwareDecodingForced();
+
+    /** Calls `func(firstRow, lastRow)` on bands covering the rows [0, rowCount).
+     When accelerated the bands run on the WorkerPool, `costPerRow` (blocks or pixels per row) sizing them,
+     otherwise func(0, rowCount) is called in place.
+     */
+    static void forEachRowBand(int rowCount, int costPerRow, const std::function<void(int, int)>& func);
+
+    /** Writes a decoded 4x4 block of RGBA8888 pixels, stride being in pixels:
+     pixel i gets `alphas[i] + colors[(indices >> 2 * i) & 3]`, i going left to right, then top to bottom.
+     */
+    static void write4x4Block(uint32_t* out, unsigned int stride, const uint32_t colors[4], uint32_t indices, const uint32_t alphas[16]);
+};
+
+// end of base group
+/// @}
+
+NS_CC_END
+
+#endif //__CCBLOCK_DECODER_H__
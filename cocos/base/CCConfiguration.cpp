@@ -44,6 +44,7 @@ Configuration::Configuration()
 , _supportsBGRA8888(false)
 , _supportsDiscardFramebuffer(false)
 , _supportsShareableVAO(false)
+, _supportsBufferStreaming(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -142,6 +143,9 @@ void Configuration::gatherGPUInfo()
     _supportsShareableVAO = checkForGLExtension("vertex_array_object");
 	_valueDict["gl.supports_vertex_array_object"] = Value(_supportsShareableVAO);
 
+    _supportsBufferStreaming = checkForGLExtension("map_buffer_range") && checkForGLExtension("GL_ARB_sync");
+    _valueDict["gl.supports_buffer_streaming"] = Value(_supportsBufferStreaming);
+
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -247,6 +251,15 @@ bool Configuration::supportsShareableVAO() const
 #endif
 }
 
+bool Configuration::supportsBufferStreaming() const
+{
+#if CC_ENABLE_VBO_STREAMING
+    return _supportsBufferStreaming;
+#else
+    return false;
+#endif
+}
+
 int Configuration::getMaxSupportDirLightInShader() const
 {
     return _maxDirLightInShader;
@@ -110,6 +110,11 @@ public:
      @since v2.0.0
      */
 	bool supportsShareableVAO() const;
+
+    /** Whether or not buffers can be streamed with glMapBufferRange and fences.
+     Always false when CC_ENABLE_VBO_STREAMING is disabled.
+     */
+    bool supportsBufferStreaming() const;
     
     /** Max support directional light in shader, for Sprite3D
      @since v3.3
@@ -162,6 +167,7 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsBufferStreaming;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
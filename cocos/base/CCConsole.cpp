@@ -60,6 +60,7 @@
 #include "platform/CCPlatformConfig.h"
 #include "base/CCConfiguration.h"
 #include "2d/CCScene.h"
+#include "2d/CCDynamicAtlasCache.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
 #include "base/base64.h"
@@ -309,7 +310,7 @@ Console::Console()
         { "projection", "Change or print the current projection. Args: [2d | 3d]", std::bind(&Console::commandProjection, this, std::placeholders::_1, std::placeholders::_2) },
         { "resolution", "Change or print the window resolution. Args: [width height resolution_policy | ]", std::bind(&Console::commandResolution, this, std::placeholders::_1, std::placeholders::_2) },
         { "scenegraph", "Print the scene graph", std::bind(&Console::commandSceneGraph, this, std::placeholders::_1, std::placeholders::_2) },
-        { "texture", "Flush or print the TextureCache info. Args: [flush | ] ", std::bind(&Console::commandTextures, this, std::placeholders::_1, std::placeholders::_2) },
+        { "texture", "Flush or print the TextureCache info, set its memory budget in MB (0: no limit), or print the dynamic atlas pages. Args: [flush | budget MB | atlas | ] ", std::bind(&Console::commandTextures, this, std::placeholders::_1, std::placeholders::_2) },
         { "director", "director commands, type -h or [director help] to list supported directives", std::bind(&Console::commandDirector, this, std::placeholders::_1, std::placeholders::_2) },
         { "touch", "simulate touch event via console, type -h or [touch help] to list supported directives", std::bind(&Console::commandTouch, this, std::placeholders::_1, std::placeholders::_2) },
         { "upload", "upload file. Args: [filename base64_encoded_data]", std::bind(&Console::commandUpload, this, std::placeholders::_1) },
@@ -610,6 +611,31 @@ void Console::commandTextures(int fd, const std::string& args)
         }
                                             );
     }
+    else if(args.compare(0, 6, "budget")== 0)
+    {
+        // without a value, only print the budget
+        bool setBudget = args.find_first_of("0123456789", 6) != std::string::npos;
+        float megabytes = (float)atof(args.c_str() + 6);
+        if (megabytes < 0)
+            megabytes = 0;
+        sched->performFunctionInCocosThread( [=](){
+            auto cache = Director::getInstance()->getTextureCache();
+            if (setBudget)
+                cache->setResidencyBudget((size_t)(megabytes * 1024 * 1024));
+            auto stats = cache->getResidencyStats();
+            mydprintf(fd, "budget %.2f MB, %.2f MB resident in %u textures\n", stats.budget / (1024.0f*1024.0f), stats.residentBytes / (1024.0f*1024.0f), stats.textureCount);
+            sendPrompt(fd);
+        }
+                                            );
+    }
+    else if(args.compare("atlas")== 0)
+    {
+        sched->performFunctionInCocosThread( [=](){
+            mydprintf(fd, "%s", DynamicAtlasCache::getInstance()->getCachedAtlasInfo().c_str());
+            sendPrompt(fd);
+        }
+                                            );
+    }
     else if(args.length()==0)
     {
         sched->performFunctionInCocosThread( [=](){
@@ -620,7 +646,7 @@ void Console::commandTextures(int fd, const std::string& args)
     }
     else
     {
-        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'flush' or nothing", args.c_str());
+        mydprintf(fd, "Unsupported argument: '%s'. Supported arguments: 'flush', 'budget MB', 'atlas' or nothing", args.c_str());
     }
 }
 
@@ -33,6 +33,8 @@ THE SOFTWARE.
 
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlasCache.h"
+#include "2d/CCLabelLayoutCache.h"
 #include "platform/CCFileUtils.h"
 
 #include "2d/CCActionManager.h"
@@ -58,6 +60,7 @@ THE SOFTWARE.
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCWorkerPool.h"
 #include "platform/CCApplication.h"
 //#include "platform/CCGLViewImpl.h"
 
@@ -671,10 +674,12 @@ void Director::purgeCachedData(void)
 {
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    LabelLayoutCache::getInstance()->removeAllLayouts();
 
     if (s_SharedDirector->getOpenGLView())
     {
         SpriteFrameCache::getInstance()->removeUnusedSpriteFrames();
+        DynamicAtlasCache::getInstance()->removeUnusedPages();
         _textureCache->removeUnusedTextures();
 
         // Note: some tests such as ActionsTest are leaking refcounted textures
@@ -1005,10 +1010,14 @@ void Director::reset()
 #endif
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
+    DynamicAtlasCache::destroyInstance();
+    LabelLayoutCache::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
+    AsyncFileLoader::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destoryInstance();
+    WorkerPool::destroyInstance();
     
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
@@ -107,6 +107,69 @@ static EventListener::ListenerID __getListenerID(Event* event)
     return ret;
 }
 
+// Returns how deep the node is in its tree and the root of that tree.
+static int __getDepthInTree(Node* node, Node** root)
+{
+    int depth = 0;
+    while (node->getParent())
+    {
+        node = node->getParent();
+        ++depth;
+    }
+    *root = node;
+    return depth;
+}
+
+// Whether `n1` is drawn after `n2` by the scene, which means its listeners receive the events first.
+// The order is the one of the scene graph traversal, grouped by global Z order. A node is drawn after
+// its children with a negative local Z order, and siblings are drawn in the order they are sorted.
+// Nodes outside of the scene, or listeners already removed (nullptr), are the lowest and equal.
+static bool __isDrawnAfter(Node* n1, Node* n2, Node* scene)
+{
+    if (n1 == n2)
+        return false;
+
+    Node* root1 = nullptr;
+    Node* root2 = nullptr;
+    int depth1 = n1 ? __getDepthInTree(n1, &root1) : 0;
+    int depth2 = n2 ? __getDepthInTree(n2, &root2) : 0;
+
+    bool isInScene1 = (n1 != nullptr && root1 == scene);
+    bool isInScene2 = (n2 != nullptr && root2 == scene);
+    if (!isInScene1 || !isInScene2)
+        return isInScene1;
+
+    if (n1->getGlobalZOrder() != n2->getGlobalZOrder())
+        return n1->getGlobalZOrder() > n2->getGlobalZOrder();
+
+    // Bring both nodes to the same depth, remembering the child each one comes from
+    Node* child1 = nullptr;
+    Node* child2 = nullptr;
+    for (; depth1 > depth2; --depth1)
+    {
+        child1 = n1;
+        n1 = n1->getParent();
+    }
+    for (; depth2 > depth1; --depth2)
+    {
+        child2 = n2;
+        n2 = n2->getParent();
+    }
+
+    // One node is an ancestor of the other
+    if (n1 == n2)
+    {
+        return child1 ? child1->getLocalZOrder() >= 0 : child2->getLocalZOrder() < 0;
+    }
+
+    while (n1->getParent() != n2->getParent())
+    {
+        n1 = n1->getParent();
+        n2 = n2->getParent();
+    }
+    return nodeComparisonLess(n2, n1);
+}
+
 EventDispatcher::EventListenerVector::EventListenerVector() :
  _fixedListeners(nullptr),
  _sceneGraphListeners(nullptr),
@@ -201,7 +264,7 @@ void EventDispatcher::EventListenerVector::clear()
 EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
+, _sceneGraphRoot(nullptr)
 {
     _toAddedListeners.reserve(50);
     
@@ -220,73 +283,6 @@ EventDispatcher::~EventDispatcher()
     removeAllEventListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
-{    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
-    {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
-    }
-    else
-    {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-    }
-    
-    if (isRootNode)
-    {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
-        {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
-        }
-        
-        _globalZOrderNodeMap.clear();
-    }
-}
-
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
 {
     auto listenerIter = _nodeListenersMap.find(target);
@@ -297,6 +293,9 @@ void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/
         {
             l->setPaused(true);
         }
+        
+        // The node is leaving the scene, so its listeners have to move behind the ones in the scene.
+        _dirtyNodes.insert(target);
     }
 
     for (auto& listener : _toAddedListeners)
@@ -353,9 +352,14 @@ void EventDispatcher::removeEventListenersForTarget(Node* target, bool recursive
 {
     // Ensure the node is removed from these immediately also.
     // Don't want any dangling pointers or the possibility of dealing with deleted objects..
-    _nodePriorityMap.erase(target);
     _dirtyNodes.erase(target);
 
+    // Node::~Node() calls it: a scene allocated later at the same address is a different root
+    if (target == _sceneGraphRoot)
+    {
+        _sceneGraphRoot = nullptr;
+    }
+
     auto listenerIter = _nodeListenersMap.find(target);
     if (listenerIter != _nodeListenersMap.end())
     {
@@ -472,6 +476,7 @@ void EventDispatcher::forceAddEventListener(EventListener* listener)
     if (listener->getFixedPriority() == 0)
     {
         setDirty(listenerID, DirtyFlag::SCENE_GRAPH_PRIORITY);
+        _sceneGraphListenersToPlace[listenerID].insert(listener);
         
         auto node = listener->getAssociatedNode();
         CCASSERT(node != nullptr, "Invalid scene graph priority!");
@@ -542,13 +547,6 @@ void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
         }
     }
     
-    // Check the node priority map
-    for (const auto & keyValuePair : _nodePriorityMap)
-    {
-        CCASSERT(keyValuePair.first != node,
-                 "Node should have no event listeners registered for it upon destruction!");
-    }
-    
     // Check the to be added list
     for (EventListener * listener : _toAddedListeners)
     {
@@ -663,6 +661,7 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (iter->second->empty())
         {
             _priorityDirtyFlagMap.erase(listener->getListenerID());
+            _sceneGraphListenersToPlace.erase(listener->getListenerID());
             auto list = iter->second;
             iter = _listenerMap.erase(iter);
             CC_SAFE_DELETE(list);
@@ -1102,6 +1101,7 @@ void EventDispatcher::updateListeners(Event* event)
         if (iter->second->empty())
         {
             _priorityDirtyFlagMap.erase(iter->first);
+            _sceneGraphListenersToPlace.erase(iter->first);
             delete iter->second;
             iter = _listenerMap.erase(iter);
         }
@@ -1133,6 +1133,7 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
                 for (auto& l : *iter->second)
                 {
                     setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    _sceneGraphListenersToPlace[l->getListenerID()].insert(l);
                 }
             }
         }
@@ -1141,8 +1142,29 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
+void EventDispatcher::setDirtyForAllSceneGraphListeners()
+{
+    for (const auto& e : _listenerMap)
+    {
+        auto sceneGraphListeners = e.second->getSceneGraphPriorityListeners();
+        if (sceneGraphListeners == nullptr || sceneGraphListeners->empty())
+            continue;
+        
+        setDirty(e.first, DirtyFlag::SCENE_GRAPH_PRIORITY);
+        _sceneGraphListenersToPlace[e.first].insert(sceneGraphListeners->begin(), sceneGraphListeners->end());
+    }
+}
+
 void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
 {
+    // The listeners were placed against another scene, all of them have to be placed again
+    auto runningScene = Director::getInstance()->getRunningScene();
+    if (runningScene && runningScene != _sceneGraphRoot)
+    {
+        _sceneGraphRoot = runningScene;
+        setDirtyForAllSceneGraphListeners();
+    }
+    
     DirtyFlag dirtyFlag = DirtyFlag::NONE;
     
     auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
@@ -1187,22 +1209,60 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
+    auto toPlaceIter = _sceneGraphListenersToPlace.find(listenerID);
+    if (toPlaceIter == _sceneGraphListenersToPlace.end())
+        return;
     
-    // After sort: priority < 0, > 0
-    std::sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
-    });
+    // Take out the queued listeners and the removed ones, the others are still sorted.
+    // The queued pointers are only compared, since some of them may have been released already.
+    const auto& toPlaceSet = toPlaceIter->second;
+    std::vector<EventListener*> toPlace;
+    size_t sortedCount = 0;
+    for (size_t i = 0, count = sceneGraphListeners->size(); i < count; ++i)
+    {
+        auto l = (*sceneGraphListeners)[i];
+        if (l->getAssociatedNode() == nullptr || toPlaceSet.find(l) != toPlaceSet.end())
+        {
+            toPlace.push_back(l);
+        }
+        else
+        {
+            (*sceneGraphListeners)[sortedCount++] = l;
+        }
+    }
+    _sceneGraphListenersToPlace.erase(toPlaceIter);
+    
+    if (toPlace.empty())
+        return;
+    
+    // After sort: the listener of the node drawn last is the first
+    auto isDrawnAfter = [rootNode](const EventListener* l1, const EventListener* l2) {
+        return __isDrawnAfter(l1->getAssociatedNode(), l2->getAssociatedNode(), rootNode);
+    };
+    std::stable_sort(toPlace.begin(), toPlace.end(), isDrawnAfter);
+    
+    // Merge them back, looking up the position of each one with a binary search.
+    // The result is copied into the same storage, an event may be dispatched to these listeners right now.
+    std::vector<EventListener*> merged;
+    merged.reserve(sceneGraphListeners->size());
+    auto first = sceneGraphListeners->begin();
+    auto last = first + sortedCount;
+    for (const auto& l : toPlace)
+    {
+        auto pos = std::upper_bound(first, last, l, isDrawnAfter);
+        merged.insert(merged.end(), first, pos);
+        merged.push_back(l);
+        first = pos;
+    }
+    merged.insert(merged.end(), first, last);
+    std::copy(merged.begin(), merged.end(), sceneGraphListeners->begin());
     
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        log("listener priority: node ([%s]%p), global z (%f), local z (%d)", l->_node ? typeid(*l->_node).name() : "", l->_node,
+            l->_node ? l->_node->getGlobalZOrder() : 0.0f, l->_node ? l->_node->getLocalZOrder() : 0);
     }
 #endif
 }
@@ -1296,6 +1356,7 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
         _priorityDirtyFlagMap.erase(listenerID);
+        _sceneGraphListenersToPlace.erase(listenerID);
         
         if (!_inDispatch)
         {
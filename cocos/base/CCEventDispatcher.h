@@ -28,6 +28,7 @@
 #include <functional>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <set>
 
@@ -206,7 +207,9 @@ protected:
     /** Sort event listener */
     void sortEventListeners(const EventListener::ListenerID& listenerID);
     
-    /** Sorts the listeners of specified type by scene graph priority */
+    /** Sorts the listeners of specified type by scene graph priority.
+     *  Only the listeners queued in `_sceneGraphListenersToPlace` are moved, the others keep their order.
+     */
     void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
     
     /** Sorts the listeners of specified type by fixed priority */
@@ -242,8 +245,8 @@ protected:
     /** Sets the dirty flag for a specified listener ID */
     void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** Queues all the scene graph priority listeners to be placed again, it's called when the running scene changes */
+    void setDirtyForAllSceneGraphListeners();
     
     /** Listeners map */
     std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
@@ -254,11 +257,13 @@ protected:
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
+    /** key: Listener ID, value: The scene graph priority listeners whose nodes changed their draw order */
+    std::unordered_map<EventListener::ListenerID, std::unordered_set<EventListener*>> _sceneGraphListenersToPlace;
     
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** The scene the scene graph priority listeners were sorted against, only compared and never dereferenced.
+     *  It is reset when the scene is destroyed, so that another scene at the same address is seen as a new one.
+     */
+    Node* _sceneGraphRoot;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -272,8 +277,6 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
     std::set<std::string> _internalCustomListenerIDs;
 };
 
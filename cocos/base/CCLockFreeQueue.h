@@ -0,0 +1,131 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_LOCK_FREE_QUEUE_H__
+#define __CC_LOCK_FREE_QUEUE_H__
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+/** @brief An unbounded multi-producer single-consumer queue.
+
+ `push()` can be called from any thread and never blocks: it only swaps the head of the list.
+ `pop()` and `empty()` must be called from a single thread, the consumer.
+ Each value is stored inline in its node, so pushing a std::function costs one allocation,
+ and none more for callables small enough for the std::function's own buffer.
+ A value whose node can't be allocated is dropped, logged, and `push()` returns false.
+ */
+template <class T>
+class LockFreeQueue
+{
+public:
+    LockFreeQueue()
+    {
+        _stub = new (std::nothrow) Node();
+        CCASSERT(_stub, "LockFreeQueue: can't allocate the stub node");
+        _head.store(_stub, std::memory_order_relaxed);
+    }
+
+    ~LockFreeQueue()
+    {
+        T value;
+        while (pop(value))
+        {
+        }
+        delete _stub;
+    }
+
+    /** Any thread. Returns false if the value was dropped because its node couldn't be allocated */
+    bool push(const T& value)
+    {
+        return pushNode(new (std::nothrow) Node(value));
+    }
+
+    bool push(T&& value)
+    {
+        return pushNode(new (std::nothrow) Node(std::move(value)));
+    }
+
+    /** moves the oldest value into `value`. Returns false if the queue is empty. Consumer only */
+    bool pop(T& value)
+    {
+        Node* next = _stub->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+
+        // the popped node becomes the new stub
+        value = std::move(next->value);
+        delete _stub;
+        _stub = next;
+        return true;
+    }
+
+    /** Consumer only. A value being pushed may not be visible yet */
+    bool empty() const
+    {
+        return _stub->next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    struct Node
+    {
+        Node() : next(nullptr) {}
+        explicit Node(const T& v) : next(nullptr), value(v) {}
+        explicit Node(T&& v) : next(nullptr), value(std::move(v)) {}
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    bool pushNode(Node* node)
+    {
+        if (node == nullptr)
+        {
+            CCLOG("cocos2d: LockFreeQueue: out of memory, a value was dropped");
+            return false;
+        }
+
+        Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+        // until this store, the consumer sees the queue ending at prev
+        prev->next.store(node, std::memory_order_release);
+        return true;
+    }
+
+    LockFreeQueue(const LockFreeQueue&);
+    LockFreeQueue& operator=(const LockFreeQueue&);
+
+    std::atomic<Node*> _head;   // last pushed node, shared by the producers
+    Node* _stub;                // last popped node, owned by the consumer
+};
+
+NS_CC_END
+
+#endif // __CC_LOCK_FREE_QUEUE_H__
@@ -26,12 +26,15 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "base/CCScheduler.h"
+#include "base/CCTimerWheel.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
+#include <chrono>
+
 NS_CC_BEGIN
 
 // data structures
@@ -79,6 +82,13 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _start(0)
+, _due(0)
+, _pausedTime(0)
+, _entry(nullptr)
+, _wheelList(nullptr)
+, _wheelPrev(nullptr)
+, _wheelNext(nullptr)
 {
 }
 
@@ -146,6 +156,30 @@ void Timer::update(float dt)
 }
 
 
+void Timer::updateAt(double now)
+{
+    // same steps as update(), with _elapsed computed from the time the timer was started or last triggered
+    _elapsed = (float)(now - _start);
+    trigger();
+
+    if (_useDelay)
+    {
+        // the time elapsed after the delay counts for the first interval
+        _start += _delay;
+        _useDelay = false;
+    }
+    else
+    {
+        _start = now;
+    }
+    _timesExecuted += 1;
+
+    if (!_runForever && _timesExecuted > _repeat)
+    {    //unschedule timer
+        cancel();
+    }
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -255,9 +289,11 @@ Scheduler::Scheduler(void)
 , _currentTarget(nullptr)
 , _currentTargetSalvaged(false)
 , _updateHashLocked(false)
+, _timerTime(0)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performFunctionsTimeBudget(0)
 {
     // I don't expect to have more than 30 functions to all per frame
     _functionsToPerform.reserve(30);
@@ -275,6 +311,67 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+void Scheduler::addTimer(_hashSelectorEntry *element, Timer *timer)
+{
+    timer->_entry = element;
+    ccArrayAppendObject(element->timers, timer);
+
+    // it starts counting at the next update. Paused timers start when they are resumed
+    if (! element->paused)
+    {
+        _startingTimers.pushBack(timer);
+    }
+}
+
+void Scheduler::insertTimer(Timer *timer)
+{
+    // pauseTimers() already saved the time it was paused at
+    if (timer->_entry->paused)
+    {
+        TimerList::remove(timer);
+        return;
+    }
+
+    timer->_due = timer->getDueTime();
+    _timerWheel.insert(timer);
+}
+
+void Scheduler::pauseTimers(_hashSelectorEntry *element)
+{
+    // paused timers are out of the wheel, their time is shifted when they are resumed
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+        TimerList::remove(timer);
+        timer->_pausedTime = _timerTime;
+    }
+}
+
+void Scheduler::resumeTimers(_hashSelectorEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = static_cast<Timer*>(element->timers->arr[i]);
+
+        // the timer being triggered is inserted again once it returns
+        if (timer == element->currentTimer)
+        {
+            continue;
+        }
+
+        if (timer->_elapsed == -1)
+        {
+            TimerList::remove(timer);
+            _startingTimers.pushBack(timer);
+        }
+        else
+        {
+            timer->_start += _timerTime - timer->_pausedTime;
+            insertTimer(timer);
+        }
+    }
+}
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
@@ -317,6 +414,10 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                if (timer->_elapsed != -1 && timer != element->currentTimer)
+                {
+                    insertTimer(timer);
+                }
                 return;
             }        
         }
@@ -325,7 +426,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -357,6 +458,7 @@ void Scheduler::unschedule(const std::string &key, void *target)
                     element->currentTimerSalvaged = true;
                 }
 
+                TimerList::remove(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -653,6 +755,10 @@ void Scheduler::unscheduleAllForTarget(void *target)
             element->currentTimer->retain();
             element->currentTimerSalvaged = true;
         }
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            TimerList::remove(static_cast<Timer*>(element->timers->arr[i]));
+        }
         ccArrayRemoveAllObjects(element->timers);
 
         if (_currentTarget == element)
@@ -699,9 +805,10 @@ void Scheduler::resumeTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
@@ -721,9 +828,10 @@ void Scheduler::pauseTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && !element->paused)
     {
         element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
@@ -772,7 +880,11 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        if (!element->paused)
+        {
+            element->paused = true;
+            pauseTimers(element);
+        }
         idsWithSelectors.insert(element->target);
     }
 
@@ -820,11 +932,7 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
 {
-    _performMutex.lock();
-
-    _functionsToPerform.push_back(function);
-
-    _performMutex.unlock();
+    _postedFunctions.push(function);
 }
 
 // main loop
@@ -871,37 +979,41 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+    // Trigger the custom selectors that are due. Paused targets have no timer in the wheel
+    _timerTime += dt;
+    _timerWheel.advance(_timerTime, _dueTimers);
+
+    for (Timer *timer = _dueTimers.popFront(); timer != nullptr; timer = _dueTimers.popFront())
     {
+        // the interval may have been changed after the timer was inserted
+        if (timer->getDueTime() > _timerTime)
+        {
+            insertTimer(timer);
+            continue;
+        }
+
+        tHashTimerEntry *elt = timer->_entry;
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
-
-                elt->currentTimer->update(dt);
+        elt->currentTimer = timer;
+        elt->currentTimerSalvaged = false;
 
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+        timer->updateAt(_timerTime);
 
-                elt->currentTimer = nullptr;
-            }
+        if (elt->currentTimerSalvaged)
+        {
+            // The currentTimer told the remove itself. To prevent the timer from
+            // accidentally deallocating itself before finishing its step, we retained
+            // it. Now that step is done, it's safe to release it.
+            timer->release();
+        }
+        else
+        {
+            insertTimer(timer);
         }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+        elt->currentTimer = nullptr;
 
         // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
         if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
@@ -909,6 +1021,16 @@ void Scheduler::update(float dt)
             removeHashElement(_currentTarget);
         }
     }
+    _currentTarget = nullptr;
+
+    // the timers scheduled since the last update start counting now
+    for (Timer *timer = _startingTimers.popFront(); timer != nullptr; timer = _startingTimers.popFront())
+    {
+        timer->_elapsed = 0;
+        timer->_timesExecuted = 0;
+        timer->_start = _timerTime;
+        insertTimer(timer);
+    }
 
     // delete all updates that are marked for deletion
     // updates with priority < 0
@@ -967,18 +1089,25 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
+    // Only the functions posted before this point are called: the ones posted by these functions wait for the next frame.
+    std::function<void()> function;
+    while (_postedFunctions.pop(function)) {
+        _functionsToPerform.push_back(std::move(function));
+    }
+
     if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for( const auto &function : temp ) {
-            function();
+        // _functionsToPerform is only changed here, the functions can't add to it while they are called
+        auto budget = std::chrono::duration<float>(_performFunctionsTimeBudget);
+        auto start = std::chrono::steady_clock::now();
+        size_t called = 0;
+        while (called < _functionsToPerform.size()) {
+            _functionsToPerform[called++]();
+            if (_performFunctionsTimeBudget > 0 && std::chrono::steady_clock::now() - start >= budget)
+                break;
         }
-        
+
+        // over budget: the remaining functions are the first ones called in the next frame
+        _functionsToPerform.erase(_functionsToPerform.begin(), _functionsToPerform.begin() + called);
     }
 }
 
@@ -1018,6 +1147,10 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                if (timer->_elapsed != -1 && timer != element->currentTimer)
+                {
+                    insertTimer(timer);
+                }
                 return;
             }
         }
@@ -1026,7 +1159,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -1098,6 +1231,7 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
                     element->currentTimerSalvaged = true;
                 }
                 
+                TimerList::remove(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
                 // update timerIndex in case we are in tick:, looping over the actions
@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include "base/CCRef.h"
 #include "base/CCVector.h"
 #include "base/uthash.h"
+#include "base/CCLockFreeQueue.h"
+#include "base/CCTimerWheel.h"
 
 NS_CC_BEGIN
 
@@ -44,6 +46,8 @@ NS_CC_BEGIN
  */
 
 class Scheduler;
+struct TimerList;
+struct _hashSelectorEntry;
 
 typedef std::function<void(float)> ccSchedulerFunc;
 //
@@ -70,6 +74,14 @@ public:
     void update(float dt);
     
 protected:
+    friend class Scheduler;
+    friend class TimerWheel;
+    friend struct TimerList;
+
+    // triggers the timer at the scheduler time `now`, when it is due in the timing wheel
+    void updateAt(double now);
+    // scheduler time when the timer is due
+    double getDueTime() const { return _start + (_useDelay ? _delay : _interval); }
     
     Scheduler* _scheduler; // weak ref
     float _elapsed;
@@ -79,6 +91,15 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+
+    // used by the timing wheel of the Scheduler
+    double _start;                  // scheduler time from which _elapsed is counted
+    double _due;                    // scheduler time when the timer must be triggered
+    double _pausedTime;             // scheduler time when the target was paused
+    struct _hashSelectorEntry* _entry;  // entry of the target in the Scheduler
+    TimerList* _wheelList;          // list the timer is linked in, if any
+    Timer* _wheelPrev;
+    Timer* _wheelNext;
 };
 
 
@@ -146,7 +167,6 @@ private:
 // Scheduler
 //
 struct _listEntry;
-struct _hashSelectorEntry;
 struct _hashUpdateEntry;
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -363,6 +383,13 @@ public:
      @since v3.0
      */
     void performFunctionInCocosThread( const std::function<void()> &function);
+
+    /** Sets the time, in seconds, that the functions passed to `performFunctionInCocosThread()` can use in a frame.
+     The functions left when the time is over are called in the next frames, in the same order.
+     At least one function is called per frame. 0 means no limit, which is the default.
+     */
+    void setPerformFunctionsTimeBudget(float seconds) { _performFunctionsTimeBudget = seconds; }
+    float getPerformFunctionsTimeBudget() const { return _performFunctionsTimeBudget; }
     
     /////////////////////////////////////
     
@@ -431,6 +458,13 @@ protected:
     void removeHashElement(struct _hashSelectorEntry *element);
     void removeUpdateFromHash(struct _listEntry *entry);
 
+    // timing wheel specific
+
+    void addTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void insertTimer(Timer *timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+
     // update specific
 
     void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
@@ -453,14 +487,22 @@ protected:
     bool _currentTargetSalvaged;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
+
+    // Only the timers that are due are touched by update(): they are kept in a timing wheel, ordered by due time.
+    // _timerTime is the scaled time elapsed in update(), the time the due times are based on.
+    TimerWheel _timerWheel;
+    TimerList _startingTimers;   // timers scheduled since the last update
+    TimerList _dueTimers;        // timers being triggered by update()
+    double _timerTime;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
     
-    // Used for "perform Function"
+    // Used for "perform Function": posted by any thread, then moved to _functionsToPerform by the cocos thread
+    LockFreeQueue<std::function<void()>> _postedFunctions;
     std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    float _performFunctionsTimeBudget;
 };
 
 // end of global group
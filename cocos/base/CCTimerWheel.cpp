@@ -0,0 +1,163 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "base/CCTimerWheel.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+// TimerList
+
+void TimerList::pushBack(Timer* timer)
+{
+    timer->_wheelList = this;
+    timer->_wheelNext = nullptr;
+    timer->_wheelPrev = tail;
+    if (tail)
+        tail->_wheelNext = timer;
+    else
+        head = timer;
+    tail = timer;
+}
+
+Timer* TimerList::popFront()
+{
+    Timer* timer = head;
+    if (timer)
+        remove(timer);
+    return timer;
+}
+
+void TimerList::remove(Timer* timer)
+{
+    TimerList* list = timer->_wheelList;
+    if (list == nullptr)
+        return;
+
+    if (timer->_wheelPrev)
+        timer->_wheelPrev->_wheelNext = timer->_wheelNext;
+    else
+        list->head = timer->_wheelNext;
+
+    if (timer->_wheelNext)
+        timer->_wheelNext->_wheelPrev = timer->_wheelPrev;
+    else
+        list->tail = timer->_wheelPrev;
+
+    timer->_wheelList = nullptr;
+    timer->_wheelPrev = timer->_wheelNext = nullptr;
+}
+
+// TimerWheel
+
+// 120 ticks per second: a frame usually covers 2 ticks at 60 fps
+const double TimerWheel::RESOLUTION = 1.0 / 120.0;
+
+TimerWheel::TimerWheel()
+: _currentTick(0)
+{
+}
+
+void TimerWheel::insert(Timer* timer)
+{
+    TimerList::remove(timer);
+
+    double due = timer->_due > 0 ? timer->_due : 0;
+    uint64_t tick = (uint64_t)(due / RESOLUTION);
+    // late timers are due at the current tick
+    if (tick < _currentTick)
+        tick = _currentTick;
+
+    uint64_t delta = tick - _currentTick;
+    if (delta < ROOT_SIZE)
+    {
+        _root[tick & (ROOT_SIZE - 1)].pushBack(timer);
+        return;
+    }
+
+    for (int level = 0; level < LEVELS; ++level)
+    {
+        int shift = ROOT_BITS + level * LEVEL_BITS;
+        if (delta < ((uint64_t)1 << (shift + LEVEL_BITS)) || level == LEVELS - 1)
+        {
+            // timers beyond the last level are kept in its last slot, and inserted again when it is cascaded
+            if (delta >= ((uint64_t)1 << (shift + LEVEL_BITS)))
+                tick = _currentTick + ((uint64_t)1 << (shift + LEVEL_BITS)) - 1;
+
+            _levels[level][(tick >> shift) & (LEVEL_SIZE - 1)].pushBack(timer);
+            return;
+        }
+    }
+}
+
+void TimerWheel::cascade(TimerList& slot)
+{
+    // the list is detached first, since the timers can go back into the same slot
+    TimerList timers = slot;
+    slot.head = slot.tail = nullptr;
+    for (Timer* timer = timers.head; timer; timer = timer->_wheelNext)
+        timer->_wheelList = &timers;
+
+    while (Timer* timer = timers.popFront())
+        insert(timer);
+}
+
+void TimerWheel::advance(double now, TimerList& due)
+{
+    uint64_t lastTick = (uint64_t)((now > 0 ? now : 0) / RESOLUTION);
+
+    for (; _currentTick <= lastTick; ++_currentTick)
+    {
+        // when the root wraps, the next slots of the upper levels are spread in the levels below them
+        if ((_currentTick & (ROOT_SIZE - 1)) == 0)
+        {
+            int level = 0;
+            while (level < LEVELS - 1 && ((_currentTick >> (ROOT_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1)) == 0)
+                ++level;
+            for (; level >= 0; --level)
+                cascade(_levels[level][(_currentTick >> (ROOT_BITS + level * LEVEL_BITS)) & (LEVEL_SIZE - 1)]);
+        }
+
+        TimerList timers = _root[_currentTick & (ROOT_SIZE - 1)];
+        _root[_currentTick & (ROOT_SIZE - 1)].head = _root[_currentTick & (ROOT_SIZE - 1)].tail = nullptr;
+        for (Timer* timer = timers.head; timer; timer = timer->_wheelNext)
+            timer->_wheelList = &timers;
+
+        while (Timer* timer = timers.popFront())
+        {
+            // the ticks before the last one are over, all their timers are due
+            if (_currentTick < lastTick || timer->_due <= now)
+                due.pushBack(timer);
+            else
+                insert(timer);
+        }
+
+        // the last tick isn't over, it will be checked again by the next advance
+        if (_currentTick == lastTick)
+            break;
+    }
+}
+
+NS_CC_END
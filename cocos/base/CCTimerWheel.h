@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_TIMER_WHEEL_H__
+#define __CC_TIMER_WHEEL_H__
+
+#include <stdint.h>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Timer;
+
+/** intrusive list of timers, linked by Timer::_wheelPrev and Timer::_wheelNext */
+struct CC_DLL TimerList
+{
+    TimerList() : head(nullptr), tail(nullptr) {}
+
+    bool empty() const { return head == nullptr; }
+
+    /** appends a timer that isn't in any list */
+    void pushBack(Timer* timer);
+    /** removes and returns the first timer, or nullptr */
+    Timer* popFront();
+
+    /** removes a timer from the list it is in, if any */
+    static void remove(Timer* timer);
+
+    Timer* head;
+    Timer* tail;
+};
+
+/** @brief Hierarchical timing wheel used by the Scheduler for the timers with an interval or a delay.
+
+ The time is cut in ticks of `RESOLUTION` seconds. The first level has a slot per tick for the next 256 ticks,
+ and each of the 3 other levels has 64 slots, each one 64 times longer than a slot of the level below.
+ When a slot of the first level wraps, the matching slot of the level above is cascaded down.
+ Inserting or removing a timer is O(1), and advancing the wheel only touches the timers that are due,
+ plus the cascaded ones, whatever the number of timers.
+ */
+class CC_DLL TimerWheel
+{
+public:
+    /** length of a tick, in seconds */
+    static const double RESOLUTION;
+
+    TimerWheel();
+
+    /** Inserts a timer to be due at its `_due` time. It is removed from its previous list first. */
+    void insert(Timer* timer);
+
+    /** Moves the timers whose due time is <= `now` to `due`. Each timer is checked against `now`,
+     so `now` doesn't have to be a multiple of RESOLUTION.
+     */
+    void advance(double now, TimerList& due);
+
+private:
+    enum
+    {
+        ROOT_BITS = 8,
+        LEVEL_BITS = 6,
+        LEVELS = 3,
+        ROOT_SIZE = 1 << ROOT_BITS,
+        LEVEL_SIZE = 1 << LEVEL_BITS,
+    };
+
+    // re-inserts the timers of a slot, they will land in a lower level
+    void cascade(TimerList& slot);
+
+    TimerList _root[ROOT_SIZE];
+    TimerList _levels[LEVELS][LEVEL_SIZE];
+    // first tick that wasn't entirely processed
+    uint64_t _currentTick;
+};
+
+NS_CC_END
+
+#endif // __CC_TIMER_WHEEL_H__
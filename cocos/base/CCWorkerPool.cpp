@@ -0,0 +1,183 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCWorkerPool.h"
+#include "base/ccMacros.h"
+
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+NS_CC_BEGIN
+
+// state shared by the threads running the same parallelFor().
+// It is ref counted since a late worker may pick its task after the caller returned.
+struct ParallelForJob
+{
+    std::function<void(ssize_t)> func;
+    ssize_t count;
+    std::atomic<ssize_t> next;
+    std::atomic<ssize_t> done;
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+
+    void run()
+    {
+        ssize_t processed = 0;
+        for (ssize_t index = next++; index < count; index = next++)
+        {
+            func(index);
+            ++processed;
+        }
+
+        if (processed > 0 && (done += processed) == count)
+        {
+            std::lock_guard<std::mutex> lock(doneMutex);
+            doneCondition.notify_all();
+        }
+    }
+};
+
+WorkerPool* WorkerPool::s_sharedWorkerPool = nullptr;
+
+WorkerPool* WorkerPool::getInstance()
+{
+    if (s_sharedWorkerPool == nullptr)
+    {
+        int cores = (int)std::thread::hardware_concurrency();
+        s_sharedWorkerPool = new (std::nothrow) WorkerPool(std::max(cores - 1, 1));
+    }
+    return s_sharedWorkerPool;
+}
+
+void WorkerPool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedWorkerPool);
+}
+
+WorkerPool::WorkerPool(int workerCount)
+: _stop(false)
+{
+    _workers.reserve(workerCount);
+    _workerIndices.reserve(workerCount);
+
+    // the workers only read the indices once they run a task, which is queued under the same lock
+    std::lock_guard<std::mutex> lock(_tasksMutex);
+    for (int i = 0; i < workerCount; ++i)
+    {
+        _workers.push_back(std::thread(&WorkerPool::workerLoop, this));
+        _workerIndices[_workers.back().get_id()] = i + 1;
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        _stop = true;
+    }
+    _tasksCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+int WorkerPool::getCurrentThreadIndex() const
+{
+    auto it = _workerIndices.find(std::this_thread::get_id());
+    return it != _workerIndices.end() ? it->second : 0;
+}
+
+void WorkerPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_tasksMutex);
+            _tasksCondition.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+            if (_stop && _tasks.empty())
+                return;
+
+            task = std::move(_tasks.front());
+            _tasks.pop_front();
+        }
+
+        task();
+    }
+}
+
+void WorkerPool::enqueue(const std::function<void()>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        CCASSERT(!_stop, "WorkerPool already stopped");
+        _tasks.push_back(task);
+    }
+    _tasksCondition.notify_one();
+}
+
+void WorkerPool::parallelFor(ssize_t count, const std::function<void(ssize_t)>& func)
+{
+    if (count <= 0)
+        return;
+
+    // nested jobs, or jobs that don't need splitting, are run in place
+    if (count == 1 || _workers.empty() || isWorkerThread())
+    {
+        for (ssize_t index = 0; index < count; ++index)
+            func(index);
+        return;
+    }
+
+    auto job = std::make_shared<ParallelForJob>();
+    job->func = func;
+    job->count = count;
+    job->next = 0;
+    job->done = 0;
+
+    ssize_t helpers = std::min((ssize_t)_workers.size(), count - 1);
+    {
+        std::lock_guard<std::mutex> lock(_tasksMutex);
+        for (ssize_t i = 0; i < helpers; ++i)
+        {
+            // front, since the caller is blocked until the job is over
+            _tasks.push_front([job]{ job->run(); });
+        }
+    }
+    if (helpers == (ssize_t)_workers.size())
+        _tasksCondition.notify_all();
+    else
+        for (ssize_t i = 0; i < helpers; ++i)
+            _tasksCondition.notify_one();
+
+    job->run();
+
+    std::unique_lock<std::mutex> lock(job->doneMutex);
+    job->doneCondition.wait(lock, [&job]{ return job->done == job->count; });
+}
+
+NS_CC_END
@@ -0,0 +1,100 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCWORKER_POOL_H_
+#define __CCWORKER_POOL_H_
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <unordered_map>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup base
+ * @{
+ */
+
+/** @brief A pool of worker threads used to split frame work (visiting, particles, decoding...) across the cores.
+
+ Unlike AsyncTaskPool, the tasks don't report back to the cocos thread: `parallelFor()` blocks the caller
+ until every index was processed, and the caller helps processing them while it waits.
+ */
+class CC_DLL WorkerPool
+{
+public:
+    /** returns the shared pool. It is created with one worker less than the number of cores */
+    static WorkerPool* getInstance();
+
+    /** destroys the shared pool, waiting for the running tasks */
+    static void destroyInstance();
+
+    /** returns the number of worker threads, not counting the threads that call parallelFor() */
+    int getWorkerCount() const { return (int)_workers.size(); }
+
+    /** returns 1..getWorkerCount() when called from a worker thread of this pool, 0 otherwise */
+    int getCurrentThreadIndex() const;
+
+    /** returns true when called from a worker thread of this pool */
+    bool isWorkerThread() const { return getCurrentThreadIndex() != 0; }
+
+    /** Calls `func(index)` for every index in [0, count) and returns once all of them are done.
+     The indices are spread over the worker threads and the calling thread.
+     Nested calls from a worker thread are run serially on that worker.
+     */
+    void parallelFor(ssize_t count, const std::function<void(ssize_t)>& func);
+
+    /** queues a task to be run on a worker thread. It doesn't wait for the task */
+    void enqueue(const std::function<void()>& task);
+
+CC_CONSTRUCTOR_ACCESS:
+    explicit WorkerPool(int workerCount);
+    ~WorkerPool();
+
+protected:
+    void workerLoop();
+
+    std::vector<std::thread> _workers;
+    // index of each worker by thread id, filled before any task is queued and read only afterwards
+    std::unordered_map<std::thread::id, int> _workerIndices;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _tasksMutex;
+    std::condition_variable _tasksCondition;
+    bool _stop;
+
+    static WorkerPool* s_sharedWorkerPool;
+};
+
+// end of base group
+/// @}
+
+NS_CC_END
+
+#endif //__CCWORKER_POOL_H_
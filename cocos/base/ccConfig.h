@@ -181,6 +181,22 @@ Only valid for cocos2d-mac. Not supported on cocos2d-ios.
 #endif
 
 
+/** @def CC_ENABLE_VBO_STREAMING
+ If enabled, the Renderer can stream the batched quads and triangles into ring buffers
+ (see Renderer::setBufferStreamingEnabled) instead of respecifying its VBOs at every flush.
+ It needs glMapBufferRange and fences, so it is only available with desktop OpenGL.
+ 
+ To disable it set it to 0. Enabled by default on Windows and Linux.
+ */
+#ifndef CC_ENABLE_VBO_STREAMING
+    #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        #define CC_ENABLE_VBO_STREAMING 1
+    #else
+        #define CC_ENABLE_VBO_STREAMING 0
+    #endif
+#endif
+
+
 /** @def CC_USE_LA88_LABELS
  If enabled, it will use LA88 (Luminance Alpha 16-bit textures) for LabelTTF objects.
  If it is disabled, it will use A8 (Alpha 8-bit textures).
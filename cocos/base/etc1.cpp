@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "base/etc1.h"
+#include "base/CCBlockDecoder.h"
 
 #include <string.h>
 
@@ -571,41 +572,46 @@ int etc1_decode_image(const etc1_byte* pIn, etc1_byte* pOut,
     if (pixelSize < 2 || pixelSize > 3) {
         return -1;
     }
-    etc1_byte block[ETC1_DECODED_BLOCK_SIZE];
-
     etc1_uint32 encodedWidth = (width + 3) & ~3;
     etc1_uint32 encodedHeight = (height + 3) & ~3;
 
-    for (etc1_uint32 y = 0; y < encodedHeight; y += 4) {
-        etc1_uint32 yEnd = height - y;
-        if (yEnd > 4) {
-            yEnd = 4;
-        }
-        for (etc1_uint32 x = 0; x < encodedWidth; x += 4) {
-            etc1_uint32 xEnd = width - x;
-            if (xEnd > 4) {
-                xEnd = 4;
+    // the block rows are decoded in bands, each band starting at its own blocks
+    etc1_uint32 blocksPerRow = encodedWidth / 4;
+    cocos2d::BlockDecoder::forEachRowBand(encodedHeight / 4, blocksPerRow, [=](int firstRow, int lastRow) {
+        etc1_byte block[ETC1_DECODED_BLOCK_SIZE];
+        const etc1_byte* pBlocks = pIn + firstRow * blocksPerRow * ETC1_ENCODED_BLOCK_SIZE;
+
+        for (etc1_uint32 y = firstRow * 4; y < (etc1_uint32) lastRow * 4; y += 4) {
+            etc1_uint32 yEnd = height - y;
+            if (yEnd > 4) {
+                yEnd = 4;
             }
-            etc1_decode_block(pIn, block);
-            pIn += ETC1_ENCODED_BLOCK_SIZE;
-            for (etc1_uint32 cy = 0; cy < yEnd; cy++) {
-                const etc1_byte* q = block + (cy * 4) * 3;
-                etc1_byte* p = pOut + pixelSize * x + stride * (y + cy);
-                if (pixelSize == 3) {
-                    memcpy(p, q, xEnd * 3);
-                } else {
-                    for (etc1_uint32 cx = 0; cx < xEnd; cx++) {
-                        etc1_byte r = *q++;
-                        etc1_byte g = *q++;
-                        etc1_byte b = *q++;
-                        etc1_uint32 pixel = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
-                        *p++ = (etc1_byte) pixel;
-                        *p++ = (etc1_byte) (pixel >> 8);
+            for (etc1_uint32 x = 0; x < encodedWidth; x += 4) {
+                etc1_uint32 xEnd = width - x;
+                if (xEnd > 4) {
+                    xEnd = 4;
+                }
+                etc1_decode_block(pBlocks, block);
+                pBlocks += ETC1_ENCODED_BLOCK_SIZE;
+                for (etc1_uint32 cy = 0; cy < yEnd; cy++) {
+                    const etc1_byte* q = block + (cy * 4) * 3;
+                    etc1_byte* p = pOut + pixelSize * x + stride * (y + cy);
+                    if (pixelSize == 3) {
+                        memcpy(p, q, xEnd * 3);
+                    } else {
+                        for (etc1_uint32 cx = 0; cx < xEnd; cx++) {
+                            etc1_byte r = *q++;
+                            etc1_byte g = *q++;
+                            etc1_byte b = *q++;
+                            etc1_uint32 pixel = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);
+                            *p++ = (etc1_byte) pixel;
+                            *p++ = (etc1_byte) (pixel >> 8);
+                        }
                     }
                 }
             }
         }
-    }
+    });
     return 0;
 }
 
@@ -19,6 +19,7 @@
 #include <assert.h>
 #include <cstdint>
 #include "pvr.h"
+#include "base/CCBlockDecoder.h"
 
 #define PVRT_MIN(a,b)            (((a) < (b)) ? (a) : (b))
 #define PVRT_MAX(a,b)            (((a) > (b)) ? (a) : (b))
@@ -551,21 +552,24 @@ static U32 TwiddleUV(U32 YSize, U32 XSize, U32 YPos, U32 XPos)
 }
 
 /*!***********************************************************************
- @Function		Decompress
+ @Function		PVRDecompressRows
  @Input			pCompressedData The PVRTC texture data to decompress
  @Input			Do2BitMode Signifies whether the data is PVRTC2 or PVRTC4
  @Input			XDim X dimension of the texture
  @Input			YDim Y dimension of the texture
  @Input			AssumeImageTiles Assume the texture data tiles
+ @Input			FirstRow LastRow The rows [FirstRow, LastRow) to decompress
  @Modified		pResultImage The decompressed texture data
- @Description	Decompresses PVRTC to RGBA 8888
+ @Description	Decompresses rows of a PVRTC texture to RGBA 8888
  *************************************************************************/
-static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
+static void PVRDecompressRows(AMTC_BLOCK_STRUCT *pCompressedData,
                        const bool Do2bitMode,
                        const int XDim,
                        const int YDim,
                        const int AssumeImageTiles,
-                       unsigned char* pResultImage)
+                       unsigned char* pResultImage,
+                       const int FirstRow,
+                       const int LastRow)
 {
 	int x, y;
 	int i, j;
@@ -614,7 +618,7 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
      
      Note that this is a hideously inefficient way to do this!
      */
-	for(y = 0; y < YDim; y++)
+	for(y = FirstRow; y < LastRow; y++)
 	{
 		for(x = 0; x < XDim; x++)
 		{
@@ -708,6 +712,29 @@ static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
 	}
 }
 
+/*!***********************************************************************
+ @Function		PVRDecompress
+ @Input			pCompressedData The PVRTC texture data to decompress
+ @Input			Do2BitMode Signifies whether the data is PVRTC2 or PVRTC4
+ @Input			XDim X dimension of the texture
+ @Input			YDim Y dimension of the texture
+ @Input			AssumeImageTiles Assume the texture data tiles
+ @Modified		pResultImage The decompressed texture data
+ @Description	Decompresses PVRTC to RGBA 8888. Each pixel only reads the
+ compressed data, so bands of rows are decompressed in parallel.
+ *************************************************************************/
+static void PVRDecompress(AMTC_BLOCK_STRUCT *pCompressedData,
+                       const bool Do2bitMode,
+                       const int XDim,
+                       const int YDim,
+                       const int AssumeImageTiles,
+                       unsigned char* pResultImage)
+{
+	cocos2d::BlockDecoder::forEachRowBand(YDim, XDim, [=](int FirstRow, int LastRow) {
+		PVRDecompressRows(pCompressedData, Do2bitMode, XDim, YDim, AssumeImageTiles, pResultImage, FirstRow, LastRow);
+	});
+}
+
 /*****************************************************************************
  End of file (pvr.cpp)
  *****************************************************************************/
\ No newline at end of file
@@ -23,6 +23,9 @@
  ****************************************************************************/
 
 #include "s3tc.h"
+#include "base/CCBlockDecoder.h"
+
+#include <algorithm>
 
 //Decode S3TC encode block to 4x4 RGB32 pixels
 static void s3tc_decode_block(uint8_t **blockData,
@@ -35,7 +38,7 @@ static void s3tc_decode_block(uint8_t **blockData,
     unsigned int colorValue0 = 0 , colorValue1 = 0, initAlpha = (!oneBitAlphaFlag * 255u) << 24;
     unsigned int rb0 = 0, rb1 = 0, rb2 = 0, rb3 = 0, g0 = 0, g1 = 0, g2 = 0, g3 = 0;
     
-    uint32_t colors[4], pixelsIndex = 0;
+    uint32_t colors[4], alphas[16], pixelsIndex = 0;
     
     /* load the two color values*/
     memcpy((void *)&colorValue0, *blockData, 2);
@@ -109,74 +112,92 @@ static void s3tc_decode_block(uint8_t **blockData,
         // read the flowing 48bit indices (16*3)
         alpha >>= 16;
         
-        for (int y = 0; y < 4; ++y)
+        for (int i = 0; i < 16; ++i)
         {
-            for (int x = 0; x < 4; ++x)
-            {
-                decodeBlockData[x] = (alphaArray[alpha & 5] << 24) + colors[pixelsIndex & 3];
-                pixelsIndex >>= 2;
-                alpha >>= 3;
-            }
-            decodeBlockData += stride;
+            alphas[i] = alphaArray[alpha & 5] << 24;
+            alpha >>= 3;
         }
     } //if (dxt5 == comFlag)
     else
     { //dxt1 dxt3 use explicit alpha
-        for (int y = 0; y < 4; ++y)
+        for (int i = 0; i < 16; ++i)
         {
-            for (int x = 0; x < 4; ++x)
-            {
-                initAlpha   = (static_cast<int>(alpha) & 0x0f) << 28;
-                initAlpha   += initAlpha >> 4;
-                decodeBlockData[x] = initAlpha + colors[pixelsIndex & 3];
-                pixelsIndex >>= 2;
-                alpha       >>= 4;
-            }
-            decodeBlockData += stride;
+            initAlpha   = (static_cast<int>(alpha) & 0x0f) << 28;
+            initAlpha   += initAlpha >> 4;
+            alphas[i]   = initAlpha;
+            alpha       >>= 4;
         }
     }
+    
+    cocos2d::BlockDecoder::write4x4Block(decodeBlockData, stride, colors, pixelsIndex, alphas);
 }
 
 //Decode S3TC encode data to RGB32
-void s3tc_decode(uint8_t *encodeData,             //in_data
+void s3tc_decode(uint8_t *encodeBlocks,           //in_data
                  uint8_t *decodeData,             //out_data
                  const int pixelsWidth,
                  const int pixelsHeight,
                  S3TCDecodeFlag decodeFlag)
 {
-    uint32_t *decodeBlockData = (uint32_t *)decodeData;
-    for (int block_y = 0; block_y < pixelsHeight / 4; ++block_y, decodeBlockData += 3 * pixelsWidth)   //stride = 3*width
-    {
-        for(int block_x = 0; block_x < pixelsWidth / 4; ++block_x, decodeBlockData += 4)            //skip 4 pixels
+    // the block rows are independent: they are decoded in bands, each band starting at its own blocks.
+    // The encoded rows include the blocks crossing the right and bottom edges.
+    const int blocksPerRow = (pixelsWidth + 3) / 4;
+    const int blockRows = (pixelsHeight + 3) / 4;
+    const int blockSize = (S3TCDecodeFlag::DXT1 == decodeFlag) ? 8 : 16;
+    
+    cocos2d::BlockDecoder::forEachRowBand(blockRows, blocksPerRow, [=](int firstRow, int lastRow) {
+        uint8_t *encodeData = encodeBlocks + firstRow * blocksPerRow * blockSize;
+        for (int block_y = firstRow; block_y < lastRow; ++block_y)
         {
-            uint64_t blockAlpha = 0;
-            
-            switch (decodeFlag)
+            // each block row starts at its own pixel row, so the output doesn't depend on the bands
+            uint32_t *decodeRowData = (uint32_t *)decodeData + block_y * 4 * pixelsWidth;
+            const int blockHeight = std::min(4, pixelsHeight - block_y * 4);
+            for (int block_x = 0; block_x < blocksPerRow; ++block_x)
             {
-                case S3TCDecodeFlag::DXT1:
-                {
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 0, 0LL, S3TCDecodeFlag::DXT1);
-                }
-                    break;
-                case S3TCDecodeFlag::DXT3:
+                // a block crossing an edge is decoded aside, then only its pixels inside the image are copied
+                const int blockWidth = std::min(4, pixelsWidth - block_x * 4);
+                const bool clipped = (blockWidth < 4 || blockHeight < 4);
+                uint32_t clippedBlock[16];
+                uint32_t *decodeBlockData = clipped ? clippedBlock : decodeRowData + block_x * 4;
+                const int stride = clipped ? 4 : pixelsWidth;
+                
+                uint64_t blockAlpha = 0;
+            
+                switch (decodeFlag)
                 {
-                    memcpy((void *)&blockAlpha, encodeData, 8);
-                    encodeData += 8;
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT3);
-                }
-                    break;
-                case S3TCDecodeFlag::DXT5:
+                    case S3TCDecodeFlag::DXT1:
+                    {
+                        s3tc_decode_block(&encodeData, decodeBlockData, stride, 0, 0LL, S3TCDecodeFlag::DXT1);
+                    }
+                        break;
+                    case S3TCDecodeFlag::DXT3:
+                    {
+                        memcpy((void *)&blockAlpha, encodeData, 8);
+                        encodeData += 8;
+                        s3tc_decode_block(&encodeData, decodeBlockData, stride, 1, blockAlpha, S3TCDecodeFlag::DXT3);
+                    }
+                        break;
+                    case S3TCDecodeFlag::DXT5:
+                    {
+                        memcpy((void *)&blockAlpha, encodeData, 8);
+                        encodeData += 8;
+                        s3tc_decode_block(&encodeData, decodeBlockData, stride, 1, blockAlpha, S3TCDecodeFlag::DXT5);
+                    }
+                        break;
+                    default:
+                        break;
+                }//switch
+                
+                if (clipped)
                 {
-                    memcpy((void *)&blockAlpha, encodeData, 8);
-                    encodeData += 8;
-                    s3tc_decode_block(&encodeData, decodeBlockData, pixelsWidth, 1, blockAlpha, S3TCDecodeFlag::DXT5);
+                    for (int y = 0; y < blockHeight; ++y)
+                    {
+                        memcpy(decodeRowData + y * pixelsWidth + block_x * 4, clippedBlock + y * 4, blockWidth * sizeof(uint32_t));
+                    }
                 }
-                    break;
-                default:
-                    break;
-            }//switch
-        }//for block_x
-    }//for block_y
+            }//for block_x
+        }//for block_y
+    });
 }
 
 
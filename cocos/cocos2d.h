@@ -107,7 +107,9 @@ THE SOFTWARE.
 
 // 2d nodes
 #include "2d/CCNode.h"
+#include "2d/CCNodePath.h"
 #include "2d/CCProtectedNode.h"
+#include "2d/CCTransformTree.h"
 #include "2d/CCAtlasNode.h"
 #include "2d/CCDrawingPrimitives.h"
 #include "2d/CCDrawNode.h"
@@ -115,6 +117,7 @@ THE SOFTWARE.
 #include "2d/CCLabelTTF.h"
 #include "2d/CCLabelBMFont.h"
 #include "2d/CCLabel.h"
+#include "2d/CCLabelLayoutCache.h"
 #include "2d/CCFontFNT.h"
 #include "2d/CCLayer.h"
 #include "2d/CCScene.h"
@@ -151,6 +154,7 @@ THE SOFTWARE.
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCStreamBuffer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
@@ -178,6 +182,9 @@ THE SOFTWARE.
 #include "platform/CCImage.h"
 #include "platform/CCSAXParser.h"
 #include "platform/CCThread.h"
+#include "platform/CCMappedData.h"
+#include "platform/CCResourcePack.h"
+#include "platform/CCAsyncFileLoader.h"
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
 
@@ -248,6 +255,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCDynamicAtlasCache.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
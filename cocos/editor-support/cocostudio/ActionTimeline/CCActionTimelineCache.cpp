@@ -427,7 +427,7 @@ ActionTimeline* ActionTimelineCache::loadAnimationActionWithFlatBuffersFile(cons
     
     CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
     
-    Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
+    MappedData buf = FileUtils::getInstance()->getMappedDataFromFile(fullPath);
     
     auto csparsebinary = GetCSParseBinary(buf.getBytes());
     
@@ -780,7 +780,8 @@ Node* CSLoader::nodeWithFlatBuffersFile(const std::string &fileName)
     
     CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
     
-    Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
+    // the flat buffers are read in place, the nodes are created before buf is released
+    MappedData buf = FileUtils::getInstance()->getMappedDataFromFile(fullPath);
     
     auto csparsebinary = GetCSParseBinary(buf.getBytes());
     
@@ -258,6 +258,14 @@ DataReaderHelper::DataReaderHelper()
 
 DataReaderHelper::~DataReaderHelper()
 {
+    for (auto& fileRead : _fileReads)
+    {
+        FileUtils::getInstance()->cancelAsyncRead(fileRead.second);
+        CC_SAFE_RELEASE(fileRead.first->target);
+        delete fileRead.first;
+    }
+    _fileReads.clear();
+
     need_quit = true;
 
 	_sleepCondition.notify_one();
@@ -412,27 +420,6 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     size_t startPos = filePathStr.find_last_of(".");
     std::string str = &filePathStr[startPos];
 
-    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
-
-    bool isbinaryfilesrc = str==".csb";
-    std::string filereadmode("r");
-    if (isbinaryfilesrc) {
-        filereadmode += "b";
-    }
-    ssize_t size;
-    // FIXME: fileContent is being leaked
-    
-    _dataReaderHelper->_getFileMutex.lock();
-    unsigned char *pBytes = FileUtils::getInstance()->getFileData(fullPath.c_str() , filereadmode.c_str(), &size);
-    _dataReaderHelper->_getFileMutex.unlock();
-    
-	Data bytecpy;
-    bytecpy.copy(pBytes, size);
-    data->fileContent = std::string((const char*)bytecpy.getBytes(), size);
-
-    // fix memory leak for v3.3
-    free(pBytes);
-    
     if (str == ".xml")
     {
         data->configType = DragonBone_XML;
@@ -441,18 +428,26 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     {
         data->configType = CocoStudio_JSON;
     }
-    else if(isbinaryfilesrc)
+    else if(str == ".csb")
     {
         data->configType = CocoStudio_Binary;
     }
 
+    // the file is read by the I/O threads of FileUtils, then parsed by the loading thread
+    _fileReads[data] = FileUtils::getInstance()->getDataFromFileAsync(filePath, [this, data](const Data& content) {
+        _fileReads.erase(data);
+        if (!content.isNull())
+        {
+            data->fileContent = std::string((const char*)content.getBytes(), content.getSize());
+        }
 
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+        // add async struct into queue
+        _asyncStructQueueMutex.lock();
+        _asyncStructQueue->push(data);
+        _asyncStructQueueMutex.unlock();
 
-    _sleepCondition.notify_one();
+        _sleepCondition.notify_one();
+    });
 }
 
 void DataReaderHelper::addDataAsyncCallBack(float dt)
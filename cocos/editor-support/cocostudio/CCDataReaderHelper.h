@@ -36,6 +36,7 @@ THE SOFTWARE.
 
 #include <string>
 #include <queue>
+#include <unordered_map>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
@@ -222,6 +223,9 @@ protected:
 	std::queue<AsyncStruct *> *_asyncStructQueue;
 	std::queue<DataInfo *>   *_dataQueue;
 
+    // the files read by the I/O threads of FileUtils, before the loading thread parses them
+    std::unordered_map<AsyncStruct *, cocos2d::AsyncFileLoader::RequestId> _fileReads;
+
     static std::vector<std::string> _configFileList;
 
     static DataReaderHelper *_dataReaderHelper;
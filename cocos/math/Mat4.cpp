@@ -893,6 +893,13 @@ void Mat4::subtract(const Mat4& m1, const Mat4& m2, Mat4* dst)
 #endif
 }
 
+void Mat4::transformPoints(const Vec3* src, Vec3* dst, size_t count, size_t stride) const
+{
+    GP_ASSERT(src && dst);
+    GP_ASSERT(stride >= sizeof(Vec3));
+    MathUtil::transformVec3Array(m, &src->x, &dst->x, count, stride);
+}
+
 void Mat4::transformVector(Vec3* vector) const
 {
     GP_ASSERT(vector);
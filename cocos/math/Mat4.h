@@ -774,6 +774,19 @@ public:
      */
     inline void transformPoint(const Vec3& point, Vec3* dst) const { GP_ASSERT(dst); transformVector(point.x, point.y, point.z, 1.0f, dst); }
 
+    /**
+     * Transforms an array of points by this matrix.
+     *
+     * The points are `stride` bytes apart, so the positions of interleaved vertices
+     * (e.g. V3F_C4B_T2F) can be transformed in place. Only x, y and z of each point are written.
+     *
+     * @param src The first point to transform.
+     * @param dst Where to store the first transformed point. It can be equal to src.
+     * @param count The number of points to transform.
+     * @param stride The distance in bytes between two consecutive points.
+     */
+    void transformPoints(const Vec3* src, Vec3* dst, size_t count, size_t stride = sizeof(Vec3)) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
@@ -31,6 +31,7 @@ This file was modified to fit the cocos2d-x project
 //#define INCLUDE_NEON64    : neon 64 code included
 //#define USE_SSE           : SSE code used
 //#define INCLUDE_SSE       : SSE code included
+//#define INCLUDE_AVX2      : AVX2 code included, used when the cpu supports it
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
     #if defined (__arm64__)
@@ -56,6 +57,13 @@ This file was modified to fit the cocos2d-x project
 #if defined (__SSE__)
 #define USE_SSE
 #define INCLUDE_SSE
+    #if defined (__AVX2__) && defined (__FMA__)
+        #define INCLUDE_AVX2
+        #define MATHUTIL_TARGET_AVX2
+    #elif (defined (__clang__) || (defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) && (defined (__x86_64__) || defined (__i386__))
+        #define INCLUDE_AVX2
+        #define MATHUTIL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
 #endif
 
 #ifdef INCLUDE_NEON32
@@ -68,6 +76,7 @@ This file was modified to fit the cocos2d-x project
 
 #ifdef INCLUDE_SSE
 #include "MathUtilSSE.inl"
+#include "MathUtilSSEBatch.inl"
 #endif
 
 #include "MathUtil.inl"
@@ -270,4 +279,36 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+#ifdef INCLUDE_SSE
+typedef void (*TransformVec3ArrayFunc)(const float* m, const float* src, float* dst, size_t count, size_t stride);
+
+static TransformVec3ArrayFunc selectTransformVec3Array()
+{
+#if defined (INCLUDE_AVX2) && !(defined (__AVX2__) && defined (__FMA__))
+    if (MathUtilSSEBatch::isAVX2Supported())
+        return &MathUtilSSEBatch::transformVec3ArrayAVX2;
+#elif defined (INCLUDE_AVX2)
+    return &MathUtilSSEBatch::transformVec3ArrayAVX2;
+#endif
+    return &MathUtilSSEBatch::transformVec3Array;
+}
+#endif
+
+void MathUtil::transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+#ifdef USE_SSE
+    static TransformVec3ArrayFunc transformFunc = selectTransformVec3Array();
+    transformFunc(m, src, dst, count, stride);
+#elif defined (USE_NEON32)
+    MathUtilNeon::transformVec3Array(m, src, dst, count, stride);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVec3Array(m, src, dst, count, stride);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVec3Array(m, src, dst, count, stride);
+    else MathUtilC::transformVec3Array(m, src, dst, count, stride);
+#else
+    MathUtilC::transformVec3Array(m, src, dst, count, stride);
+#endif
+}
+
 NS_CC_MATH_END
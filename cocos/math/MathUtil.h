@@ -111,6 +111,8 @@ private:
 
     static void crossVec3(const float* v1, const float* v2, float* dst);
 
+    static void transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride);
+
 };
 
 NS_CC_MATH_END
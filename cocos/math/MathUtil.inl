@@ -42,6 +42,8 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +217,24 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    const char* in = reinterpret_cast<const char*>(src);
+    char* out = reinterpret_cast<char*>(dst);
+    for (size_t i = 0; i < count; ++i, in += stride, out += stride)
+    {
+        const float* v = reinterpret_cast<const float*>(in);
+        float* d = reinterpret_cast<float*>(out);
+        
+        // Handle case where src == dst.
+        float x = v[0] * m[0] + v[1] * m[4] + v[2] * m[8] + m[12];
+        float y = v[0] * m[1] + v[1] * m[5] + v[2] * m[9] + m[13];
+        float z = v[0] * m[2] + v[1] * m[6] + v[2] * m[10] + m[14];
+        
+        d[0] = x;
+        d[1] = y;
+        d[2] = z;
+    }
+}
+
 NS_CC_MATH_END
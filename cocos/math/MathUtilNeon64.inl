@@ -18,6 +18,8 @@
  This file was modified to fit the cocos2d-x project
  */
 
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon64
@@ -42,6 +44,8 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride);
 };
 
 inline void MathUtilNeon64::addMatrix(const float* m, float scalar, float* dst)
@@ -262,4 +266,28 @@ inline void MathUtilNeon64::crossVec3(const float* v1, const float* v2, float* d
     );
 }
 
+inline void MathUtilNeon64::transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    const float32x4_t col0 = vld1q_f32(m);
+    const float32x4_t col1 = vld1q_f32(m + 4);
+    const float32x4_t col2 = vld1q_f32(m + 8);
+    const float32x4_t col3 = vld1q_f32(m + 12);
+    
+    const char* in = reinterpret_cast<const char*>(src);
+    char* out = reinterpret_cast<char*>(dst);
+    for (size_t i = 0; i < count; ++i, in += stride, out += stride)
+    {
+        const float* v = reinterpret_cast<const float*>(in);
+        float* d = reinterpret_cast<float*>(out);
+        
+        float32x4_t r = vmlaq_n_f32(col3, col0, v[0]);
+        r = vmlaq_n_f32(r, col1, v[1]);
+        r = vmlaq_n_f32(r, col2, v[2]);
+        
+        // only x, y, z are written, w would overwrite the next vertex attribute
+        vst1_f32(d, vget_low_f32(r));
+        vst1q_lane_f32(d + 2, r, 2);
+    }
+}
+
 NS_CC_MATH_END
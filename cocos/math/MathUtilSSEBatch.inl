@@ -0,0 +1,139 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+// Batch kernels of the SSE builds. The AVX2 one is compiled for AVX2 and FMA even when the build doesn't enable them,
+// and is only called when the cpu supports them (INCLUDE_AVX2 and MATHUTIL_TARGET_AVX2 are set by the includer).
+
+#include <immintrin.h>
+#ifdef INCLUDE_AVX2
+#include <cpuid.h>
+#endif
+
+NS_CC_MATH_BEGIN
+
+class MathUtilSSEBatch
+{
+public:
+    inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride);
+
+#ifdef INCLUDE_AVX2
+    inline static bool isAVX2Supported();
+
+    MATHUTIL_TARGET_AVX2 inline static void transformVec3ArrayAVX2(const float* m, const float* src, float* dst, size_t count, size_t stride);
+#endif
+
+private:
+    // only x, y, z are written, w would overwrite the next vertex attribute
+    inline static void storeVec3(float* dst, __m128 v);
+};
+
+inline void MathUtilSSEBatch::storeVec3(float* dst, __m128 v)
+{
+    _mm_storel_pi(reinterpret_cast<__m64*>(dst), v);
+    _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+}
+
+inline void MathUtilSSEBatch::transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_loadu_ps(m + 12);
+
+    const char* in = reinterpret_cast<const char*>(src);
+    char* out = reinterpret_cast<char*>(dst);
+    for (size_t i = 0; i < count; ++i, in += stride, out += stride)
+    {
+        const float* v = reinterpret_cast<const float*>(in);
+
+        // same order of the additions as MathUtilC
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(v[0])), _mm_mul_ps(col1, _mm_set1_ps(v[1]))),
+                                         _mm_mul_ps(col2, _mm_set1_ps(v[2]))), col3);
+        storeVec3(reinterpret_cast<float*>(out), r);
+    }
+}
+
+#ifdef INCLUDE_AVX2
+
+inline bool MathUtilSSEBatch::isAVX2Supported()
+{
+    // __builtin_cpu_supports() also checks that the OS saves the AVX registers
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("avx2"))
+        return false;
+
+    unsigned int eax, ebx, ecx, edx;
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_FMA) != 0;
+}
+
+MATHUTIL_TARGET_AVX2 inline void MathUtilSSEBatch::transformVec3ArrayAVX2(const float* m, const float* src, float* dst, size_t count, size_t stride)
+{
+    // the matrix in both 128 bits lanes, one point per lane
+    const __m256 col0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m));
+    const __m256 col1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 4));
+    const __m256 col2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 8));
+    const __m256 col3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m + 12));
+
+    const char* in = reinterpret_cast<const char*>(src);
+    char* out = reinterpret_cast<char*>(dst);
+    size_t i = 0;
+
+    // four points per iteration, in two registers
+    for ( ; i + 3 < count; i += 4, in += stride * 4, out += stride * 4)
+    {
+        const float* v0 = reinterpret_cast<const float*>(in);
+        const float* v1 = reinterpret_cast<const float*>(in + stride);
+        const float* v2 = reinterpret_cast<const float*>(in + stride * 2);
+        const float* v3 = reinterpret_cast<const float*>(in + stride * 3);
+
+        __m256 x01 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_broadcast_ss(v0)), _mm_broadcast_ss(v1), 1);
+        __m256 y01 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_broadcast_ss(v0 + 1)), _mm_broadcast_ss(v1 + 1), 1);
+        __m256 z01 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_broadcast_ss(v0 + 2)), _mm_broadcast_ss(v1 + 2), 1);
+        __m256 x23 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_broadcast_ss(v2)), _mm_broadcast_ss(v3), 1);
+        __m256 y23 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_broadcast_ss(v2 + 1)), _mm_broadcast_ss(v3 + 1), 1);
+        __m256 z23 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_broadcast_ss(v2 + 2)), _mm_broadcast_ss(v3 + 2), 1);
+
+        __m256 r01 = _mm256_fmadd_ps(col0, x01, _mm256_fmadd_ps(col1, y01, _mm256_fmadd_ps(col2, z01, col3)));
+        __m256 r23 = _mm256_fmadd_ps(col0, x23, _mm256_fmadd_ps(col1, y23, _mm256_fmadd_ps(col2, z23, col3)));
+
+        // the points are read before being written, src may be dst
+        storeVec3(reinterpret_cast<float*>(out), _mm256_castps256_ps128(r01));
+        storeVec3(reinterpret_cast<float*>(out + stride), _mm256_extractf128_ps(r01, 1));
+        storeVec3(reinterpret_cast<float*>(out + stride * 2), _mm256_castps256_ps128(r23));
+        storeVec3(reinterpret_cast<float*>(out + stride * 3), _mm256_extractf128_ps(r23, 1));
+    }
+
+    for ( ; i < count; ++i, in += stride, out += stride)
+    {
+        const float* v = reinterpret_cast<const float*>(in);
+        __m128 r = _mm_fmadd_ps(_mm256_castps256_ps128(col0), _mm_broadcast_ss(v),
+                                _mm_fmadd_ps(_mm256_castps256_ps128(col1), _mm_broadcast_ss(v + 1),
+                                             _mm_fmadd_ps(_mm256_castps256_ps128(col2), _mm_broadcast_ss(v + 2), _mm256_castps256_ps128(col3))));
+        storeVec3(reinterpret_cast<float*>(out), r);
+    }
+}
+
+#endif
+
+NS_CC_MATH_END
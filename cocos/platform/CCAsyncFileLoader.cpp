@@ -0,0 +1,296 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "platform/CCAsyncFileLoader.h"
+
+#include <algorithm>
+
+#include "base/ccMacros.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+AsyncFileLoader* AsyncFileLoader::s_sharedAsyncFileLoader = nullptr;
+
+AsyncFileLoader* AsyncFileLoader::getInstance()
+{
+    if (s_sharedAsyncFileLoader == nullptr)
+    {
+        s_sharedAsyncFileLoader = new (std::nothrow) AsyncFileLoader();
+    }
+    return s_sharedAsyncFileLoader;
+}
+
+void AsyncFileLoader::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedAsyncFileLoader);
+}
+
+AsyncFileLoader::AsyncFileLoader()
+: _nextRequestId(1)
+, _threadCount(2)
+, _stop(false)
+{
+}
+
+AsyncFileLoader::~AsyncFileLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+        for (auto& queue : _queues)
+        {
+            queue.clear();
+        }
+        // the reads already posted to the scheduler find no waiter
+        for (auto& iter : _requests)
+        {
+            iter.second->waiters.clear();
+        }
+        _requests.clear();
+        _waiting.clear();
+    }
+    _condition.notify_all();
+
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void AsyncFileLoader::setThreadCount(int count)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _threadCount = std::max(count, 1);
+
+    // the running threads are kept, more are started when some are already running
+    while (!_threads.empty() && (int)_threads.size() < _threadCount)
+    {
+        _threads.push_back(std::thread(&AsyncFileLoader::threadLoop, this));
+    }
+}
+
+AsyncFileLoader::RequestId AsyncFileLoader::readData(const std::string& fullPath, const std::function<void(const Data&)>& callback, Priority priority)
+{
+    return enqueue(Kind::DATA, fullPath, [callback](const Request& request){ callback(request.data); }, priority);
+}
+
+AsyncFileLoader::RequestId AsyncFileLoader::readString(const std::string& fullPath, const std::function<void(const std::string&)>& callback, Priority priority)
+{
+    return enqueue(Kind::STRING, fullPath, [callback](const Request& request){ callback(request.string); }, priority);
+}
+
+AsyncFileLoader::RequestId AsyncFileLoader::readValueMap(const std::string& fullPath, const std::function<void(const ValueMap&)>& callback, Priority priority)
+{
+    return enqueue(Kind::VALUE_MAP, fullPath, [callback](const Request& request){ callback(request.valueMap); }, priority);
+}
+
+AsyncFileLoader::RequestId AsyncFileLoader::readMappedData(const std::string& fullPath, const std::function<void(const MappedData&)>& callback, Priority priority)
+{
+    return enqueue(Kind::MAPPED_DATA, fullPath, [callback](const Request& request){ callback(request.mappedData); }, priority);
+}
+
+AsyncFileLoader::RequestId AsyncFileLoader::enqueue(Kind kind, const std::string& fullPath, const std::function<void(const Request&)>& callback, Priority priority)
+{
+    std::string key;
+    key.reserve(fullPath.length() + 1);
+    key += (char)('0' + (int)kind);
+    key += fullPath;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    RequestId requestId = _nextRequestId++;
+    if (_nextRequestId == 0)
+        _nextRequestId = 1;
+
+    RequestPtr request;
+    auto iter = _requests.find(key);
+    if (iter != _requests.end())
+    {
+        // the file is already queued or read: this request waits for the same read
+        request = iter->second;
+        if (request->state == State::QUEUED && priority < request->priority)
+        {
+            auto& from = _queues[(int)request->priority];
+            auto& to = _queues[(int)priority];
+            to.splice(to.end(), from, request->position);
+            request->priority = priority;
+        }
+    }
+    else
+    {
+        request = std::make_shared<Request>();
+        request->kind = kind;
+        request->fullPath = fullPath;
+        request->key = key;
+        request->priority = priority;
+        request->state = State::QUEUED;
+
+        auto& queue = _queues[(int)priority];
+        request->position = queue.insert(queue.end(), request);
+        _requests.emplace(key, request);
+
+        // lazy init
+        while ((int)_threads.size() < _threadCount)
+        {
+            _threads.push_back(std::thread(&AsyncFileLoader::threadLoop, this));
+        }
+    }
+
+    Waiter waiter;
+    waiter.id = requestId;
+    waiter.callback = callback;
+    request->waiters.push_back(std::move(waiter));
+    _waiting[requestId] = request;
+
+    lock.unlock();
+    _condition.notify_one();
+    return requestId;
+}
+
+void AsyncFileLoader::cancel(RequestId requestId)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto iter = _waiting.find(requestId);
+    if (iter == _waiting.end())
+        return;
+
+    RequestPtr request = iter->second;
+    _waiting.erase(iter);
+
+    auto& waiters = request->waiters;
+    waiters.erase(std::remove_if(waiters.begin(), waiters.end(), [requestId](const Waiter& waiter){ return waiter.id == requestId; }), waiters.end());
+
+    // nobody waits for a file that isn't read yet: it won't be
+    if (waiters.empty() && request->state == State::QUEUED)
+    {
+        _queues[(int)request->priority].erase(request->position);
+        _requests.erase(request->key);
+    }
+}
+
+ssize_t AsyncFileLoader::getPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ssize_t count = 0;
+    for (const auto& iter : _requests)
+    {
+        if (iter.second->state != State::READ)
+            ++count;
+    }
+    return count;
+}
+
+void AsyncFileLoader::threadLoop()
+{
+    for (;;)
+    {
+        RequestPtr request;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]{
+                return _stop || !_queues[0].empty() || !_queues[1].empty() || !_queues[2].empty();
+            });
+            if (_stop)
+                return;
+
+            for (auto& queue : _queues)
+            {
+                if (!queue.empty())
+                {
+                    request = queue.front();
+                    queue.pop_front();
+                    break;
+                }
+            }
+            request->state = State::READING;
+        }
+
+        read(*request);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            request->state = State::READ;
+        }
+
+        // the callbacks are called by the cocos thread, unless the loader is destroyed before
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([request]{
+            if (s_sharedAsyncFileLoader)
+            {
+                s_sharedAsyncFileLoader->deliver(request);
+            }
+        });
+    }
+}
+
+void AsyncFileLoader::read(Request& request)
+{
+    // the path is a full path, FileUtils doesn't search it and its cache isn't touched
+    auto fileUtils = FileUtils::getInstance();
+    switch (request.kind)
+    {
+        case Kind::DATA:
+            request.data = fileUtils->getDataFromFile(request.fullPath);
+            break;
+        case Kind::STRING:
+            request.string = fileUtils->getStringFromFile(request.fullPath);
+            break;
+        case Kind::VALUE_MAP:
+            request.valueMap = fileUtils->getValueMapFromFile(request.fullPath);
+            break;
+        case Kind::MAPPED_DATA:
+            request.mappedData = fileUtils->getMappedDataFromFile(request.fullPath);
+            break;
+    }
+}
+
+void AsyncFileLoader::deliver(const RequestPtr& request)
+{
+    std::vector<Waiter> waiters;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        waiters.swap(request->waiters);
+        auto iter = _requests.find(request->key);
+        if (iter != _requests.end() && iter->second == request)
+        {
+            _requests.erase(iter);
+        }
+    }
+
+    for (const auto& waiter : waiters)
+    {
+        // a callback may cancel the requests that follow it
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_waiting.erase(waiter.id) == 0)
+                continue;
+        }
+        waiter.callback(*request);
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,176 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_ASYNC_FILE_LOADER_H__
+#define __CC_ASYNC_FILE_LOADER_H__
+
+#include <string>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+#include "base/CCValue.h"
+#include "platform/CCMappedData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @brief The I/O threads that read files for the asynchronous reads of FileUtils.
+
+ The loaders of the engine share these threads instead of owning one each. The reads are queued by priority,
+ the requests for a file that is already queued or being read wait for the same read, and the callbacks are
+ called on the cocos thread by the scheduler. A request can be canceled until its callback is called.
+
+ The requests are made and canceled from the cocos thread, usually through FileUtils::getDataFromFileAsync()
+ and the other asynchronous reads of FileUtils.
+ @since v3.3
+ */
+class CC_DLL AsyncFileLoader
+{
+public:
+    /** The priority classes of the reads. A queued read starts after the reads of a higher priority. */
+    enum class Priority
+    {
+        HIGH,
+        NORMAL,
+        LOW,
+    };
+
+    /** Identifies a request, to cancel it. 0 is never a request */
+    typedef unsigned int RequestId;
+
+    /** returns the shared loader, its threads are started by the first request */
+    static AsyncFileLoader* getInstance();
+
+    /** destroys the shared loader. The reads in progress are waited for, the queued ones are dropped */
+    static void destroyInstance();
+
+    /** The I/O threads, 2 by default. Storage serves a few parallel reads well, more threads only wait */
+    void setThreadCount(int count);
+    int getThreadCount() const { return _threadCount; }
+
+    /** Reads a file, like FileUtils::getDataFromFile(). The callback gets Data::Null when the file can't be read */
+    RequestId readData(const std::string& fullPath, const std::function<void(const Data&)>& callback, Priority priority);
+
+    /** Reads a file, like FileUtils::getStringFromFile() */
+    RequestId readString(const std::string& fullPath, const std::function<void(const std::string&)>& callback, Priority priority);
+
+    /** Reads a plist, like FileUtils::getValueMapFromFile() */
+    RequestId readValueMap(const std::string& fullPath, const std::function<void(const ValueMap&)>& callback, Priority priority);
+
+    /** Maps a file, like FileUtils::getMappedDataFromFile() */
+    RequestId readMappedData(const std::string& fullPath, const std::function<void(const MappedData&)>& callback, Priority priority);
+
+    /** Cancels a request: its callback won't be called. The file isn't read if no other request waits for it */
+    void cancel(RequestId requestId);
+
+    /** returns the number of files that are queued or being read */
+    ssize_t getPendingCount() const;
+
+CC_CONSTRUCTOR_ACCESS:
+    AsyncFileLoader();
+    ~AsyncFileLoader();
+
+protected:
+    enum class Kind
+    {
+        DATA,
+        STRING,
+        VALUE_MAP,
+        MAPPED_DATA,
+    };
+
+    enum class State
+    {
+        QUEUED,
+        READING,
+        READ,
+    };
+
+    struct Request;
+    typedef std::shared_ptr<Request> RequestPtr;
+    typedef std::list<RequestPtr> RequestQueue;
+
+    struct Waiter
+    {
+        RequestId id;
+        std::function<void(const Request&)> callback;
+    };
+
+    // a read, shared by the requests of a file
+    struct Request
+    {
+        Kind kind;
+        std::string fullPath;
+        std::string key;
+        Priority priority;
+        State state;
+        RequestQueue::iterator position;
+        std::vector<Waiter> waiters;
+
+        Data data;
+        std::string string;
+        ValueMap valueMap;
+        MappedData mappedData;
+    };
+
+    RequestId enqueue(Kind kind, const std::string& fullPath, const std::function<void(const Request&)>& callback, Priority priority);
+    void threadLoop();
+    void read(Request& request);
+    void deliver(const RequestPtr& request);
+
+    RequestQueue _queues[3];
+    // the requests that didn't call their callbacks yet, by kind and path
+    std::unordered_map<std::string, RequestPtr> _requests;
+    // the request waited by each request id
+    std::unordered_map<RequestId, RequestPtr> _waiting;
+    RequestId _nextRequestId;
+
+    std::vector<std::thread> _threads;
+    int _threadCount;
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stop;
+
+    static AsyncFileLoader* s_sharedAsyncFileLoader;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_ASYNC_FILE_LOADER_H__
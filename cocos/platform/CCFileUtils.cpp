@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "platform/CCSAXParser.h"
+#include "platform/CCResourcePack.h"
 #include "base/ccUtils.h"
 
 #include "tinyxml2.h"
@@ -528,6 +529,14 @@ FileUtils::FileUtils()
 
 FileUtils::~FileUtils()
 {
+    for (auto& iter : _resourcePacks)
+    {
+        iter.second->release();
+    }
+    for (auto& iter : _unmountedResourcePacks)
+    {
+        iter.second->release();
+    }
 }
 
 
@@ -556,6 +565,14 @@ static Data getData(const std::string& filename, bool forString)
     size_t size = 0;
     size_t readsize;
     const char* mode = nullptr;
+
+    std::string entryName;
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    ResourcePack* pack = FileUtils::getInstance()->getResourcePackForPath(fullPath, &entryName);
+    if (pack)
+    {
+        return pack->copyFileData(entryName, forString);
+    }
     
     if (forString)
         mode = "rt";
@@ -565,7 +582,6 @@ static Data getData(const std::string& filename, bool forString)
     do
     {
         // Read the file from hardware
-        std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
         FILE *fp = fopen(fullPath.c_str(), mode);
         CC_BREAK_IF(!fp);
         fseek(fp,0,SEEK_END);
@@ -620,6 +636,64 @@ Data FileUtils::getDataFromFile(const std::string& filename)
     return getData(filename, false);
 }
 
+MappedData FileUtils::getMappedDataFromFile(const std::string& filename)
+{
+    if (filename.empty())
+    {
+        return MappedData::Null;
+    }
+
+    if (!canMapFiles())
+    {
+        return MappedData(getDataFromFile(filename));
+    }
+
+    std::string entryName;
+    const std::string fullPath = fullPathForFilename(filename);
+    ResourcePack* pack = getResourcePackForPath(fullPath, &entryName);
+    if (pack)
+    {
+        return pack->getFileData(entryName);
+    }
+
+    MappedData ret = MappedData::mapFile(fullPath);
+    if (ret.isNull())
+    {
+        ret = MappedData(getDataFromFile(filename));
+    }
+    return ret;
+}
+
+bool FileUtils::canMapFiles() const
+{
+    return false;
+}
+
+AsyncFileLoader::RequestId FileUtils::getDataFromFileAsync(const std::string& filename, const std::function<void(const Data&)>& callback, AsyncFileLoader::Priority priority)
+{
+    return AsyncFileLoader::getInstance()->readData(fullPathForFilename(filename), callback, priority);
+}
+
+AsyncFileLoader::RequestId FileUtils::getStringFromFileAsync(const std::string& filename, const std::function<void(const std::string&)>& callback, AsyncFileLoader::Priority priority)
+{
+    return AsyncFileLoader::getInstance()->readString(fullPathForFilename(filename), callback, priority);
+}
+
+AsyncFileLoader::RequestId FileUtils::getValueMapFromFileAsync(const std::string& filename, const std::function<void(const ValueMap&)>& callback, AsyncFileLoader::Priority priority)
+{
+    return AsyncFileLoader::getInstance()->readValueMap(fullPathForFilename(filename), callback, priority);
+}
+
+AsyncFileLoader::RequestId FileUtils::getMappedDataFromFileAsync(const std::string& filename, const std::function<void(const MappedData&)>& callback, AsyncFileLoader::Priority priority)
+{
+    return AsyncFileLoader::getInstance()->readMappedData(fullPathForFilename(filename), callback, priority);
+}
+
+void FileUtils::cancelAsyncRead(AsyncFileLoader::RequestId requestId)
+{
+    AsyncFileLoader::getInstance()->cancel(requestId);
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size)
 {
     unsigned char * buffer = nullptr;
@@ -723,6 +797,21 @@ std::string FileUtils::getPathForFilename(const std::string& filename, const std
         file_path = filename.substr(0, pos+1);
         file = filename.substr(pos+1);
     }
+
+    if (!_resourcePacks.empty())
+    {
+        auto packIter = _resourcePacks.find(searchPath);
+        if (packIter != _resourcePacks.end())
+        {
+            // the names of the files of a pack include their directories
+            std::string entryName = file_path + resolutionDirectory + file;
+            if (packIter->second->hasFile(entryName))
+            {
+                return packIter->second->getPath() + "/" + entryName;
+            }
+            return "";
+        }
+    }
     
     // searchPath + file_path + resourceDirectory
     std::string path = searchPath;
@@ -881,6 +970,16 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         //CCLOG("Default root path doesn't exist, adding it.");
         _searchPathArray.push_back(_defaultResRootPath);
     }
+
+    {
+        std::lock_guard<std::mutex> lock(_resourcePacksMutex);
+        _unmountedResourcePacks.insert(_resourcePacks.begin(), _resourcePacks.end());
+        _resourcePacks.clear();
+    }
+    for (const auto& path : _searchPathArray)
+    {
+        mountResourcePack(path);
+    }
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
@@ -899,6 +998,75 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     } else {
         _searchPathArray.push_back(path);
     }
+
+    mountResourcePack(path);
+}
+
+void FileUtils::mountResourcePack(const std::string& searchPath)
+{
+    static const std::string PACK_EXTENSION(".ccpack/");
+    if (searchPath.length() <= PACK_EXTENSION.length()
+        || searchPath.compare(searchPath.length() - PACK_EXTENSION.length(), PACK_EXTENSION.length(), PACK_EXTENSION) != 0
+        || _resourcePacks.find(searchPath) != _resourcePacks.end())
+    {
+        return;
+    }
+
+    auto iter = _unmountedResourcePacks.find(searchPath);
+    if (iter != _unmountedResourcePacks.end())
+    {
+        std::lock_guard<std::mutex> lock(_resourcePacksMutex);
+        _resourcePacks[searchPath] = iter->second;
+        _unmountedResourcePacks.erase(iter);
+        return;
+    }
+
+    // the search path is relative on iOS and Mac, where the bundle finds the files
+    std::string packPath = searchPath.substr(0, searchPath.length() - 1);
+    if (!isAbsolutePath(packPath))
+    {
+        packPath = searchFullPathForFilename(packPath);
+    }
+
+    ResourcePack* pack = packPath.empty() ? nullptr : ResourcePack::create(packPath);
+    if (pack)
+    {
+        pack->retain();
+        {
+            std::lock_guard<std::mutex> lock(_resourcePacksMutex);
+            _resourcePacks[searchPath] = pack;
+        }
+        _fullPathCache.clear();
+    }
+    else
+    {
+        CCLOG("cocos2d: FileUtils: can't mount the resource pack %s", searchPath.c_str());
+    }
+}
+
+ResourcePack* FileUtils::getResourcePackForPath(const std::string& fullPath, std::string* entryName) const
+{
+    // called by the threads reading files
+    std::lock_guard<std::mutex> lock(_resourcePacksMutex);
+    for (const auto& iter : _resourcePacks)
+    {
+        const std::string& packPath = iter.second->getPath();
+        if (fullPath.length() > packPath.length() + 1
+            && fullPath[packPath.length()] == '/'
+            && fullPath.compare(0, packPath.length(), packPath) == 0)
+        {
+            std::string name = fullPath.substr(packPath.length() + 1);
+            if (iter.second->hasFile(name))
+            {
+                if (entryName)
+                {
+                    *entryName = name;
+                }
+                return iter.second;
+            }
+        }
+    }
+    return nullptr;
 }
 
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
@@ -964,7 +1132,7 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        return isFileExistInternal(filename) || getResourcePackForPath(filename, nullptr) != nullptr;
     }
     else
     {
@@ -1327,6 +1495,13 @@ long FileUtils::getFileSize(const std::string &filepath)
         if (fullpath.empty())
             return 0;
     }
+
+    std::string entryName;
+    ResourcePack* pack = getResourcePackForPath(fullpath, &entryName);
+    if (pack)
+    {
+        return (long)pack->getFileSize(entryName);
+    }
     
     struct stat info;
     // Get data associated with "crt_stat.c":
@@ -28,14 +28,19 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "platform/CCMappedData.h"
+#include "platform/CCAsyncFileLoader.h"
 
 NS_CC_BEGIN
 
+class ResourcePack;
+
 /**
  * @addtogroup platform
  * @{
@@ -102,6 +107,47 @@ public:
      *  @return A data object.
      */
     virtual Data getDataFromFile(const std::string& filename);
+
+    /**
+     *  Gets the bytes of a file without copying them: the file is mapped in memory when the platform can.
+     *  Otherwise, like for the assets of an Android apk, or when canMapFiles() returns false, it is read with getDataFromFile().
+     *  The bytes are read only, and stay valid while a copy of the returned object exists.
+     *  @return A mapped data object, null when the file can't be read.
+     *  @since v3.3
+     */
+    virtual MappedData getMappedDataFromFile(const std::string& filename);
+
+    /**
+     *  Reads a file on the I/O threads of AsyncFileLoader, and calls the callback on the cocos thread with the bytes
+     *  that getDataFromFile() returns. Several requests for a file while it is queued or read share the same read.
+     *  The path is resolved by the caller thread, so the search paths shouldn't change until the callback is called.
+     *
+     *  @param filename The file name, resolved with fullPathForFilename().
+     *  @param callback Called on the cocos thread, with Data::Null when the file can't be read.
+     *  @param priority The queued reads of a higher priority start first.
+     *  @return The id of the request, to cancel it with cancelAsyncRead().
+     *  @since v3.3
+     */
+    AsyncFileLoader::RequestId getDataFromFileAsync(const std::string& filename, const std::function<void(const Data&)>& callback,
+                                                    AsyncFileLoader::Priority priority = AsyncFileLoader::Priority::NORMAL);
+
+    /** Reads a file as a string on the I/O threads, see getDataFromFileAsync(). @since v3.3 */
+    AsyncFileLoader::RequestId getStringFromFileAsync(const std::string& filename, const std::function<void(const std::string&)>& callback,
+                                                      AsyncFileLoader::Priority priority = AsyncFileLoader::Priority::NORMAL);
+
+    /** Reads a plist on the I/O threads, see getDataFromFileAsync(). @since v3.3 */
+    AsyncFileLoader::RequestId getValueMapFromFileAsync(const std::string& filename, const std::function<void(const ValueMap&)>& callback,
+                                                        AsyncFileLoader::Priority priority = AsyncFileLoader::Priority::NORMAL);
+
+    /** Maps a file on the I/O threads, see getDataFromFileAsync(). @since v3.3 */
+    AsyncFileLoader::RequestId getMappedDataFromFileAsync(const std::string& filename, const std::function<void(const MappedData&)>& callback,
+                                                          AsyncFileLoader::Priority priority = AsyncFileLoader::Priority::NORMAL);
+
+    /**
+     *  Cancels an asynchronous read: its callback won't be called.
+     *  @since v3.3
+     */
+    void cancelAsyncRead(AsyncFileLoader::RequestId requestId);
     
     /**
      *  Gets resource file data
@@ -266,6 +312,7 @@ public:
      *        	On Android, the default resource root path is "assets/".
      *        	If "/mnt/sdcard/" and "resources-large" were set to the search paths vector,
      *        	"resources-large" will be converted to "assets/resources-large" since it was a relative path.
+     *        A search path ending with ".ccpack" is a resource pack, it is mounted and searched like a directory.
      *
      *  @param searchPaths The array contains search paths.
      *  @see fullPathForFilename(const char*)
@@ -408,6 +455,18 @@ public:
      */
     virtual long getFileSize(const std::string &filepath);
 
+    /**
+     *  Finds the resource pack mounted in the search paths that contains a file.
+     *  It can be called by any thread, the pack stays open until FileUtils is destroyed.
+     *
+     *  @param fullPath The full path of the file, as returned by fullPathForFilename().
+     *  @param entryName If not null, receives the name of the file in the pack.
+     *  @return The pack, or nullptr when the file isn't in a mounted pack.
+     *  @see ResourcePack
+     *  @since v3.3
+     */
+    ResourcePack* getResourcePackForPath(const std::string& fullPath, std::string* entryName) const;
+
     /** Returns the full path cache */
     const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
 
@@ -435,6 +494,14 @@ protected:
      *          If the original filename wasn't in the dictionary, it will return the original filename.
      */
     virtual std::string getNewFilename(const std::string &filename) const;
+
+    /**
+     *  Whether getMappedDataFromFile() may map the files, instead of reading them with getDataFromFile().
+     *  The platform classes return true for their own type only: a subclass set with setDelegate() that overrides
+     *  getDataFromFile(), e.g. to decrypt the files, keeps reading every file. It may return true if it reads them unchanged.
+     *  @since v3.3
+     */
+    virtual bool canMapFiles() const;
     
     /**
      *  Checks whether a file exists without considering search paths and resolution orders.
@@ -481,6 +548,13 @@ protected:
      *  @return The full path for the file, if not found, the return value will be an empty string
      */
     virtual std::string searchFullPathForFilename(const std::string& filename) const;
+
+    /**
+     *  Mounts the resource pack named by a search path, does nothing for the other search paths.
+     *  A pack that was unmounted before is mounted again instead of being opened.
+     *  @param searchPath The search path, ending with '/'.
+     */
+    void mountResourcePack(const std::string& searchPath);
     
     
     /** Dictionary used to lookup filenames based on a key.
@@ -518,6 +592,26 @@ protected:
      *  This variable is used for improving the performance of file search.
      */
     std::unordered_map<std::string, std::string> _fullPathCache;
+
+    /**
+     *  The resource packs mounted in the search paths, by search path.
+     *  @since v3.3
+     */
+    std::unordered_map<std::string, ResourcePack*> _resourcePacks;
+
+    /**
+     *  The resource packs removed from the search paths. They stay open until FileUtils is destroyed,
+     *  because a thread reading files may still use them.
+     *  @since v3.3
+     */
+    std::unordered_map<std::string, ResourcePack*> _unmountedResourcePacks;
+
+    /**
+     *  Guards _resourcePacks and _unmountedResourcePacks, that the threads reading files look up while
+     *  the cocos thread changes the search paths. The cocos thread reads them without locking.
+     *  @since v3.3
+     */
+    mutable std::mutex _resourcePacksMutex;
     
     /**
      * Writable path.
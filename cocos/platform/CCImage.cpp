@@ -84,6 +84,8 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "renderer/CCPixelConvert.h"
+#include "base/CCBlockDecoder.h"
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "android/CCFileUtils-android.h"
 #endif
@@ -426,6 +428,12 @@ namespace
             png_error(png_ptr, "pngReaderCallback failed");
         }
     }
+
+    // the compressed formats are kept as is when the GPU supports them, unless BlockDecoder forces the software decoders
+    static bool hardwareSupportsPVRTC() { return Configuration::getInstance()->supportsPVRTC() && !BlockDecoder::isSoftwareDecodingForced(); }
+    static bool hardwareSupportsETC() { return Configuration::getInstance()->supportsETC() && !BlockDecoder::isSoftwareDecodingForced(); }
+    static bool hardwareSupportsS3TC() { return Configuration::getInstance()->supportsS3TC() && !BlockDecoder::isSoftwareDecodingForced(); }
+    static bool hardwareSupportsATITC() { return Configuration::getInstance()->supportsATITC() && !BlockDecoder::isSoftwareDecodingForced(); }
 }
 
 Texture2D::PixelFormat getDevicePixelFormat(Texture2D::PixelFormat format)
@@ -435,12 +443,12 @@ Texture2D::PixelFormat getDevicePixelFormat(Texture2D::PixelFormat format)
         case Texture2D::PixelFormat::PVRTC4A:
         case Texture2D::PixelFormat::PVRTC2:
         case Texture2D::PixelFormat::PVRTC2A:
-            if(Configuration::getInstance()->supportsPVRTC())
+            if(hardwareSupportsPVRTC())
                 return format;
             else
                 return Texture2D::PixelFormat::RGBA8888;
         case Texture2D::PixelFormat::ETC:
-            if(Configuration::getInstance()->supportsETC())
+            if(hardwareSupportsETC())
                 return format;
             else
                 return Texture2D::PixelFormat::RGB888;
@@ -503,7 +511,7 @@ bool Image::initWithImageFile(const std::string& path)
 
     SDL_FreeSurface(iSurf);
 #else
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    MappedData data = FileUtils::getInstance()->getMappedDataFromFile(_filePath);
 
     if (!data.isNull())
     {
@@ -519,7 +527,7 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    MappedData data = FileUtils::getInstance()->getMappedDataFromFile(fullpath);
 
     if (!data.isNull())
     {
@@ -1361,7 +1369,7 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
     {
         switch (formatFlags) {
             case PVR2TexturePixelFormat::PVRTC2BPP_RGBA:
-                if (!Configuration::getInstance()->supportsPVRTC())
+                if (!hardwareSupportsPVRTC())
                 {
                     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
                     _unpack = true;
@@ -1375,7 +1383,7 @@ bool Image::initWithPVRv2Data(const unsigned char * data, ssize_t dataLen)
                 heightBlocks = height / 4;
                 break;
             case PVR2TexturePixelFormat::PVRTC4BPP_RGBA:
-                if (!Configuration::getInstance()->supportsPVRTC())
+                if (!hardwareSupportsPVRTC())
                 {
                     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
                     _unpack = true;
@@ -1515,7 +1523,7 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
         {
             case PVR3TexturePixelFormat::PVRTC2BPP_RGB :
             case PVR3TexturePixelFormat::PVRTC2BPP_RGBA :
-                if (!Configuration::getInstance()->supportsPVRTC())
+                if (!hardwareSupportsPVRTC())
                 {
                     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
                     _unpack = true;
@@ -1530,7 +1538,7 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
                 break;
             case PVR3TexturePixelFormat::PVRTC4BPP_RGB :
             case PVR3TexturePixelFormat::PVRTC4BPP_RGBA :
-                if (!Configuration::getInstance()->supportsPVRTC())
+                if (!hardwareSupportsPVRTC())
                 {
                     CCLOG("cocos2d: Hardware PVR decoder not present. Using software decoder");
                     _unpack = true;
@@ -1544,7 +1552,7 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
                 heightBlocks = height / 4;
                 break;
             case PVR3TexturePixelFormat::ETC1:
-                if (!Configuration::getInstance()->supportsETC())
+                if (!hardwareSupportsETC())
                 {
                     CCLOG("cocos2d: Hardware ETC1 decoder not present. Using software decoder");
                     int bytePerPixel = 3;
@@ -1629,7 +1637,7 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
         return false;
     }
 
-    if (Configuration::getInstance()->supportsETC())
+    if (hardwareSupportsETC())
     {
         //old opengl version has no define for GL_ETC1_RGB8_OES, add macro to make compiler happy. 
 #ifdef GL_ETC1_RGB8_OES
@@ -1785,7 +1793,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     int width = _width;
     int height = _height;
     
-    if (Configuration::getInstance()->supportsS3TC())  //compressed data length
+    if (hardwareSupportsS3TC())  //compressed data length
     {
         _dataLen = dataLen - sizeof(S3TCTexHeader);
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
@@ -1807,7 +1815,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     }
     
     /* if hardware supports s3tc, set pixelformat before loading mipmaps, to support non-mipmapped textures  */
-    if (Configuration::getInstance()->supportsS3TC())
+    if (hardwareSupportsS3TC())
     {   //decode texture throught hardware
         
         if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
@@ -1839,7 +1847,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
         
         int size = ((width+3)/4)*((height+3)/4)*blockSize;
                 
-        if (Configuration::getInstance()->supportsS3TC())
+        if (hardwareSupportsS3TC())
         {   //decode texture throught hardware
             _mipmaps[i].address = (unsigned char *)_data + encodeOffset;
             _mipmaps[i].len = size;
@@ -1852,23 +1860,23 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
             int bytePerPixel = 4;
             unsigned int stride = width * bytePerPixel;
 
-            std::vector<unsigned char> decodeImageData(stride * height);
+            // decoded straight into the mipmap, the decoder clips the blocks crossing the edges
+            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
+            _mipmaps[i].len = (stride * height);
+            
             if (FOURCC_DXT1 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT1);
+                s3tc_decode(pixelData + encodeOffset, _mipmaps[i].address, width, height, S3TCDecodeFlag::DXT1);
             }
             else if (FOURCC_DXT3 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT3);
+                s3tc_decode(pixelData + encodeOffset, _mipmaps[i].address, width, height, S3TCDecodeFlag::DXT3);
             }
             else if (FOURCC_DXT5 == header->ddsd.DUMMYUNIONNAMEN4.ddpfPixelFormat.fourCC)
             {
-                s3tc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, S3TCDecodeFlag::DXT5);
+                s3tc_decode(pixelData + encodeOffset, _mipmaps[i].address, width, height, S3TCDecodeFlag::DXT5);
             }
             
-            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
-            _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
             decodeOffset += stride * height;
         }
         
@@ -1919,7 +1927,7 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     int width = _width;
     int height = _height;
     
-    if (Configuration::getInstance()->supportsATITC())  //compressed data length
+    if (hardwareSupportsATITC())  //compressed data length
     {
         _dataLen = dataLen - sizeof(ATITCTexHeader) - header->bytesOfKeyValueData - 4;
         _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
@@ -1952,7 +1960,7 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
         
         int size = ((width+3)/4)*((height+3)/4)*blockSize;
         
-        if (Configuration::getInstance()->supportsATITC())
+        if (hardwareSupportsATITC())
         {
             /* decode texture throught hardware */
             
@@ -1986,25 +1994,25 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
             unsigned int stride = width * bytePerPixel;
             _renderFormat = Texture2D::PixelFormat::RGBA8888;
             
-            std::vector<unsigned char> decodeImageData(stride * height);
+            // decoded straight into the mipmap, the decoder clips the blocks crossing the edges
+            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
+            _mipmaps[i].len = (stride * height);
+            
             switch (header->glInternalFormat)
             {
                 case CC_GL_ATC_RGB_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_RGB);
+                    atitc_decode(pixelData + encodeOffset, _mipmaps[i].address, width, height, ATITCDecodeFlag::ATC_RGB);
                     break;
                 case CC_GL_ATC_RGBA_EXPLICIT_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
+                    atitc_decode(pixelData + encodeOffset, _mipmaps[i].address, width, height, ATITCDecodeFlag::ATC_EXPLICIT_ALPHA);
                     break;
                 case CC_GL_ATC_RGBA_INTERPOLATED_ALPHA_AMD:
-                    atitc_decode(pixelData + encodeOffset, &decodeImageData[0], width, height, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
+                    atitc_decode(pixelData + encodeOffset, _mipmaps[i].address, width, height, ATITCDecodeFlag::ATC_INTERPOLATED_ALPHA);
                     break;
                 default:
                     break;
             }
 
-            _mipmaps[i].address = (unsigned char *)_data + decodeOffset;
-            _mipmaps[i].len = (stride * height);
-            memcpy((void *)_mipmaps[i].address, (void *)&decodeImageData[0], _mipmaps[i].len);
             decodeOffset += stride * height;
         }
 
@@ -2374,11 +2382,19 @@ void Image::premultipliedAlpha()
 {
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->premultiplyAlpha)
+    {
+        simd->premultiplyAlpha(_data, _width * _height);
+    }
+    else
     {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+        unsigned int* fourBytes = (unsigned int*)_data;
+        for(int i = 0; i < _width * _height; i++)
+        {
+            unsigned char* p = _data + i * 4;
+            fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+        }
     }
     
     _hasPremultipliedAlpha = true;
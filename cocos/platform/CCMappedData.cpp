@@ -0,0 +1,217 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCMappedData.h"
+
+#include "base/ccMacros.h"
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <windows.h>
+#elif (CC_TARGET_PLATFORM != CC_PLATFORM_WP8) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CC_MAPPED_DATA_POSIX 1
+#endif
+
+NS_CC_BEGIN
+
+const MappedData MappedData::Null;
+
+const ssize_t MappedData::MIN_MAPPED_SIZE = 16 * 1024;
+
+MappedData::MappedData()
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+{
+}
+
+MappedData::MappedData(Data&& data)
+: _bytes(nullptr)
+, _size(0)
+, _mapped(false)
+{
+    if (!data.isNull())
+    {
+        auto bytes = data.getBytes();
+        // the buffer of a Data is allocated with malloc()
+        _owner.reset(bytes, free);
+        _bytes = bytes;
+        _size = data.getSize();
+        data.fastSet(nullptr, 0);
+    }
+}
+
+MappedData MappedData::slice(ssize_t offset, ssize_t size) const
+{
+    CCASSERT(offset >= 0 && size >= 0 && offset + size <= _size, "the slice must be inside the data");
+
+    MappedData ret;
+    ret._owner = _owner;
+    ret._bytes = _bytes + offset;
+    ret._size = size;
+    ret._mapped = _mapped;
+    return ret;
+}
+
+Data MappedData::copyToData() const
+{
+    Data data;
+    data.copy(_bytes, _size);
+    return data;
+}
+
+void MappedData::clear()
+{
+    _owner.reset();
+    _bytes = nullptr;
+    _size = 0;
+    _mapped = false;
+}
+
+#if defined(CC_MAPPED_DATA_POSIX)
+
+MappedData MappedData::mapFile(const std::string& fullPath)
+{
+    MappedData ret;
+
+    int fd = open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return ret;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        ssize_t size = static_cast<ssize_t>(st.st_size);
+        if (size >= MIN_MAPPED_SIZE)
+        {
+            void* bytes = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (bytes != MAP_FAILED)
+            {
+                ret._owner.reset(bytes, [size](const void* p) {
+                    munmap(const_cast<void*>(p), size);
+                });
+                ret._bytes = static_cast<const unsigned char*>(bytes);
+                ret._size = size;
+                ret._mapped = true;
+            }
+        }
+        else
+        {
+            auto buffer = static_cast<unsigned char*>(malloc(size));
+            ssize_t readSize = 0;
+            while (readSize < size)
+            {
+                auto count = read(fd, buffer + readSize, size - readSize);
+                if (count <= 0)
+                    break;
+                readSize += count;
+            }
+            if (readSize > 0)
+            {
+                ret._owner.reset(buffer, free);
+                ret._bytes = buffer;
+                ret._size = readSize;
+            }
+            else
+            {
+                free(buffer);
+            }
+        }
+    }
+    close(fd);
+
+    return ret;
+}
+
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+
+MappedData MappedData::mapFile(const std::string& fullPath)
+{
+    MappedData ret;
+
+    WCHAR wszBuf[CC_MAX_PATH] = {0};
+    MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wszBuf, sizeof(wszBuf)/sizeof(wszBuf[0]));
+
+    HANDLE fileHandle = ::CreateFileW(wszBuf, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return ret;
+
+    LARGE_INTEGER fileSize;
+    if (::GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+    {
+        ssize_t size = static_cast<ssize_t>(fileSize.QuadPart);
+        if (size >= MIN_MAPPED_SIZE)
+        {
+            HANDLE mappingHandle = ::CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mappingHandle)
+            {
+                void* bytes = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+                // the view keeps the mapping alive
+                ::CloseHandle(mappingHandle);
+                if (bytes)
+                {
+                    ret._owner.reset(bytes, [](const void* p) {
+                        ::UnmapViewOfFile(p);
+                    });
+                    ret._bytes = static_cast<const unsigned char*>(bytes);
+                    ret._size = size;
+                    ret._mapped = true;
+                }
+            }
+        }
+        else
+        {
+            auto buffer = static_cast<unsigned char*>(malloc(size));
+            DWORD sizeRead = 0;
+            if (::ReadFile(fileHandle, buffer, static_cast<DWORD>(size), &sizeRead, nullptr) && sizeRead > 0)
+            {
+                ret._owner.reset(buffer, free);
+                ret._bytes = buffer;
+                ret._size = sizeRead;
+            }
+            else
+            {
+                free(buffer);
+            }
+        }
+    }
+    ::CloseHandle(fileHandle);
+
+    return ret;
+}
+
+#else
+
+MappedData MappedData::mapFile(const std::string& fullPath)
+{
+    // no file mapping on WinRT and WP8, FileUtils::getMappedDataFromFile() reads the file instead
+    return MappedData::Null;
+}
+
+#endif
+
+NS_CC_END
@@ -0,0 +1,96 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_MAPPED_DATA_H__
+#define __CC_MAPPED_DATA_H__
+
+#include <memory>
+#include <string>
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h" // for ssize_t on window
+#include "base/CCData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** Read-only bytes of a file, mapped in memory when the platform can.
+
+Copies of a MappedData share the same bytes, they are unmapped or freed when the last copy is destroyed.
+It avoids both the copy of the file into a buffer and a second buffer while the file is parsed.
+The files that can't be mapped, like the assets of an Android apk, and the small files, are read into a buffer instead.
+@see FileUtils::getMappedDataFromFile
+@since v3.3
+*/
+class CC_DLL MappedData
+{
+public:
+    static const MappedData Null;
+
+    /** Files smaller than this are read rather than mapped: a mapping costs more than a copy of a few pages */
+    static const ssize_t MIN_MAPPED_SIZE;
+
+    /** Maps a file by its full path. Returns MappedData::Null when the file can't be opened or is empty.
+     It is thread safe.
+     */
+    static MappedData mapFile(const std::string& fullPath);
+
+    MappedData();
+    /** Takes the buffer of a Data, without copying it */
+    explicit MappedData(Data&& data);
+
+    const unsigned char* getBytes() const { return _bytes; }
+    ssize_t getSize() const { return _size; }
+    bool isNull() const { return _bytes == nullptr || _size == 0; }
+
+    /** Returns true when the bytes are mapped from the file, false when they were read into a buffer */
+    bool isMapped() const { return _mapped; }
+
+    /** Returns a view of size bytes from offset, that shares the bytes of this object */
+    MappedData slice(ssize_t offset, ssize_t size) const;
+
+    /** Copies the bytes into a Data, for the APIs that take its ownership */
+    Data copyToData() const;
+
+    /** Releases this reference to the bytes */
+    void clear();
+
+private:
+    // unmaps or frees the bytes
+    std::shared_ptr<const void> _owner;
+    const unsigned char* _bytes;
+    ssize_t _size;
+    bool _mapped;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_MAPPED_DATA_H__
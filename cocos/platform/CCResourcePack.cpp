@@ -0,0 +1,246 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "platform/CCResourcePack.h"
+
+#include <string.h>
+#include <zlib.h>
+
+#include "base/ccMacros.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    const char PACK_MAGIC[4] = { 'C', 'C', 'P', 'K' };
+    const uint32_t PACK_VERSION = 1;
+
+    struct PackHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t fileCount;
+        uint32_t namesOffset;
+        uint32_t namesSize;
+        uint32_t reserved[3];
+    };
+
+    const size_t PACK_HEADER_SIZE = 32;
+    static_assert(sizeof(PackHeader) == PACK_HEADER_SIZE, "the header of a pack is 32 bytes");
+}
+
+ResourcePack* ResourcePack::create(const std::string& fullPath)
+{
+    // read like the other files, so that a FileUtils delegate reads the pack too
+    MappedData data = FileUtils::getInstance()->getMappedDataFromFile(fullPath);
+
+    auto pack = new (std::nothrow) ResourcePack();
+    if (pack && pack->initWithData(fullPath, data))
+    {
+        pack->autorelease();
+        return pack;
+    }
+    CC_SAFE_DELETE(pack);
+    return nullptr;
+}
+
+uint32_t ResourcePack::hashName(uint32_t seed, const char* name, size_t length)
+{
+    // FNV based, the packer computes the same hash
+    uint32_t hash = seed ? seed : 0x01000193;
+    for (size_t i = 0; i < length; ++i)
+    {
+        hash = (hash * 0x01000193) ^ static_cast<unsigned char>(name[i]);
+    }
+    return hash;
+}
+
+ResourcePack::ResourcePack()
+: _fileCount(0)
+, _displacements(nullptr)
+, _entries(nullptr)
+, _names(nullptr)
+{
+}
+
+ResourcePack::~ResourcePack()
+{
+}
+
+bool ResourcePack::initWithData(const std::string& fullPath, const MappedData& data)
+{
+    static_assert(sizeof(Entry) == 32, "the entries of a pack are 32 bytes");
+
+    auto bytes = data.getBytes();
+    auto size = data.getSize();
+    if (static_cast<size_t>(size) < PACK_HEADER_SIZE)
+        return false;
+
+    PackHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.version != PACK_VERSION)
+    {
+        CCLOG("cocos2d: ResourcePack: %s isn't a resource pack of version %u", fullPath.c_str(), PACK_VERSION);
+        return false;
+    }
+
+    // in 64 bits, the sizes of a corrupted header would overflow size_t on the 32 bits platforms
+    uint64_t packSize = static_cast<uint64_t>(size);
+    uint64_t fileCount = header.fileCount;
+    uint64_t entriesOffset = (PACK_HEADER_SIZE + fileCount * sizeof(int32_t) + 7) & ~static_cast<uint64_t>(7);
+    uint64_t entriesEnd = entriesOffset + fileCount * sizeof(Entry);
+    if (entriesEnd > packSize || static_cast<uint64_t>(header.namesOffset) + header.namesSize > packSize)
+    {
+        CCLOG("cocos2d: ResourcePack: %s is truncated", fullPath.c_str());
+        return false;
+    }
+
+    _displacements = reinterpret_cast<const int32_t*>(bytes + PACK_HEADER_SIZE);
+    _entries = reinterpret_cast<const Entry*>(bytes + entriesOffset);
+    _names = reinterpret_cast<const char*>(bytes + header.namesOffset);
+
+    for (size_t i = 0; i < static_cast<size_t>(fileCount); ++i)
+    {
+        const auto& entry = _entries[i];
+        if (entry.offset > packSize || entry.storedSize > packSize - entry.offset
+            || static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header.namesSize
+            || (static_cast<Compression>(entry.compression) == Compression::NONE && entry.storedSize != entry.size))
+        {
+            CCLOG("cocos2d: ResourcePack: %s has an invalid entry", fullPath.c_str());
+            return false;
+        }
+    }
+
+    _path = fullPath;
+    _data = data;
+    _fileCount = static_cast<ssize_t>(fileCount);
+    return true;
+}
+
+ssize_t ResourcePack::findEntry(const std::string& name) const
+{
+    if (_fileCount == 0)
+        return -1;
+
+    auto length = name.length();
+    auto displacement = _displacements[hashName(0, name.c_str(), length) % _fileCount];
+    ssize_t slot;
+    if (displacement < 0)
+    {
+        // a single name had this hash, it was put in a free slot
+        slot = -static_cast<ssize_t>(displacement) - 1;
+        if (slot >= _fileCount)
+            return -1;
+    }
+    else
+    {
+        slot = hashName(static_cast<uint32_t>(displacement), name.c_str(), length) % _fileCount;
+    }
+
+    // the hash only knows the names of the pack, it must be checked
+    const auto& entry = _entries[slot];
+    if (entry.nameLength != length || memcmp(_names + entry.nameOffset, name.c_str(), length) != 0)
+        return -1;
+
+    return slot;
+}
+
+ssize_t ResourcePack::getFileSize(const std::string& name) const
+{
+    auto slot = findEntry(name);
+    return slot < 0 ? -1 : static_cast<ssize_t>(_entries[slot].size);
+}
+
+MappedData ResourcePack::getFileData(const std::string& name) const
+{
+    auto slot = findEntry(name);
+    if (slot < 0)
+        return MappedData::Null;
+
+    const auto& entry = _entries[slot];
+    if (static_cast<Compression>(entry.compression) == Compression::NONE)
+    {
+        return _data.slice(static_cast<ssize_t>(entry.offset), entry.storedSize);
+    }
+
+    Data data = copyFileData(name, false);
+    if (data.isNull())
+        return MappedData::Null;
+    return MappedData(std::move(data));
+}
+
+Data ResourcePack::copyFileData(const std::string& name, bool nullTerminated) const
+{
+    Data ret;
+    auto slot = findEntry(name);
+    if (slot < 0)
+        return ret;
+
+    const auto& entry = _entries[slot];
+    auto buffer = static_cast<unsigned char*>(malloc(entry.size + (nullTerminated ? 1 : 0)));
+    if (buffer && readEntry(entry, buffer))
+    {
+        if (nullTerminated)
+            buffer[entry.size] = '\0';
+        ret.fastSet(buffer, entry.size);
+    }
+    else
+    {
+        free(buffer);
+        CCLOG("cocos2d: ResourcePack: can't read %s from %s", name.c_str(), _path.c_str());
+    }
+    return ret;
+}
+
+bool ResourcePack::readEntry(const Entry& entry, unsigned char* buffer) const
+{
+    const unsigned char* stored = _data.getBytes() + entry.offset;
+    switch (static_cast<Compression>(entry.compression))
+    {
+        case Compression::NONE:
+            memcpy(buffer, stored, entry.size);
+            return true;
+        case Compression::ZLIB:
+        {
+            uLongf size = entry.size;
+            return uncompress(buffer, &size, stored, entry.storedSize) == Z_OK && size == entry.size;
+        }
+        default:
+            return false;
+    }
+}
+
+std::vector<std::string> ResourcePack::getFileNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(_fileCount);
+    for (ssize_t i = 0; i < _fileCount; ++i)
+    {
+        names.push_back(std::string(_names + _entries[i].nameOffset, _entries[i].nameLength));
+    }
+    return names;
+}
+
+NS_CC_END
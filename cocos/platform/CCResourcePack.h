@@ -0,0 +1,133 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __CC_RESOURCE_PACK_H__
+#define __CC_RESOURCE_PACK_H__
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "base/CCRef.h"
+#include "platform/CCMappedData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** A read-only archive of resource files, made by tools/resource-pack/pack_resources.py.
+
+A pack has a table of contents indexed by a minimal perfect hash of the file names: finding a file costs
+one hash and one string comparison, whatever the number of files. The pack is mapped in memory, and the files
+stored without compression are returned as views of the mapping, without copying them. Compressed files are
+inflated with zlib.
+
+A pack is mounted by adding it to the search paths, like a directory: FileUtils::addSearchPath("res.ccpack").
+The full path of a file of the pack is then the path of the pack followed by the name of the file,
+e.g. "/path/to/res.ccpack/images/grossini.png", and FileUtils reads it from the pack.
+
+Layout of a pack, little endian:
+- header: "CCPK", version, file count, offset and size of the names, padded to 32 bytes
+- one int32 displacement per file, the perfect hash
+- one 32 bytes entry per file, in the order of the hash slots: offset, stored size, size, name offset, name length, compression
+- the names, in UTF-8
+- the files, aligned to 16 bytes
+@since v3.3
+*/
+class CC_DLL ResourcePack : public Ref
+{
+public:
+    enum class Compression
+    {
+        NONE = 0,
+        ZLIB = 1,
+    };
+
+    /** Opens a pack by its full path. Returns nullptr if it isn't a valid pack. */
+    static ResourcePack* create(const std::string& fullPath);
+
+    /** Returns the hash of a file name, as computed by the packer. seed 0 selects the slot of the displacement. */
+    static uint32_t hashName(uint32_t seed, const char* name, size_t length);
+
+    const std::string& getPath() const { return _path; }
+
+    ssize_t getFileCount() const { return _fileCount; }
+
+    /** Returns true when the pack has a file, name is relative to the root of the pack */
+    bool hasFile(const std::string& name) const { return findEntry(name) >= 0; }
+
+    /** Returns the size of a file once inflated, or -1 when the pack doesn't have it */
+    ssize_t getFileSize(const std::string& name) const;
+
+    /** Returns the bytes of a file, or MappedData::Null. They are shared with the pack when the file isn't compressed. */
+    MappedData getFileData(const std::string& name) const;
+
+    /** Copies the bytes of a file into a Data, or returns Data::Null.
+     *  With nullTerminated, a '\0' that the size of the Data doesn't count follows the bytes, to read a string.
+     */
+    Data copyFileData(const std::string& name, bool nullTerminated) const;
+
+    /** Returns the names of the files of the pack */
+    std::vector<std::string> getFileNames() const;
+
+CC_CONSTRUCTOR_ACCESS:
+    ResourcePack();
+    virtual ~ResourcePack();
+
+    bool initWithData(const std::string& fullPath, const MappedData& data);
+
+protected:
+    struct Entry
+    {
+        uint64_t offset;
+        uint32_t storedSize;
+        uint32_t size;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t compression;
+        uint32_t reserved;
+    };
+
+    // returns the slot of a file, or -1
+    ssize_t findEntry(const std::string& name) const;
+    // copies or inflates a file into a buffer of entry.size bytes
+    bool readEntry(const Entry& entry, unsigned char* buffer) const;
+
+    std::string _path;
+    MappedData _data;
+    ssize_t _fileCount;
+    const int32_t* _displacements;
+    const Entry* _entries;
+    const char* _names;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_RESOURCE_PACK_H__
@@ -28,11 +28,13 @@ THE SOFTWARE.
 
 #include "CCFileUtils-android.h"
 #include "platform/CCCommon.h"
+#include "platform/CCResourcePack.h"
 #include "jni/Java_org_cocos2dx_lib_Cocos2dxHelper.h"
 #include "android/asset_manager.h"
 #include "android/asset_manager_jni.h"
 
 #include <stdlib.h>
+#include <typeinfo>
 
 #define  LOG_TAG    "CCFileUtils-android.cpp"
 #define  LOGD(...)  __android_log_print(ANDROID_LOG_DEBUG,LOG_TAG,__VA_ARGS__)
@@ -196,6 +198,13 @@ Data FileUtilsAndroid::getData(const std::string& filename, bool forString)
     unsigned char* data = nullptr;
     ssize_t size = 0;
     string fullPath = fullPathForFilename(filename);
+
+    string entryName;
+    ResourcePack* pack = getResourcePackForPath(fullPath, &entryName);
+    if (pack)
+    {
+        return pack->copyFileData(entryName, forString);
+    }
     
     if (fullPath[0] != '/')
     {
@@ -392,6 +401,12 @@ unsigned char* FileUtilsAndroid::getFileData(const std::string& filename, const
     return data;
 }
 
+bool FileUtilsAndroid::canMapFiles() const
+{
+    // a subclass may read the files another way. The assets of the apk are read anyway
+    return typeid(*this) == typeid(FileUtilsAndroid);
+}
+
 string FileUtilsAndroid::getWritablePath() const
 {
     // Fix for Nexus 10 (Android 4.2 multi-user environment)
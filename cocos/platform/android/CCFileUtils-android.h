@@ -79,7 +79,10 @@ public:
 
     virtual std::string getWritablePath() const;
     virtual bool isAbsolutePath(const std::string& strPath) const;
-    
+
+protected:
+    virtual bool canMapFiles() const override;
+
 private:
     virtual bool isFileExistInternal(const std::string& strFilePath) const;
     Data getData(const std::string& filename, bool forString);
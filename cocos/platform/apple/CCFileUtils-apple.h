@@ -55,6 +55,8 @@ public:
 
     virtual ValueVector getValueVectorFromFile(const std::string& filename) override;
     void setBundle(NSBundle* bundle);
+protected:
+    virtual bool canMapFiles() const override;
 private:
     virtual bool isFileExistInternal(const std::string& filePath) const override;
     NSBundle* getBundle() const;
@@ -29,12 +29,14 @@ THE SOFTWARE.
 
 #include <string>
 #include <stack>
+#include <typeinfo>
 
 #include "base/CCDirector.h"
 #include "deprecated/CCString.h"
 #include "deprecated/CCDictionary.h"
 #include "platform/CCFileUtils.h"
 #include "platform/CCSAXParser.h"
+#include "platform/CCResourcePack.h"
 
 NS_CC_BEGIN
 
@@ -335,6 +337,12 @@ FileUtils* FileUtils::getInstance()
 }
 
 
+bool FileUtilsApple::canMapFiles() const
+{
+    // a subclass may read the files another way
+    return typeid(*this) == typeid(FileUtilsApple);
+}
+
 std::string FileUtilsApple::getWritablePath() const
 {
     // save to document folder
@@ -412,6 +420,16 @@ std::string FileUtilsApple::getFullPathForDirectoryAndFilename(const std::string
 ValueMap FileUtilsApple::getValueMapFromFile(const std::string& filename)
 {
     std::string fullPath = fullPathForFilename(filename);
+
+    // NSDictionary can't read from a resource pack
+    std::string entryName;
+    ResourcePack* pack = getResourcePackForPath(fullPath, &entryName);
+    if (pack)
+    {
+        MappedData data = pack->getFileData(entryName);
+        return getValueMapFromData((const char*)data.getBytes(), (int)data.getSize());
+    }
+
     NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
     NSDictionary* dict = [NSDictionary dictionaryWithContentsOfFile:path];
 
@@ -473,8 +491,28 @@ ValueVector FileUtilsApple::getValueVectorFromFile(const std::string& filename)
     //    pPath = [[NSBundle mainBundle] pathForResource:pPath ofType:pathExtension];
     //    fixing cannot read data using Array::createWithContentsOfFile
     std::string fullPath = fullPathForFilename(filename);
-    NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
-    NSArray* array = [NSArray arrayWithContentsOfFile:path];
+
+    NSArray* array = nil;
+    // NSArray can't read from a resource pack
+    std::string entryName;
+    ResourcePack* pack = getResourcePackForPath(fullPath, &entryName);
+    if (pack)
+    {
+        MappedData data = pack->getFileData(entryName);
+        NSData* file = [NSData dataWithBytes:data.getBytes() length:data.getSize()];
+        NSPropertyListFormat format;
+        NSError* error;
+        id plist = [NSPropertyListSerialization propertyListWithData:file options:NSPropertyListImmutable format:&format error:&error];
+        if ([plist isKindOfClass:[NSArray class]])
+        {
+            array = plist;
+        }
+    }
+    else
+    {
+        NSString* path = [NSString stringWithUTF8String:fullPath.c_str()];
+        array = [NSArray arrayWithContentsOfFile:path];
+    }
 
     ValueVector ret;
 
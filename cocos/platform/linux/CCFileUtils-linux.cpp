@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include <sys/stat.h>
 #include <stdio.h>
 #include <errno.h>
+#include <typeinfo>
 
 #ifndef CC_RESOURCE_FOLDER_LINUX
 #define CC_RESOURCE_FOLDER_LINUX ("/Resources/")
@@ -93,6 +94,12 @@ bool FileUtilsLinux::init()
     return FileUtils::init();
 }
 
+bool FileUtilsLinux::canMapFiles() const
+{
+    // a subclass may read the files another way
+    return typeid(*this) == typeid(FileUtilsLinux);
+}
+
 string FileUtilsLinux::getWritablePath() const
 {
     struct stat st;
@@ -51,6 +51,8 @@ public:
     /* override funtions */
     bool init();
     virtual std::string getWritablePath() const;
+protected:
+    virtual bool canMapFiles() const override;
 private:
     virtual bool isFileExistInternal(const std::string& strFilePath) const;
 };
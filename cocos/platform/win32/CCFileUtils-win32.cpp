@@ -28,7 +28,9 @@ THE SOFTWARE.
 
 #include "CCFileUtils-win32.h"
 #include "platform/CCCommon.h"
+#include "platform/CCResourcePack.h"
 #include <Shlobj.h>
+#include <typeinfo>
 
 using namespace std;
 
@@ -138,11 +140,18 @@ static Data getData(const std::string& filename, bool forString)
 
     unsigned char *buffer = nullptr;
 
+    std::string entryName;
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    ResourcePack* pack = FileUtils::getInstance()->getResourcePackForPath(fullPath, &entryName);
+    if (pack)
+    {
+        return pack->copyFileData(entryName, forString);
+    }
+
     size_t size = 0;
     do
     {
         // read the file from hardware
-        std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
         WCHAR wszBuf[CC_MAX_PATH] = {0};
         MultiByteToWideChar(CP_UTF8, 0, fullPath.c_str(), -1, wszBuf, sizeof(wszBuf)/sizeof(wszBuf[0]));
@@ -278,6 +287,12 @@ std::string FileUtilsWin32::getFullPathForDirectoryAndFilename(const std::string
     return FileUtils::getFullPathForDirectoryAndFilename(unixDirectory, unixFilename);
 }
 
+bool FileUtilsWin32::canMapFiles() const
+{
+    // a subclass may read the files another way
+    return typeid(*this) == typeid(FileUtilsWin32);
+}
+
 string FileUtilsWin32::getWritablePath() const
 {
     // Get full path of executable, e.g. c:\Program Files (x86)\My Game Folder\MyGame.exe
@@ -54,6 +54,8 @@ public:
 protected:
 
     virtual bool isFileExistInternal(const std::string& strFilePath) const;
+
+    virtual bool canMapFiles() const override;
     
     /**
      *  Gets resource file data
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #include "CCFileUtilsWinRT.h"
 #include "CCWinRTUtils.h"
 #include "platform/CCCommon.h"
+#include "platform/CCResourcePack.h"
 
 using namespace std;
 
@@ -142,11 +143,18 @@ static Data getData(const std::string& filename, bool forString)
     ssize_t size = 0;
     const char* mode = nullptr;
     mode = "rb";
+
+    std::string entryName;
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    ResourcePack* pack = FileUtils::getInstance()->getResourcePackForPath(fullPath, &entryName);
+    if (pack)
+    {
+        return pack->copyFileData(entryName, forString);
+    }
     
     do
     {
         // Read the file from hardware
-        std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
         FILE *fp = fopen(fullPath.c_str(), mode);
         CC_BREAK_IF(!fp);
         fseek(fp,0,SEEK_END);
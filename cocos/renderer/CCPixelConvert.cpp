@@ -0,0 +1,130 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "renderer/CCPixelConvert.h"
+#include "math/MathUtil.h"
+
+#include <atomic>
+
+//#define INCLUDE_SSE2    : SSE2 kernels included
+//#define INCLUDE_AVX2    : AVX2 kernels included, used when the cpu supports them
+//#define INCLUDE_NEON    : NEON kernels included
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define INCLUDE_SSE2
+    #if defined (__AVX2__)
+        #define INCLUDE_AVX2
+        #define CC_TARGET_AVX2
+    #elif (defined (__clang__) || (defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) && (defined (__x86_64__) || defined (__i386__))
+        #define INCLUDE_AVX2
+        #define CC_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+#if defined (__ARM_NEON__) || defined (__ARM_NEON) || defined (__aarch64__)
+    #define INCLUDE_NEON
+#endif
+
+NS_CC_BEGIN
+
+// one pixel conversions, for the pixels left by the vector loops. Same as the ones of Texture2D
+static inline unsigned short toRGB565(const unsigned char* p)
+{
+    return (p[0] & 0xF8) << 8 | (p[1] & 0xFC) << 3 | (p[2] & 0xF8) >> 3;
+}
+
+static inline unsigned short toRGBA4444(const unsigned char* p)
+{
+    return (p[0] & 0xF0) << 8 | (p[1] & 0xF0) << 4 | (p[2] & 0xF0) | (p[3] & 0xF0) >> 4;
+}
+
+static inline unsigned short toRGB5A1(const unsigned char* p)
+{
+    return (p[0] & 0xF8) << 8 | (p[1] & 0xF8) << 3 | (p[2] & 0xF8) >> 2 | (p[3] & 0x80) >> 7;
+}
+
+static inline void premultiplyPixel(unsigned char* p)
+{
+    unsigned int alpha = p[3] + 1;
+    p[0] = (unsigned char)(p[0] * alpha >> 8);
+    p[1] = (unsigned char)(p[1] * alpha >> 8);
+    p[2] = (unsigned char)(p[2] * alpha >> 8);
+}
+
+NS_CC_END
+
+#ifdef INCLUDE_SSE2
+#include "CCPixelConvertSSE.inl"
+#endif
+
+#ifdef INCLUDE_NEON
+#include "CCPixelConvertNeon.inl"
+#endif
+
+NS_CC_BEGIN
+
+static std::atomic<bool> s_kernelsEnabled(true);
+
+static const PixelConvertKernels* selectPixelConvertKernels()
+{
+#if defined (INCLUDE_AVX2) && !defined (__AVX2__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return &s_kernelsAVX2;
+#elif defined (INCLUDE_AVX2)
+    return &s_kernelsAVX2;
+#endif
+
+#ifdef INCLUDE_SSE2
+    return &s_kernelsSSE2;
+#elif defined (INCLUDE_NEON)
+    #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) && !defined (__aarch64__)
+    // armeabi-v7a devices may lack NEON
+    if (!MathUtil::isNeon32Enabled())
+        return nullptr;
+    #endif
+    return &s_kernelsNeon;
+#else
+    return nullptr;
+#endif
+}
+
+const PixelConvertKernels* PixelConvertKernels::getInstance()
+{
+    static const PixelConvertKernels* kernels = selectPixelConvertKernels();
+    return s_kernelsEnabled ? kernels : nullptr;
+}
+
+void PixelConvertKernels::setEnabled(bool enabled)
+{
+    s_kernelsEnabled = enabled;
+}
+
+bool PixelConvertKernels::isEnabled()
+{
+    return s_kernelsEnabled;
+}
+
+NS_CC_END
@@ -0,0 +1,78 @@
+/****************************************************************************
+Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CCPIXEL_CONVERT_H__
+#define __CCPIXEL_CONVERT_H__
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCStdC.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup textures
+ * @{
+ */
+
+/** @brief SIMD versions of the pixel format conversions of Texture2D, and of the alpha premultiplication of Image.
+
+ The instruction set is picked at runtime: AVX2 when the cpu supports it (gcc and clang builds), SSE2 otherwise on x86,
+ and NEON on ARM. Each kernel gives the same bytes as the scalar conversion of Texture2D, which remains the reference:
+ it is used for the conversions without a kernel, and for all of them when the kernels are disabled.
+ */
+struct CC_DLL PixelConvertKernels
+{
+    /** converts dataLen bytes of data, same as the Texture2D::convertXXXToYYY() functions */
+    typedef void (*ConvertFunction)(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
+    /** premultiplies RGBA8888 pixels in place, same as CC_RGB_PREMULTIPLY_ALPHA */
+    typedef void (*PremultiplyFunction)(unsigned char* data, ssize_t pixelCount);
+
+    /** name of the instruction set */
+    const char* name;
+
+    ConvertFunction rgba8888ToRGB888;
+    ConvertFunction rgba8888ToRGB565;
+    ConvertFunction rgba8888ToRGBA4444;
+    ConvertFunction rgba8888ToRGB5A1;
+    ConvertFunction rgba8888ToA8;
+    ConvertFunction rgb888ToRGBA8888;
+    ConvertFunction i8ToRGBA8888;
+    ConvertFunction ai88ToRGBA8888;
+    PremultiplyFunction premultiplyAlpha;
+
+    /** returns the kernels of this cpu, or nullptr when it has none or when they are disabled */
+    static const PixelConvertKernels* getInstance();
+
+    /** enables the kernels. They are enabled by default, disabling them runs the scalar conversions */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CCPIXEL_CONVERT_H__
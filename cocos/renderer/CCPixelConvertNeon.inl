@@ -0,0 +1,179 @@
+// NEON kernels of PixelConvertKernels, included by CCPixelConvert.cpp
+
+#include <arm_neon.h>
+
+NS_CC_BEGIN
+
+// the 16 bits pixels are stored as their low and high bytes, interleaved
+static void rgba8888ToRGB565Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4, i = 0;
+    unsigned short* out16 = (unsigned short*)outData;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t px = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        // RRRRRGGG GGGBBBBB
+        out.val[1] = vorrq_u8(vandq_u8(px.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(px.val[1], 5));
+        out.val[0] = vorrq_u8(vshlq_n_u8(vandq_u8(px.val[1], vdupq_n_u8(0x1C)), 3), vshrq_n_u8(px.val[2], 3));
+        vst2q_u8(outData + i * 2, out);
+    }
+    for (; i < pixels; ++i)
+        out16[i] = toRGB565(data + i * 4);
+}
+
+static void rgba8888ToRGBA4444Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4, i = 0;
+    unsigned short* out16 = (unsigned short*)outData;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t px = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        // RRRRGGGG BBBBAAAA
+        out.val[1] = vorrq_u8(vandq_u8(px.val[0], vdupq_n_u8(0xF0)), vshrq_n_u8(px.val[1], 4));
+        out.val[0] = vorrq_u8(vandq_u8(px.val[2], vdupq_n_u8(0xF0)), vshrq_n_u8(px.val[3], 4));
+        vst2q_u8(outData + i * 2, out);
+    }
+    for (; i < pixels; ++i)
+        out16[i] = toRGBA4444(data + i * 4);
+}
+
+static void rgba8888ToRGB5A1Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4, i = 0;
+    unsigned short* out16 = (unsigned short*)outData;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t px = vld4q_u8(data + i * 4);
+        uint8x16x2_t out;
+        // RRRRRGGG GGBBBBBA
+        out.val[1] = vorrq_u8(vandq_u8(px.val[0], vdupq_n_u8(0xF8)), vshrq_n_u8(px.val[1], 5));
+        out.val[0] = vorrq_u8(vorrq_u8(vshlq_n_u8(vandq_u8(px.val[1], vdupq_n_u8(0x18)), 3),
+                                       vshlq_n_u8(vshrq_n_u8(px.val[2], 3), 1)),
+                              vshrq_n_u8(px.val[3], 7));
+        vst2q_u8(outData + i * 2, out);
+    }
+    for (; i < pixels; ++i)
+        out16[i] = toRGB5A1(data + i * 4);
+}
+
+static void rgba8888ToRGB888Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4, i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t px = vld4q_u8(data + i * 4);
+        uint8x16x3_t out = { { px.val[0], px.val[1], px.val[2] } };
+        vst3q_u8(outData + i * 3, out);
+    }
+    for (; i < pixels; ++i)
+    {
+        outData[i * 3] = data[i * 4];
+        outData[i * 3 + 1] = data[i * 4 + 1];
+        outData[i * 3 + 2] = data[i * 4 + 2];
+    }
+}
+
+static void rgba8888ToA8Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4, i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x4_t px = vld4q_u8(data + i * 4);
+        vst1q_u8(outData + i, px.val[3]);
+    }
+    for (; i < pixels; ++i)
+        outData[i] = data[i * 4 + 3];
+}
+
+static void rgb888ToRGBA8888Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 3, i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x3_t px = vld3q_u8(data + i * 3);
+        uint8x16x4_t out = { { px.val[0], px.val[1], px.val[2], vdupq_n_u8(0xFF) } };
+        vst4q_u8(outData + i * 4, out);
+    }
+    for (; i < pixels; ++i)
+    {
+        outData[i * 4] = data[i * 3];
+        outData[i * 4 + 1] = data[i * 3 + 1];
+        outData[i * 4 + 2] = data[i * 3 + 2];
+        outData[i * 4 + 3] = 0xFF;
+    }
+}
+
+static void i8ToRGBA8888Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        uint8x16_t in = vld1q_u8(data + i);
+        uint8x16x4_t out = { { in, in, in, vdupq_n_u8(0xFF) } };
+        vst4q_u8(outData + i * 4, out);
+    }
+    for (; i < dataLen; ++i)
+    {
+        unsigned char* out = outData + i * 4;
+        out[0] = out[1] = out[2] = data[i];
+        out[3] = 0xFF;
+    }
+}
+
+static void ai88ToRGBA8888Neon(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 2, i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        uint8x16x2_t ia = vld2q_u8(data + i * 2);
+        uint8x16x4_t out = { { ia.val[0], ia.val[0], ia.val[0], ia.val[1] } };
+        vst4q_u8(outData + i * 4, out);
+    }
+    for (; i < pixels; ++i)
+    {
+        unsigned char* out = outData + i * 4;
+        out[0] = out[1] = out[2] = data[i * 2];
+        out[3] = data[i * 2 + 1];
+    }
+}
+
+// c * (a + 1) >> 8, computed as (c * a + c) >> 8 on 16 bits
+static inline uint8x16_t premultiplyChannelNeon(uint8x16_t c, uint8x16_t a)
+{
+    uint16x8_t low = vaddw_u8(vmull_u8(vget_low_u8(c), vget_low_u8(a)), vget_low_u8(c));
+    uint16x8_t high = vaddw_u8(vmull_u8(vget_high_u8(c), vget_high_u8(a)), vget_high_u8(c));
+    return vcombine_u8(vshrn_n_u16(low, 8), vshrn_n_u16(high, 8));
+}
+
+static void premultiplyAlphaNeon(unsigned char* data, ssize_t pixelCount)
+{
+    ssize_t i = 0;
+    for (; i + 16 <= pixelCount; i += 16)
+    {
+        uint8x16x4_t px = vld4q_u8(data + i * 4);
+        px.val[0] = premultiplyChannelNeon(px.val[0], px.val[3]);
+        px.val[1] = premultiplyChannelNeon(px.val[1], px.val[3]);
+        px.val[2] = premultiplyChannelNeon(px.val[2], px.val[3]);
+        vst4q_u8(data + i * 4, px);
+    }
+    for (; i < pixelCount; ++i)
+        premultiplyPixel(data + i * 4);
+}
+
+static const PixelConvertKernels s_kernelsNeon =
+{
+    "NEON",
+    rgba8888ToRGB888Neon,
+    rgba8888ToRGB565Neon,
+    rgba8888ToRGBA4444Neon,
+    rgba8888ToRGB5A1Neon,
+    rgba8888ToA8Neon,
+    rgb888ToRGBA8888Neon,
+    i8ToRGBA8888Neon,
+    ai88ToRGBA8888Neon,
+    premultiplyAlphaNeon,
+};
+
+NS_CC_END
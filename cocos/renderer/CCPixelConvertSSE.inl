@@ -0,0 +1,314 @@
+// SSE2 and AVX2 kernels of PixelConvertKernels, included by CCPixelConvert.cpp
+
+#include <emmintrin.h>
+#ifdef INCLUDE_AVX2
+#include <immintrin.h>
+#endif
+
+NS_CC_BEGIN
+
+// keeps the low 16 bits of the 32 bits lanes of a and b, in order
+static inline __m128i pack32To16SSE2(__m128i a, __m128i b)
+{
+    // sign extend, so that the saturation of packs doesn't change the values
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+// the 32 bits lanes hold RGBA8888 pixels: R in the low byte
+static inline __m128i toRGB565SSE2(__m128i px)
+{
+    __m128i r = _mm_and_si128(_mm_slli_epi32(px, 8), _mm_set1_epi32(0xF800));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(px, 5), _mm_set1_epi32(0x07E0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(px, 19), _mm_set1_epi32(0x001F));
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+}
+
+static inline __m128i toRGBA4444SSE2(__m128i px)
+{
+    __m128i r = _mm_and_si128(_mm_slli_epi32(px, 8), _mm_set1_epi32(0xF000));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(px, 4), _mm_set1_epi32(0x0F00));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(px, 16), _mm_set1_epi32(0x00F0));
+    __m128i a = _mm_srli_epi32(px, 28);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+static inline __m128i toRGB5A1SSE2(__m128i px)
+{
+    __m128i r = _mm_and_si128(_mm_slli_epi32(px, 8), _mm_set1_epi32(0xF800));
+    __m128i g = _mm_and_si128(_mm_srli_epi32(px, 5), _mm_set1_epi32(0x07C0));
+    __m128i b = _mm_and_si128(_mm_srli_epi32(px, 18), _mm_set1_epi32(0x003E));
+    __m128i a = _mm_srli_epi32(px, 31);
+    return _mm_or_si128(_mm_or_si128(r, g), _mm_or_si128(b, a));
+}
+
+#define CC_PIXEL_CONVERT_16BITS_SSE2(name, toPixel, toVector) \
+static void name(const unsigned char* data, ssize_t dataLen, unsigned char* outData) \
+{ \
+    ssize_t pixels = dataLen / 4, i = 0; \
+    unsigned short* out16 = (unsigned short*)outData; \
+    for (; i + 8 <= pixels; i += 8) \
+    { \
+        __m128i a = _mm_loadu_si128((const __m128i*)(data + i * 4)); \
+        __m128i b = _mm_loadu_si128((const __m128i*)(data + i * 4 + 16)); \
+        _mm_storeu_si128((__m128i*)(out16 + i), pack32To16SSE2(toVector(a), toVector(b))); \
+    } \
+    for (; i < pixels; ++i) \
+        out16[i] = toPixel(data + i * 4); \
+}
+
+CC_PIXEL_CONVERT_16BITS_SSE2(rgba8888ToRGB565SSE2, toRGB565, toRGB565SSE2)
+CC_PIXEL_CONVERT_16BITS_SSE2(rgba8888ToRGBA4444SSE2, toRGBA4444, toRGBA4444SSE2)
+CC_PIXEL_CONVERT_16BITS_SSE2(rgba8888ToRGB5A1SSE2, toRGB5A1, toRGB5A1SSE2)
+
+static void rgba8888ToA8SSE2(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4, i = 0;
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m128i a0 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4)), 24);
+        __m128i a1 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4 + 16)), 24);
+        __m128i a2 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4 + 32)), 24);
+        __m128i a3 = _mm_srli_epi32(_mm_loadu_si128((const __m128i*)(data + i * 4 + 48)), 24);
+        __m128i a = _mm_packus_epi16(_mm_packs_epi32(a0, a1), _mm_packs_epi32(a2, a3));
+        _mm_storeu_si128((__m128i*)(outData + i), a);
+    }
+    for (; i < pixels; ++i)
+        outData[i] = data[i * 4 + 3];
+}
+
+static void i8ToRGBA8888SSE2(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t i = 0;
+    const __m128i opaque = _mm_set1_epi8((char)0xFF);
+    for (; i + 16 <= dataLen; i += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+        // II pairs, and IA pairs, interleaved into IIIA
+        __m128i iiLow = _mm_unpacklo_epi8(v, v);
+        __m128i iiHigh = _mm_unpackhi_epi8(v, v);
+        __m128i iaLow = _mm_unpacklo_epi8(v, opaque);
+        __m128i iaHigh = _mm_unpackhi_epi8(v, opaque);
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_unpacklo_epi16(iiLow, iaLow));
+        _mm_storeu_si128((__m128i*)(outData + i * 4 + 16), _mm_unpackhi_epi16(iiLow, iaLow));
+        _mm_storeu_si128((__m128i*)(outData + i * 4 + 32), _mm_unpacklo_epi16(iiHigh, iaHigh));
+        _mm_storeu_si128((__m128i*)(outData + i * 4 + 48), _mm_unpackhi_epi16(iiHigh, iaHigh));
+    }
+    for (; i < dataLen; ++i)
+    {
+        unsigned char* out = outData + i * 4;
+        out[0] = out[1] = out[2] = data[i];
+        out[3] = 0xFF;
+    }
+}
+
+static void ai88ToRGBA8888SSE2(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 2, i = 0;
+    const __m128i lowBytes = _mm_set1_epi16(0x00FF);
+    for (; i + 8 <= pixels; i += 8)
+    {
+        __m128i ia = _mm_loadu_si128((const __m128i*)(data + i * 2));
+        __m128i in = _mm_and_si128(ia, lowBytes);
+        __m128i ii = _mm_or_si128(in, _mm_slli_epi16(in, 8));
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_unpacklo_epi16(ii, ia));
+        _mm_storeu_si128((__m128i*)(outData + i * 4 + 16), _mm_unpackhi_epi16(ii, ia));
+    }
+    for (; i < pixels; ++i)
+    {
+        unsigned char* out = outData + i * 4;
+        out[0] = out[1] = out[2] = data[i * 2];
+        out[3] = data[i * 2 + 1];
+    }
+}
+
+// 2 pixels widened to 16 bits per channel: c * (a + 1) >> 8 on the color channels, alpha unchanged
+static inline __m128i premultiplyWideSSE2(__m128i px)
+{
+    const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m128i colors = _mm_srli_epi16(_mm_mullo_epi16(px, _mm_add_epi16(alpha, _mm_set1_epi16(1))), 8);
+    return _mm_or_si128(_mm_andnot_si128(alphaMask, colors), _mm_and_si128(alphaMask, px));
+}
+
+static void premultiplyAlphaSSE2(unsigned char* data, ssize_t pixelCount)
+{
+    ssize_t i = 0;
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= pixelCount; i += 4)
+    {
+        __m128i px = _mm_loadu_si128((const __m128i*)(data + i * 4));
+        __m128i low = premultiplyWideSSE2(_mm_unpacklo_epi8(px, zero));
+        __m128i high = premultiplyWideSSE2(_mm_unpackhi_epi8(px, zero));
+        _mm_storeu_si128((__m128i*)(data + i * 4), _mm_packus_epi16(low, high));
+    }
+    for (; i < pixelCount; ++i)
+        premultiplyPixel(data + i * 4);
+}
+
+static const PixelConvertKernels s_kernelsSSE2 =
+{
+    "SSE2",
+    nullptr,
+    rgba8888ToRGB565SSE2,
+    rgba8888ToRGBA4444SSE2,
+    rgba8888ToRGB5A1SSE2,
+    rgba8888ToA8SSE2,
+    nullptr,
+    i8ToRGBA8888SSE2,
+    ai88ToRGBA8888SSE2,
+    premultiplyAlphaSSE2,
+};
+
+#ifdef INCLUDE_AVX2
+
+// 16 bits packing of 8 lanes, fixing the order of the in-lane packs
+CC_TARGET_AVX2 static inline __m256i pack32To16AVX2(__m256i a, __m256i b)
+{
+    a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+    b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+CC_TARGET_AVX2 static inline __m256i toRGB565AVX2(__m256i px)
+{
+    __m256i r = _mm256_and_si256(_mm256_slli_epi32(px, 8), _mm256_set1_epi32(0xF800));
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 5), _mm256_set1_epi32(0x07E0));
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(px, 19), _mm256_set1_epi32(0x001F));
+    return _mm256_or_si256(_mm256_or_si256(r, g), b);
+}
+
+CC_TARGET_AVX2 static inline __m256i toRGBA4444AVX2(__m256i px)
+{
+    __m256i r = _mm256_and_si256(_mm256_slli_epi32(px, 8), _mm256_set1_epi32(0xF000));
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 4), _mm256_set1_epi32(0x0F00));
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(px, 16), _mm256_set1_epi32(0x00F0));
+    __m256i a = _mm256_srli_epi32(px, 28);
+    return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+}
+
+CC_TARGET_AVX2 static inline __m256i toRGB5A1AVX2(__m256i px)
+{
+    __m256i r = _mm256_and_si256(_mm256_slli_epi32(px, 8), _mm256_set1_epi32(0xF800));
+    __m256i g = _mm256_and_si256(_mm256_srli_epi32(px, 5), _mm256_set1_epi32(0x07C0));
+    __m256i b = _mm256_and_si256(_mm256_srli_epi32(px, 18), _mm256_set1_epi32(0x003E));
+    __m256i a = _mm256_srli_epi32(px, 31);
+    return _mm256_or_si256(_mm256_or_si256(r, g), _mm256_or_si256(b, a));
+}
+
+#define CC_PIXEL_CONVERT_16BITS_AVX2(name, toPixel, toVector) \
+CC_TARGET_AVX2 static void name(const unsigned char* data, ssize_t dataLen, unsigned char* outData) \
+{ \
+    ssize_t pixels = dataLen / 4, i = 0; \
+    unsigned short* out16 = (unsigned short*)outData; \
+    for (; i + 16 <= pixels; i += 16) \
+    { \
+        __m256i a = _mm256_loadu_si256((const __m256i*)(data + i * 4)); \
+        __m256i b = _mm256_loadu_si256((const __m256i*)(data + i * 4 + 32)); \
+        _mm256_storeu_si256((__m256i*)(out16 + i), pack32To16AVX2(toVector(a), toVector(b))); \
+    } \
+    for (; i < pixels; ++i) \
+        out16[i] = toPixel(data + i * 4); \
+}
+
+CC_PIXEL_CONVERT_16BITS_AVX2(rgba8888ToRGB565AVX2, toRGB565, toRGB565AVX2)
+CC_PIXEL_CONVERT_16BITS_AVX2(rgba8888ToRGBA4444AVX2, toRGBA4444, toRGBA4444AVX2)
+CC_PIXEL_CONVERT_16BITS_AVX2(rgba8888ToRGB5A1AVX2, toRGB5A1, toRGB5A1AVX2)
+
+// the byte shuffles need SSSE3, which every AVX2 cpu has
+CC_TARGET_AVX2 static void rgba8888ToRGB888AVX2(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 4, i = 0;
+    const __m128i dropAlpha = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    for (; i + 16 <= pixels; i += 16)
+    {
+        __m128i p0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4)), dropAlpha);
+        __m128i p1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4 + 16)), dropAlpha);
+        __m128i p2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4 + 32)), dropAlpha);
+        __m128i p3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + i * 4 + 48)), dropAlpha);
+        // 4 x 12 bytes into 3 x 16 bytes
+        unsigned char* out = outData + i * 3;
+        _mm_storeu_si128((__m128i*)out, _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+        _mm_storeu_si128((__m128i*)(out + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+        _mm_storeu_si128((__m128i*)(out + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+    }
+    for (; i < pixels; ++i)
+    {
+        outData[i * 3] = data[i * 4];
+        outData[i * 3 + 1] = data[i * 4 + 1];
+        outData[i * 3 + 2] = data[i * 4 + 2];
+    }
+}
+
+CC_TARGET_AVX2 static void rgb888ToRGBA8888AVX2(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+{
+    ssize_t pixels = dataLen / 3, i = 0;
+    const __m128i addAlpha = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i opaque = _mm_set1_epi32(0xFF000000);
+    for (; i + 16 <= pixels; i += 16)
+    {
+        const unsigned char* in = data + i * 3;
+        __m128i a = _mm_loadu_si128((const __m128i*)in);
+        __m128i b = _mm_loadu_si128((const __m128i*)(in + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(in + 32));
+        // the 12 bytes of each group of 4 pixels at the start of a register
+        __m128i p0 = a;
+        __m128i p1 = _mm_alignr_epi8(b, a, 12);
+        __m128i p2 = _mm_alignr_epi8(c, b, 8);
+        __m128i p3 = _mm_srli_si128(c, 4);
+        _mm_storeu_si128((__m128i*)(outData + i * 4), _mm_or_si128(_mm_shuffle_epi8(p0, addAlpha), opaque));
+        _mm_storeu_si128((__m128i*)(outData + i * 4 + 16), _mm_or_si128(_mm_shuffle_epi8(p1, addAlpha), opaque));
+        _mm_storeu_si128((__m128i*)(outData + i * 4 + 32), _mm_or_si128(_mm_shuffle_epi8(p2, addAlpha), opaque));
+        _mm_storeu_si128((__m128i*)(outData + i * 4 + 48), _mm_or_si128(_mm_shuffle_epi8(p3, addAlpha), opaque));
+    }
+    for (; i < pixels; ++i)
+    {
+        outData[i * 4] = data[i * 3];
+        outData[i * 4 + 1] = data[i * 3 + 1];
+        outData[i * 4 + 2] = data[i * 3 + 2];
+        outData[i * 4 + 3] = 0xFF;
+    }
+}
+
+CC_TARGET_AVX2 static inline __m256i premultiplyWideAVX2(__m256i px)
+{
+    const __m256i alphaMask = _mm256_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0, -1, 0, 0, 0);
+    __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    __m256i colors = _mm256_srli_epi16(_mm256_mullo_epi16(px, _mm256_add_epi16(alpha, _mm256_set1_epi16(1))), 8);
+    return _mm256_blendv_epi8(colors, px, alphaMask);
+}
+
+CC_TARGET_AVX2 static void premultiplyAlphaAVX2(unsigned char* data, ssize_t pixelCount)
+{
+    ssize_t i = 0;
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 8 <= pixelCount; i += 8)
+    {
+        // the unpacks and the pack work within the 128 bits lanes, so the pixels keep their order
+        __m256i px = _mm256_loadu_si256((const __m256i*)(data + i * 4));
+        __m256i low = premultiplyWideAVX2(_mm256_unpacklo_epi8(px, zero));
+        __m256i high = premultiplyWideAVX2(_mm256_unpackhi_epi8(px, zero));
+        _mm256_storeu_si256((__m256i*)(data + i * 4), _mm256_packus_epi16(low, high));
+    }
+    for (; i < pixelCount; ++i)
+        premultiplyPixel(data + i * 4);
+}
+
+static const PixelConvertKernels s_kernelsAVX2 =
+{
+    "AVX2",
+    rgba8888ToRGB888AVX2,
+    rgba8888ToRGB565AVX2,
+    rgba8888ToRGBA4444AVX2,
+    rgba8888ToRGB5A1AVX2,
+    rgba8888ToA8SSE2,
+    rgb888ToRGBA8888AVX2,
+    i8ToRGBA8888SSE2,
+    ai88ToRGBA8888SSE2,
+    premultiplyAlphaAVX2,
+};
+
+#endif // INCLUDE_AVX2
+
+NS_CC_END
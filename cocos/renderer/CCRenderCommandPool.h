@@ -26,74 +26,211 @@
 #ifndef __CC_RENDERCOMMANDPOOL_H__
 #define __CC_RENDERCOMMANDPOOL_H__
 
-#include <list>
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+#include <typeinfo>
+#include <sstream>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/ccMacros.h"
+#include "base/allocator/CCAllocatorBase.h"
+#include "base/allocator/CCAllocatorDiagnostics.h"
 
 NS_CC_BEGIN
 
+/** @brief Pool of render commands of type T.
+
+ Commands are stored in contiguous blocks (slabs) that are never freed before the pool,
+ and released commands are kept in an intrusive free list, so generating and pushing back
+ a command never touches the heap once the pool is warm.
+ Each new block holds `growthFactor` times the commands of the previous one, up to `maxBlockSize`.
+ When all the commands generated during a frame are dropped together, `reset()` returns them
+ to the pool at once instead of calling `pushBackCommand()` for each of them.
+ The pool is not thread safe.
+ */
 template <class T>
 class RenderCommandPool
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+    : public allocator::AllocatorBase
+#endif
 {
 public:
-    RenderCommandPool()
+    RenderCommandPool(size_t blockSize = 32, size_t growthFactor = 2, size_t maxBlockSize = 1024, const char* tag = nullptr)
+    : _freeList(nullptr)
+    , _blockSize(blockSize)
+    , _growthFactor(growthFactor)
+    , _maxBlockSize(maxBlockSize)
+    , _currentBlock(0)
+    , _capacity(0)
+    , _usedCount(0)
+    , _highestUsedCount(0)
     {
+        CCASSERT(blockSize > 0 && growthFactor > 0 && maxBlockSize >= blockSize, "Invalid RenderCommandPool block sizes");
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+        allocator::AllocatorDiagnostics::instance()->trackAllocator(this);
+        AllocatorBase::setTag(tag ? tag : typeid(RenderCommandPool).name());
+#else
+        CC_UNUSED_PARAM(tag);
+#endif
     }
+
     ~RenderCommandPool()
     {
-//        if( 0 != _usedPool.size())
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+        allocator::AllocatorDiagnostics::instance()->untrackAllocator(this);
+#endif
+//        if( 0 != _usedCount)
 //        {
 //            CCLOG("All RenderCommand should not be used when Pool is released!");
 //        }
-        _freePool.clear();
-        for (typename std::list<T*>::iterator iter = _allocatedPoolBlocks.begin(); iter != _allocatedPoolBlocks.end(); ++iter)
+        for (auto& block : _blocks)
         {
-            delete[] *iter;
-            *iter = nullptr;
+            for (size_t i = 0; i < block.size; ++i)
+            {
+                block.slots[i].command()->~T();
+            }
+            delete[] block.slots;
         }
-        _allocatedPoolBlocks.clear();
+        _blocks.clear();
     }
 
+    /** Returns a command of the pool, or nullptr when a new block can't be allocated. */
     T* generateCommand()
     {
-        T* result = nullptr;
-        if(_freePool.empty())
+        Slot* slot = _freeList;
+        if (slot)
         {
-            AllocateCommands();
+            _freeList = slot->next;
         }
-        result = _freePool.front();
-        _freePool.pop_front();
-        //_usedPool.insert(result);
-        return result;
+        else
+        {
+            slot = nextUnusedSlot();
+            if (!slot)
+                return nullptr;
+        }
+
+        if (++_usedCount > _highestUsedCount)
+            _highestUsedCount = _usedCount;
+
+        return slot->command();
     }
     
     void pushBackCommand(T* ptr)
     {
-//        if(_usedPool.find(ptr) == _usedPool.end())
-//        {
-//            CCLOG("push Back Wrong command!");
-//            return;
-//        }
-        
-        _freePool.push_back(ptr);
-        //_usedPool.erase(ptr);
-        
+        CCASSERT(ptr && _usedCount > 0, "push back wrong command!");
+
+        Slot* slot = Slot::fromCommand(ptr);
+        slot->next = _freeList;
+        _freeList = slot;
+        --_usedCount;
+    }
+
+    /** Returns all the generated commands to the pool. The blocks are kept for the next frame. */
+    void reset()
+    {
+        for (auto& block : _blocks)
+        {
+            block.used = 0;
+        }
+        _freeList = nullptr;
+        _currentBlock = 0;
+        _usedCount = 0;
     }
+
+    /** number of commands that can be generated without allocating a new block */
+    size_t getCapacity() const { return _capacity; }
+    /** number of commands generated and not pushed back yet */
+    size_t getUsedCount() const { return _usedCount; }
+    /** highest number of commands used at the same time */
+    size_t getHighestUsedCount() const { return _highestUsedCount; }
+    /** number of blocks allocated by the pool */
+    size_t getBlockCount() const { return _blocks.size(); }
+
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+    std::string diagnostics() const
+    {
+        std::stringstream s;
+        s << AllocatorBase::tag() << " blocks:" << _blocks.size() << " capacity:" << _capacity << " count:" << _usedCount << " highest:" << _highestUsedCount << "\n";
+        return s.str();
+    }
+#endif
+
 private:
-    void AllocateCommands()
+    // The command is constructed in raw storage so that Slot stays a standard-layout type
+    // whatever T is, and offsetof() can be used to go back from a command to its slot.
+    struct Slot
+    {
+        Slot* next;     // only meaningful while the slot is in the free list
+        typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage;
+
+        T* command() { return reinterpret_cast<T*>(&storage); }
+        static Slot* fromCommand(T* command)
+        {
+            return reinterpret_cast<Slot*>(reinterpret_cast<char*>(command) - offsetof(Slot, storage));
+        }
+    };
+
+    struct Block
+    {
+        Slot* slots;
+        size_t size;
+        size_t used;    // slots handed out from this block since the last reset
+    };
+
+    // bump allocates from the blocks, a new block is only allocated when all of them are used
+    Slot* nextUnusedSlot()
+    {
+        while (_currentBlock < _blocks.size() && _blocks[_currentBlock].used == _blocks[_currentBlock].size)
+        {
+            ++_currentBlock;
+        }
+
+        if (_currentBlock == _blocks.size() && !allocateBlock())
+        {
+            return nullptr;
+        }
+
+        Block& block = _blocks[_currentBlock];
+        return &block.slots[block.used++];
+    }
+
+    // the commands are constructed once with the block and reused until the pool is deleted, like the commands of new T[]
+    bool allocateBlock()
     {
-        static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
-        T* commands = new (std::nothrow) T[COMMANDS_ALLOCATE_BLOCK_SIZE];
-        _allocatedPoolBlocks.push_back(commands);
-        for(int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+        size_t size = _blocks.empty() ? _blockSize : std::min(_blocks.back().size * _growthFactor, _maxBlockSize);
+
+        Block block;
+        block.slots = new (std::nothrow) Slot[size];
+        if (!block.slots)
+        {
+            CCLOG("cocos2d: RenderCommandPool: can't allocate a block of %d commands", (int)size);
+            return false;
+        }
+        for (size_t i = 0; i < size; ++i)
         {
-            _freePool.push_back(commands+index);
+            new (block.slots[i].command()) T();
         }
+        block.size = size;
+        block.used = 0;
+        _blocks.push_back(block);
+        _capacity += size;
+        return true;
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
-    //std::set<T*> _usedPool;
+    std::vector<Block> _blocks;
+    Slot* _freeList;
+
+    size_t _blockSize;
+    size_t _growthFactor;
+    size_t _maxBlockSize;
+    size_t _currentBlock;
+
+    size_t _capacity;
+    size_t _usedCount;
+    size_t _highestUsedCount;
 };
 
 NS_CC_END
@@ -35,11 +35,13 @@
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCMeshCommand.h"
+#include "renderer/CCStreamBuffer.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCWorkerPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
 
@@ -51,6 +53,128 @@ static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
     return a->getGlobalOrder() < b->getGlobalOrder();
 }
 
+// maps the global order to an unsigned integer that has the same ordering
+static inline uint32_t globalOrderKey(float globalOrder)
+{
+    // +0 and -0 must have the same key
+    if (globalOrder == 0)
+        globalOrder = 0;
+
+    uint32_t bits;
+    memcpy(&bits, &globalOrder, sizeof(bits));
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+// scratch buffers of the radix sort. Queues are only sorted by the cocos thread
+static std::vector<uint64_t> s_sortKeys;
+static std::vector<uint64_t> s_sortKeysTemp;
+static std::vector<RenderCommand*> s_sortCommandsTemp;
+
+// Stable LSD radix sort of `commands` by `s_sortKeys`, 8 bits per pass.
+// Passes on bytes that are the same for all the keys are skipped.
+static void radixSortCommands(std::vector<RenderCommand*>& commands)
+{
+    size_t count = commands.size();
+    s_sortKeysTemp.resize(count);
+    s_sortCommandsTemp.resize(count);
+
+    uint64_t* keys = s_sortKeys.data();
+    uint64_t* keysTemp = s_sortKeysTemp.data();
+    RenderCommand** cmds = commands.data();
+    RenderCommand** cmdsTemp = s_sortCommandsTemp.data();
+
+    // the histograms of the 8 bytes are built in a single read of the keys
+    static size_t histograms[8][256];
+    memset(histograms, 0, sizeof(histograms));
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint64_t key = keys[i];
+        for (int byte = 0; byte < 8; ++byte)
+            ++histograms[byte][(key >> (byte * 8)) & 0xff];
+    }
+
+    for (int byte = 0; byte < 8; ++byte)
+    {
+        int shift = byte * 8;
+        size_t* histogram = histograms[byte];
+        if (histogram[(keys[0] >> shift) & 0xff] == count)
+            continue;
+
+        size_t offset = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            size_t bucket = histogram[i];
+            histogram[i] = offset;
+            offset += bucket;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t dst = histogram[(keys[i] >> shift) & 0xff]++;
+            keysTemp[dst] = keys[i];
+            cmdsTemp[dst] = cmds[i];
+        }
+
+        std::swap(keys, keysTemp);
+        std::swap(cmds, cmdsTemp);
+    }
+
+    // odd number of passes: the result is in the scratch buffer
+    if (cmds != commands.data())
+        memcpy(commands.data(), cmds, count * sizeof(RenderCommand*));
+}
+
+static inline uint32_t batchMaterialID(RenderCommand* command)
+{
+    switch (command->getType())
+    {
+        case RenderCommand::Type::QUAD_COMMAND:
+            return static_cast<QuadCommand*>(command)->getMaterialID();
+        case RenderCommand::Type::TRIANGLES_COMMAND:
+            return static_cast<TrianglesCommand*>(command)->getMaterialID();
+        default:
+            return Renderer::MATERIAL_ID_DO_NOT_BATCH;
+    }
+}
+
+// Radix sorts the commands by global order. When `batchMaterials` is true, the runs of batchable
+// commands of the same type and global order are sorted by material ID too.
+// Key: global order (32 bits) | material ID (32 bits), the stability keeps the submission order.
+static void sortCommands(std::vector<RenderCommand*>& commands, bool descending, bool batchMaterials)
+{
+    size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    s_sortKeys.resize(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t key = globalOrderKey(commands[i]->getGlobalOrder());
+        s_sortKeys[i] = (uint64_t)(descending ? ~key : key) << 32;
+    }
+    radixSortCommands(commands);
+
+    if (!batchMaterials)
+        return;
+
+    // commands that don't batch, or a change of type or global order, end a run.
+    // Each run gets its own index in the high bits, so the commands never leave their run.
+    uint32_t run = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto command = commands[i];
+        uint32_t materialID = batchMaterialID(command);
+        bool sameRun = i > 0 && materialID != Renderer::MATERIAL_ID_DO_NOT_BATCH
+            && command->getType() == commands[i-1]->getType()
+            && command->getGlobalOrder() == commands[i-1]->getGlobalOrder()
+            && batchMaterialID(commands[i-1]) != Renderer::MATERIAL_ID_DO_NOT_BATCH;
+        if (!sameRun)
+            ++run;
+        s_sortKeys[i] = ((uint64_t)run << 32) | materialID;
+    }
+    radixSortCommands(commands);
+}
+
 // queue
 
 void RenderQueue::push_back(RenderCommand* command)
@@ -69,11 +193,22 @@ ssize_t RenderQueue::size() const
     return _queueNegZ.size() + _queue0.size() + _queuePosZ.size();
 }
 
-void RenderQueue::sort()
+void RenderQueue::sort(SortMode mode)
 {
-    // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_queueNegZ), std::end(_queueNegZ), compareRenderCommand);
-    std::sort(std::begin(_queuePosZ), std::end(_queuePosZ), compareRenderCommand);
+    if (mode == SortMode::DEFAULT)
+    {
+        // Don't sort _queue0, it already comes sorted
+        std::sort(std::begin(_queueNegZ), std::end(_queueNegZ), compareRenderCommand);
+        std::sort(std::begin(_queuePosZ), std::end(_queuePosZ), compareRenderCommand);
+        return;
+    }
+
+    bool batchMaterials = (mode == SortMode::RADIX_BATCH_MATERIALS);
+    sortCommands(_queueNegZ, false, batchMaterials);
+    sortCommands(_queuePosZ, false, batchMaterials);
+    // _queue0 comes sorted, but its materials can still be grouped
+    if (batchMaterials)
+        sortCommands(_queue0, false, true);
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -102,6 +237,13 @@ void RenderQueue::clear()
     _queuePosZ.clear();
 }
 
+void RenderQueue::append(const RenderQueue& other)
+{
+    _queueNegZ.insert(_queueNegZ.end(), other._queueNegZ.begin(), other._queueNegZ.end());
+    _queue0.insert(_queue0.end(), other._queue0.begin(), other._queue0.end());
+    _queuePosZ.insert(_queuePosZ.end(), other._queuePosZ.begin(), other._queuePosZ.end());
+}
+
 // helper
 static bool compareTransparentRenderCommand(RenderCommand* a, RenderCommand* b)
 {
@@ -113,9 +255,13 @@ void TransparentRenderQueue::push_back(RenderCommand* command)
     _queueCmd.push_back(command);
 }
 
-void TransparentRenderQueue::sort()
+void TransparentRenderQueue::sort(RenderQueue::SortMode mode)
 {
-    std::sort(std::begin(_queueCmd), std::end(_queueCmd), compareTransparentRenderCommand);
+    // transparent commands are not batched, so the materials are never grouped
+    if (mode == RenderQueue::SortMode::DEFAULT)
+        std::sort(std::begin(_queueCmd), std::end(_queueCmd), compareTransparentRenderCommand);
+    else
+        sortCommands(_queueCmd, true, false);
 }
 
 RenderCommand* TransparentRenderQueue::operator[](ssize_t index) const
@@ -142,8 +288,24 @@ Renderer::Renderer()
 ,_filledVertex(0)
 ,_filledIndex(0)
 ,_numberQuads(0)
+,_batchVerts(_verts)
+,_batchIndices(_indices)
+,_batchVertexCapacity(VBO_SIZE)
+,_batchIndexCapacity(INDEX_VBO_SIZE)
+,_batchQuadVerts(_quadVerts)
+,_batchQuadVertexCapacity(VBO_SIZE)
+,_bufferStreamingEnabled(false)
+,_trianglesStreamed(false)
+,_quadsStreamed(false)
+,_streamVerts(nullptr)
+,_streamIndices(nullptr)
+,_streamQuadVerts(nullptr)
 ,_glViewAssigned(false)
 ,_isRendering(false)
+,_recordingInParallel(false)
+,_cameraDrawLists(nullptr)
+,_legacyMatrixStackEnabled(true)
+,_sortMode(RenderQueue::SortMode::DEFAULT)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
@@ -164,6 +326,11 @@ Renderer::~Renderer()
     
     glDeleteBuffers(2, _buffersVBO);
     glDeleteBuffers(2, _quadbuffersVBO);
+#if CC_ENABLE_VBO_STREAMING
+    CC_SAFE_DELETE(_streamVerts);
+    CC_SAFE_DELETE(_streamIndices);
+    CC_SAFE_DELETE(_streamQuadVerts);
+#endif
     
     if (Configuration::getInstance()->supportsShareableVAO())
     {
@@ -310,6 +477,43 @@ void Renderer::mapBuffers()
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::setBufferStreamingEnabled(bool enabled)
+{
+    CCASSERT(!_isRendering, "Cannot change the streaming mode while rendering");
+
+#if CC_ENABLE_VBO_STREAMING
+    if (enabled && !Configuration::getInstance()->supportsBufferStreaming())
+    {
+        CCLOG("cocos2d: Renderer: buffer streaming is not supported");
+        return;
+    }
+
+    if (enabled && _streamVerts == nullptr)
+    {
+        _streamVerts = new (std::nothrow) StreamBuffer();
+        _streamIndices = new (std::nothrow) StreamBuffer();
+        _streamQuadVerts = new (std::nothrow) StreamBuffer();
+        if (!_streamVerts || !_streamVerts->init(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE)
+            || !_streamIndices || !_streamIndices->init(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE)
+            || !_streamQuadVerts || !_streamQuadVerts->init(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * VBO_SIZE))
+        {
+            CCLOG("cocos2d: Renderer: failed to create the stream buffers, buffer streaming stays disabled");
+            CC_SAFE_DELETE(_streamVerts);
+            CC_SAFE_DELETE(_streamIndices);
+            CC_SAFE_DELETE(_streamQuadVerts);
+            _bufferStreamingEnabled = false;
+            return;
+        }
+    }
+    _bufferStreamingEnabled = enabled;
+#else
+    if (enabled)
+    {
+        CCLOG("cocos2d: Renderer: buffer streaming is disabled by CC_ENABLE_VBO_STREAMING");
+    }
+#endif
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
     int renderQueue =_commandGroupStack.top();
@@ -321,6 +525,16 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(!_isRendering, "Cannot add command while rendering");
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
+    // the recorded nodes are drawn when the lists are replayed for each camera, only an overridden visit() adds a command here
+    CCASSERT(_cameraDrawLists == nullptr, "A node overrides visit() but not hasCustomVisit(): it can't be recorded for all the cameras");
+
+    if (_recordingInParallel)
+    {
+        CCASSERT(renderQueue == _commandGroupStack.top(), "Cannot add commands to another render queue while recording in parallel");
+        int threadIndex = WorkerPool::getInstance()->getCurrentThreadIndex();
+        _threadRecordingQueues[threadIndex]->push_back(command);
+        return;
+    }
     
     _renderGroups[renderQueue].push_back(command);
 }
@@ -328,15 +542,48 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(!_recordingInParallel, "Cannot change render queue while recording in parallel");
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(!_recordingInParallel, "Cannot change render queue while recording in parallel");
     _commandGroupStack.pop();
 }
 
+void Renderer::recordInParallel(ssize_t count, const std::function<void(ssize_t)>& func)
+{
+    CCASSERT(!_isRendering, "Cannot record commands while rendering");
+    CCASSERT(!_recordingInParallel, "recordInParallel() can't be nested");
+
+    auto pool = WorkerPool::getInstance();
+
+    if ((ssize_t)_recordedQueues.size() < count)
+        _recordedQueues.resize(count);
+    for (ssize_t i = 0; i < count; ++i)
+        _recordedQueues[i].clear();
+    _threadRecordingQueues.assign(pool->getWorkerCount() + 1, nullptr);
+
+    _recordingInParallel = true;
+    pool->parallelFor(count, [this, pool, &func](ssize_t index) {
+        // each thread only writes its own slot, and the slots don't move while recording
+        _threadRecordingQueues[pool->getCurrentThreadIndex()] = &_recordedQueues[index];
+        func(index);
+    });
+    _recordingInParallel = false;
+}
+
+void Renderer::mergeRecordedCommands(ssize_t index)
+{
+    CCASSERT(!_recordingInParallel, "Cannot merge while recording in parallel");
+    CCASSERT(index >= 0 && index < (ssize_t)_recordedQueues.size(), "Invalid index");
+
+    _renderGroups[_commandGroupStack.top()].append(_recordedQueues[index]);
+    _recordedQueues[index].clear();
+}
+
 int Renderer::createRenderQueue()
 {
     RenderQueue newRenderQueue;
@@ -363,13 +610,9 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
             
             auto cmd = static_cast<TrianglesCommand*>(command);
             //Batch Triangles
-            if( _filledVertex + cmd->getVertexCount() > VBO_SIZE || _filledIndex + cmd->getIndexCount() > INDEX_VBO_SIZE)
-            {
-                CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
-                CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
-                //Draw batched Triangles if VBO is full
-                drawBatchedTriangles();
-            }
+            CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
+            CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
+            prepareTriangleBatch(cmd->getVertexCount(), cmd->getIndexCount());
             
             _batchedCommands.push_back(cmd);
             
@@ -386,12 +629,8 @@ void Renderer::visitRenderQueue(const RenderQueue& queue)
             }
             auto cmd = static_cast<QuadCommand*>(command);
             //Batch quads
-            if( (_numberQuads + cmd->getQuadCount()) * 4 > VBO_SIZE )
-            {
-                CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() * 4 < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
-                //Draw batched quads if VBO is full
-                drawBatchedQuads();
-            }
+            CCASSERT(cmd->getQuadCount()>= 0 && cmd->getQuadCount() * 4 < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
+            prepareQuadBatch(cmd->getQuadCount());
             
             _batchQuadCommands.push_back(cmd);
             
@@ -518,7 +757,7 @@ void Renderer::render()
         //1. Sort render commands based on ID
         for (auto &renderqueue : _renderGroups)
         {
-            renderqueue.sort();
+            renderqueue.sort(_sortMode);
         }
         visitRenderQueue(_renderGroups[0]);
         flush();
@@ -527,7 +766,7 @@ void Renderer::render()
         //draw transparent objects here, do not batch for transparent objects
         if (0 < _transparentRenderGroups.size())
         {
-            _transparentRenderGroups.sort();
+            _transparentRenderGroups.sort(_sortMode);
             glEnable(GL_DEPTH_TEST);
             visitTransparentRenderQueue(_transparentRenderGroups);
             glDisable(GL_DEPTH_TEST);
@@ -564,21 +803,18 @@ void Renderer::clean()
 
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 {
-    memcpy(_verts + _filledVertex, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
+    V3F_C4B_T2F* verts = _batchVerts + _filledVertex;
+    memcpy(verts, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
     const Mat4& modelView = cmd->getModelView();
     
-    for(ssize_t i=0; i< cmd->getVertexCount(); ++i)
-    {
-        V3F_C4B_T2F *q = &_verts[i + _filledVertex];
-        Vec3 *vec1 = (Vec3*)&q->vertices;
-        modelView.transformPoint(vec1);
-    }
+    //transform the positions in one batch. The batch is only written since it may be mapped
+    modelView.transformPoints(&cmd->getVertices()->vertices, &verts->vertices, cmd->getVertexCount(), sizeof(V3F_C4B_T2F));
     
     const unsigned short* indices = cmd->getIndices();
     //fill index
     for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
     {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
+        _batchIndices[_filledIndex + i] = _filledVertex + indices[i];
     }
     
     _filledVertex += cmd->getVertexCount();
@@ -588,29 +824,152 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 void Renderer::fillQuads(const QuadCommand *cmd)
 {
     const Mat4& modelView = cmd->getModelView();
-    const V3F_C4B_T2F* quads =  (V3F_C4B_T2F*)cmd->getQuads();
-    for(ssize_t i=0; i< cmd->getQuadCount() * 4; ++i)
-    {
-        _quadVerts[i + _numberQuads * 4] = quads[i];
-        modelView.transformPoint(quads[i].vertices,&(_quadVerts[i + _numberQuads * 4].vertices));
-    }
+    V3F_C4B_T2F* verts = _batchQuadVerts + _numberQuads * 4;
+    memcpy(verts, cmd->getQuads(), sizeof(V3F_C4B_T2F_Quad) * cmd->getQuadCount());
+    
+    //transform the positions in one batch. The batch is only written since it may be mapped
+    modelView.transformPoints(&cmd->getQuads()->tl.vertices, &verts->vertices, cmd->getQuadCount() * 4, sizeof(V3F_C4B_T2F));
     
     _numberQuads += cmd->getQuadCount();
 }
 
+void Renderer::prepareTriangleBatch(ssize_t vertexCount, ssize_t indexCount)
+{
+    if (_filledVertex + vertexCount > _batchVertexCapacity || _filledIndex + indexCount > _batchIndexCapacity)
+    {
+        //Draw batched Triangles if VBO is full
+        drawBatchedTriangles();
+    }
+
+#if CC_ENABLE_VBO_STREAMING
+    // only an empty batch can move to the stream buffers, the vertices already batched are in the arrays
+    if (_bufferStreamingEnabled && !_trianglesStreamed && _filledVertex == 0 && _filledIndex == 0)
+    {
+        GLsizeiptr vertsSize, indicesSize;
+        void* verts = _streamVerts->map(sizeof(_verts[0]) * vertexCount, &vertsSize);
+        void* indices = verts ? _streamIndices->map(sizeof(_indices[0]) * indexCount, &indicesSize) : nullptr;
+        if (indices)
+        {
+            _batchVerts = static_cast<V3F_C4B_T2F*>(verts);
+            _batchIndices = static_cast<GLushort*>(indices);
+            // indices are unsigned shorts, a batch can't use more than VBO_SIZE vertices
+            _batchVertexCapacity = std::min((int)(vertsSize / sizeof(_verts[0])), VBO_SIZE);
+            _batchIndexCapacity = std::min((int)(indicesSize / sizeof(_indices[0])), INDEX_VBO_SIZE);
+            _trianglesStreamed = true;
+        }
+        else if (verts)
+        {
+            // fall back to the arrays until this batch is drawn
+            _streamVerts->unmap(0);
+        }
+    }
+#endif
+}
+
+void Renderer::prepareQuadBatch(ssize_t quadCount)
+{
+    if ((_numberQuads + quadCount) * 4 > _batchQuadVertexCapacity)
+    {
+        //Draw batched quads if VBO is full
+        drawBatchedQuads();
+    }
+
+#if CC_ENABLE_VBO_STREAMING
+    // only an empty batch can move to the stream buffer, the quads already batched are in the array
+    if (_bufferStreamingEnabled && !_quadsStreamed && _numberQuads == 0)
+    {
+        GLsizeiptr size;
+        void* verts = _streamQuadVerts->map(sizeof(V3F_C4B_T2F_Quad) * quadCount, &size);
+        if (verts)
+        {
+            _batchQuadVerts = static_cast<V3F_C4B_T2F*>(verts);
+            // the quads are drawn with _quadIndices, made for VBO_SIZE vertices
+            _batchQuadVertexCapacity = std::min((int)(size / sizeof(_quadVerts[0])), VBO_SIZE);
+            _quadsStreamed = true;
+        }
+    }
+#endif
+}
+
+void Renderer::setupVertexAttribs(GLintptr offset)
+{
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+
+    // vertices
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, vertices)));
+
+    // colors
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, colors)));
+
+    // tex coords
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) (offset + offsetof(V3F_C4B_T2F, texCoords)));
+}
+
 void Renderer::drawBatchedTriangles()
 {
     //TODO: we can improve the draw performance by insert material switching command before hand.
 
     int indexToDraw = 0;
     int startIndex = 0;
+    GLintptr indexOffset = 0;
 
     //Upload buffer to VBO
     if(_filledVertex <= 0 || _filledIndex <= 0 || _batchedCommands.empty())
     {
+#if CC_ENABLE_VBO_STREAMING
+        if (_trianglesStreamed)
+        {
+            _streamVerts->unmap(0);
+            _streamIndices->unmap(0);
+            _trianglesStreamed = false;
+            _batchVerts = _verts;
+            _batchIndices = _indices;
+            _batchVertexCapacity = VBO_SIZE;
+            _batchIndexCapacity = INDEX_VBO_SIZE;
+        }
+#endif
         return;
     }
 
+    bool streamed = _trianglesStreamed;
+#if CC_ENABLE_VBO_STREAMING
+    GLintptr vertexOffset = 0;
+    if (streamed)
+    {
+        // the data is already in the stream buffers, written by fillVerticesAndIndices()
+        vertexOffset = _streamVerts->unmap(sizeof(_verts[0]) * _filledVertex);
+        indexOffset = _streamIndices->unmap(sizeof(_indices[0]) * _filledIndex);
+
+        _trianglesStreamed = false;
+        _batchVerts = _verts;
+        _batchIndices = _indices;
+        _batchVertexCapacity = VBO_SIZE;
+        _batchIndexCapacity = INDEX_VBO_SIZE;
+
+        if (vertexOffset < 0 || indexOffset < 0)
+        {
+            // the stores were corrupted while mapped, the batch is filled again in the arrays and uploaded below
+            CCLOG("cocos2d: Renderer: stream buffers corrupted, uploading the triangles again");
+            _filledVertex = 0;
+            _filledIndex = 0;
+            for (const auto& cmd : _batchedCommands)
+            {
+                fillVerticesAndIndices(cmd);
+            }
+            indexOffset = 0;
+            streamed = false;
+        }
+    }
+
+    if (streamed)
+    {
+        GL::bindVAO(0);
+        glBindBuffer(GL_ARRAY_BUFFER, _streamVerts->getBuffer());
+        setupVertexAttribs(vertexOffset);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _streamIndices->getBuffer());
+    }
+    else
+#endif
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         //Bind VAO
@@ -628,7 +987,11 @@ void Renderer::drawBatchedTriangles()
         glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, nullptr, GL_DYNAMIC_DRAW);
         void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
         memcpy(buf, _verts, sizeof(_verts[0])* _filledVertex);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
+        if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+        {
+            // the data store was corrupted while mapped
+            glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * _filledVertex, _verts, GL_DYNAMIC_DRAW);
+        }
 
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         
@@ -666,7 +1029,7 @@ void Renderer::drawBatchedTriangles()
             //Draw quads
             if(indexToDraw > 0)
             {
-                glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_indices[0])) );
+                glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + startIndex*sizeof(_indices[0])) );
                 _drawnBatches++;
                 _drawnVertices += indexToDraw;
 
@@ -685,12 +1048,12 @@ void Renderer::drawBatchedTriangles()
     //Draw any remaining triangles
     if(indexToDraw > 0)
     {
-        glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (startIndex*sizeof(_indices[0])) );
+        glDrawElements(GL_TRIANGLES, (GLsizei) indexToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + startIndex*sizeof(_indices[0])) );
         _drawnBatches++;
         _drawnVertices += indexToDraw;
     }
 
-    if (Configuration::getInstance()->supportsShareableVAO())
+    if (!streamed && Configuration::getInstance()->supportsShareableVAO())
     {
         //Unbind VAO
         GL::bindVAO(0);
@@ -716,9 +1079,52 @@ void Renderer::drawBatchedQuads()
     //Upload buffer to VBO
     if(_numberQuads <= 0 || _batchQuadCommands.empty())
     {
+#if CC_ENABLE_VBO_STREAMING
+        if (_quadsStreamed)
+        {
+            _streamQuadVerts->unmap(0);
+            _quadsStreamed = false;
+            _batchQuadVerts = _quadVerts;
+            _batchQuadVertexCapacity = VBO_SIZE;
+        }
+#endif
         return;
     }
     
+    bool streamed = _quadsStreamed;
+#if CC_ENABLE_VBO_STREAMING
+    GLintptr offset = 0;
+    if (streamed)
+    {
+        // the quads are already in the stream buffer, written by fillQuads()
+        offset = _streamQuadVerts->unmap(sizeof(_quadVerts[0]) * _numberQuads * 4);
+
+        _quadsStreamed = false;
+        _batchQuadVerts = _quadVerts;
+        _batchQuadVertexCapacity = VBO_SIZE;
+
+        if (offset < 0)
+        {
+            // the store was corrupted while mapped, the quads are filled again in the array and uploaded below
+            CCLOG("cocos2d: Renderer: stream buffer corrupted, uploading the quads again");
+            _numberQuads = 0;
+            for (const auto& cmd : _batchQuadCommands)
+            {
+                fillQuads(cmd);
+            }
+            streamed = false;
+        }
+    }
+
+    if (streamed)
+    {
+        GL::bindVAO(0);
+        glBindBuffer(GL_ARRAY_BUFFER, _streamQuadVerts->getBuffer());
+        setupVertexAttribs(offset);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _quadbuffersVBO[1]);
+    }
+    else
+#endif
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         //Bind VAO
@@ -736,7 +1142,11 @@ void Renderer::drawBatchedQuads()
         glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4, nullptr, GL_DYNAMIC_DRAW);
         void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
         memcpy(buf, _quadVerts, sizeof(_quadVerts[0])* _numberQuads * 4);
-        glUnmapBuffer(GL_ARRAY_BUFFER);
+        if (glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+        {
+            // the data store was corrupted while mapped
+            glBufferData(GL_ARRAY_BUFFER, sizeof(_quadVerts[0]) * _numberQuads * 4, _quadVerts, GL_DYNAMIC_DRAW);
+        }
         
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         
@@ -796,7 +1206,7 @@ void Renderer::drawBatchedQuads()
         _drawnVertices += indexToDraw;
     }
     
-    if (Configuration::getInstance()->supportsShareableVAO())
+    if (!streamed && Configuration::getInstance()->supportsShareableVAO())
     {
         //Unbind VAO
         GL::bindVAO(0);
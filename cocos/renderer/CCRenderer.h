@@ -28,6 +28,7 @@
 
 #include <vector>
 #include <stack>
+#include <functional>
 
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
@@ -49,11 +50,27 @@ class MeshCommand;
 class RenderQueue {
 
 public:
+    /** How the queues are sorted by `Renderer::render()` */
+    enum class SortMode
+    {
+        /** std::sort on the global order */
+        DEFAULT,
+        /** stable radix sort on the global order */
+        RADIX,
+        /** stable radix sort on the global order, then the consecutive Quad or Triangles commands
+         that have the same global order are grouped by material ID to batch them.
+         The drawing order of overlapping commands using different materials is not kept.
+         */
+        RADIX_BATCH_MATERIALS,
+    };
+
     void push_back(RenderCommand* command);
     ssize_t size() const;
-    void sort();
+    void sort(SortMode mode = SortMode::DEFAULT);
     RenderCommand* operator[](ssize_t index) const;
     void clear();
+    /** appends the commands of another queue, as if they were pushed back one by one */
+    void append(const RenderQueue& other);
 
 protected:
     std::vector<RenderCommand*> _queueNegZ;
@@ -69,7 +86,7 @@ public:
     {
         return _queueCmd.size();
     }
-    void sort();
+    void sort(RenderQueue::SortMode mode = RenderQueue::SortMode::DEFAULT);
     RenderCommand* operator[](ssize_t index) const;
     void clear();
     
@@ -84,6 +101,8 @@ struct RenderStackElement
 };
 
 class GroupCommandManager;
+class StreamBuffer;
+class CameraDrawLists;
 
 /* Class responsible for the rendering in.
 
@@ -138,9 +157,48 @@ public:
 
     inline GroupCommandManager* getGroupCommandManager() const { return _groupCommandManager; };
 
+    /** Sets how the render queues are sorted before being drawn. Default is RenderQueue::SortMode::DEFAULT.
+     Compare getDrawnBatches() between the modes to measure the draw calls saved by RADIX_BATCH_MATERIALS.
+     */
+    void setSortMode(RenderQueue::SortMode mode) { _sortMode = mode; }
+    RenderQueue::SortMode getSortMode() const { return _sortMode; }
+
+    /** Streams the batched quads and triangles into ring buffers, written directly by the render commands,
+     instead of copying them to the VBOs at every flush.
+     It is ignored when `Configuration::supportsBufferStreaming()` is false. Disabled by default.
+     */
+    void setBufferStreamingEnabled(bool enabled);
+    bool isBufferStreamingEnabled() const { return _bufferStreamingEnabled; }
+
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
+    /** Calls `func(index)` for every index in [0, count) on the worker threads.
+     The commands added by each call are recorded into a private queue for that index,
+     and they are added to the current render queue by `mergeRecordedCommands(index)`.
+     Groups can't be pushed or popped while recording.
+     */
+    void recordInParallel(ssize_t count, const std::function<void(ssize_t)>& func);
+
+    /** Adds the commands recorded for `index` by the last `recordInParallel()` to the current render queue */
+    void mergeRecordedCommands(ssize_t index);
+
+    /** returns whether `recordInParallel()` is running */
+    bool isRecordingInParallel() const { return _recordingInParallel; }
+
+    /** While lists are set, Node::visit() records the draws into them instead of drawing.
+     @see Scene::setCameraVisitMode()
+     */
+    void setCameraDrawLists(CameraDrawLists* lists) { _cameraDrawLists = lists; }
+    CameraDrawLists* getCameraDrawLists() const { return _cameraDrawLists; }
+
+    /** Enables or disables the legacy model view stack of the Director during the visit. Enabled by default.
+     While disabled, Node::visit() no longer pushes and loads its transform on the stack, except for the nodes
+     that declare they read it with Node::setUsesLegacyMatrixStack(). @see Scene::setLegacyMatrixStackEnabled()
+     */
+    void setLegacyMatrixStackEnabled(bool enabled) { _legacyMatrixStackEnabled = enabled; }
+    bool isLegacyMatrixStackEnabled() const { return _legacyMatrixStackEnabled; }
+
 protected:
 
     //Setup VBO or VAO based on OpenGL extensions
@@ -151,6 +209,12 @@ protected:
     void drawBatchedTriangles();
     void drawBatchedQuads();
 
+    // draw the current batch if it can't take the command, and start a new batch if needed
+    void prepareQuadBatch(ssize_t quadCount);
+    void prepareTriangleBatch(ssize_t vertexCount, ssize_t indexCount);
+    // points the vertex attributes at `offset` in the bound array buffer
+    void setupVertexAttribs(GLintptr offset);
+
     //Draw the previews queued quads and flush previous context
     void flush();
     
@@ -192,6 +256,21 @@ protected:
     GLuint _quadVAO;
     GLuint _quadbuffersVBO[2]; //0: vertex  1: indices
     int _numberQuads;
+
+    // where the batches are filled: the arrays above, or the mapped stream buffers
+    V3F_C4B_T2F* _batchVerts;
+    GLushort* _batchIndices;
+    int _batchVertexCapacity;
+    int _batchIndexCapacity;
+    V3F_C4B_T2F* _batchQuadVerts;
+    int _batchQuadVertexCapacity;
+
+    bool _bufferStreamingEnabled;
+    bool _trianglesStreamed;
+    bool _quadsStreamed;
+    StreamBuffer* _streamVerts;
+    StreamBuffer* _streamIndices;
+    StreamBuffer* _streamQuadVerts;
     
     bool _glViewAssigned;
 
@@ -202,6 +281,15 @@ protected:
     bool _isRendering;
     
     GroupCommandManager* _groupCommandManager;
+
+    // queues used by recordInParallel(), one per index, and the one each thread is recording into
+    std::vector<RenderQueue> _recordedQueues;
+    std::vector<RenderQueue*> _threadRecordingQueues;
+    bool _recordingInParallel;
+    CameraDrawLists* _cameraDrawLists;
+    bool _legacyMatrixStackEnabled;
+
+    RenderQueue::SortMode _sortMode;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
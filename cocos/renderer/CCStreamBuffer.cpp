@@ -0,0 +1,183 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#include "renderer/CCStreamBuffer.h"
+
+#if CC_ENABLE_VBO_STREAMING
+
+#include "renderer/ccGLStateCache.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+// offsets of the mapped ranges are kept aligned for the vertex attributes
+static const GLintptr STREAM_BUFFER_ALIGNMENT = 16;
+
+#if COCOS2D_DEBUG > 0
+int StreamBuffer::s_mapFailureInterval = 0;
+int StreamBuffer::s_mapCount = 0;
+
+void StreamBuffer::setMapFailureInterval(int interval)
+{
+    s_mapFailureInterval = interval;
+    s_mapCount = 0;
+}
+#endif
+
+StreamBuffer::StreamBuffer()
+: _target(GL_ARRAY_BUFFER)
+, _buffer(0)
+, _segmentSize(0)
+, _segmentCount(0)
+, _segment(0)
+, _offset(0)
+, _mappedOffset(0)
+, _mapped(false)
+{
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    for (auto fence : _fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+    }
+    if (_buffer)
+    {
+        glDeleteBuffers(1, &_buffer);
+    }
+}
+
+bool StreamBuffer::init(GLenum target, GLsizeiptr segmentSize, int segmentCount)
+{
+    CCASSERT(segmentSize > 0 && segmentCount > 1, "Invalid StreamBuffer size");
+
+    _target = target;
+    _segmentSize = segmentSize;
+    _segmentCount = segmentCount;
+    _segment = 0;
+    _offset = 0;
+    _fences.assign(segmentCount, nullptr);
+
+    // Avoid changing the element buffer for whatever VAO might be bound.
+    GL::bindVAO(0);
+
+    glGenBuffers(1, &_buffer);
+    glBindBuffer(_target, _buffer);
+    glBufferData(_target, _segmentSize * _segmentCount, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(_target, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+    return _buffer != 0;
+}
+
+void StreamBuffer::nextSegment()
+{
+    _fences[_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    _segment = (_segment + 1) % _segmentCount;
+    _offset = _segment * _segmentSize;
+
+    GLsync fence = _fences[_segment];
+    if (fence)
+    {
+        // the commands are flushed by the first wait only
+        GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+        for (;;)
+        {
+            GLenum result = glClientWaitSync(fence, flags, 1000000);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+                break;
+            flags = 0;
+        }
+        glDeleteSync(fence);
+        _fences[_segment] = nullptr;
+    }
+}
+
+void* StreamBuffer::map(GLsizeiptr minSize, GLsizeiptr* mappedSize)
+{
+    CCASSERT(!_mapped, "StreamBuffer already mapped");
+    CCASSERT(minSize <= _segmentSize, "StreamBuffer segments are too small");
+
+#if COCOS2D_DEBUG > 0
+    if (s_mapFailureInterval > 0 && ++s_mapCount % s_mapFailureInterval == 0)
+    {
+        return nullptr;
+    }
+#endif
+
+    GLintptr segmentEnd = (_segment + 1) * _segmentSize;
+    if (_offset + minSize > segmentEnd)
+    {
+        nextSegment();
+        segmentEnd = (_segment + 1) * _segmentSize;
+    }
+
+    GL::bindVAO(0);
+    glBindBuffer(_target, _buffer);
+    void* buf = glMapBufferRange(_target, _offset, segmentEnd - _offset,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_FLUSH_EXPLICIT_BIT);
+    glBindBuffer(_target, 0);
+
+    if (buf == nullptr)
+    {
+        CCLOG("cocos2d: StreamBuffer: failed to map the buffer");
+        return nullptr;
+    }
+
+    _mapped = true;
+    _mappedOffset = _offset;
+    *mappedSize = segmentEnd - _offset;
+    return buf;
+}
+
+GLintptr StreamBuffer::unmap(GLsizeiptr usedSize)
+{
+    CCASSERT(_mapped, "StreamBuffer not mapped");
+
+    GL::bindVAO(0);
+    glBindBuffer(_target, _buffer);
+    if (usedSize > 0)
+    {
+        glFlushMappedBufferRange(_target, 0, usedSize);
+    }
+    GLboolean valid = glUnmapBuffer(_target);
+    glBindBuffer(_target, 0);
+
+    _mapped = false;
+    _offset = (_mappedOffset + usedSize + STREAM_BUFFER_ALIGNMENT - 1) & ~(STREAM_BUFFER_ALIGNMENT - 1);
+    if (valid == GL_FALSE)
+    {
+        CCLOG("cocos2d: StreamBuffer: the data store was corrupted while mapped");
+        return -1;
+    }
+    return _mappedOffset;
+}
+
+NS_CC_END
+
+#endif // CC_ENABLE_VBO_STREAMING
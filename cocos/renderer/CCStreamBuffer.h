@@ -0,0 +1,101 @@
+/****************************************************************************
+ Copyright (c) 2013-2014 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+
+#ifndef __CC_STREAM_BUFFER_H__
+#define __CC_STREAM_BUFFER_H__
+
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+#include "platform/CCGL.h"
+#include "base/ccConfig.h"
+
+#if CC_ENABLE_VBO_STREAMING
+
+NS_CC_BEGIN
+
+/** @brief A GL buffer written as a ring, for data that changes at every draw.
+
+ The buffer is split in segments. Each `map()` returns the free space left in the current segment,
+ and `unmap()` keeps only the bytes that were written, so the next `map()` starts right after them.
+ Nothing is respecified and the mapping is unsynchronized: before writing again into a segment,
+ the buffer waits for the fence inserted when it was left, which is signaled once the GPU stopped reading it.
+ */
+class CC_DLL StreamBuffer
+{
+public:
+    StreamBuffer();
+    ~StreamBuffer();
+
+    /** creates a buffer of `segmentCount` segments of `segmentSize` bytes for `target` */
+    bool init(GLenum target, GLsizeiptr segmentSize, int segmentCount = 3);
+
+    GLuint getBuffer() const { return _buffer; }
+
+    /** Maps the free space of the current segment, or of the next one if less than `minSize` bytes are left.
+     Returns nullptr if the buffer couldn't be mapped. `mappedSize` receives the size of the mapped range.
+     */
+    void* map(GLsizeiptr minSize, GLsizeiptr* mappedSize);
+
+    /** Unmaps the buffer, keeping the first `usedSize` bytes of the mapped range.
+     Returns the offset of the mapped range in the buffer, to be used by the draw calls,
+     or -1 if GL reported that the data store was corrupted while mapped and must be written again.
+     */
+    GLintptr unmap(GLsizeiptr usedSize);
+
+    bool isMapped() const { return _mapped; }
+
+#if COCOS2D_DEBUG > 0
+    /** Debug only: makes one call to `map()` out of `interval` fail, for all the stream buffers.
+     Used to test the fallback of the renderer to its client side arrays. 0 disables it.
+     */
+    static void setMapFailureInterval(int interval);
+#endif
+
+protected:
+    // fences the current segment and waits until the next one isn't used by the GPU anymore
+    void nextSegment();
+
+    GLenum _target;
+    GLuint _buffer;
+    GLsizeiptr _segmentSize;
+    int _segmentCount;
+    int _segment;
+    GLintptr _offset;
+    GLintptr _mappedOffset;
+    bool _mapped;
+    std::vector<GLsync> _fences;
+
+#if COCOS2D_DEBUG > 0
+    static int s_mapFailureInterval;
+    static int s_mapCount;
+#endif
+};
+
+NS_CC_END
+
+#endif // CC_ENABLE_VBO_STREAMING
+
+#endif //__CC_STREAM_BUFFER_H__
@@ -45,6 +45,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCPixelConvert.h"
 
 #include "deprecated/CCString.h"
 
@@ -123,6 +124,7 @@ static Texture2D::PixelFormat g_defaultAlphaPixelFormat = Texture2D::PixelFormat
 
 //////////////////////////////////////////////////////////////////////////
 //conventer function
+// The scalar conversions are the reference. The common ones use the SIMD kernels of PixelConvertKernels when available.
 
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBB
 void Texture2D::convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
@@ -149,6 +151,13 @@ void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->i8ToRGBA8888)
+    {
+        simd->i8ToRGBA8888(data, dataLen, outData);
+        return;
+    }
+
     for (ssize_t i = 0; i < dataLen; ++i)
     {
         *outData++ = data[i];     //R
@@ -161,6 +170,13 @@ void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->ai88ToRGBA8888)
+    {
+        simd->ai88ToRGBA8888(data, dataLen, outData);
+        return;
+    }
+
     for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i];     //R
@@ -278,6 +294,13 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->rgb888ToRGBA8888)
+    {
+        simd->rgb888ToRGBA8888(data, dataLen, outData);
+        return;
+    }
+
     for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = data[i];         //R
@@ -290,6 +313,13 @@ void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->rgba8888ToRGB888)
+    {
+        simd->rgba8888ToRGB888(data, dataLen, outData);
+        return;
+    }
+
     for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
     {
         *outData++ = data[i];         //R
@@ -313,6 +343,13 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->rgba8888ToRGB565)
+    {
+        simd->rgba8888ToRGB565(data, dataLen, outData);
+        return;
+    }
+
     unsigned short* out16 = (unsigned short*)outData;
     for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
     {
@@ -343,6 +380,13 @@ void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->rgba8888ToA8)
+    {
+        simd->rgba8888ToA8(data, dataLen, outData);
+        return;
+    }
+
     for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
     {
         *outData++ = data[i + 3]; //A
@@ -386,6 +430,13 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->rgba8888ToRGBA4444)
+    {
+        simd->rgba8888ToRGBA4444(data, dataLen, outData);
+        return;
+    }
+
     unsigned short* out16 = (unsigned short*)outData;
     for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
     {
@@ -412,6 +463,13 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    auto simd = PixelConvertKernels::getInstance();
+    if (simd && simd->rgba8888ToRGB5A1)
+    {
+        simd->rgba8888ToRGB5A1(data, dataLen, outData);
+        return;
+    }
+
     unsigned short* out16 = (unsigned short*)outData;
     for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
     {
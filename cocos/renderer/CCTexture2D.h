@@ -351,16 +351,17 @@ public:
     
 public:
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
-    
-private:
-
-    /**convert functions*/
 
     /**
     Convert the format to the format param you specified, if the format is PixelFormat::Automatic, it will detect it automatically and convert to the closest format for you.
-    It will return the converted format to you. if the outData != data, you must delete it manually.
+    It will return the converted format to you. if the outData != data, you must free it manually.
+    The common conversions use the SIMD kernels of PixelConvertKernels when the cpu has them.
     */
     static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
+    
+private:
+
+    /**convert functions*/
 
     static PixelFormat convertI8ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertAI88ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
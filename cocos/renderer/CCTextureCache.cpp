@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -59,11 +61,15 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _asyncStructQueue(nullptr)
-, _imageInfoQueue(nullptr)
-, _needQuit(false)
+: _needQuit(false)
 , _asyncRefCount(0)
+, _asyncRequestCount(0)
+, _asyncUploadSeconds(0.004f)
+, _asyncUploadBytes(0)
+, _asyncLoadingThreadCount(0)
+, _residencyBudget(0)
+, _evictionCount(0)
+, _restreamCount(0)
 {
 }
 
@@ -71,10 +77,15 @@ TextureCache::~TextureCache()
 {
     CCLOGINFO("deallocing TextureCache: %p", this);
 
+    waitForQuit();
+
+    if (_residencyBudget > 0)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::updateResidency), this);
+    }
+
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
-
-    CC_SAFE_DELETE(_loadingThread);
 }
 
 void TextureCache::destroyInstance()
@@ -95,32 +106,51 @@ std::string TextureCache::getDescription() const
     return StringUtils::format("<TextureCache | Number of textures = %d>", static_cast<int>(_textures.size()));
 }
 
+// orders the heap of the images waiting for a loading thread: highest priority, then oldest request first
+static bool isDecodedAfter(const TextureCache::AsyncStruct* a, const TextureCache::AsyncStruct* b)
+{
+    if (a->priority != b->priority)
+        return a->priority < b->priority;
+    return a->order > b->order;
+}
+
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
 {
-    Texture2D *texture = nullptr;
+    addImageAsync(path, callback, 0);
+}
 
+unsigned int TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, int priority)
+{
     std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
 
     auto it = _textures.find(fullpath);
     if( it != _textures.end() )
-        texture = it->second;
-
-    if (texture != nullptr)
     {
-        callback(texture);
-        return;
+        markTextureUsed(fullpath);
+        callback(it->second);
+        return 0;
     }
 
-    // lazy init
-    if (_asyncStructQueue == nullptr)
-    {             
-        _asyncStructQueue = new queue<AsyncStruct*>();
-        _imageInfoQueue   = new deque<ImageInfo*>();        
+    unsigned int requestId = ++_asyncRequestCount;
+    if (requestId == 0)
+    {
+        requestId = ++_asyncRequestCount;
+    }
 
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
+    // the file is already being loaded: wait for the same image
+    auto loading = _asyncStructs.find(fullpath);
+    if (loading != _asyncStructs.end())
+    {
+        AsyncStruct *asyncStruct = loading->second;
+        asyncStruct->callbacks.push_back(std::make_pair(requestId, callback));
 
-        _needQuit = false;
+        if (priority > asyncStruct->priority)
+        {
+            std::lock_guard<std::mutex> lock(_asyncStructQueueMutex);
+            asyncStruct->priority = priority;
+            std::make_heap(_asyncStructQueue.begin(), _asyncStructQueue.end(), isDecodedAfter);
+        }
+        return requestId;
     }
 
     if (0 == _asyncRefCount)
@@ -131,184 +161,254 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, callback);
+    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, priority, requestId);
+    data->callbacks.push_back(std::make_pair(requestId, callback));
+    _asyncStructs.insert(std::make_pair(fullpath, data));
 
     // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+    size_t pendingCount = 0;
+    size_t maxThreadCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(_asyncStructQueueMutex);
+        _asyncStructQueue.push_back(data);
+        std::push_heap(_asyncStructQueue.begin(), _asyncStructQueue.end(), isDecodedAfter);
+        pendingCount = _asyncStructQueue.size();
+        maxThreadCount = _asyncLoadingThreadCount;
+    }
 
-    _sleepCondition.notify_one();
-}
+    // the threads above the limit ignore the wake up, all of them are woken so that one under the limit takes the image
+    _sleepCondition.notify_all();
 
-void TextureCache::unbindImageAsync(const std::string& filename)
-{
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    // lazy init: the loading threads are created while images are waiting, up to one per core
+    if (maxThreadCount == 0)
     {
-        std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
-        auto found = std::find_if(_imageInfoQueue->begin(), _imageInfoQueue->end(), [&fullpath](ImageInfo* ptr)->bool{ return ptr->asyncStruct->filename == fullpath; });
-        if (found != _imageInfoQueue->end())
+        maxThreadCount = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    if (_loadingThreads.size() < maxThreadCount && _loadingThreads.size() < pendingCount)
+    {
+        if (_loadingThreads.empty())
         {
-            (*found)->asyncStruct->callback = nullptr;
+            _needQuit = false;
         }
+        _loadingThreads.push_back(std::thread(&TextureCache::loadImage, this, (unsigned int)_loadingThreads.size()));
     }
-    _imageInfoMutex.unlock();
+
+    return requestId;
 }
 
-void TextureCache::unbindAllImageAsync()
+void TextureCache::cancelImageAsync(unsigned int requestId)
 {
-    _imageInfoMutex.lock();
-    if (_imageInfoQueue && !_imageInfoQueue->empty())
+    for (auto it = _asyncStructs.begin(); it != _asyncStructs.end(); ++it)
     {
-        std::for_each(_imageInfoQueue->begin(), _imageInfoQueue->end(), [](ImageInfo* ptr) { ptr->asyncStruct->callback = nullptr; });
-    }
-    _imageInfoMutex.unlock();
-}
+        AsyncStruct *asyncStruct = it->second;
+        auto& callbacks = asyncStruct->callbacks;
+        auto found = std::find_if(callbacks.begin(), callbacks.end(), [requestId](const std::pair<unsigned int, std::function<void(Texture2D*)>>& callback){ return callback.first == requestId; });
+        if (found == callbacks.end())
+            continue;
 
-void TextureCache::loadImage()
-{
-    AsyncStruct *asyncStruct = nullptr;
+        callbacks.erase(found);
+        if (!callbacks.empty())
+            return;
 
-    while (true)
-    {
-        std::queue<AsyncStruct*> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock();
-        if (pQueue->empty())
+        // nobody waits for the image anymore
+        _asyncStructs.erase(it);
+
+        bool pending = false;
         {
-            _asyncStructQueueMutex.unlock();
-            if (_needQuit) {
-                break;
+            std::lock_guard<std::mutex> lock(_asyncStructQueueMutex);
+            auto queued = std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct);
+            if (queued != _asyncStructQueue.end())
+            {
+                _asyncStructQueue.erase(queued);
+                std::make_heap(_asyncStructQueue.begin(), _asyncStructQueue.end(), isDecodedAfter);
+                pending = true;
             }
-            else {
-                std::unique_lock<std::mutex> lk(_sleepMutex);
-                _sleepCondition.wait(lk);
-                continue;
+        }
+
+        if (pending)
+        {
+            delete asyncStruct;
+
+            --_asyncRefCount;
+            if (0 == _asyncRefCount)
+            {
+                Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
             }
         }
         else
         {
-            asyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
-        }        
+            // a loading thread owns it, it is dropped once decoded
+            asyncStruct->cancelled = true;
+        }
+        return;
+    }
+}
+
+void TextureCache::setAsyncUploadBudget(float seconds, size_t bytes)
+{
+    _asyncUploadSeconds = seconds;
+    _asyncUploadBytes = bytes;
+}
 
-        Image *image = nullptr;
-        bool generateImage = false;
+void TextureCache::setAsyncLoadingThreadCount(unsigned int count)
+{
+    {
+        std::lock_guard<std::mutex> lock(_asyncStructQueueMutex);
+        _asyncLoadingThreadCount = count;
+    }
+    // the threads allowed again take the waiting images
+    _sleepCondition.notify_all();
+}
 
-        auto it = _textures.find(asyncStruct->filename);
-        if( it == _textures.end() )
+void TextureCache::unbindImageAsync(const std::string& filename)
+{
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    auto found = _asyncStructs.find(fullpath);
+    if (found != _asyncStructs.end())
+    {
+        for (auto& callback : found->second->callbacks)
         {
-           _imageInfoMutex.lock();
-           ImageInfo *imageInfo;
-           size_t pos = 0;
-           size_t infoSize = _imageInfoQueue->size();
-           for (; pos < infoSize; pos++)
-           {
-               imageInfo = (*_imageInfoQueue)[pos];
-               if(imageInfo->asyncStruct->filename.compare(asyncStruct->filename) == 0)
-                   break;
-           }
-           _imageInfoMutex.unlock();
-           if(infoSize == 0 || pos == infoSize)
-               generateImage = true;
+            callback.second = nullptr;
         }
+    }
+}
 
-        if (generateImage)
+void TextureCache::unbindAllImageAsync()
+{
+    for (auto& loading : _asyncStructs)
+    {
+        for (auto& callback : loading.second->callbacks)
         {
-            const std::string& filename = asyncStruct->filename;
-            // generate image      
-            image = new (std::nothrow) Image();
-            if (image && !image->initWithImageFileThreadSafe(filename))
+            callback.second = nullptr;
+        }
+    }
+}
+
+void TextureCache::loadImage(unsigned int threadIndex)
+{
+    while (true)
+    {
+        AsyncStruct *asyncStruct = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(_asyncStructQueueMutex);
+            _sleepCondition.wait(lock, [this, threadIndex]{
+                return _needQuit || (!_asyncStructQueue.empty() && (_asyncLoadingThreadCount == 0 || threadIndex < _asyncLoadingThreadCount));
+            });
+            if (_needQuit)
             {
-                CC_SAFE_RELEASE(image);
-                CCLOG("can not load %s", filename.c_str());
-                continue;
+                break;
             }
-        }    
 
-        // generate image info
-        ImageInfo *imageInfo = new (std::nothrow) ImageInfo();
-        imageInfo->asyncStruct = asyncStruct;
-        imageInfo->image = image;
+            std::pop_heap(_asyncStructQueue.begin(), _asyncStructQueue.end(), isDecodedAfter);
+            asyncStruct = _asyncStructQueue.back();
+            _asyncStructQueue.pop_back();
+        }
 
-        // put the image info into the queue
-        _imageInfoMutex.lock();
-        _imageInfoQueue->push_back(imageInfo);
-        _imageInfoMutex.unlock();
-    }
-    
-	if(_asyncStructQueue != nullptr)
-    {
-        delete _asyncStructQueue;
-	    _asyncStructQueue = nullptr;
-        delete _imageInfoQueue;
-	    _imageInfoQueue = nullptr;
+        // generate image
+        const std::string& filename = asyncStruct->filename;
+        Image *image = new (std::nothrow) Image();
+        if (image && !image->initWithImageFileThreadSafe(filename))
+        {
+            CC_SAFE_RELEASE_NULL(image);
+            CCLOG("can not load %s", filename.c_str());
+        }
+        asyncStruct->image = image;
+
+        // put the image into the upload queue
+        std::lock_guard<std::mutex> lock(_imageInfoMutex);
+        _imageInfoQueue.push_back(asyncStruct);
     }
 }
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
-    // the image is generated in loading thread
-    std::deque<ImageInfo*> *imagesQueue = _imageInfoQueue;
+    auto startTime = std::chrono::steady_clock::now();
+    size_t uploadedBytes = 0;
 
-    _imageInfoMutex.lock();
-    if (imagesQueue->empty())
-    {
-        _imageInfoMutex.unlock();
-    }
-    else
+    // the images are decoded by the loading threads, and uploaded here until the frame budget is spent
+    while (true)
     {
-        ImageInfo *imageInfo = imagesQueue->front();
-        imagesQueue->pop_front();
-        _imageInfoMutex.unlock();
-
-        AsyncStruct *asyncStruct = imageInfo->asyncStruct;
-        Image *image = imageInfo->image;
+        AsyncStruct *asyncStruct = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_imageInfoMutex);
+            if (_imageInfoQueue.empty())
+            {
+                break;
+            }
+            asyncStruct = _imageInfoQueue.front();
+            _imageInfoQueue.pop_front();
+        }
 
+        Image *image = asyncStruct->image;
         const std::string& filename = asyncStruct->filename;
 
+        std::vector<std::pair<unsigned int, std::function<void(Texture2D*)>>> callbacks;
         Texture2D *texture = nullptr;
-        if (image)
+        if (!asyncStruct->cancelled)
         {
-            // generate texture in render thread
-            texture = new (std::nothrow) Texture2D();
+            // the next requests of the file find it in the cache
+            _asyncStructs.erase(filename);
+            callbacks.swap(asyncStruct->callbacks);
+
+            auto it = _textures.find(filename);
+            if (it != _textures.end())
+            {
+                // loaded by addImage() in the meantime
+                texture = it->second;
+                markTextureUsed(filename);
+            }
+            else if (image)
+            {
+                // generate texture in render thread
+                texture = new (std::nothrow) Texture2D();
 
-            texture->initWithImage(image);
+                texture->initWithImage(image);
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
-            // cache the texture file name
-            VolatileTextureMgr::addImageTexture(texture, filename);
+                // cache the texture file name
+                VolatileTextureMgr::addImageTexture(texture, filename);
 #endif
-            // cache the texture. retain it, since it is added in the map
-            _textures.insert( std::make_pair(filename, texture) );
-            texture->retain();
+                // cache the texture. retain it, since it is added in the map
+                _textures.insert( std::make_pair(filename, texture) );
+                texture->retain();
 
-            texture->autorelease();
-        }
-        else
-        {
-            auto it = _textures.find(asyncStruct->filename);
-            if(it != _textures.end())
-                texture = it->second;
+                texture->autorelease();
+
+                addTextureUsage(filename, true);
+                enforceResidencyBudget();
+
+                uploadedBytes += image->getDataLen();
+            }
         }
-        
-        if (asyncStruct->callback)
+
+        if (texture)
         {
-            asyncStruct->callback(texture);
+            for (auto& callback : callbacks)
+            {
+                if (callback.second)
+                {
+                    callback.second(texture);
+                }
+            }
         }
-        
-        if(image)
-        {
-            image->release();
-        }       
+
+        CC_SAFE_RELEASE(image);
         delete asyncStruct;
-        delete imageInfo;
 
         --_asyncRefCount;
         if (0 == _asyncRefCount)
         {
             Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+            break;
+        }
+
+        if (_asyncUploadBytes > 0 && uploadedBytes >= _asyncUploadBytes)
+        {
+            break;
+        }
+        if (_asyncUploadSeconds > 0 && std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count() >= _asyncUploadSeconds)
+        {
+            break;
         }
     }
 }
@@ -328,7 +428,10 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if( it != _textures.end() )
+    {
         texture = it->second;
+        markTextureUsed(fullpath);
+    }
 
     if (! texture)
     {
@@ -341,21 +444,7 @@ Texture2D * TextureCache::addImage(const std::string &path)
             bool bRet = image->initWithImageFile(fullpath);
             CC_BREAK_IF(!bRet);
 
-            texture = new (std::nothrow) Texture2D();
-
-            if( texture && texture->initWithImage(image) )
-            {
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-                // cache the texture file name
-                VolatileTextureMgr::addImageTexture(texture, fullpath);
-#endif
-                // texture already retained, no need to re-retain it
-                _textures.insert( std::make_pair(fullpath, texture) );
-            }
-            else
-            {
-                CCLOG("cocos2d: Couldn't create texture for file:%s in TextureCache", path.c_str());
-            }
+            texture = addDecodedImage(fullpath, image);
         } while (0);
     }
 
@@ -364,6 +453,45 @@ Texture2D * TextureCache::addImage(const std::string &path)
     return texture;
 }
 
+Texture2D* TextureCache::addDecodedImage(const std::string& filepath, Image* image)
+{
+    CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filepath);
+    if (fullpath.empty())
+    {
+        return nullptr;
+    }
+
+    auto it = _textures.find(fullpath);
+    if (it != _textures.end())
+    {
+        markTextureUsed(fullpath);
+        return it->second;
+    }
+
+    Texture2D* texture = new (std::nothrow) Texture2D();
+    if (texture && texture->initWithImage(image))
+    {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // cache the texture file name
+        VolatileTextureMgr::addImageTexture(texture, fullpath);
+#endif
+        // texture already retained, no need to re-retain it
+        _textures.insert( std::make_pair(fullpath, texture) );
+
+        addTextureUsage(fullpath, true);
+        enforceResidencyBudget();
+    }
+    else
+    {
+        CCLOG("cocos2d: Couldn't create texture for file:%s in TextureCache", filepath.c_str());
+        CC_SAFE_RELEASE_NULL(texture);
+    }
+
+    return texture;
+}
+
 Texture2D* TextureCache::addImage(Image *image, const std::string &key)
 {
     CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
@@ -375,6 +503,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if( it != _textures.end() ) {
             texture = it->second;
+            markTextureUsed(key);
             break;
         }
 
@@ -388,6 +517,8 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             texture->retain();
 
             texture->autorelease();
+
+            addTextureUsage(key, false);
         }
         else
         {
@@ -417,6 +548,7 @@ bool TextureCache::reloadTexture(const std::string& fileName)
     auto it = _textures.find(fullpath);
     if (it != _textures.end()) {
         texture = it->second;
+        markTextureUsed(fullpath);
     }
 
     bool ret = false;
@@ -450,6 +582,8 @@ void TextureCache::removeAllTextures()
         (it->second)->release();
     }
     _textures.clear();
+    _textureUsage.clear();
+    _evictedTextures.clear();
 }
 
 void TextureCache::removeUnusedTextures()
@@ -460,6 +594,7 @@ void TextureCache::removeUnusedTextures()
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
             tex->release();
+            _textureUsage.erase(it->first);
             _textures.erase(it++);
         } else {
             ++it;
@@ -478,6 +613,7 @@ void TextureCache::removeTexture(Texture2D* texture)
     for( auto it=_textures.cbegin(); it!=_textures.cend(); /* nothing */ ) {
         if( it->second == texture ) {
             texture->release();
+            _textureUsage.erase(it->first);
             _textures.erase(it++);
             break;
         } else
@@ -497,6 +633,7 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
 
     if( it != _textures.end() ) {
         (it->second)->release();
+        _textureUsage.erase(it->first);
         _textures.erase(it);
     }
 }
@@ -512,7 +649,10 @@ Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) con
     }
 
     if( it != _textures.end() )
+    {
+        markTextureUsed(key);
         return it->second;
+    }
     return nullptr;
 }
 
@@ -526,10 +666,37 @@ void TextureCache::reloadAllTextures()
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    // notify sub threads to quit
+    {
+        std::lock_guard<std::mutex> lock(_asyncStructQueueMutex);
+        _needQuit = true;
+    }
+    _sleepCondition.notify_all();
+    for (auto& thread : _loadingThreads)
+    {
+        thread.join();
+    }
+    _loadingThreads.clear();
+
+    // drop the images which weren't uploaded
+    for (auto asyncStruct : _asyncStructQueue)
+    {
+        delete asyncStruct;
+    }
+    _asyncStructQueue.clear();
+    for (auto asyncStruct : _imageInfoQueue)
+    {
+        CC_SAFE_RELEASE(asyncStruct->image);
+        delete asyncStruct;
+    }
+    _imageInfoQueue.clear();
+    _asyncStructs.clear();
+
+    if (_asyncRefCount > 0)
+    {
+        _asyncRefCount = 0;
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+    }
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -538,7 +705,7 @@ std::string TextureCache::getCachedTextureInfo() const
     char buftmp[4096];
 
     unsigned int count = 0;
-    unsigned int totalBytes = 0;
+    size_t totalBytes = 0;
 
     for( auto it = _textures.begin(); it != _textures.end(); ++it ) {
 
@@ -547,17 +714,18 @@ std::string TextureCache::getCachedTextureInfo() const
 
         Texture2D* tex = it->second;
         unsigned int bpp = tex->getBitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
+        // Each texture takes up width * height * bytesPerPixel bytes, plus a third for the mipmaps
+        auto bytes = getTextureMemorySize(tex);
         totalBytes += bytes;
         count++;
-        snprintf(buftmp,sizeof(buftmp)-1,"\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
+        snprintf(buftmp,sizeof(buftmp)-1,"\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp%s => %lu KB\n",
                it->first.c_str(),
                (long)tex->getReferenceCount(),
                (long)tex->getName(),
                (long)tex->getPixelsWide(),
                (long)tex->getPixelsHigh(),
                (long)bpp,
+               tex->hasMipmaps() ? " mipmaps" : "",
                (long)bytes / 1024);
         
         buffer += buftmp;
@@ -566,9 +734,155 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp)-1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    auto stats = getResidencyStats();
+    if (stats.budget > 0)
+        snprintf(buftmp, sizeof(buftmp)-1, "TextureCache residency: budget %lu KB, %lu KB evictable, %u textures evicted, %u loaded again\n", (long)stats.budget / 1024, (long)stats.evictableBytes / 1024, stats.evictionCount, stats.restreamCount);
+    else
+        snprintf(buftmp, sizeof(buftmp)-1, "TextureCache residency: no budget, %lu KB evictable\n", (long)stats.evictableBytes / 1024);
+    buffer += buftmp;
+
     return buffer;
 }
 
+// TextureCache - Residency
+
+size_t TextureCache::getTextureMemorySize(Texture2D* texture)
+{
+    size_t bytes = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    // the mipmap chain adds 1/4 + 1/16 + ... of the base level
+    if (texture->hasMipmaps())
+        bytes += bytes / 3;
+    return bytes;
+}
+
+void TextureCache::addTextureUsage(const std::string& key, bool fromFile)
+{
+    TextureUsage usage = { Director::getInstance()->getTotalFrames(), fromFile };
+    _textureUsage[key] = usage;
+
+    if (fromFile && _evictedTextures.erase(key) > 0)
+    {
+        ++_restreamCount;
+    }
+}
+
+void TextureCache::markTextureUsed(const std::string& key) const
+{
+    auto it = _textureUsage.find(key);
+    if (it != _textureUsage.end())
+    {
+        it->second.lastUsedFrame = Director::getInstance()->getTotalFrames();
+    }
+}
+
+void TextureCache::setResidencyBudget(size_t bytes)
+{
+    auto scheduler = Director::getInstance()->getScheduler();
+    if (_residencyBudget == 0 && bytes > 0)
+    {
+        scheduler->schedule(CC_SCHEDULE_SELECTOR(TextureCache::updateResidency), this, 0, false);
+    }
+    else if (_residencyBudget > 0 && bytes == 0)
+    {
+        scheduler->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::updateResidency), this);
+    }
+
+    _residencyBudget = bytes;
+    enforceResidencyBudget();
+}
+
+void TextureCache::updateResidency(float dt)
+{
+    enforceResidencyBudget();
+}
+
+void TextureCache::enforceResidencyBudget()
+{
+    if (_residencyBudget == 0)
+    {
+        return;
+    }
+
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    size_t residentBytes = 0;
+
+    struct Candidate
+    {
+        unsigned int lastUsedFrame;
+        size_t bytes;
+        std::unordered_map<std::string, Texture2D*>::iterator texture;
+    };
+    std::vector<Candidate> candidates;
+
+    for (auto it = _textures.begin(); it != _textures.end(); ++it)
+    {
+        size_t bytes = getTextureMemorySize(it->second);
+        residentBytes += bytes;
+
+        auto usage = _textureUsage.find(it->first);
+        if (usage == _textureUsage.end())
+            continue;
+
+        if (it->second->getReferenceCount() > 1)
+        {
+            // retained by a sprite, a sprite frame...
+            usage->second.lastUsedFrame = frame;
+        }
+        else if (usage->second.fromFile && usage->second.lastUsedFrame != frame)
+        {
+            Candidate candidate = { usage->second.lastUsedFrame, bytes, it };
+            candidates.push_back(candidate);
+        }
+    }
+
+    if (residentBytes <= _residencyBudget)
+    {
+        return;
+    }
+
+    // least recently used first
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUsedFrame < b.lastUsedFrame;
+    });
+
+    for (auto& candidate : candidates)
+    {
+        if (residentBytes <= _residencyBudget)
+            break;
+
+        const std::string& key = candidate.texture->first;
+        CCLOG("cocos2d: TextureCache: evicting texture: %s", key.c_str());
+
+        candidate.texture->second->release();
+        residentBytes -= candidate.bytes;
+        ++_evictionCount;
+
+        _evictedTextures.insert(key);
+        _textureUsage.erase(key);
+        _textures.erase(candidate.texture);
+    }
+}
+
+TextureCache::ResidencyStats TextureCache::getResidencyStats() const
+{
+    ResidencyStats stats = { (unsigned int)_textures.size(), 0, 0, _residencyBudget, _evictionCount, _restreamCount };
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+
+    for (auto& texture : _textures)
+    {
+        size_t bytes = getTextureMemorySize(texture.second);
+        stats.residentBytes += bytes;
+
+        auto usage = _textureUsage.find(texture.first);
+        if (usage != _textureUsage.end() && usage->second.fromFile && usage->second.lastUsedFrame != frame
+            && texture.second->getReferenceCount() == 1)
+        {
+            stats.evictableBytes += bytes;
+        }
+    }
+    return stats;
+}
+
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 
 std::list<VolatileTexture*> VolatileTextureMgr::_textures;
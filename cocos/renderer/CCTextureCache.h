@@ -33,8 +33,11 @@ THE SOFTWARE.
 #include <thread>
 #include <condition_variable>
 #include <queue>
+#include <vector>
+#include <deque>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 
 #include "base/CCRef.h"
@@ -110,6 +113,13 @@ public:
     */
     Texture2D* addImage(const std::string &filepath);
 
+    /** Same as addImage(filepath), with the image of the file already decoded, so that the file isn't read again.
+    * The texture is cached with the full path of the file, and is reloaded from the file like those of addImage(filepath).
+    * Returns the cached texture if the file was already loaded.
+    * @since v3.3
+    */
+    Texture2D* addDecodedImage(const std::string& filepath, Image* image);
+
     /* Returns a Texture2D object given a file image
     * If the file image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will load a texture in a new thread, and when the image is loaded, the callback will be called with the Texture2D as a parameter.
@@ -118,6 +128,35 @@ public:
     * @since v0.8
     */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
+
+    /** Same as addImageAsync(), with a priority.
+    * The pending images are decoded on several threads, the highest priorities first. Requests of a file that is
+    * already being loaded share its decoding, and raise its priority if theirs is higher.
+    * Returns the id to pass to cancelImageAsync(), or 0 when the texture was already cached and the callback was called.
+    * @since v3.3
+    */
+    unsigned int addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback, int priority);
+
+    /** Cancels a request of addImageAsync(): its callback won't be called.
+    * The image isn't decoded nor uploaded if no other request waits for it.
+    * @since v3.3
+    */
+    void cancelImageAsync(unsigned int requestId);
+
+    /** Limits the work spent each frame creating the textures loaded by addImageAsync().
+    * Decoded images are uploaded until one of the limits is reached, and at least one is uploaded per frame.
+    * @param seconds time spent per frame, 0 for no limit. Default is 0.004
+    * @param bytes size of the decoded images uploaded per frame, 0 for no limit. Default is 0
+    * @since v3.3
+    */
+    void setAsyncUploadBudget(float seconds, size_t bytes);
+
+    /** Sets how many threads may decode the images of addImageAsync() at the same time.
+    * 0, the default, means one per core. Running threads above the limit stop taking images.
+    * With 1, the images are decoded and uploaded strictly in the order of their priorities.
+    * @since v3.3
+    */
+    void setAsyncLoadingThreadCount(unsigned int count);
     
     /* Unbind a specified bound image asynchronous callback
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
@@ -185,47 +224,114 @@ public:
     */
     std::string getCachedTextureInfo() const;
 
+    /** GPU memory used by the cached textures, see setResidencyBudget() */
+    struct ResidencyStats
+    {
+        unsigned int textureCount;
+        // memory of the cached textures, mipmaps included
+        size_t residentBytes;
+        // memory of the textures that can be evicted now
+        size_t evictableBytes;
+        size_t budget;
+        // textures evicted since the cache was created, and evicted textures that were loaded again
+        unsigned int evictionCount;
+        unsigned int restreamCount;
+    };
+
+    /** Sets how much GPU memory the cached textures may use, mipmaps included. 0 (the default) means no limit.
+    * While over budget, the cache releases the textures loaded from a file that only the cache retains, least
+    * recently used first. A texture is used when it is returned by the cache, and while something else retains it.
+    * The textures used during the current frame are never evicted.
+    * An evicted texture is loaded again by the next addImage() or addImageAsync() of its file, with the default
+    * texture parameters, as after removeUnusedTextures().
+    * @since v3.3
+    */
+    void setResidencyBudget(size_t bytes);
+    size_t getResidencyBudget() const { return _residencyBudget; }
+
+    /** Evicts textures until the cache fits the budget.
+    * It is done every frame, and after each texture loaded, while a budget is set.
+    * @since v3.3
+    */
+    void enforceResidencyBudget();
+
+    /** Returns the memory used by the cached textures
+    * @since v3.3
+    */
+    ResidencyStats getResidencyStats() const;
+
+    /** Returns the GPU memory used by a texture: its pixels in its pixel format, plus a third when it has mipmaps
+    * @since v3.3
+    */
+    static size_t getTextureMemorySize(Texture2D* texture);
+
     //wait for texture cahe to quit befor destroy instance
     //called by director, please do not called outside
     void waitForQuit();
 
 private:
     void addImageAsyncCallBack(float dt);
-    void loadImage();
+    void loadImage(unsigned int threadIndex);
+    void updateResidency(float dt);
+    // records a texture added to _textures, or that it was returned by the cache
+    void addTextureUsage(const std::string& key, bool fromFile);
+    void markTextureUsed(const std::string& key) const;
 
 public:
+    /** an image being loaded, shared by the addImageAsync() requests of the same file */
     struct AsyncStruct
     {
     public:
-        AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f) {}
+        AsyncStruct(const std::string& fn, int p, unsigned int o) : filename(fn), priority(p), order(o), image(nullptr), cancelled(false) {}
 
         std::string filename;
-        std::function<void(Texture2D*)> callback;
+        int priority;
+        // position of the request, so that equal priorities are decoded in order
+        unsigned int order;
+        // request ids and their callbacks
+        std::vector<std::pair<unsigned int, std::function<void(Texture2D*)>>> callbacks;
+        // set by the loading thread, nullptr if the file couldn't be decoded
+        Image* image;
+        // every request was cancelled after the decoding started
+        bool cancelled;
     };
 
 protected:
-    typedef struct _ImageInfo
-    {
-        AsyncStruct *asyncStruct;
-        Image        *image;
-    } ImageInfo;
-    
-    std::thread* _loadingThread;
-
-    std::queue<AsyncStruct*>* _asyncStructQueue;
-    std::deque<ImageInfo*>* _imageInfoQueue;
-
+    std::vector<std::thread> _loadingThreads;
+    // heap of the images waiting for a loading thread, guarded by _asyncStructQueueMutex
+    std::vector<AsyncStruct*> _asyncStructQueue;
+    // decoded images waiting for the upload, guarded by _imageInfoMutex
+    std::deque<AsyncStruct*> _imageInfoQueue;
+    // images being loaded, by full path. Only used on the cocos thread
+    std::unordered_map<std::string, AsyncStruct*> _asyncStructs;
     std::mutex _asyncStructQueueMutex;
     std::mutex _imageInfoMutex;
-
-    std::mutex _sleepMutex;
     std::condition_variable _sleepCondition;
-
     bool _needQuit;
-
     int _asyncRefCount;
+    unsigned int _asyncRequestCount;
+    float _asyncUploadSeconds;
+    size_t _asyncUploadBytes;
+    // 0 for one per core, guarded by _asyncStructQueueMutex
+    unsigned int _asyncLoadingThreadCount;
 
     std::unordered_map<std::string, Texture2D*> _textures;
+
+    /** how a cached texture is used, for the residency budget */
+    struct TextureUsage
+    {
+        // last frame when it was returned by the cache, or retained by something else
+        unsigned int lastUsedFrame;
+        // loaded from a file, so it can be evicted and loaded again
+        bool fromFile;
+    };
+    // by key of _textures
+    mutable std::unordered_map<std::string, TextureUsage> _textureUsage;
+    // files of the evicted textures, to count the ones loaded again
+    std::unordered_set<std::string> _evictedTextures;
+    size_t _residencyBudget;
+    unsigned int _evictionCount;
+    unsigned int _restreamCount;
 };
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -399,6 +399,7 @@ namespace ui {
              * @lua NA
              */
             virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+            virtual bool hasCustomVisit() const override { return true; }
             /**
              * @js NA
              * @lua NA
@@ -249,6 +249,7 @@ public:
     virtual void addChild(Node* child, int zOrder, const std::string &name) override;
     
     virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     virtual void removeChild(Node* child, bool cleanup = true) override;
     
@@ -290,6 +290,7 @@ namespace ui {
         /// @} end of Children and Parent
         
         virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+        virtual bool hasCustomVisit() const override { return true; }
         
         virtual void cleanup() override;
         
@@ -232,6 +232,7 @@ public:
     float getTopBoundary() const;
 
     virtual void visit(cocos2d::Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual bool hasCustomVisit() const override { return true; }
 
     /**
      * Sets the touch event target/selector to the widget
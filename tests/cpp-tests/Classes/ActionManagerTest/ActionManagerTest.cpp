@@ -15,7 +15,7 @@ Layer* restartActionManagerAction();
 
 static int sceneIdx = -1; 
 
-#define MAX_LAYER    6
+#define MAX_LAYER    7
 
 Layer* createActionManagerLayer(int nIndex)
 {
@@ -27,6 +27,7 @@ Layer* createActionManagerLayer(int nIndex)
         case 3: return new StopActionTest();
         case 4: return new StopAllActionsTest();
         case 5: return new ResumeTest();
+        case 6: return new CompactStorageTest();
     }
 
     return nullptr;
@@ -358,6 +359,75 @@ void ResumeTest::resumeGrossini(float time)
     director->getActionManager()->resumeTarget(pGrossini);
 }
 
+//------------------------------------------------------------------
+//
+// CompactStorageTest
+//
+//------------------------------------------------------------------
+static const int kCompactStorageSprites = 1000;
+static const int kTagCompactStorageSprite = 1000;
+
+std::string CompactStorageTest::subtitle() const
+{
+    return "1000 sprites tweened every 2 seconds. See FPS";
+}
+
+void CompactStorageTest::onEnter()
+{
+    ActionManagerTest::onEnter();
+
+    auto actionManager = Director::getInstance()->getActionManager();
+    _compactStorageWasEnabled = actionManager->isCompactStorageEnabled();
+
+    auto item = MenuItemToggle::createWithCallback(CC_CALLBACK_1(CompactStorageTest::toggleCompactStorage, this),
+                                                   MenuItemFont::create("Compact storage: Off"),
+                                                   MenuItemFont::create("Compact storage: On"),
+                                                   nullptr);
+    item->setSelectedIndex(_compactStorageWasEnabled ? 1 : 0);
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(VisibleRect::center().x, VisibleRect::top().y - 75);
+    addChild(menu, 2);
+
+    for (int i = 0; i < kCompactStorageSprites; ++i)
+    {
+        auto sprite = Sprite::create("Images/ball.png");
+        sprite->setPosition(CCRANDOM_0_1() * VisibleRect::getVisibleRect().size.width,
+                            CCRANDOM_0_1() * VisibleRect::getVisibleRect().size.height);
+        addChild(sprite, 1, kTagCompactStorageSprite + i);
+    }
+
+    tween(0);
+    schedule(CC_SCHEDULE_SELECTOR(CompactStorageTest::tween), 2.0f);
+}
+
+void CompactStorageTest::onExit()
+{
+    Director::getInstance()->getActionManager()->setCompactStorageEnabled(_compactStorageWasEnabled);
+
+    ActionManagerTest::onExit();
+}
+
+void CompactStorageTest::tween(float time)
+{
+    auto size = VisibleRect::getVisibleRect().size;
+    for (int i = 0; i < kCompactStorageSprites; ++i)
+    {
+        // only plain interval actions, run directly on the sprites
+        auto sprite = getChildByTag(kTagCompactStorageSprite + i);
+        sprite->runAction(MoveTo::create(2, Vec2(CCRANDOM_0_1() * size.width, CCRANDOM_0_1() * size.height)));
+        sprite->runAction(ScaleTo::create(2, 0.5f + CCRANDOM_0_1()));
+        sprite->runAction(RotateBy::create(2, 360));
+        sprite->runAction(FadeTo::create(2, (GLubyte)(128 + CCRANDOM_0_1() * 127)));
+        sprite->runAction(TintTo::create(2, (GLubyte)(CCRANDOM_0_1() * 255), (GLubyte)(CCRANDOM_0_1() * 255), 255));
+    }
+}
+
+void CompactStorageTest::toggleCompactStorage(Ref* sender)
+{
+    auto item = static_cast<MenuItemToggle*>(sender);
+    Director::getInstance()->getActionManager()->setCompactStorageEnabled(item->getSelectedIndex() == 1);
+}
+
 //------------------------------------------------------------------
 //
 // ActionManagerTestScene
@@ -70,6 +70,18 @@ public:
     void resumeGrossini(float time);
 };
 
+class CompactStorageTest : public ActionManagerTest
+{
+public:
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    void tween(float time);
+    void toggleCompactStorage(Ref* sender);
+private:
+    bool _compactStorageWasEnabled;
+};
+
 class ActionManagerTestScene : public TestScene
 {
 public:
@@ -8,6 +8,8 @@ static std::function<Layer*()> createFunctions[] = {
     CL(TestFileFuncs),
     CL(TestDirectoryFuncs),
     CL(TextWritePlist),
+    CL(TestResourcePack),
+    CL(TestAsyncRead),
 };
 
 static int sceneIdx=-1;
@@ -560,3 +562,216 @@ std::string TextWritePlist::subtitle() const
     std::string writablePath = FileUtils::getInstance()->getWritablePath().c_str();
     return ("See plist file at your writablePath");
 }
+
+// TestResourcePack
+
+void TestResourcePack::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto sharedFileUtils = FileUtils::getInstance();
+    _defaultSearchPathArray = sharedFileUtils->getSearchPaths();
+
+    // bench.ccpack and bench.zip have the same 128 files, made with tools/resource-pack/pack_resources.py
+    std::string packPath = sharedFileUtils->fullPathForFilename("FileUtilsTest/bench.ccpack");
+    std::string zipPath = sharedFileUtils->fullPathForFilename("FileUtilsTest/bench.zip");
+    auto pack = ResourcePack::create(packPath);
+    if (!pack)
+    {
+        addResult("Can't open FileUtilsTest/bench.ccpack", 1);
+        return;
+    }
+
+    // the loose files are extracted from the pack to the writable path
+    auto names = pack->getFileNames();
+    _looseRoot = sharedFileUtils->getWritablePath() + "ccpack-bench/";
+    for (const auto& name : names)
+    {
+        std::string path = _looseRoot + name;
+        sharedFileUtils->createDirectory(path.substr(0, path.find_last_of('/')));
+        Data data = pack->copyFileData(name, false);
+        FILE* fp = fopen(path.c_str(), "wb");
+        if (fp)
+        {
+            fwrite(data.getBytes(), 1, data.getSize(), fp);
+            fclose(fp);
+        }
+    }
+
+    // search paths before the one that has the files, like the patches and themes of a game
+    std::vector<std::string> searchPaths;
+    searchPaths.push_back(_looseRoot + "patch/");
+    searchPaths.push_back(_looseRoot + "theme/");
+    searchPaths.push_back(_looseRoot + "hd/");
+
+    // loose files
+    auto looseSearchPaths = searchPaths;
+    looseSearchPaths.push_back(_looseRoot);
+    sharedFileUtils->setSearchPaths(looseSearchPaths);
+    ssize_t looseBytes = 0;
+    double start = utils::gettime();
+    for (const auto& name : names)
+    {
+        looseBytes += sharedFileUtils->getDataFromFile(name).getSize();
+    }
+    double looseTime = utils::gettime() - start;
+
+    // zip, opened and searched for each file
+    ssize_t zipBytes = 0;
+    start = utils::gettime();
+    for (const auto& name : names)
+    {
+        ssize_t size = 0;
+        unsigned char* buffer = sharedFileUtils->getFileDataFromZip(zipPath, name, &size);
+        zipBytes += size;
+        free(buffer);
+    }
+    double zipTime = utils::gettime() - start;
+
+    // pack, the time to mount it included
+    ssize_t packBytes = 0;
+    start = utils::gettime();
+    auto packSearchPaths = searchPaths;
+    packSearchPaths.push_back(packPath);
+    sharedFileUtils->setSearchPaths(packSearchPaths);
+    for (const auto& name : names)
+    {
+        packBytes += sharedFileUtils->getDataFromFile(name).getSize();
+    }
+    double packTime = utils::gettime() - start;
+
+    // pack, the files are views of the mapping
+    ssize_t mappedBytes = 0;
+    sharedFileUtils->purgeCachedEntries();
+    start = utils::gettime();
+    for (const auto& name : names)
+    {
+        mappedBytes += sharedFileUtils->getMappedDataFromFile(name).getSize();
+    }
+    double mappedTime = utils::gettime() - start;
+
+    // the four reads of each file must return the same bytes. The zip wasn't made from the pack
+    int differences = 0;
+    for (const auto& name : names)
+    {
+        Data loose = sharedFileUtils->getDataFromFile(_looseRoot + name);
+        ssize_t zipSize = 0;
+        unsigned char* zipBuffer = sharedFileUtils->getFileDataFromZip(zipPath, name, &zipSize);
+        Data packed = sharedFileUtils->getDataFromFile(name);
+        MappedData mapped = sharedFileUtils->getMappedDataFromFile(name);
+
+        bool same = !loose.isNull() && zipBuffer != nullptr
+            && zipSize == loose.getSize() && memcmp(zipBuffer, loose.getBytes(), zipSize) == 0
+            && packed.getSize() == loose.getSize() && memcmp(packed.getBytes(), loose.getBytes(), loose.getSize()) == 0
+            && mapped.getSize() == loose.getSize() && memcmp(mapped.getBytes(), loose.getBytes(), loose.getSize()) == 0;
+        free(zipBuffer);
+
+        if (!same)
+        {
+            log("TestResourcePack: %s isn't the same in the loose directory, the zip and the pack", name.c_str());
+            ++differences;
+        }
+        CCASSERT(same, "the loose, zip and pack bytes of a file must be identical");
+    }
+
+    addResult(StringUtils::format("%d files, %d different", (int)names.size(), differences), 5);
+    addResult(StringUtils::format("loose: %.2f ms (%ld bytes)", looseTime * 1000, (long)looseBytes), 4);
+    addResult(StringUtils::format("zip: %.2f ms (%ld bytes)", zipTime * 1000, (long)zipBytes), 3);
+    addResult(StringUtils::format("ccpack: %.2f ms (%ld bytes)", packTime * 1000, (long)packBytes), 2);
+    addResult(StringUtils::format("ccpack, mapped: %.2f ms (%ld bytes)", mappedTime * 1000, (long)mappedBytes), 1);
+}
+
+void TestResourcePack::addResult(const std::string& message, int line)
+{
+    auto s = Director::getInstance()->getWinSize();
+    log("%s", message.c_str());
+    auto label = Label::createWithSystemFont(message, "", 20);
+    label->setPosition(s.width/2, s.height/6 * line);
+    this->addChild(label);
+}
+
+void TestResourcePack::onExit()
+{
+    auto sharedFileUtils = FileUtils::getInstance();
+
+    // reset search path
+    sharedFileUtils->setSearchPaths(_defaultSearchPathArray);
+    if (!_looseRoot.empty())
+    {
+        sharedFileUtils->removeDirectory(_looseRoot);
+    }
+    FileUtilsDemo::onExit();
+}
+
+std::string TestResourcePack::title() const
+{
+    return "FileUtils: resource pack";
+}
+
+std::string TestResourcePack::subtitle() const
+{
+    return "Time to find and read the files of a loose directory, a zip and a pack, and their bytes must be the same";
+}
+
+// TestAsyncRead
+
+void TestAsyncRead::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto sharedFileUtils = FileUtils::getInstance();
+    _results = 0;
+
+    // three requests for the same file share one read
+    for (int i = 0; i < 3; ++i)
+    {
+        _requests.push_back(sharedFileUtils->getDataFromFileAsync("FileUtilsTest/bench.zip", [this, i](const Data& data) {
+            addResult(StringUtils::format("bench.zip, request %d: %ld bytes", i + 1, (long)data.getSize()));
+        }, AsyncFileLoader::Priority::LOW));
+    }
+
+    // read before the low priority requests that are still queued
+    _requests.push_back(sharedFileUtils->getValueMapFromFileAsync("fileLookup.plist", [this](const ValueMap& dict) {
+        addResult(StringUtils::format("fileLookup.plist: %d keys", (int)dict.size()));
+    }, AsyncFileLoader::Priority::HIGH));
+
+    _requests.push_back(sharedFileUtils->getStringFromFileAsync("FileUtilsTest/missing.txt", [this](const std::string& content) {
+        addResult(StringUtils::format("missing.txt: %s", content.empty() ? "can't be read" : "read"));
+    }));
+
+    auto canceled = sharedFileUtils->getDataFromFileAsync("Hello.png", [this](const Data& data) {
+        addResult("Hello.png: shouldn't be read, it was canceled");
+    });
+    sharedFileUtils->cancelAsyncRead(canceled);
+
+    log("TestAsyncRead: %ld files to read", (long)AsyncFileLoader::getInstance()->getPendingCount());
+}
+
+void TestAsyncRead::addResult(const std::string& message)
+{
+    auto s = Director::getInstance()->getWinSize();
+    log("%s", message.c_str());
+    auto label = Label::createWithSystemFont(message, "", 20);
+    label->setPosition(s.width/2, s.height * 3/4 - 30 * _results);
+    this->addChild(label);
+    ++_results;
+}
+
+void TestAsyncRead::onExit()
+{
+    // the callbacks capture this layer
+    for (auto requestId : _requests)
+    {
+        FileUtils::getInstance()->cancelAsyncRead(requestId);
+    }
+    _requests.clear();
+    FileUtilsDemo::onExit();
+}
+
+std::string TestAsyncRead::title() const
+{
+    return "FileUtils: asynchronous reads";
+}
+
+std::string TestAsyncRead::subtitle() const
+{
+    return "Files read by the I/O threads, the results are shown in the order of the callbacks";
+}
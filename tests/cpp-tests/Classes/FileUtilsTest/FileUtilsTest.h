@@ -103,4 +103,36 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TestResourcePack : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestResourcePack);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    void addResult(const std::string& message, int line);
+
+    std::vector<std::string> _defaultSearchPathArray;
+    std::string _looseRoot;
+};
+
+class TestAsyncRead : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestAsyncRead);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    void addResult(const std::string& message);
+
+    std::vector<AsyncFileLoader::RequestId> _requests;
+    int _results;
+};
+
 #endif /* __FILEUTILSTEST_H__ */
@@ -83,7 +83,8 @@ static std::function<Layer*()> createFunctions[] =
     CL(LabelAdditionalKerningTest),
     CL(LabelIssue8492Test),
     CL(LabelMultilineWithOutline),
-    CL(LabelIssue9255Test)
+    CL(LabelIssue9255Test),
+    CL(LabelAsyncRasterizationTest)
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -1877,3 +1878,48 @@ std::string LabelIssue9255Test::subtitle() const
 {
     return "switch to desktop and switch back. Crashed!!!";
 }
+
+LabelAsyncRasterizationTest::LabelAsyncRasterizationTest()
+: _textIndex(0)
+{
+    TTFConfig ttfConfig("fonts/HKYuanMini.ttf", 40, GlyphCollection::DYNAMIC,nullptr,true);
+    _label = Label::createWithTTF(ttfConfig, "");
+    _label->setPosition(VisibleRect::center());
+    _label->setTextColor(Color4B::GREEN);
+    _label->enableGlow(Color4B::YELLOW);
+    addChild(_label);
+
+    _label->getFontAtlas()->setAsyncRasterizationEnabled(true);
+    changeText(0);
+
+    schedule(CC_SCHEDULE_SELECTOR(LabelAsyncRasterizationTest::changeText), 1.0f);
+}
+
+void LabelAsyncRasterizationTest::onExit()
+{
+    _label->getFontAtlas()->setAsyncRasterizationEnabled(false);
+    AtlasDemoNew::onExit();
+}
+
+void LabelAsyncRasterizationTest::changeText(float dt)
+{
+    static const char* texts[] = {
+        "美好的一天啊",
+        "春眠不觉晓，处处闻啼鸟",
+        "夜来风雨声，花落知多少",
+        "床前明月光，疑是地上霜",
+        "举头望明月，低头思故乡"
+    };
+    _label->setString(texts[_textIndex]);
+    _textIndex = (_textIndex + 1) % (sizeof(texts) / sizeof(texts[0]));
+}
+
+std::string LabelAsyncRasterizationTest::title() const
+{
+    return "Asynchronous glyph rasterization";
+}
+
+std::string LabelAsyncRasterizationTest::subtitle() const
+{
+    return "New letters appear a few frames later, without blocking setString()";
+}
@@ -544,5 +544,23 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class LabelAsyncRasterizationTest : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelAsyncRasterizationTest);
+
+    LabelAsyncRasterizationTest();
+
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void changeText(float dt);
+
+private:
+    Label* _label;
+    int _textIndex;
+};
+
 
 #endif
@@ -40,7 +40,8 @@ static std::function<Layer*()> createFunctions[] =
     CL(NewDrawNodeTest),
     CL(NewCullingTest),
     CL(VBOFullTest),
-    CL(CaptureScreenTest)
+    CL(CaptureScreenTest),
+    CL(DynamicAtlasTest)
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -631,3 +632,66 @@ void CaptureScreenTest::afterCaptured(bool succeed, const std::string& outputFil
         log("Capture screen failed.");
     }
 }
+
+DynamicAtlasTest::DynamicAtlasTest()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    _sprites = Node::create();
+    addChild(_sprites);
+
+    _info = Label::createWithTTF(TTFConfig("fonts/arial.ttf", 10), "");
+    _info->setPosition(s.width / 2, s.height / 4);
+    addChild(_info, 1);
+
+    MenuItemFont::setFontSize(16);
+    auto toggle = MenuItemToggle::createWithCallback(CC_CALLBACK_1(DynamicAtlasTest::onToggleAtlas, this),
+                                                     MenuItemFont::create("Dynamic atlas: on"),
+                                                     MenuItemFont::create("Dynamic atlas: off"),
+                                                     nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(s.width / 2, s.height / 4 - 30);
+    addChild(menu, 1);
+
+    DynamicAtlasCache::getInstance()->setEnabled(true);
+    createSprites();
+}
+
+DynamicAtlasTest::~DynamicAtlasTest()
+{
+    DynamicAtlasCache::getInstance()->setEnabled(false);
+}
+
+void DynamicAtlasTest::createSprites()
+{
+    Size s = Director::getInstance()->getWinSize();
+    _sprites->removeAllChildren();
+
+    // interleave the files: each sprite breaks the batch of the previous one unless they share a page
+    for (int i = 0; i < 100; ++i)
+    {
+        auto sprite = Sprite::create(StringUtils::format("Images/grossini_dance_0%d.png", i % 9 + 1));
+        sprite->setScale(0.5f);
+        sprite->setPosition(Vec2((i % 20 + 0.5f) * s.width / 20, s.height / 2 + (i / 20 - 2) * 30));
+        _sprites->addChild(sprite);
+    }
+
+    _info->setString(DynamicAtlasCache::getInstance()->getCachedAtlasInfo());
+}
+
+void DynamicAtlasTest::onToggleAtlas(Ref* sender)
+{
+    auto atlas = DynamicAtlasCache::getInstance();
+    atlas->setEnabled(!atlas->isEnabled());
+    createSprites();
+}
+
+std::string DynamicAtlasTest::title() const
+{
+    return "New Renderer";
+}
+
+std::string DynamicAtlasTest::subtitle() const
+{
+    return "Loose PNGs packed in a dynamic atlas: compare the draw calls";
+}
@@ -164,4 +164,22 @@ protected:
     std::string _filename;
 };
 
+class DynamicAtlasTest : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(DynamicAtlasTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    DynamicAtlasTest();
+    virtual ~DynamicAtlasTest();
+
+    void createSprites();
+    void onToggleAtlas(Ref* sender);
+
+    Node* _sprites;
+    Label* _info;
+};
+
 #endif //__NewRendererTest_H_
@@ -1508,6 +1508,53 @@ void NodeNameTest::test(float dt)
     auto findChildren = utils::findChildren(*parent, "node");
     CCAssert(findChildren.size() == 50, "");
     
+    // NodePath and the child index
+    
+    parent = Node::create();
+    parent->setChildIndexEnabled(true);
+    for (int j = 0; j < 100; ++j)
+    {
+        auto node = Node::create();
+        sprintf(name, "node%d", j);
+        parent->addChild(node, 0, j);
+        node->setName(name);
+        
+        for (int k = 0; k < 10; ++k)
+        {
+            auto child = Node::create();
+            child->setName("node");
+            node->addChild(child);
+        }
+    }
+    CCAssert(parent->getChildByName("node42") == parent->getChildByTag(42), "");
+    
+    i = 0;
+    NodePath path("node4[[:digit:]]/node");
+    parent->enumerateChildren(path, [&i](Node* node) -> bool {
+        ++i;
+        return false;
+    });
+    CCAssert(i == 100, "");
+    
+    i = 0;
+    parent->enumerateChildren(NodePath("//node"), [&i](Node* node) -> bool {
+        ++i;
+        return false;
+    });
+    CCAssert(i == 1000, "");
+    CCAssert(NodePath("node7/node").findFirst(parent)->getParent() == parent->getChildByTag(7), "");
+    
+    parent->getChildByTag(42)->setName("renamed");
+    CCAssert(parent->getChildByName("renamed")->getTag() == 42, "");
+    CCAssert(parent->getChildByName("node42") == nullptr, "");
+    
+    // with the same name, the first child is found
+    auto duplicate = Node::create();
+    duplicate->setName("node1");
+    parent->addChild(duplicate, 0, 1000);
+    CCAssert(parent->getChildByName("node1")->getTag() == 1, "");
+    parent->removeChildByTag(1);
+    CCAssert(parent->getChildByName("node1") == duplicate, "");
 }
 
 ///
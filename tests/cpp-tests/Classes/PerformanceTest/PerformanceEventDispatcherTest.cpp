@@ -355,7 +355,57 @@ void TouchEventDispatchingPerfTest::generateTestFunctions()
             dispatcher->dispatchEvent(&touchEvent);
             CC_PROFILER_STOP(this->profilerName());
         } } ,
-        
+
+        { "OneByOne-scenegraph-reorder",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            if (_quantityOfNodes != _lastRenderedCount)
+            {
+                auto listener = EventListenerTouchOneByOne::create();
+                listener->onTouchBegan = [](Touch* touch, Event* event){
+                    return false;
+                };
+
+                listener->onTouchMoved = [](Touch* touch, Event* event){};
+                listener->onTouchEnded = [](Touch* touch, Event* event){};
+
+                // Create new touchable nodes
+                for (int i = 0; i < this->_quantityOfNodes; ++i)
+                {
+                    auto node = Node::create();
+                    node->setTag(1000 + i);
+                    this->addChild(node);
+                    this->_nodes.push_back(node);
+                    dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+                }
+
+                _lastRenderedCount = _quantityOfNodes;
+            }
+
+            Size size = Director::getInstance()->getWinSize();
+            EventTouch touchEvent;
+            touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+            std::vector<Touch*> touches;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                Touch* touch = new (std::nothrow) Touch();
+                touch->autorelease();
+                touch->setTouchInfo(i, rand() % 200, rand() % 200);
+                touches.push_back(touch);
+            }
+            touchEvent.setTouches(touches);
+
+            // A few touchable nodes move to the front every frame, as in a scrolling list
+            CC_PROFILER_START(this->profilerName());
+            for (int i = 0; i < 4 && !this->_nodes.empty(); ++i)
+            {
+                auto node = this->_nodes[rand() % this->_nodes.size()];
+                node->setLocalZOrder(node->getLocalZOrder() + 1);
+            }
+            dispatcher->dispatchEvent(&touchEvent);
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+
         { "OneByOne-fixed",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
             if (_quantityOfNodes != _lastRenderedCount)
@@ -1,16 +1,19 @@
 #include "PerformanceLabelTest.h"
 
+#include <chrono>
+
 enum {
     kMaxNodes = 200,
     kNodesIncrease = 10,
 
-    TEST_COUNT = 5,
+    TEST_COUNT = 7,
 };
 
 enum {
     kTagInfoLayer = 1,
     kTagMainLayer,
     kTagAutoTestMenu,
+    kTagSpeedLayer,
     kTagMenuLayer = (kMaxNodes + 1000),
 };
 
@@ -19,9 +22,13 @@ enum {
     kCaseLabelBMFontUpdate,
     kCaseLabelUpdate,
     kCaseLabelBMFontBigLabels,
-    kCaseLabelBigLabels
+    kCaseLabelBigLabels,
+    kCaseLabelCounterUpdate,
+    kCaseLabelChatLogUpdate
 };
 
+static const int kChatLogMaxLines = 12;
+
 #define LongSentencesExample "Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\
 Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua.\
 Lorem ipsum dolor sit amet, consectetur adipisicing elit, sed do eiusmod tempor incididunt ut labore et dolore magna aliqua."
@@ -87,6 +94,9 @@ void LabelMainScene::initWithSubTest(int nodes)
     _lastRenderedCount = 0;
     _quantityNodes = 0;
     _accumulativeTime = 0.0f;
+    _updateCount = 0;
+    _setStringCount = 0;
+    _setStringTime = 0.0f;
 
     _labelContainer = Layer::create();
     addChild(_labelContainer);
@@ -107,6 +117,11 @@ void LabelMainScene::initWithSubTest(int nodes)
     infoLabel->setPosition(Vec2(s.width/2, s.height-90));
     addChild(infoLabel, 1, kTagInfoLayer);
 
+    auto speedLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    speedLabel->setColor(Color3B(0,200,20));
+    speedLabel->setPosition(Vec2(s.width/2, 40));
+    addChild(speedLabel, 1, kTagSpeedLayer);
+
     // add menu
     auto menuLayer = new (std::nothrow) LabelMenuLayer(true, TEST_COUNT, LabelMainScene::_s_labelCurCase);
     addChild(menuLayer, 1, kTagMenuLayer);
@@ -158,6 +173,10 @@ std::string LabelMainScene::title() const
         return "Testing LabelBMFont Big Labels";
     case kCaseLabelBigLabels:
         return "Testing Label Big Labels";
+    case kCaseLabelCounterUpdate:
+        return "Testing Label Counters";
+    case kCaseLabelChatLogUpdate:
+        return "Testing Label Chat Log";
     default:
         break;
     }
@@ -247,6 +266,33 @@ void LabelMainScene::onIncrease(Ref* sender)
             }
             break;
         }        
+    case kCaseLabelCounterUpdate:
+        {
+            TTFConfig ttfConfig("fonts/arial.ttf", 24, GlyphCollection::DYNAMIC);
+            for( int i=0;i< kNodesIncrease;i++)
+            {
+                auto label = Label::createWithTTF(ttfConfig, "Score: 0", TextHAlignment::LEFT);
+                label->setPosition(Vec2((size.width/2 + rand() % 100), ((int)size.height/2 + rand() % 100)));
+                _labelContainer->addChild(label, 1, _quantityNodes);
+
+                _quantityNodes++;
+            }
+            break;
+        }
+    case kCaseLabelChatLogUpdate:
+        {
+            TTFConfig ttfConfig("fonts/arial.ttf", 16, GlyphCollection::DYNAMIC);
+            for( int i=0;i< kNodesIncrease;i++)
+            {
+                auto label = Label::createWithTTF(ttfConfig, "", TextHAlignment::LEFT, size.width/2);
+                label->setAnchorPoint(Vec2::ANCHOR_BOTTOM_LEFT);
+                label->setPosition(Vec2((rand() % 50), rand()%((int)size.height/3)));
+                _labelContainer->addChild(label, 1, _quantityNodes);
+
+                _quantityNodes++;
+            }
+            break;
+        }
     default:
         break;
     }
@@ -310,6 +356,11 @@ void LabelMainScene::updateAutoTest(float dt)
 
 void LabelMainScene::updateText(float dt)
 {
+    if(_s_labelCurCase == kCaseLabelCounterUpdate || _s_labelCurCase == kCaseLabelChatLogUpdate)
+    {
+        updateTextWithLayout(dt);
+        return;
+    }
     if(_s_labelCurCase > kCaseLabelUpdate)
         return;
 
@@ -344,6 +395,54 @@ void LabelMainScene::updateText(float dt)
     }
 }
 
+void LabelMainScene::updateTextWithLayout(float dt)
+{
+    _accumulativeTime += dt;
+    ++_updateCount;
+
+    auto& children = _labelContainer->getChildren();
+    auto start = std::chrono::steady_clock::now();
+
+    if (_s_labelCurCase == kCaseLabelCounterUpdate)
+    {
+        // every label shows the same score, like a HUD duplicated in several views
+        char text[32];
+        sprintf(text, "Score: %d", _updateCount * 7);
+        for(const auto &child : children) {
+            auto label = static_cast<Label*>(child);
+            label->setString(text);
+            // lays the text out now instead of at the next draw, to time it
+            label->getContentSize();
+        }
+    }
+    else
+    {
+        // each label appends a message, and starts over after kChatLogMaxLines lines
+        int line = _updateCount % kChatLogMaxLines;
+        for(const auto &child : children) {
+            auto label = static_cast<Label*>(child);
+            std::string chat = (line == 0) ? std::string() : label->getString() + "\n";
+            chat += StringUtils::format("Player%d: message %d", label->getTag(), _updateCount);
+            label->setString(chat);
+            label->getContentSize();
+        }
+    }
+
+    _setStringTime += std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - start).count();
+    _setStringCount += static_cast<int>(children.size());
+
+    if (_setStringTime > 0.0f && _accumulativeTime >= 1.0f)
+    {
+        auto speedLabel = static_cast<Label*>(getChildByTag(kTagSpeedLayer));
+        speedLabel->setString(StringUtils::format("%.0f setString/sec", _setStringCount / _setStringTime));
+        log("Cur test: %d, %.0f setString/sec", LabelMainScene::_s_labelCurCase, _setStringCount / _setStringTime);
+
+        _accumulativeTime = 0.0f;
+        _setStringTime = 0.0f;
+        _setStringCount = 0;
+    }
+}
+
 void LabelMainScene::onEnter()
 {
     Scene::onEnter();
@@ -377,6 +476,10 @@ void LabelMainScene::autoShowLabelTests(int curCase,int nodes)
     _lastRenderedCount = 0;
     _quantityNodes = 0;
     _accumulativeTime = 0.0f;
+    _updateCount = 0;
+    _setStringCount = 0;
+    _setStringTime = 0.0f;
+    static_cast<Label*>(getChildByTag(kTagSpeedLayer))->setString("");
     while(_quantityNodes < nodes)
         onIncrease(this);
 }
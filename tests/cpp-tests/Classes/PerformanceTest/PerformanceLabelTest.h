@@ -36,6 +36,8 @@ public:
     
     void  updateAutoTest(float dt);
     void  updateText(float dt);
+    // sets the strings of the counters and chat logs, and measures setString/sec with the layout
+    void  updateTextWithLayout(float dt);
     void  onAutoTest(Ref* sender);
 
     void  autoShowLabelTests(int curCase,int nodes);
@@ -48,7 +50,7 @@ public:
 
 private:
     static const  int MAX_AUTO_TEST_TIMES  = 35;
-    static const  int MAX_SUB_TEST_NUMS    = 5;
+    static const  int MAX_SUB_TEST_NUMS    = 7;
     
 
     void  dumpProfilerFPS();
@@ -67,6 +69,10 @@ private:
     int            _executeTimes;
 
     float          _accumulativeTime;
+
+    int            _updateCount;
+    int            _setStringCount;
+    float          _setStringTime;
 };
 
 void runLabelTest();
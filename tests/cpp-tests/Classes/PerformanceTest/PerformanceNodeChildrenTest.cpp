@@ -1,6 +1,7 @@
 #include "PerformanceNodeChildrenTest.h"
 
 #include <algorithm>
+#include <regex>
 
 // Enable profiles for this file
 #undef CC_PROFILER_DISPLAY_TIMERS
@@ -46,6 +47,10 @@ static std::function<NodeChildrenMainScene*()> createFunctions[] =
     CL(SortAllChildrenSpriteSheet),
 
     CL(VisitSceneGraph),
+    CL(VisitSceneGraphParallel),
+    CL(VisitSceneGraphMatrixStack),
+    CL(VisitSceneGraphFlatTransforms),
+    CL(EnumerateChildrenPath),
 };
 
 #define MAX_LAYER    (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -968,6 +973,496 @@ const char*  VisitSceneGraph::testName()
     return "visit()";
 }
 
+////////////////////////////////////////////////////////
+//
+// VisitSceneGraphParallel
+//
+////////////////////////////////////////////////////////
+VisitSceneGraphParallel::VisitSceneGraphParallel()
+: _container(nullptr)
+{
+}
+
+void VisitSceneGraphParallel::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    _container->setChildrenVisitedInParallel(true);
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([&](Ref* sender) {
+        _container->setChildrenVisitedInParallel(!_container->isChildrenVisitedInParallel());
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Parallel: On"), MenuItemFont::create("Parallel: Off"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(menu, 1);
+
+    scheduleUpdate();
+}
+
+void VisitSceneGraphParallel::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto texture = Director::getInstance()->getTextureCache()->addImage("Images/spritesheet1.png");
+
+    // each child is a small subtree, like a widget made of several sprites
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            node->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            for (int j = 0; j < 4; ++j)
+            {
+                auto sprite = Sprite::createWithTexture(texture, Rect(32 * j, 0, 32, 32));
+                sprite->setPosition(Vec2(8 * j, 8 * j));
+                node->addChild(sprite);
+            }
+            _container->addChild(node, 0, 1000 + currentQuantityOfNodes + i);
+        }
+    }
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChildByTag(1000 + currentQuantityOfNodes - i - 1);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void VisitSceneGraphParallel::update(float dt)
+{
+    // move the container so every transform has to be recomputed
+    _container->setPosition(Vec2(CCRANDOM_MINUS1_1(), CCRANDOM_MINUS1_1()));
+
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string VisitSceneGraphParallel::title() const
+{
+    return "Visiting the scene graph in parallel";
+}
+
+std::string VisitSceneGraphParallel::subtitle() const
+{
+    return "sibling subtrees visited on worker threads. See console";
+}
+
+const char*  VisitSceneGraphParallel::testName()
+{
+    return (_container && !_container->isChildrenVisitedInParallel()) ? "visit() serial" : "visit() parallel";
+}
+
+////////////////////////////////////////////////////////
+//
+// VisitSceneGraphMatrixStack
+//
+////////////////////////////////////////////////////////
+VisitSceneGraphMatrixStack::VisitSceneGraphMatrixStack()
+: _container(nullptr)
+, _rateLabel(nullptr)
+, _legacyMatrixStack(true)
+, _visitedNodes(0)
+, _visitTime(0)
+, _frames(0)
+{
+}
+
+void VisitSceneGraphMatrixStack::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([&](Ref* sender) {
+        _legacyMatrixStack = !_legacyMatrixStack;
+        _visitTime = 0;
+        _frames = 0;
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Matrix stack: On"), MenuItemFont::create("Matrix stack: Off"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(menu, 1);
+
+    _rateLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _rateLabel->setPosition(Vec2(s.width/2, s.height/2-80));
+    addChild(_rateLabel, 1);
+
+    scheduleUpdate();
+}
+
+void VisitSceneGraphMatrixStack::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // each child is a small subtree of empty nodes, so the visit itself is measured
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            node->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            for (int j = 0; j < 4; ++j)
+            {
+                auto child = Node::create();
+                child->setPosition(Vec2(8 * j, 8 * j));
+                node->addChild(child);
+            }
+            _container->addChild(node, 0, 1000 + currentQuantityOfNodes + i);
+        }
+    }
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChildByTag(1000 + currentQuantityOfNodes - i - 1);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+    _visitedNodes = currentQuantityOfNodes * 5;
+    _visitTime = 0;
+    _frames = 0;
+}
+
+void VisitSceneGraphMatrixStack::update(float dt)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    bool previous = renderer->isLegacyMatrixStackEnabled();
+    renderer->setLegacyMatrixStackEnabled(_legacyMatrixStack);
+
+    auto start = utils::gettime();
+    CC_PROFILER_START( this->profilerName() );
+    _container->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+    _visitTime += (float)(utils::gettime() - start);
+
+    renderer->setLegacyMatrixStackEnabled(previous);
+    renderer->clean();
+
+    if (++_frames == 60)
+    {
+        auto rate = _visitTime > 0 ? _visitedNodes * _frames / (_visitTime * 1000) : 0;
+        _rateLabel->setString(StringUtils::format("%.0f nodes visited per ms", rate));
+        _visitTime = 0;
+        _frames = 0;
+    }
+}
+
+std::string VisitSceneGraphMatrixStack::title() const
+{
+    return "Visiting without the matrix stack";
+}
+
+std::string VisitSceneGraphMatrixStack::subtitle() const
+{
+    return "Renderer::setLegacyMatrixStackEnabled(). See console";
+}
+
+const char*  VisitSceneGraphMatrixStack::testName()
+{
+    return _legacyMatrixStack ? "visit() matrix stack" : "visit() no matrix stack";
+}
+
+////////////////////////////////////////////////////////
+//
+// VisitSceneGraphFlatTransforms
+//
+////////////////////////////////////////////////////////
+VisitSceneGraphFlatTransforms::VisitSceneGraphFlatTransforms()
+: _container(nullptr)
+{
+}
+
+void VisitSceneGraphFlatTransforms::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    _container->setFlatTransformsEnabled(true);
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([&](Ref* sender) {
+        _container->setFlatTransformsEnabled(!_container->isFlatTransformsEnabled());
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("Flat transforms: On"), MenuItemFont::create("Flat transforms: Off"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(menu, 1);
+
+    scheduleUpdate();
+}
+
+void VisitSceneGraphFlatTransforms::updateQuantityOfNodes()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // each child is a static tile of 2 levels of empty nodes, only the container moves
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto tile = Node::create();
+            tile->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            for (int j = 0; j < 2; ++j)
+            {
+                auto row = Node::create();
+                row->setPosition(Vec2(0, 16 * j));
+                for (int k = 0; k < 2; ++k)
+                {
+                    auto cell = Node::create();
+                    cell->setPosition(Vec2(16 * k, 0));
+                    row->addChild(cell);
+                }
+                tile->addChild(row);
+            }
+            _container->addChild(tile, 0, 1000 + currentQuantityOfNodes + i);
+        }
+    }
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _container->removeChildByTag(1000 + currentQuantityOfNodes - i - 1);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void VisitSceneGraphFlatTransforms::update(float dt)
+{
+    // move the container so every transform below it has to be recomputed
+    _container->setPosition(Vec2(CCRANDOM_MINUS1_1(), CCRANDOM_MINUS1_1()));
+
+    CC_PROFILER_START( this->profilerName() );
+    _container->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string VisitSceneGraphFlatTransforms::title() const
+{
+    return "Visiting with flat transforms";
+}
+
+std::string VisitSceneGraphFlatTransforms::subtitle() const
+{
+    return "Node::setFlatTransformsEnabled(). See console";
+}
+
+const char*  VisitSceneGraphFlatTransforms::testName()
+{
+    return (_container && !_container->isFlatTransformsEnabled()) ? "visit() per node transforms" : "visit() flat transforms";
+}
+
+////////////////////////////////////////////////////////
+//
+// EnumerateChildrenPath
+//
+////////////////////////////////////////////////////////
+
+// Node::enumerateChildren() of v3.2, which builds a std::regex for every child it tests
+static bool enumerateWithRegexPerChild(const Node* node, std::string name, const std::function<bool(Node*)>& callback)
+{
+    size_t pos = name.find('/');
+    std::string searchName = name;
+    bool needRecursive = false;
+    if (pos != name.npos)
+    {
+        searchName = name.substr(0, pos);
+        name.erase(0, pos+1);
+        needRecursive = true;
+    }
+
+    for (const auto& child : node->getChildren())
+    {
+        if (std::regex_match(child->getName(), std::regex(searchName)))
+        {
+            if (needRecursive ? enumerateWithRegexPerChild(child, name, callback) : callback(child))
+                return true;
+        }
+    }
+    return false;
+}
+
+static bool enumerateRecursivelyWithRegexPerChild(const Node* node, const std::string& name, const std::function<bool(Node*)>& callback)
+{
+    if (enumerateWithRegexPerChild(node, name, callback))
+        return true;
+
+    for (const auto& child : node->getChildren())
+    {
+        if (enumerateRecursivelyWithRegexPerChild(child, name, callback))
+            return true;
+    }
+    return false;
+}
+
+static const char* kButtonsPath = "//Panel/Button_.*";
+static const int kPathLookups = 100;
+
+EnumerateChildrenPath::EnumerateChildrenPath()
+: _container(nullptr)
+, _mode(Mode::COMPILED_PATH)
+{
+}
+
+void EnumerateChildrenPath::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _container = Node::create();
+    _container->setChildIndexEnabled(true);
+    addChild(_container);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+
+    auto s = Director::getInstance()->getWinSize();
+    MenuItemFont::setFontSize(24);
+    auto toggle = MenuItemToggle::createWithCallback([&](Ref* sender) {
+        switch (_mode)
+        {
+            case Mode::COMPILED_PATH: _mode = Mode::REGEX_PER_CHILD; break;
+            case Mode::REGEX_PER_CHILD: _mode = Mode::STRING_PATH; break;
+            case Mode::STRING_PATH: _mode = Mode::COMPILED_PATH; break;
+        }
+        _container->setChildIndexEnabled(_mode == Mode::COMPILED_PATH);
+        updateProfilerName();
+        CC_PROFILER_PURGE_ALL();
+    }, MenuItemFont::create("NodePath and child index"), MenuItemFont::create("std::regex per child"),
+       MenuItemFont::create("enumerateChildren(string)"), nullptr);
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height/2-50));
+    addChild(menu, 1);
+
+    scheduleUpdate();
+}
+
+void EnumerateChildrenPath::updateQuantityOfNodes()
+{
+    char name[32];
+
+    // each child is an item of a list: a panel with a few buttons and labels
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = currentQuantityOfNodes; i < quantityOfNodes; i++)
+        {
+            auto panel = Node::create();
+            panel->setName("Panel");
+            for (int j = 0; j < 4; ++j)
+            {
+                auto button = Node::create();
+                sprintf(name, "Button_%d", j);
+                button->setName(name);
+                panel->addChild(button);
+
+                auto label = Node::create();
+                sprintf(name, "Label_%d", j);
+                label->setName(name);
+                panel->addChild(label);
+            }
+
+            auto item = Node::create();
+            item->addChild(panel);
+            sprintf(name, "Item%d", i);
+            _container->addChild(item, 0, name);
+        }
+    }
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = quantityOfNodes; i < currentQuantityOfNodes; i++)
+        {
+            sprintf(name, "Item%d", i);
+            _container->removeChildByName(name);
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+
+    _lookups.clear();
+    _compiledLookups.clear();
+    for (int i = 0; i < kPathLookups; ++i)
+    {
+        sprintf(name, "Item%d/Panel/Button_2", (int)(CCRANDOM_0_1() * (quantityOfNodes - 1)));
+        _lookups.push_back(name);
+        _compiledLookups.push_back(NodePath(name));
+    }
+}
+
+void EnumerateChildrenPath::update(float dt)
+{
+    int found = 0;
+    auto count = [&found](Node* node) {
+        ++found;
+        return false;
+    };
+
+    CC_PROFILER_START( this->profilerName() );
+    switch (_mode)
+    {
+        case Mode::REGEX_PER_CHILD:
+            enumerateRecursivelyWithRegexPerChild(_container, kButtonsPath + 2, count);
+            for (const auto& path : _lookups)
+                enumerateWithRegexPerChild(_container, path, count);
+            break;
+        case Mode::STRING_PATH:
+            _container->enumerateChildren(kButtonsPath, count);
+            for (const auto& path : _lookups)
+                _container->enumerateChildren(path, count);
+            break;
+        case Mode::COMPILED_PATH:
+        {
+            static const NodePath buttons(kButtonsPath);
+            _container->enumerateChildren(buttons, count);
+            for (const auto& path : _compiledLookups)
+                _container->enumerateChildren(path, count);
+            break;
+        }
+    }
+    CC_PROFILER_STOP( this->profilerName() );
+
+    CCASSERT(found == currentQuantityOfNodes * 4 + kPathLookups, "every path should be found");
+}
+
+std::string EnumerateChildrenPath::title() const
+{
+    return "Finding children by path";
+}
+
+std::string EnumerateChildrenPath::subtitle() const
+{
+    return "//Panel/Button_.* and 100 ItemN/Panel/Button_2. See console";
+}
+
+const char*  EnumerateChildrenPath::testName()
+{
+    switch (_mode)
+    {
+        case Mode::REGEX_PER_CHILD: return "enumerateChildren() std::regex per child";
+        case Mode::STRING_PATH: return "enumerateChildren(std::string)";
+        case Mode::COMPILED_PATH: return "enumerateChildren(NodePath)";
+    }
+    return "";
+}
+
 ///----------------------------------------
 void runNodeChildrenTest()
 {
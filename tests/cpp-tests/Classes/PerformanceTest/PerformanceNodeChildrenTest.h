@@ -226,6 +226,93 @@ public:
     virtual const char* testName() override;
 };
 
+class VisitSceneGraphParallel : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(VisitSceneGraphParallel);
+
+    VisitSceneGraphParallel();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    Node* _container;
+};
+
+class VisitSceneGraphMatrixStack : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(VisitSceneGraphMatrixStack);
+
+    VisitSceneGraphMatrixStack();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    Node* _container;
+    Label* _rateLabel;
+    bool _legacyMatrixStack;
+    int _visitedNodes;
+    float _visitTime;
+    int _frames;
+};
+
+class VisitSceneGraphFlatTransforms : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(VisitSceneGraphFlatTransforms);
+
+    VisitSceneGraphFlatTransforms();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    Node* _container;
+};
+
+class EnumerateChildrenPath : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(EnumerateChildrenPath);
+
+    EnumerateChildrenPath();
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    enum class Mode
+    {
+        REGEX_PER_CHILD,
+        STRING_PATH,
+        COMPILED_PATH,
+    };
+
+    Node* _container;
+    Mode _mode;
+    std::vector<std::string> _lookups;
+    std::vector<NodePath> _compiledLookups;
+};
+
 void runNodeChildrenTest();
 
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
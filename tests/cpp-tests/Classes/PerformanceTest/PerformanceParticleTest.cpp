@@ -8,7 +8,7 @@ enum {
     kTagLabelAtlas = 4,
     kTagMenuLayer = 1000,
 
-    TEST_COUNT = 4,
+    TEST_COUNT = 5,
 };
 
 enum {
@@ -51,6 +51,9 @@ void ParticleMenuLayer::showCurrentTest()
     case 3:
         pNewScene = new (std::nothrow) ParticlePerformTest4;
         break;
+    case 4:
+        pNewScene = new (std::nothrow) ParticlePerformTest5;
+        break;
     }
 
     s_nParCurIdx = _curCase;
@@ -548,6 +551,79 @@ void ParticlePerformTest4::doTest()
 
 }
 
+////////////////////////////////////////////////////////
+//
+// ParticlePerformTest5
+//
+////////////////////////////////////////////////////////
+std::string ParticlePerformTest5::title() const
+{
+    char str[40] = {0};
+    sprintf(str, "E (%d) size=4 parallel", subtestNumber);
+    std::string strRet = str;
+    return strRet;
+}
+
+void ParticlePerformTest5::doTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto particleSystem = (ParticleSystem*)getChildByTag(kTagParticleSystem);
+
+    // same as test A, but the particles are moved on the worker threads, in chunks
+    particleSystem->setUpdatedInParallel(true);
+
+    // duration
+    particleSystem->setDuration(-1);
+
+    // gravity
+    particleSystem->setGravity(Vec2(0,-90));
+
+    // angle
+    particleSystem->setAngle(90);
+    particleSystem->setAngleVar(0);
+
+    // radial
+    particleSystem->setRadialAccel(0);
+    particleSystem->setRadialAccelVar(0);
+
+    // speed of particles
+    particleSystem->setSpeed(180);
+    particleSystem->setSpeedVar(50);
+
+    // emitter position
+    particleSystem->setPosition(Vec2(s.width/2, 100));
+    particleSystem->setPosVar(Vec2(s.width/2,0));
+
+    // life of particles
+    particleSystem->setLife(2.0f);
+    particleSystem->setLifeVar(1);
+
+    // emits per frame
+    particleSystem->setEmissionRate(particleSystem->getTotalParticles() /particleSystem->getLife());
+
+    // color of particles
+    Color4F startColor(0.5f, 0.5f, 0.5f, 1.0f);
+    particleSystem->setStartColor(startColor);
+
+    Color4F startColorVar(0.5f, 0.5f, 0.5f, 1.0f);
+    particleSystem->setStartColorVar( startColorVar);
+
+    Color4F endColor(0.1f, 0.1f, 0.1f, 0.2f);
+    particleSystem->setEndColor(endColor);
+
+    Color4F endColorVar(0.1f, 0.1f, 0.1f, 0.2f);    
+    particleSystem->setEndColorVar(endColorVar);
+
+    // size, in pixels
+    particleSystem->setEndSize(4.0f);
+    particleSystem->setStartSize(4.0f);
+    particleSystem->setEndSizeVar(0);
+    particleSystem->setStartSizeVar(0);
+
+    // additive
+    particleSystem->setBlendAdditive(false);
+}
+
 void runParticleTest()
 {
     auto scene = new (std::nothrow) ParticlePerformTest1;
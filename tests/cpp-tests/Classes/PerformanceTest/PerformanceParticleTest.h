@@ -58,6 +58,13 @@ public:
     virtual void doTest();
 };
 
+class ParticlePerformTest5 : public ParticleMainScene
+{
+public:
+    virtual std::string title() const override;
+    virtual void doTest();
+};
+
 void runParticleTest();
 
 #endif
@@ -53,3 +53,420 @@ void runRendererTest()
     auto scene = RenderTestLayer::scene();
     Director::getInstance()->replaceScene(scene);
 }
+
+////////////////////////////////////////////////////////
+//
+// VertexTransformTestLayer
+//
+////////////////////////////////////////////////////////
+
+enum {
+    kTagVertexTransformInfo = 100,
+};
+
+// same size as the Renderer VBOs
+static const int kVertexTransformCount = Renderer::VBO_SIZE;
+
+VertexTransformTestLayer::VertexTransformTestLayer()
+: PerformBasicLayer(false)
+{
+}
+
+Scene* VertexTransformTestLayer::scene()
+{
+    auto scene = Scene::create();
+    auto layer = new (std::nothrow) VertexTransformTestLayer();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void VertexTransformTestLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto title = Label::createWithTTF("Vertex transform", "fonts/arial.ttf", 32);
+    title->setPosition(Vec2(s.width/2, s.height-50));
+    addChild(title);
+
+    auto subtitle = Label::createWithTTF("Mat4::transformPoint() per vertex vs Mat4::transformPoints(). See console", "fonts/Thonburi.ttf", 16);
+    subtitle->setPosition(Vec2(s.width/2, s.height-80));
+    addChild(subtitle);
+
+    auto info = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    info->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(info, 0, kTagVertexTransformInfo);
+
+    _vertices.resize(kVertexTransformCount);
+    for (int i = 0; i < kVertexTransformCount; ++i)
+    {
+        _vertices[i].vertices = Vec3(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height, 0);
+        _vertices[i].colors = Color4B::WHITE;
+        _vertices[i].texCoords = Tex2F(CCRANDOM_0_1(), CCRANDOM_0_1());
+    }
+
+    // a typical sprite transform: rotation, scale and translation
+    Mat4::createRotationZ(CC_DEGREES_TO_RADIANS(30), &_transform);
+    _transform.scale(1.5f);
+    _transform.m[12] = s.width/2;
+    _transform.m[13] = s.height/2;
+
+    schedule(CC_SCHEDULE_SELECTOR(VertexTransformTestLayer::doPerformanceTest), 1.0f);
+}
+
+void VertexTransformTestLayer::doPerformanceTest(float dt)
+{
+    static const int kLoops = 20;
+
+    // the transform is applied to a copy so the positions don't drift between the two runs
+    std::vector<V3F_C4B_T2F> work(_vertices);
+
+    double start = utils::gettime();
+    for (int loop = 0; loop < kLoops; ++loop)
+    {
+        for (auto& vertex : work)
+            _transform.transformPoint(&vertex.vertices);
+    }
+    double scalarTime = utils::gettime() - start;
+
+    work = _vertices;
+    start = utils::gettime();
+    for (int loop = 0; loop < kLoops; ++loop)
+    {
+        _transform.transformPoints(&work[0].vertices, &work[0].vertices, work.size(), sizeof(V3F_C4B_T2F));
+    }
+    double batchTime = utils::gettime() - start;
+
+    double vertices = (double)kVertexTransformCount * kLoops;
+    double scalarRate = scalarTime > 0 ? vertices / scalarTime : 0;
+    double batchRate = batchTime > 0 ? vertices / batchTime : 0;
+
+    auto info = StringUtils::format("per vertex: %.1f Mverts/s\nbatched: %.1f Mverts/s", scalarRate / 1e6, batchRate / 1e6);
+    static_cast<Label*>(getChildByTag(kTagVertexTransformInfo))->setString(info);
+    log("VertexTransform: per vertex %.1f Mverts/s, batched %.1f Mverts/s", scalarRate / 1e6, batchRate / 1e6);
+}
+
+void runVertexTransformTest()
+{
+    auto scene = VertexTransformTestLayer::scene();
+    Director::getInstance()->replaceScene(scene);
+}
+
+////////////////////////////////////////////////////////
+//
+// RenderSortTestLayer
+//
+////////////////////////////////////////////////////////
+
+enum {
+    kTagRenderSortMode = 100,
+    kTagRenderSortBatches,
+};
+
+static const int kRenderSortSpriteCount = 2000;
+
+static const char* sortModeName(RenderQueue::SortMode mode)
+{
+    switch (mode)
+    {
+        case RenderQueue::SortMode::DEFAULT: return "Sort mode: std::sort";
+        case RenderQueue::SortMode::RADIX: return "Sort mode: radix";
+        case RenderQueue::SortMode::RADIX_BATCH_MATERIALS: return "Sort mode: radix, batch materials";
+    }
+    return "";
+}
+
+RenderSortTestLayer::RenderSortTestLayer()
+: PerformBasicLayer(false)
+, _previousSortMode(RenderQueue::SortMode::DEFAULT)
+{
+}
+
+Scene* RenderSortTestLayer::scene()
+{
+    auto scene = Scene::create();
+    auto layer = new (std::nothrow) RenderSortTestLayer();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void RenderSortTestLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // sprites of two textures are interleaved, so each one breaks the batch of the previous one
+    // unless the materials are grouped
+    const char* textures[] = { s_pathGrossini, s_pathBlock };
+    for (int i = 0; i < kRenderSortSpriteCount; ++i)
+    {
+        auto sprite = Sprite::create(textures[i % 2]);
+        sprite->setScale(0.25f);
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * (s.height - 100)));
+        sprite->setGlobalZOrder((float)(i % 3));
+        addChild(sprite);
+    }
+
+    auto renderer = Director::getInstance()->getRenderer();
+    _previousSortMode = renderer->getSortMode();
+
+    auto modeLabel = Label::createWithTTF(sortModeName(_previousSortMode), "fonts/arial.ttf", 24);
+    modeLabel->setGlobalZOrder(10);
+    auto toggle = MenuItemLabel::create(modeLabel, CC_CALLBACK_1(RenderSortTestLayer::toggleSortMode, this));
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height-50));
+    addChild(menu, 1, kTagRenderSortMode);
+
+    auto batches = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    batches->setGlobalZOrder(10);
+    batches->setPosition(Vec2(s.width/2, s.height-80));
+    addChild(batches, 1, kTagRenderSortBatches);
+
+    scheduleUpdate();
+}
+
+void RenderSortTestLayer::onExit()
+{
+    Director::getInstance()->getRenderer()->setSortMode(_previousSortMode);
+    PerformBasicLayer::onExit();
+}
+
+void RenderSortTestLayer::toggleSortMode(Ref* sender)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    auto mode = renderer->getSortMode();
+    switch (mode)
+    {
+        case RenderQueue::SortMode::DEFAULT: mode = RenderQueue::SortMode::RADIX; break;
+        case RenderQueue::SortMode::RADIX: mode = RenderQueue::SortMode::RADIX_BATCH_MATERIALS; break;
+        case RenderQueue::SortMode::RADIX_BATCH_MATERIALS: mode = RenderQueue::SortMode::DEFAULT; break;
+    }
+    renderer->setSortMode(mode);
+    static_cast<Label*>(static_cast<MenuItemLabel*>(sender)->getLabel())->setString(sortModeName(mode));
+}
+
+void RenderSortTestLayer::update(float dt)
+{
+    // the stats are the ones of the last frame, since they are cleared before drawing
+    auto renderer = Director::getInstance()->getRenderer();
+    auto info = StringUtils::format("draw calls: %d", (int)renderer->getDrawnBatches());
+    static_cast<Label*>(getChildByTag(kTagRenderSortBatches))->setString(info);
+}
+
+void runRenderSortTest()
+{
+    auto scene = RenderSortTestLayer::scene();
+    Director::getInstance()->replaceScene(scene);
+}
+
+////////////////////////////////////////////////////////
+//
+// BufferStreamingTestLayer
+//
+////////////////////////////////////////////////////////
+
+static const int kBufferStreamingGroups = 200;
+static const int kBufferStreamingSpritesPerGroup = 20;
+
+BufferStreamingTestLayer::BufferStreamingTestLayer()
+: PerformBasicLayer(false)
+, _previousStreaming(false)
+, _mapFailures(false)
+{
+}
+
+Scene* BufferStreamingTestLayer::scene()
+{
+    auto scene = Scene::create();
+    auto layer = new (std::nothrow) BufferStreamingTestLayer();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void BufferStreamingTestLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // each LayerColor is a CustomCommand, so every group of sprites is flushed on its own
+    for (int group = 0; group < kBufferStreamingGroups; ++group)
+    {
+        for (int i = 0; i < kBufferStreamingSpritesPerGroup; ++i)
+        {
+            auto sprite = Sprite::create(s_pathGrossini);
+            sprite->setScale(0.25f);
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * (s.height - 100)));
+            addChild(sprite);
+        }
+        auto separator = LayerColor::create(Color4B(255, 255, 255, 32), 4, 4);
+        separator->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * (s.height - 100)));
+        addChild(separator);
+    }
+
+    auto renderer = Director::getInstance()->getRenderer();
+    _previousStreaming = renderer->isBufferStreamingEnabled();
+
+    const char* text = Configuration::getInstance()->supportsBufferStreaming() ? "Streaming: Off" : "Streaming: not supported";
+    auto label = Label::createWithTTF(text, "fonts/arial.ttf", 24);
+    auto toggle = MenuItemLabel::create(label, CC_CALLBACK_1(BufferStreamingTestLayer::toggleStreaming, this));
+    auto menu = Menu::create(toggle, nullptr);
+
+#if CC_ENABLE_VBO_STREAMING && COCOS2D_DEBUG > 0
+    // Failing some of the maps makes batches start in the arrays, while the next commands could be streamed.
+    // The sprites should look the same with the failures on.
+    auto failuresLabel = Label::createWithTTF("Failed maps: Off", "fonts/arial.ttf", 24);
+    menu->addChild(MenuItemLabel::create(failuresLabel, CC_CALLBACK_1(BufferStreamingTestLayer::toggleMapFailures, this)));
+    menu->alignItemsHorizontallyWithPadding(40);
+#endif
+
+    menu->setPosition(Vec2(s.width/2, s.height-50));
+    addChild(menu, 1);
+}
+
+void BufferStreamingTestLayer::onExit()
+{
+    Director::getInstance()->getRenderer()->setBufferStreamingEnabled(_previousStreaming);
+#if CC_ENABLE_VBO_STREAMING && COCOS2D_DEBUG > 0
+    StreamBuffer::setMapFailureInterval(0);
+#endif
+    PerformBasicLayer::onExit();
+}
+
+void BufferStreamingTestLayer::toggleStreaming(Ref* sender)
+{
+    if (!Configuration::getInstance()->supportsBufferStreaming())
+        return;
+
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setBufferStreamingEnabled(!renderer->isBufferStreamingEnabled());
+    auto label = static_cast<Label*>(static_cast<MenuItemLabel*>(sender)->getLabel());
+    label->setString(renderer->isBufferStreamingEnabled() ? "Streaming: On" : "Streaming: Off");
+}
+
+void BufferStreamingTestLayer::toggleMapFailures(Ref* sender)
+{
+#if CC_ENABLE_VBO_STREAMING && COCOS2D_DEBUG > 0
+    _mapFailures = !_mapFailures;
+    // one map out of three fails, so the batches alternate between the arrays and the stream buffers
+    StreamBuffer::setMapFailureInterval(_mapFailures ? 3 : 0);
+    auto label = static_cast<Label*>(static_cast<MenuItemLabel*>(sender)->getLabel());
+    label->setString(_mapFailures ? "Failed maps: 1 in 3" : "Failed maps: Off");
+#endif
+}
+
+void runBufferStreamingTest()
+{
+    auto scene = BufferStreamingTestLayer::scene();
+    Director::getInstance()->replaceScene(scene);
+}
+
+////////////////////////////////////////////////////////
+//
+// MultiCameraTestLayer
+//
+////////////////////////////////////////////////////////
+
+enum {
+    kTagMultiCameraStats = 100,
+};
+
+static const int kMultiCameraSpriteCount = 3000;
+
+MultiCameraTestLayer::MultiCameraTestLayer()
+: PerformBasicLayer(false)
+, _frameTime(0)
+, _frames(0)
+{
+}
+
+Scene* MultiCameraTestLayer::scene()
+{
+    auto scene = Scene::create();
+    auto layer = new (std::nothrow) MultiCameraTestLayer();
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+void MultiCameraTestLayer::onEnter()
+{
+    PerformBasicLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // every sprite is seen by the default camera and by one or both of the user cameras,
+    // so the scene graph is traversed up to three times per frame in PER_CAMERA mode
+    const unsigned short masks[] = {
+        (unsigned short)CameraFlag::DEFAULT | (unsigned short)CameraFlag::USER1,
+        (unsigned short)CameraFlag::DEFAULT | (unsigned short)CameraFlag::USER2,
+        (unsigned short)CameraFlag::DEFAULT | (unsigned short)CameraFlag::USER1 | (unsigned short)CameraFlag::USER2,
+    };
+    for (int i = 0; i < kMultiCameraSpriteCount; ++i)
+    {
+        auto sprite = Sprite::create(s_pathGrossini);
+        sprite->setScale(0.1f);
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * (s.height - 100)));
+        addChild(sprite);
+        sprite->setCameraMask(masks[i % 3]);
+    }
+
+    const CameraFlag flags[] = { CameraFlag::USER1, CameraFlag::USER2 };
+    for (int i = 0; i < 2; ++i)
+    {
+        auto camera = Camera::create();
+        camera->setCameraFlag(flags[i]);
+        camera->setPosition3D(camera->getPosition3D() + Vec3(i == 0 ? -20.0f : 20.0f, 0, 100));
+        addChild(camera);
+    }
+
+    auto label = Label::createWithTTF("Visit mode: per camera", "fonts/arial.ttf", 24);
+    auto toggle = MenuItemLabel::create(label, CC_CALLBACK_1(MultiCameraTestLayer::toggleVisitMode, this));
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(s.width/2, s.height-50));
+    addChild(menu, 1);
+
+    auto stats = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    stats->setPosition(Vec2(s.width/2, s.height-80));
+    addChild(stats, 1, kTagMultiCameraStats);
+
+    scheduleUpdate();
+}
+
+void MultiCameraTestLayer::toggleVisitMode(Ref* sender)
+{
+    auto scene = Director::getInstance()->getRunningScene();
+    bool singlePass = scene->getCameraVisitMode() == Scene::CameraVisitMode::PER_CAMERA;
+    scene->setCameraVisitMode(singlePass ? Scene::CameraVisitMode::SINGLE_PASS : Scene::CameraVisitMode::PER_CAMERA);
+    auto label = static_cast<Label*>(static_cast<MenuItemLabel*>(sender)->getLabel());
+    label->setString(singlePass ? "Visit mode: single pass" : "Visit mode: per camera");
+    _frameTime = 0;
+    _frames = 0;
+}
+
+void MultiCameraTestLayer::update(float dt)
+{
+    _frameTime += dt;
+    if (++_frames < 60)
+        return;
+
+    auto info = StringUtils::format("avg frame: %.2f ms", _frameTime * 1000 / _frames);
+    static_cast<Label*>(getChildByTag(kTagMultiCameraStats))->setString(info);
+    _frameTime = 0;
+    _frames = 0;
+}
+
+void runMultiCameraTest()
+{
+    auto scene = MultiCameraTestLayer::scene();
+    Director::getInstance()->replaceScene(scene);
+}
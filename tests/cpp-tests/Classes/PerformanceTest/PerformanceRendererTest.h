@@ -24,5 +24,82 @@ public:
     static Scene* scene();
 };
 
+class VertexTransformTestLayer : public PerformBasicLayer
+{
+public:
+    VertexTransformTestLayer();
+
+    virtual void onEnter() override;
+    virtual void showCurrentTest() override {}
+
+    void doPerformanceTest(float dt);
+
+    static Scene* scene();
+
+protected:
+    std::vector<V3F_C4B_T2F> _vertices;
+    Mat4 _transform;
+};
+
+class RenderSortTestLayer : public PerformBasicLayer
+{
+public:
+    RenderSortTestLayer();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void showCurrentTest() override {}
+
+    void update(float dt) override;
+
+    static Scene* scene();
+
+protected:
+    void toggleSortMode(Ref* sender);
+
+    RenderQueue::SortMode _previousSortMode;
+};
+
+class BufferStreamingTestLayer : public PerformBasicLayer
+{
+public:
+    BufferStreamingTestLayer();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void showCurrentTest() override {}
+
+    static Scene* scene();
+
+protected:
+    void toggleStreaming(Ref* sender);
+    void toggleMapFailures(Ref* sender);
+
+    bool _previousStreaming;
+    bool _mapFailures;
+};
+
+class MultiCameraTestLayer : public PerformBasicLayer
+{
+public:
+    MultiCameraTestLayer();
+
+    virtual void onEnter() override;
+    virtual void showCurrentTest() override {}
+    virtual void update(float dt) override;
+
+    static Scene* scene();
+
+protected:
+    void toggleVisitMode(Ref* sender);
+
+    float _frameTime;
+    int _frames;
+};
+
 void runRendererTest();
+void runVertexTransformTest();
+void runRenderSortTest();
+void runBufferStreamingTest();
+void runMultiCameraTest();
 #endif
@@ -33,6 +33,10 @@ struct {
 	{ "Touches Perf Test",[](Ref*sender){runTouchesTest();} },
     { "Label Perf Test",[](Ref*sender){runLabelTest();} },
     //{ "Renderer Perf Test",[](Ref*sender){runRendererTest();} },
+    { "Vertex Transform Perf Test",[](Ref*sender){runVertexTransformTest();} },
+    { "Render Sort Perf Test",[](Ref*sender){runRenderSortTest();} },
+    { "Buffer Streaming Perf Test",[](Ref*sender){runBufferStreamingTest();} },
+    { "Multi Camera Perf Test",[](Ref*sender){runMultiCameraTest();} },
     { "Container Perf Test", [](Ref* sender ) { runContainerPerformanceTest(); } },
     { "EventDispatcher Perf Test", [](Ref* sender ) { runEventDispatcherPerformanceTest(); } },
     { "Scenario Perf Test", [](Ref* sender ) { runScenarioTest(); } },
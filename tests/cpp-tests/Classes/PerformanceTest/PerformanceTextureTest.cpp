@@ -1,8 +1,9 @@
 #include "PerformanceTextureTest.h"
+#include "renderer/CCPixelConvert.h"
 
 enum
 {
-    TEST_COUNT = 1,
+    TEST_COUNT = 2,
 };
 
 static int s_nTexCurCase = 0;
@@ -32,6 +33,9 @@ void TextureMenuLayer::showCurrentTest()
     case 0:
         scene = TextureTest::scene();
         break;
+    case 1:
+        scene = TextureConvertTest::scene();
+        break;
     }
     s_nTexCurCase = _curCase;
 
@@ -348,7 +352,112 @@ std::string TextureTest::subtitle() const
 Scene* TextureTest::scene()
 {
     auto scene = Scene::create();
-    TextureTest *layer = new (std::nothrow) TextureTest(false, TEST_COUNT, s_nTexCurCase);
+    TextureTest *layer = new (std::nothrow) TextureTest(true, TEST_COUNT, s_nTexCurCase);
+    scene->addChild(layer);
+    layer->release();
+
+    return scene;
+}
+
+////////////////////////////////////////////////////////
+//
+// TextureConvertTest
+//
+////////////////////////////////////////////////////////
+void TextureConvertTest::performTestsConvert(const unsigned char* data, ssize_t dataLen, Texture2D::PixelFormat originFormat, Texture2D::PixelFormat format, const char* name)
+{
+    const int RUNS = 10;
+    struct timeval now;
+    float times[2];
+
+    for (int simd = 0; simd < 2; ++simd)
+    {
+        PixelConvertKernels::setEnabled(simd != 0);
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < RUNS; ++i)
+        {
+            unsigned char* outData = nullptr;
+            ssize_t outDataLen = 0;
+            Texture2D::convertDataToFormat(data, dataLen, originFormat, format, &outData, &outDataLen);
+            if (outData != data)
+                free(outData);
+        }
+        times[simd] = calculateDeltaTime(&now) * 1000 / RUNS;
+    }
+    PixelConvertKernels::setEnabled(true);
+
+    log("%s", name);
+    log("  scalar ms:%f  simd ms:%f", times[0], times[1]);
+}
+
+void TextureConvertTest::performTests()
+{
+    const int SIZE = 2048;
+    const ssize_t pixels = SIZE * SIZE;
+    const int RUNS = 10;
+
+    auto kernels = PixelConvertKernels::getInstance();
+    log("--------");
+    log("--- CONVERT 2048x2048 (%s) ---", kernels ? kernels->name : "no SIMD kernels");
+
+    unsigned char* rgba = (unsigned char*)malloc(pixels * 4);
+    for (ssize_t i = 0; i < pixels * 4; ++i)
+        rgba[i] = (unsigned char)(rand() & 0xFF);
+
+    performTestsConvert(rgba, pixels * 4, Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGBA4444, "RGBA 8888 -> RGBA 4444");
+    performTestsConvert(rgba, pixels * 4, Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB5A1, "RGBA 8888 -> RGBA 5551");
+    performTestsConvert(rgba, pixels * 4, Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB565, "RGBA 8888 -> RGB 565");
+    performTestsConvert(rgba, pixels * 4, Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB888, "RGBA 8888 -> RGB 888");
+    performTestsConvert(rgba, pixels * 4, Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::A8, "RGBA 8888 -> A 8");
+    performTestsConvert(rgba, pixels * 3, Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::RGBA8888, "RGB 888 -> RGBA 8888");
+    performTestsConvert(rgba, pixels, Texture2D::PixelFormat::I8, Texture2D::PixelFormat::RGBA8888, "I 8 -> RGBA 8888");
+    performTestsConvert(rgba, pixels * 2, Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::RGBA8888, "AI 88 -> RGBA 8888");
+
+    // the premultiplication done when loading the PNG files with alpha
+    struct timeval now;
+    unsigned char* copy = (unsigned char*)malloc(pixels * 4);
+    float scalarTime = 0, simdTime = 0;
+    for (int i = 0; i < RUNS; ++i)
+    {
+        memcpy(copy, rgba, pixels * 4);
+        gettimeofday(&now, nullptr);
+        unsigned int* fourBytes = (unsigned int*)copy;
+        for (ssize_t j = 0; j < pixels; ++j)
+        {
+            unsigned char* p = copy + j * 4;
+            fourBytes[j] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+        }
+        scalarTime += calculateDeltaTime(&now);
+
+        if (kernels)
+        {
+            memcpy(copy, rgba, pixels * 4);
+            gettimeofday(&now, nullptr);
+            kernels->premultiplyAlpha(copy, pixels);
+            simdTime += calculateDeltaTime(&now);
+        }
+    }
+    log("premultiplied alpha");
+    log("  scalar ms:%f  simd ms:%f", scalarTime * 1000 / RUNS, simdTime * 1000 / RUNS);
+
+    free(copy);
+    free(rgba);
+}
+
+std::string TextureConvertTest::title() const
+{
+    return "Pixel Format Conversion Test";
+}
+
+std::string TextureConvertTest::subtitle() const
+{
+    return "Scalar vs SIMD on 2048x2048. See console for results";
+}
+
+Scene* TextureConvertTest::scene()
+{
+    auto scene = Scene::create();
+    TextureConvertTest *layer = new (std::nothrow) TextureConvertTest(true, TEST_COUNT, s_nTexCurCase);
     scene->addChild(layer);
     layer->release();
 
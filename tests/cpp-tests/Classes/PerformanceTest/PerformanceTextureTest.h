@@ -35,6 +35,22 @@ public:
     static Scene* scene();
 };
 
+class TextureConvertTest : public TextureMenuLayer
+{
+public:
+    TextureConvertTest(bool bControlMenuVisible, int nMaxCases = 0, int nCurCase = 0)
+        :TextureMenuLayer(bControlMenuVisible, nMaxCases, nCurCase)
+    {
+    }
+
+    virtual void performTests();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    void performTestsConvert(const unsigned char* data, ssize_t dataLen, Texture2D::PixelFormat originFormat, Texture2D::PixelFormat format, const char* name);
+
+    static Scene* scene();
+};
+
 void runTextureTest();
 
 #endif
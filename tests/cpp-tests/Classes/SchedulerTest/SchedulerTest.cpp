@@ -29,7 +29,9 @@ static std::function<Layer*()> createFunctions[] = {
     CL(SchedulerDelayAndRepeat),
     CL(SchedulerIssue2268),
     CL(ScheduleCallbackTest),
-    CL(ScheduleUpdatePriority)
+    CL(ScheduleUpdatePriority),
+    CL(SchedulerPerformFunctions),
+    CL(SchedulerTimerWheel)
 };
 
 #define MAX_LAYER (sizeof(createFunctions) / sizeof(createFunctions[0]))
@@ -1200,6 +1202,137 @@ void ScheduleUpdatePriority::update(float dt)
 {
 }
 
+// SchedulerPerformFunctions
+
+static const int kPerformThreads = 4;
+static const int kPerformFunctionsPerThread = 20000;
+
+std::string SchedulerPerformFunctions::title() const
+{
+    return "performFunctionInCocosThread";
+}
+
+std::string SchedulerPerformFunctions::subtitle() const
+{
+    return "4 threads post 80000 functions, 2 ms budget per frame";
+}
+
+void SchedulerPerformFunctions::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label, 0, 1);
+
+    auto scheduler = Director::getInstance()->getScheduler();
+    _previousBudget = scheduler->getPerformFunctionsTimeBudget();
+    scheduler->setPerformFunctionsTimeBudget(0.002f);
+
+    // the functions may be called after this layer is gone, so they only share the counter
+    _performed = std::make_shared<int>(0);
+    _lastPerformed = 0;
+    auto performed = _performed;
+    for (int i = 0; i < kPerformThreads; ++i)
+    {
+        _threads.push_back(std::thread([scheduler, performed](){
+            for (int j = 0; j < kPerformFunctionsPerThread; ++j)
+            {
+                scheduler->performFunctionInCocosThread([performed](){
+                    // a bit of work, so the budget is reached
+                    float value = 0;
+                    for (int k = 0; k < 500; ++k)
+                        value += sqrtf((float)k);
+                    *performed += (value > 0) ? 1 : 0;
+                });
+            }
+        }));
+    }
+
+    scheduleUpdate();
+}
+
+void SchedulerPerformFunctions::onExit()
+{
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+    _threads.clear();
+    Director::getInstance()->getScheduler()->setPerformFunctionsTimeBudget(_previousBudget);
+
+    SchedulerTestLayer::onExit();
+}
+
+void SchedulerPerformFunctions::update(float dt)
+{
+    int performed = *_performed;
+    auto label = static_cast<Label*>(getChildByTag(1));
+    label->setString(StringUtils::format("performed: %d / %d\nlast frame: %d", performed, kPerformThreads * kPerformFunctionsPerThread, performed - _lastPerformed));
+    _lastPerformed = performed;
+}
+
+// SchedulerTimerWheel
+
+static const int kTimerWheelTargets = 500;
+static const int kTimerWheelTimersPerTarget = 100;
+
+std::string SchedulerTimerWheel::title() const
+{
+    return "Many idle timers";
+}
+
+std::string SchedulerTimerWheel::subtitle() const
+{
+    return "50000 timers, every 10 to 60 seconds. See FPS";
+}
+
+void SchedulerTimerWheel::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label, 0, 1);
+
+    _triggered = 0;
+    auto scheduler = Director::getInstance()->getScheduler();
+    for (int i = 0; i < kTimerWheelTargets; ++i)
+    {
+        // the targets are never added, they only hold the timers
+        auto target = Node::create();
+        _targets.pushBack(target);
+
+        for (int j = 0; j < kTimerWheelTimersPerTarget; ++j)
+        {
+            float interval = CCRANDOM_0_1() * 50 + 10;
+            scheduler->schedule([this](float dt){ ++_triggered; }, target, interval, false, StringUtils::format("timer%d", j));
+        }
+    }
+
+    scheduleUpdate();
+}
+
+void SchedulerTimerWheel::onExit()
+{
+    auto scheduler = Director::getInstance()->getScheduler();
+    for (auto target : _targets)
+    {
+        scheduler->unscheduleAllForTarget(target);
+    }
+    _targets.clear();
+
+    SchedulerTestLayer::onExit();
+}
+
+void SchedulerTimerWheel::update(float dt)
+{
+    auto label = static_cast<Label*>(getChildByTag(1));
+    label->setString(StringUtils::format("triggered: %d", _triggered));
+}
+
 //------------------------------------------------------------------
 //
 // SchedulerTestScene
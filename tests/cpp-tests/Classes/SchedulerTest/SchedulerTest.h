@@ -322,6 +322,42 @@ public:
     bool onTouchBegan(Touch* touch, Event* event);
 };
 
+class SchedulerPerformFunctions : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerPerformFunctions);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    void onEnter() override;
+    void onExit() override;
+
+    virtual void update(float dt) override;
+
+private:
+    std::vector<std::thread> _threads;
+    std::shared_ptr<int> _performed;
+    int _lastPerformed;
+    float _previousBudget;
+};
+
+class SchedulerTimerWheel : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerTimerWheel);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    void onEnter() override;
+    void onExit() override;
+
+    virtual void update(float dt) override;
+
+private:
+    Vector<Node*> _targets;
+    int _triggered;
+};
+
 class SchedulerTestScene : public TestScene
 {
 public:
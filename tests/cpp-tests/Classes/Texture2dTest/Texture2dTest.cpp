@@ -26,6 +26,9 @@
 // local import
 #include "Texture2dTest.h"
 #include "../testResource.h"
+#include "base/CCBlockDecoder.h"
+
+#include <chrono>
 
 enum {
     kTagLabel = 1,
@@ -85,6 +88,8 @@ static std::function<Layer*()> createFunctions[] =
     CL(TexturePixelFormat),
     CL(TextureBlend),
     CL(TextureAsync),
+    CL(TextureAsyncRequests),
+    CL(TextureResidencyBudget),
     CL(TextureGlClamp),
     CL(TextureGlRepeat),
     CL(TextureSizeTest),
@@ -103,6 +108,8 @@ static std::function<Layer*()> createFunctions[] =
     CL(TextureATITCExplicit),
     CL(TextureATITCInterpolated),
     
+    CL(TextureSoftwareDecoders),
+    
     CL(TextureConvertRGB888),
     CL(TextureConvertRGBA8888),
     CL(TextureConvertI8),
@@ -1617,6 +1624,271 @@ std::string TextureAsync::subtitle() const
 }
 
 
+//------------------------------------------------------------------
+//
+// TextureAsyncRequests
+//
+//------------------------------------------------------------------
+
+// decoded first by the single loading thread, while the other requests are queued
+static const char* s_asyncBlockingImage = "Images/landscape-1024x1024.png";
+// the callbacks expected: the blocking image, 3 priorities, 2 requests of the same file, 1 of the 2 requests of a cancelled file
+static const size_t s_asyncExpectedCallbacks = 7;
+
+void TextureAsyncRequests::onEnter()
+{
+    TextureDemo::onEnter();
+
+    _lastCallbackFrame = 0;
+    _resultCount = 0;
+
+    auto textureCache = Director::getInstance()->getTextureCache();
+    const char* images[] = { s_asyncBlockingImage, "Images/grossini_dance_01.png", "Images/grossini_dance_02.png", "Images/grossini_dance_03.png",
+        "Images/grossini_dance_04.png", "Images/grossini_dance_05.png", "Images/grossini_dance_06.png" };
+    for (auto image : images)
+    {
+        textureCache->removeTextureForKey(image);
+    }
+
+    // one image uploaded per frame, decoded one after the other
+    textureCache->setAsyncUploadBudget(0, 1);
+    textureCache->setAsyncLoadingThreadCount(1);
+
+    // the callbacks are recorded under `name`, to tell the requests of the same file apart
+    auto request = [this, textureCache](const char* path, const std::string& name, int priority) {
+        return textureCache->addImageAsync(path, [this, name](Texture2D* texture){ imageLoaded(name, texture); }, priority);
+    };
+    request(s_asyncBlockingImage, s_asyncBlockingImage, 0);
+
+    // decoded from the highest priority: 02, 03, then 01
+    request("Images/grossini_dance_01.png", "01", 0);
+    request("Images/grossini_dance_02.png", "02", 10);
+    request("Images/grossini_dance_03.png", "03", 5);
+
+    // decoded once for both requests
+    request("Images/grossini_dance_04.png", "04", 1);
+    request("Images/grossini_dance_04.png", "04", 1);
+
+    // only the second request of 05 is called back, 06 is never loaded
+    unsigned int cancelled = request("Images/grossini_dance_05.png", "05 cancelled", 1);
+    request("Images/grossini_dance_05.png", "05", 1);
+    textureCache->cancelImageAsync(cancelled);
+    textureCache->cancelImageAsync(request("Images/grossini_dance_06.png", "06 cancelled", 1));
+
+    schedule(CC_SCHEDULE_SELECTOR(TextureAsyncRequests::checkRequests), 0.1f);
+}
+
+TextureAsyncRequests::~TextureAsyncRequests()
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->unbindAllImageAsync();
+    textureCache->setAsyncUploadBudget(0.004f, 0);
+    textureCache->setAsyncLoadingThreadCount(0);
+    textureCache->removeAllTextures();
+}
+
+void TextureAsyncRequests::imageLoaded(const std::string& name, Texture2D* texture)
+{
+    LoadedImage loaded = { name, texture, Director::getInstance()->getTotalFrames() };
+    _loadedImages.push_back(loaded);
+    _lastCallbackFrame = loaded.frame;
+    log("TextureAsyncRequests: %s loaded at frame %u", name.c_str(), loaded.frame);
+
+    auto sprite = Sprite::createWithTexture(texture);
+    sprite->setScale(40 / MAX(sprite->getContentSize().width, sprite->getContentSize().height));
+    sprite->setPosition(Vec2(30 + _loadedImages.size() * 45, 40));
+    addChild(sprite);
+}
+
+void TextureAsyncRequests::checkRequests(float dt)
+{
+    // leave the cancelled requests a few frames to show up
+    if (_loadedImages.size() < s_asyncExpectedCallbacks || Director::getInstance()->getTotalFrames() < _lastCallbackFrame + 10)
+    {
+        return;
+    }
+    unschedule(CC_SCHEDULE_SELECTOR(TextureAsyncRequests::checkRequests));
+
+    auto indexOf = [this](const std::string& name) {
+        for (size_t i = 0; i < _loadedImages.size(); ++i)
+        {
+            if (_loadedImages[i].name == name)
+                return (int)i;
+        }
+        return -1;
+    };
+
+    int first = indexOf("01");
+    int second = indexOf("02");
+    int third = indexOf("03");
+    addResult("uploaded by priority", first >= 0 && second >= 0 && third >= 0 && second < third && third < first);
+
+    bool cancelled = indexOf("05 cancelled") < 0 && indexOf("06 cancelled") < 0;
+    addResult("cancelled requests not called back", cancelled && indexOf("05") >= 0
+              && _loadedImages.size() == s_asyncExpectedCallbacks);
+
+    int shared = indexOf("04");
+    bool sharedOnce = shared >= 0 && shared + 1 < (int)_loadedImages.size()
+        && _loadedImages[shared + 1].name == _loadedImages[shared].name
+        && _loadedImages[shared + 1].texture == _loadedImages[shared].texture
+        && _loadedImages[shared + 1].frame == _loadedImages[shared].frame;
+    addResult("same file decoded once, both called back", sharedOnce);
+
+    // the callbacks of a single upload share a frame, different files mustn't
+    bool budget = true;
+    for (size_t i = 1; i < _loadedImages.size(); ++i)
+    {
+        if (_loadedImages[i].frame == _loadedImages[i - 1].frame && _loadedImages[i].texture != _loadedImages[i - 1].texture)
+            budget = false;
+    }
+    addResult("one upload per frame", budget);
+}
+
+void TextureAsyncRequests::addResult(const std::string& check, bool success)
+{
+    log("TextureAsyncRequests: %s: %s", check.c_str(), success ? "ok" : "FAILED");
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithSystemFont(check + (success ? ": ok" : ": FAILED"), "arial", 16);
+    label->setColor(success ? Color3B::GREEN : Color3B::RED);
+    label->setPosition(Vec2(s.width / 2, s.height / 2 + 45 - _resultCount * 30));
+    addChild(label);
+    ++_resultCount;
+}
+
+std::string TextureAsyncRequests::title() const
+{
+    return "Texture Async Requests";
+}
+
+std::string TextureAsyncRequests::subtitle() const
+{
+    return "Priorities, cancellation, shared decoding and upload budget";
+}
+
+//------------------------------------------------------------------
+//
+// TextureResidencyBudget
+//
+//------------------------------------------------------------------
+
+enum {
+    kTagResidencySprite = 100,
+};
+
+// loaded at frame 1 (LRU1, LRU2), 2 (LRU3, RETAINED) and touched again at 3 (RECENT), then NOW is loaded when the budget is set
+static const char* s_residencyLRU1 = "Images/grossini_dance_07.png";
+static const char* s_residencyLRU2 = "Images/grossini_dance_08.png";
+static const char* s_residencyLRU3 = "Images/grossini_dance_09.png";
+static const char* s_residencyRetained = "Images/grossini_dance_10.png";
+static const char* s_residencyRecent = "Images/grossini_dance_11.png";
+static const char* s_residencyNow = "Images/grossini_dance_12.png";
+
+void TextureResidencyBudget::onEnter()
+{
+    TextureDemo::onEnter();
+
+    _frame = 0;
+    _resultCount = 0;
+    _lruBytes = 0;
+
+    // only the textures retained by the nodes are left, they are never evicted
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setResidencyBudget(0);
+    textureCache->removeUnusedTextures();
+
+    scheduleUpdate();
+}
+
+TextureResidencyBudget::~TextureResidencyBudget()
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setResidencyBudget(0);
+    textureCache->removeUnusedTextures();
+}
+
+void TextureResidencyBudget::update(float dt)
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+
+    // the textures are used in different frames, the least recently used one being evicted first.
+    // getTextureForKey() uses a texture too, it is only called on the textures expected to be evicted or kept
+    switch (_frame++)
+    {
+    case 1:
+        textureCache->addImage(s_residencyRecent);
+        _lruBytes = TextureCache::getTextureMemorySize(textureCache->addImage(s_residencyLRU1))
+                  + TextureCache::getTextureMemorySize(textureCache->addImage(s_residencyLRU2));
+        return;
+    case 2:
+        {
+            textureCache->addImage(s_residencyLRU3);
+            auto sprite = Sprite::createWithTexture(textureCache->addImage(s_residencyRetained));
+            sprite->setPosition(VisibleRect::center());
+            addChild(sprite, 0, kTagResidencySprite);
+        }
+        return;
+    case 3:
+        textureCache->addImage(s_residencyRecent);
+        return;
+    case 4:
+        break;
+    default:
+        return;
+    }
+    unscheduleUpdate();
+
+    textureCache->addImage(s_residencyNow);
+    auto before = textureCache->getResidencyStats();
+
+    // room for all the textures but LRU1 and LRU2: only them are evicted, LRU3 and RECENT were used after them
+    textureCache->setResidencyBudget(before.residentBytes - _lruBytes);
+
+    auto evicted = textureCache->getResidencyStats();
+    addResult("least recently used evicted first", !textureCache->getTextureForKey(s_residencyLRU1) && !textureCache->getTextureForKey(s_residencyLRU2)
+              && evicted.textureCount == before.textureCount - 2);
+    addResult("stats after eviction", evicted.evictionCount == before.evictionCount + 2 && evicted.residentBytes == before.residentBytes - _lruBytes
+              && evicted.budget == before.residentBytes - _lruBytes);
+
+    // no room at all: LRU3 and RECENT are evicted, but the retained texture and the one used in this frame stay
+    textureCache->setResidencyBudget(1);
+    auto full = textureCache->getResidencyStats();
+    addResult("retained and used this frame kept", !textureCache->getTextureForKey(s_residencyLRU3) && !textureCache->getTextureForKey(s_residencyRecent)
+              && full.textureCount == evicted.textureCount - 2
+              && textureCache->getTextureForKey(s_residencyRetained) && textureCache->getTextureForKey(s_residencyNow));
+    addResult("over budget with nothing evictable", full.residentBytes > full.budget && full.evictableBytes == 0
+              && full.evictionCount == evicted.evictionCount + 2);
+
+    // an evicted texture is loaded again on demand, and counted
+    textureCache->setResidencyBudget(0);
+    textureCache->addImage(s_residencyLRU1);
+    addResult("evicted texture loaded again", textureCache->getResidencyStats().restreamCount == full.restreamCount + 1);
+
+    removeChildByTag(kTagResidencySprite);
+}
+
+void TextureResidencyBudget::addResult(const std::string& check, bool success)
+{
+    log("TextureResidencyBudget: %s: %s", check.c_str(), success ? "ok" : "FAILED");
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithSystemFont(check + (success ? ": ok" : ": FAILED"), "arial", 16);
+    label->setColor(success ? Color3B::GREEN : Color3B::RED);
+    label->setPosition(Vec2(s.width / 2, s.height / 2 + 60 - _resultCount * 30));
+    addChild(label);
+    ++_resultCount;
+}
+
+std::string TextureResidencyBudget::title() const
+{
+    return "Texture Residency Budget";
+}
+
+std::string TextureResidencyBudget::subtitle() const
+{
+    return "Least recently used textures evicted, retained ones kept";
+}
+
 //------------------------------------------------------------------
 //
 // TextureGlClamp
@@ -2224,6 +2496,124 @@ std::string TextureATITCInterpolated::subtitle() const
     return "ATITC RGBA Interpolated Alpha comrpessed texture test";
 }
 
+// TextureSoftwareDecoders
+static Image* decodeImage(const char* path, bool accelerated, float* milliseconds)
+{
+    BlockDecoder::setAccelerated(accelerated);
+    auto image = new (std::nothrow) Image();
+    
+    auto start = std::chrono::steady_clock::now();
+    image->initWithImageFile(path);
+    *milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    
+    return image;
+}
+
+TextureSoftwareDecoders::TextureSoftwareDecoders()
+{
+    const char* images[] = {
+        "Images/ETC1.pkm",
+        "Images/test_256x256_s3tc_dxt1_mipmaps.dds",
+        "Images/test_256x256_s3tc_dxt3_mipmaps.dds",
+        "Images/test_256x256_s3tc_dxt5_mipmaps.dds",
+        "Images/test_512x512_s3tc_dxt5_with_no_mipmaps.dds",
+        "Images/test_256x256_ATC_RGB_mipmaps.ktx",
+        "Images/test_256x256_ATC_RGBA_Explicit_mipmaps.ktx",
+        "Images/test_256x256_ATC_RGBA_Interpolated_mipmaps.ktx",
+        "Images/test_image_pvrtc2bpp.pvr",
+        "Images/test_image_pvrtc4bpp.pvr",
+        "Images/test_image_pvrtc2bpp_v3.pvr",
+        "Images/test_image_pvrtc4bpp_v3.pvr",
+        // cut from the 256x256 images: the blocks crossing the right and bottom edges are clipped
+        "Images/test_250x250_s3tc_dxt5.dds",
+        "Images/test_250x250_ATC_RGBA_Interpolated.ktx",
+    };
+    const int count = sizeof(images) / sizeof(images[0]);
+    const int columns = (count + 1) / 2;
+    
+    auto s = Director::getInstance()->getWinSize();
+    int failures = 0;
+    
+    // the scalar decoders running serially are the reference of the parallel and SIMD ones
+    BlockDecoder::setSoftwareDecodingForced(true);
+    for (int i = 0; i < count; ++i)
+    {
+        float referenceTime = 0, acceleratedTime = 0;
+        auto reference = decodeImage(images[i], false, &referenceTime);
+        auto accelerated = decodeImage(images[i], true, &acceleratedTime);
+        
+        bool same = reference->getDataLen() == accelerated->getDataLen()
+                 && reference->getNumberOfMipmaps() == accelerated->getNumberOfMipmaps()
+                 && memcmp(reference->getData(), accelerated->getData(), reference->getDataLen()) == 0;
+        if (!same)
+        {
+            ++failures;
+        }
+        log("%s: %s, %.2f ms serial, %.2f ms accelerated", images[i], same ? "same pixels" : "DIFFERENT PIXELS", referenceTime, acceleratedTime);
+        
+        auto texture = new (std::nothrow) Texture2D();
+        texture->initWithImage(accelerated);
+        auto sprite = Sprite::createWithTexture(texture);
+        texture->release();
+        
+        float x = (i % columns + 0.5f) * s.width / columns;
+        float y = s.height / 2 + (i < columns ? 50 : -50);
+        sprite->setScale(80 / MAX(sprite->getContentSize().width, sprite->getContentSize().height));
+        sprite->setPosition(Vec2(x, y));
+        addChild(sprite);
+        
+        auto label = Label::createWithSystemFont(same ? "same" : "different", "arial", 12);
+        label->setColor(same ? Color3B::GREEN : Color3B::RED);
+        label->setPosition(Vec2(x, y - 48));
+        addChild(label);
+        
+        reference->release();
+        accelerated->release();
+    }
+    
+    // the cut images must have the pixels of the top left corner of the full ones
+    const char* cutImages[][2] = {
+        { "Images/test_250x250_s3tc_dxt5.dds", "Images/test_256x256_s3tc_dxt5_mipmaps.dds" },
+        { "Images/test_250x250_ATC_RGBA_Interpolated.ktx", "Images/test_256x256_ATC_RGBA_Interpolated_mipmaps.ktx" },
+    };
+    for (const auto& cut : cutImages)
+    {
+        float cutTime = 0, fullTime = 0;
+        auto cutImage = decodeImage(cut[0], true, &cutTime);
+        auto fullImage = decodeImage(cut[1], true, &fullTime);
+        
+        bool same = cutImage->getWidth() <= fullImage->getWidth() && cutImage->getHeight() <= fullImage->getHeight();
+        for (int y = 0; same && y < cutImage->getHeight(); ++y)
+        {
+            same = memcmp(cutImage->getData() + y * cutImage->getWidth() * 4,
+                          fullImage->getData() + y * fullImage->getWidth() * 4,
+                          cutImage->getWidth() * 4) == 0;
+        }
+        if (!same)
+        {
+            ++failures;
+        }
+        log("%s: %s %s", cut[0], same ? "same pixels as" : "DIFFERENT PIXELS from", cut[1]);
+        
+        cutImage->release();
+        fullImage->release();
+    }
+    BlockDecoder::setSoftwareDecodingForced(false);
+    BlockDecoder::setAccelerated(true);
+    
+    log("TextureSoftwareDecoders: %d failures", failures);
+}
+
+std::string TextureSoftwareDecoders::title() const
+{
+    return "Software decoders of the compressed formats";
+}
+
+std::string TextureSoftwareDecoders::subtitle() const
+{
+    return "ETC1, S3TC, ATITC and PVRTC decoded in parallel, compared with the serial decoders";
+}
+
 static void addImageToDemo(TextureDemo& demo, float x, float y, const char* path, Texture2D::PixelFormat format)
 {
     Texture2D::setDefaultAlphaPixelFormat(format);
@@ -420,6 +420,49 @@ private:
     int _imageOffset;
 };
 
+// checks the priorities, the cancellation, the shared decoding and the upload budget of addImageAsync()
+class TextureAsyncRequests : public TextureDemo
+{
+public:
+    CREATE_FUNC(TextureAsyncRequests);
+    virtual ~TextureAsyncRequests();
+    void imageLoaded(const std::string& name, cocos2d::Texture2D* texture);
+    void checkRequests(float dt);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+private:
+    void addResult(const std::string& check, bool success);
+
+    struct LoadedImage
+    {
+        std::string name;
+        cocos2d::Texture2D* texture;
+        unsigned int frame;
+    };
+    std::vector<LoadedImage> _loadedImages;
+    unsigned int _lastCallbackFrame;
+    int _resultCount;
+};
+
+// loads textures over a small residency budget, and checks which ones are evicted
+class TextureResidencyBudget : public TextureDemo
+{
+public:
+    CREATE_FUNC(TextureResidencyBudget);
+    virtual ~TextureResidencyBudget();
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+private:
+    void addResult(const std::string& check, bool success);
+
+    int _frame;
+    int _resultCount;
+    size_t _lruBytes;
+};
+
 class TextureGlRepeat : public TextureDemo
 {
 public:
@@ -610,6 +653,17 @@ public:
     virtual std::string subtitle() const override;
 };
 
+// compares the parallel and SIMD software decoders with the serial ones
+class TextureSoftwareDecoders : public TextureDemo
+{
+public:
+    CREATE_FUNC(TextureSoftwareDecoders);
+    TextureSoftwareDecoders();
+    
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 
 // RGB888 texture convert test
 class TextureConvertRGB888 : public TextureDemo
@@ -25,9 +25,16 @@
 #if defined (__SSE__)
 #define USE_SSE
 #define INCLUDE_SSE
+    #if defined (__AVX2__) && defined (__FMA__)
+        #define INCLUDE_AVX2
+        #define MATHUTIL_TARGET_AVX2
+    #elif (defined (__clang__) || (defined (__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)))) && (defined (__x86_64__) || defined (__i386__))
+        #define INCLUDE_AVX2
+        #define MATHUTIL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+    #endif
 #endif
 
-#if (defined INCLUDE_NEON64) || (defined INCLUDE_NEON32) // FIXME: || (defined INCLUDE_SSE)
+#if (defined INCLUDE_NEON64) || (defined INCLUDE_NEON32) || (defined INCLUDE_SSE)
 #define UNIT_TEST_FOR_OPTIMIZED_MATH_UTIL
 #endif
 
@@ -40,6 +47,8 @@ static std::function<Layer*()> createFunctions[] = {
     CL(ValueTest),
     CL(RefPtrTest),
     CL(UTFConversionTest),
+    CL(RenderCommandPoolTest),
+    CL(LabelLayoutTest),
 #ifdef UNIT_TEST_FOR_OPTIMIZED_MATH_UTIL
     CL(MathUtilTest)
 #endif
@@ -851,8 +860,193 @@ std::string UTFConversionTest::subtitle() const
     return "UTF8 <-> UTF16 Conversion Test, no crash";
 }
 
+// RenderCommandPoolTest
+
+void RenderCommandPoolTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+    
+    // blocks of 2, 4, 4, ... commands
+    RenderCommandPool<CustomCommand> pool(2, 2, 4);
+    std::vector<CustomCommand*> commands;
+    
+    //---------------------------
+    commands.push_back(pool.generateCommand());
+    commands.push_back(pool.generateCommand());
+    CCASSERT(pool.getBlockCount() == 1 && pool.getCapacity() == 2 && pool.getUsedCount() == 2, "RenderCommandPool: wrong first block");
+    
+    commands.push_back(pool.generateCommand());
+    CCASSERT(pool.getBlockCount() == 2 && pool.getCapacity() == 6 && pool.getUsedCount() == 3, "RenderCommandPool: the second block should be twice as large");
+    
+    //---------------------------
+    // a pushed back command is the next one generated
+    CustomCommand* released = commands[1];
+    pool.pushBackCommand(released);
+    CCASSERT(pool.getUsedCount() == 2, "RenderCommandPool::pushBackCommand failed");
+    CCASSERT(pool.generateCommand() == released, "RenderCommandPool: pushed back command not reused");
+    CCASSERT(pool.getCapacity() == 6, "RenderCommandPool: a free command shouldn't allocate a block");
+    
+    //---------------------------
+    for (int i = 0; i < 7; ++i)
+    {
+        commands.push_back(pool.generateCommand());
+    }
+    CCASSERT(pool.getBlockCount() == 3 && pool.getCapacity() == 10, "RenderCommandPool: blocks shouldn't grow past maxBlockSize");
+    CCASSERT(pool.getUsedCount() == 10 && pool.getHighestUsedCount() == 10, "RenderCommandPool: wrong counters");
+    
+    std::set<CustomCommand*> distinct(commands.begin(), commands.end());
+    CCASSERT(distinct.size() == commands.size(), "RenderCommandPool: a command was generated twice");
+    for (auto command : commands)
+    {
+        CCASSERT(command->getType() == RenderCommand::Type::CUSTOM_COMMAND, "RenderCommandPool: command not constructed");
+    }
+    
+    //---------------------------
+    // reset() keeps the blocks and generates from the first one again
+    pool.reset();
+    CCASSERT(pool.getUsedCount() == 0 && pool.getHighestUsedCount() == 10 && pool.getCapacity() == 10, "RenderCommandPool::reset failed");
+    CCASSERT(pool.generateCommand() == commands[0], "RenderCommandPool: reset() should reuse the first block");
+    
+    for (int i = 0; i < 13; ++i)
+    {
+        pool.generateCommand();
+    }
+    CCASSERT(pool.getBlockCount() == 4 && pool.getCapacity() == 14 && pool.getHighestUsedCount() == 14, "RenderCommandPool: wrong growth after reset");
+}
+
+std::string RenderCommandPoolTest::subtitle() const
+{
+    return "RenderCommandPool Test, no crash";
+}
+
+// LabelLayoutTest
+
+// the layout of the label made from scratch, without the layout cache
+static Label* __createFullLayoutLabel(const TTFConfig& config, const std::string& text, unsigned int maxLineWidth, unsigned int width, TextHAlignment alignment)
+{
+    auto cache = LabelLayoutCache::getInstance();
+    size_t maxLetterCount = cache->getMaxLetterCount();
+    cache->setMaxLetterCount(0);
+    
+    auto label = Label::createWithTTF(config, text, alignment, maxLineWidth);
+    label->setWidth(width);
+    label->updateContent();
+    
+    cache->setMaxLetterCount(maxLetterCount);
+    return label;
+}
+
+static bool __isSameLayout(Label* label, Label* expected)
+{
+    label->updateContent();
+    if (label->getStringLength() != expected->getStringLength() || !label->getContentSize().equals(expected->getContentSize()))
+        return false;
+    
+    for (int i = 0; i < expected->getStringLength(); ++i)
+    {
+        auto letter = label->getLetter(i);
+        auto expectedLetter = expected->getLetter(i);
+        if ((letter == nullptr) != (expectedLetter == nullptr))
+            return false;
+        if (letter && !letter->getPosition().fuzzyEquals(expectedLetter->getPosition(), 0.01f))
+            return false;
+    }
+    return true;
+}
+
+void LabelLayoutTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+    
+    auto cache = LabelLayoutCache::getInstance();
+    size_t maxLetterCount = cache->getMaxLetterCount();
+    TTFConfig config("fonts/arial.ttf", 20);
+    const std::string text = "The first line\nThe second line\nThe last line";
+    
+    // rasterizes all the letters first, the letters added to the atlas would change the layout key
+    Label::createWithTTF(config, text + "Edited middle end, also wrapped")->updateContent();
+    
+    //---------------------------
+    // incremental layouts, the cache would replace relayoutChangedLines() by the layout of the previous label
+    cache->setMaxLetterCount(0);
+    
+    const std::string middleEdited = "The first line\nThe edited middle line\nThe last line";
+    auto label = Label::createWithTTF(config, text);
+    label->updateContent();
+    label->setString(middleEdited);
+    CCASSERT(__isSameLayout(label, __createFullLayoutLabel(config, middleEdited, 0, 0, TextHAlignment::LEFT)), "LabelLayout: middle line edited");
+    
+    const std::string lastEdited = "The first line\nThe edited middle line\nThe last line, longer";
+    label->setString(lastEdited);
+    CCASSERT(__isSameLayout(label, __createFullLayoutLabel(config, lastEdited, 0, 0, TextHAlignment::LEFT)), "LabelLayout: last line edited");
+    
+    const std::string lastShortened = "The first line\nThe edited middle line\nThe";
+    label->setString(lastShortened);
+    CCASSERT(__isSameLayout(label, __createFullLayoutLabel(config, lastShortened, 0, 0, TextHAlignment::LEFT)), "LabelLayout: last line shortened");
+    
+    // wrap width
+    label->setMaxLineWidth(80);
+    CCASSERT(__isSameLayout(label, __createFullLayoutLabel(config, lastShortened, 80, 0, TextHAlignment::LEFT)), "LabelLayout: wrap width set");
+    label->setString(lastEdited);
+    CCASSERT(__isSameLayout(label, __createFullLayoutLabel(config, lastEdited, 80, 0, TextHAlignment::LEFT)), "LabelLayout: wrapped line edited");
+    label->setMaxLineWidth(120);
+    CCASSERT(__isSameLayout(label, __createFullLayoutLabel(config, lastEdited, 120, 0, TextHAlignment::LEFT)), "LabelLayout: wrap width changed");
+    label->setMaxLineWidth(0);
+    label->setString(middleEdited);
+    CCASSERT(__isSameLayout(label, __createFullLayoutLabel(config, middleEdited, 0, 0, TextHAlignment::LEFT)), "LabelLayout: wrap width removed");
+    
+    //---------------------------
+    // labels sharing a cached layout
+    cache->setMaxLetterCount(maxLetterCount);
+    cache->removeAllLayouts();
+    
+    auto first = Label::createWithTTF(config, text);
+    auto second = Label::createWithTTF(config, text);
+    first->updateContent();
+    second->updateContent();
+    auto unchanged = __createFullLayoutLabel(config, text, 0, 0, TextHAlignment::LEFT);
+    CCASSERT(__isSameLayout(first, unchanged) && __isSameLayout(second, unchanged), "LabelLayout: shared layout");
+    
+    first->setMaxLineWidth(80);
+    CCASSERT(__isSameLayout(first, __createFullLayoutLabel(config, text, 80, 0, TextHAlignment::LEFT)), "LabelLayout: shared layout, width changed");
+    CCASSERT(__isSameLayout(second, unchanged), "LabelLayout: shared layout changed by the other label width");
+    
+    first->setMaxLineWidth(0);
+    first->setWidth(300);
+    first->setAlignment(TextHAlignment::CENTER);
+    CCASSERT(__isSameLayout(first, __createFullLayoutLabel(config, text, 0, 300, TextHAlignment::CENTER)), "LabelLayout: shared layout, alignment changed");
+    CCASSERT(__isSameLayout(second, unchanged), "LabelLayout: shared layout changed by the other label alignment");
+    
+    TTFConfig largerConfig("fonts/arial.ttf", 30);
+    first->setTTFConfig(largerConfig);
+    CCASSERT(__isSameLayout(first, __createFullLayoutLabel(largerConfig, text, 0, 300, TextHAlignment::CENTER)), "LabelLayout: shared layout, font changed");
+    CCASSERT(__isSameLayout(second, unchanged), "LabelLayout: shared layout changed by the other label font");
+    
+    // the other label edited after, from the shared layout
+    second->setString(middleEdited);
+    CCASSERT(__isSameLayout(second, __createFullLayoutLabel(config, middleEdited, 0, 0, TextHAlignment::LEFT)), "LabelLayout: label edited after a shared layout");
+}
+
+std::string LabelLayoutTest::subtitle() const
+{
+    return "Incremental Label layouts, no crash";
+}
+
 // MathUtilTest
 
+// the NEON kernels use intrinsics, which must not be declared inside the UnitTest namespace
+#if (defined INCLUDE_NEON32) || (defined INCLUDE_NEON64)
+#include <arm_neon.h>
+#endif
+
+#ifdef INCLUDE_SSE
+#include <immintrin.h>
+#endif
+
+#ifdef INCLUDE_AVX2
+#include <cpuid.h>
+#endif
+
 namespace UnitTest {
 
 #ifdef INCLUDE_NEON32
@@ -865,6 +1059,7 @@ namespace UnitTest {
 
 #ifdef INCLUDE_SSE
 //FIXME: #include "math/MathUtilSSE.inl"
+#include "math/MathUtilSSEBatch.inl"
 #endif
 
 #include "math/MathUtil.inl"
@@ -874,13 +1069,13 @@ namespace UnitTest {
 // I know the next line looks ugly, but it's a way to test MathUtil. :)
 using namespace UnitTest::cocos2d;
 
-static void __checkMathUtilResult(const char* description, const float* a1, const float* a2, int size)
+static void __checkMathUtilResult(const char* description, const float* a1, const float* a2, int size, float tolerance = 0.00001f)
 {
     log("-------------checking %s ----------------------------", description);
     // Check whether the result of the optimized instruction is the same as which is implemented in C
     for (int i = 0; i < size; ++i)
     {
-        bool r = fabs(a1[i] - a2[i]) < 0.00001f;//FLT_EPSILON;
+        bool r = fabs(a1[i] - a2[i]) < tolerance;//FLT_EPSILON;
         if (r)
         {
             log("Correct: a1[%d]=%f, a2[%d]=%f", i, a1[i], i, a2[i]);
@@ -928,6 +1123,8 @@ void MathUtilTest::onEnter()
     float outVec4Opt[VEC4_SIZE] = {0};
     float outVec4C[VEC4_SIZE] = {0};
     
+    // the SSE versions of the matrix functions take __m128 columns, only the batch kernels are compared on SSE builds
+#if (defined INCLUDE_NEON32) || (defined INCLUDE_NEON64)
     // inline static void addMatrix(const float* m, float scalar, float* dst);
     MathUtilC::addMatrix(inMat41, scalar, outMat4C);
     
@@ -1127,6 +1324,57 @@ void MathUtilTest::onEnter()
     // Clean
     memset(outVec4C, 0, sizeof(outVec4C));
     memset(outVec4Opt, 0, sizeof(outVec4Opt));
+    
+#endif
+    
+    // inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride);
+    // five interleaved vertices of 6 floats, the last 3 floats of each vertex must not be written.
+    // The AVX2 kernel transforms four vertices per iteration and the last one alone
+    const int VERTS_COUNT = 5;
+    const int VERTS_SIZE = VERTS_COUNT * 6;
+    const float inVerts[VERTS_SIZE] = {
+        2.323478f, 0.238482f, 4.223783f, 7.238238f, 1.0f, 2.0f,
+        0.322374f, 8.258883f, 3.293683f, 2.838337f, 3.0f, 4.0f,
+        1.640232f, 4.472349f, 0.983244f, 1.233430f, 5.0f, 6.0f,
+        2.834124f, 8.234975f, 0.082572f, 3.824640f, 7.0f, 8.0f,
+        3.238028f, 2.845237f, 0.331721f, 4.625440f, 9.0f, 10.0f,
+    };
+    float outVertsC[VERTS_SIZE];
+    float outVertsOpt[VERTS_SIZE];
+    memcpy(outVertsC, inVerts, sizeof(inVerts));
+    memcpy(outVertsOpt, inVerts, sizeof(inVerts));
+    MathUtilC::transformVec3Array(inMat41, outVertsC, outVertsC, VERTS_COUNT, sizeof(float) * 6);
+    
+#ifdef INCLUDE_NEON32
+    MathUtilNeon::transformVec3Array(inMat41, outVertsOpt, outVertsOpt, VERTS_COUNT, sizeof(float) * 6);
+#endif
+    
+#ifdef INCLUDE_NEON64
+    MathUtilNeon64::transformVec3Array(inMat41, outVertsOpt, outVertsOpt, VERTS_COUNT, sizeof(float) * 6);
+#endif
+    
+#ifdef INCLUDE_SSE
+    MathUtilSSEBatch::transformVec3Array(inMat41, outVertsOpt, outVertsOpt, VERTS_COUNT, sizeof(float) * 6);
+#endif
+    
+    __checkMathUtilResult("inline static void transformVec3Array(const float* m, const float* src, float* dst, size_t count, size_t stride);", outVertsC, outVertsOpt, VERTS_SIZE);
+    __checkMathUtilResult("transformVec3Array must only write x, y, z", inVerts + 3, outVertsOpt + 3, 3);
+    
+#ifdef INCLUDE_AVX2
+    if (MathUtilSSEBatch::isAVX2Supported())
+    {
+        memcpy(outVertsOpt, inVerts, sizeof(inVerts));
+        MathUtilSSEBatch::transformVec3ArrayAVX2(inMat41, outVertsOpt, outVertsOpt, VERTS_COUNT, sizeof(float) * 6);
+        
+        // the fused multiply-adds round less often than MathUtilC
+        __checkMathUtilResult("transformVec3ArrayAVX2(const float* m, const float* src, float* dst, size_t count, size_t stride);", outVertsC, outVertsOpt, VERTS_SIZE, 0.0001f);
+        __checkMathUtilResult("transformVec3ArrayAVX2 must only write x, y, z", inVerts + 3 + 6 * 4, outVertsOpt + 3 + 6 * 4, 3);
+    }
+    else
+    {
+        log("transformVec3ArrayAVX2 isn't checked, the cpu doesn't support AVX2 and FMA");
+    }
+#endif
 }
 
 std::string MathUtilTest::subtitle() const
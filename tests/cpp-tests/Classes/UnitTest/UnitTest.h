@@ -61,6 +61,22 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class RenderCommandPoolTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(RenderCommandPoolTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class LabelLayoutTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(LabelLayoutTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
 class MathUtilTest : public UnitTestDemo
 {
 public:
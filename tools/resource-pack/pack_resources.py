@@ -0,0 +1,150 @@
+#!/usr/bin/python
+# pack_resources.py
+# Packs a directory of resources into a .ccpack file, read by cocos2d::ResourcePack.
+# The names of the files are indexed by a minimal perfect hash (hash, displace and compress),
+# so the engine finds a file with one hash and one string comparison.
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+PACK_MAGIC = b'CCPK'
+PACK_VERSION = 1
+HEADER_SIZE = 32
+ENTRY_SIZE = 32
+DATA_ALIGNMENT = 16
+
+COMPRESSION_NONE = 0
+COMPRESSION_ZLIB = 1
+
+# extensions of files that don't get smaller with zlib
+STORED_EXTENSIONS = ('.png', '.jpg', '.jpeg', '.webp', '.pkm', '.pvr', '.ccz', '.gz', '.zip', '.mp3', '.ogg', '.m4a', '.caf')
+
+
+# must match ResourcePack::hashName()
+def hash_name(seed, name):
+    h = seed if seed else 0x01000193
+    for c in bytearray(name):
+        h = ((h * 0x01000193) & 0xffffffff) ^ c
+    return h
+
+
+# returns the displacement of each bucket and the slot of each name
+def build_perfect_hash(names):
+    n = len(names)
+    buckets = [[] for _ in range(n)]
+    for name in names:
+        buckets[hash_name(0, name) % n].append(name)
+    order = sorted(range(n), key=lambda b: len(buckets[b]), reverse=True)
+
+    displacements = [0] * n
+    slots = {}
+    taken = [False] * n
+    index = 0
+    # the buckets with several names look for a seed that puts all of them in free slots
+    while index < n and len(buckets[order[index]]) > 1:
+        bucket = buckets[order[index]]
+        seed = 1
+        while True:
+            candidates = [hash_name(seed, name) % n for name in bucket]
+            if len(set(candidates)) == len(candidates) and not any(taken[s] for s in candidates):
+                break
+            seed += 1
+            if seed >= 0x7fffffff:
+                raise RuntimeError('no perfect hash for bucket %d' % order[index])
+        displacements[order[index]] = seed
+        for name, slot in zip(bucket, candidates):
+            taken[slot] = True
+            slots[name] = slot
+        index += 1
+
+    # a single name goes to any free slot, stored as -slot-1
+    free = [s for s in range(n) if not taken[s]]
+    while index < n and len(buckets[order[index]]) == 1:
+        slot = free.pop()
+        displacements[order[index]] = -slot - 1
+        slots[buckets[order[index]][0]] = slot
+        index += 1
+
+    return displacements, slots
+
+
+def collect_files(root):
+    files = []
+    for directory, _, filenames in os.walk(root):
+        for filename in filenames:
+            path = os.path.join(directory, filename)
+            name = os.path.relpath(path, root).replace(os.sep, '/')
+            files.append((name.encode('utf-8'), path))
+    files.sort()
+    return files
+
+
+def align(value, alignment):
+    return (value + alignment - 1) & ~(alignment - 1)
+
+
+def write_pack(files, output, compress, verbose):
+    n = len(files)
+    names = [name for name, _ in files]
+    paths = dict(files)
+    displacements, slots = build_perfect_hash(names)
+
+    ordered = sorted(names, key=lambda name: slots[name])
+    entries_offset = align(HEADER_SIZE + 4 * n, 8)
+    names_offset = entries_offset + ENTRY_SIZE * n
+    names_blob = b''.join(ordered)
+    data_offset = align(names_offset + len(names_blob), DATA_ALIGNMENT)
+
+    entries = []
+    blobs = []
+    offset = data_offset
+    name_offset = 0
+    for name in ordered:
+        with open(paths[name], 'rb') as f:
+            data = f.read()
+        stored = data
+        compression = COMPRESSION_NONE
+        if compress and not name.lower().endswith(tuple(e.encode('ascii') for e in STORED_EXTENSIONS)):
+            deflated = zlib.compress(data, 9)
+            if len(deflated) < len(data):
+                stored = deflated
+                compression = COMPRESSION_ZLIB
+        entries.append(struct.pack('<QIIIIII', offset, len(stored), len(data), name_offset, len(name), compression, 0))
+        padding = align(len(stored), DATA_ALIGNMENT) - len(stored)
+        blobs.append(stored + b'\0' * padding)
+        offset += len(stored) + padding
+        name_offset += len(name)
+        if verbose:
+            print('%s: %d bytes%s' % (name.decode('utf-8'), len(data), ', zlib %d bytes' % len(stored) if compression else ''))
+
+    with open(output, 'wb') as f:
+        f.write(struct.pack('<4sIIII12x', PACK_MAGIC, PACK_VERSION, n, names_offset, len(names_blob)))
+        f.write(struct.pack('<%di' % n, *displacements))
+        f.write(b'\0' * (entries_offset - HEADER_SIZE - 4 * n))
+        f.write(b''.join(entries))
+        f.write(names_blob)
+        f.write(b'\0' * (data_offset - names_offset - len(names_blob)))
+        for blob in blobs:
+            f.write(blob)
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Packs a directory of resources into a .ccpack file.')
+    parser.add_argument('input', help='the directory to pack, its files are named relative to it')
+    parser.add_argument('output', help='the pack to write, e.g. res.ccpack')
+    parser.add_argument('-z', '--zlib', action='store_true', help='compress the files that get smaller with zlib')
+    parser.add_argument('-v', '--verbose', action='store_true', help='print the packed files')
+    args = parser.parse_args()
+
+    if not os.path.isdir(args.input):
+        sys.exit('%s is not a directory' % args.input)
+    files = collect_files(args.input)
+    write_pack(files, args.output, args.zlib, args.verbose)
+    print('packed %d files into %s' % (len(files), args.output))
+
+
+if __name__ == '__main__':
+    main()